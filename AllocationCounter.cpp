@@ -0,0 +1,27 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local uint64_t t_allocations = 0;
+
+}  // namespace
+
+uint64_t AllocationCounter::count() {
+    return t_allocations;
+}
+
+void* operator new(std::size_t size) {
+    ++t_allocations;
+    void* memory = std::malloc(size != 0 ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
@@ -0,0 +1,21 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+/**
+ * @class AllocationCounter
+ * @brief 按线程统计全局 operator new 的调用次数
+ *
+ * AllocationCounter.cpp 替换了全局 operator new/delete（仍由 malloc/free 分配），
+ * 每次分配只递增一个线程局部计数。离线基准在被测代码前后各读一次，
+ * 用差值核对热路径不分配内存（--bench-encoder）。
+ * 数组形式和 nothrow 形式的默认实现都经过替换后的 operator new，因此也会被计入。
+ */
+class AllocationCounter {
+public:
+    /** 当前线程累计的 operator new 调用次数 */
+    static uint64_t count();
+};
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,608 @@
+#include "ArmCollisionGuard.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+namespace {
+
+uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+const double kDegToRad = M_PI / 180.0;
+// 没有可比较的机械臂时的间隙
+const double kFar = 1e9;
+// 占位胶囊体的位置（远离任何工作空间）
+const double kPlaceholder = 1e6;
+// 连杆端点重合（零长度连杆）的判定距离（毫米）
+const double kMinLinkLength = 1.0;
+
+inline double clamp01(double value) {
+    return std::min(std::max(value, 0.0), 1.0);
+}
+
+// 参考实现：Ericson《Real-Time Collision Detection》5.1.9，逐分支处理退化和钳位
+double referenceSegmentDistance(const double p1[3], const double q1[3], const double p2[3], const double q2[3]) {
+    const double epsilon = 1e-12;
+    double d1[3], d2[3], r[3];
+    for (int k = 0; k < 3; ++k) {
+        d1[k] = q1[k] - p1[k];
+        d2[k] = q2[k] - p2[k];
+        r[k] = p1[k] - p2[k];
+    }
+    double a = d1[0] * d1[0] + d1[1] * d1[1] + d1[2] * d1[2];
+    double e = d2[0] * d2[0] + d2[1] * d2[1] + d2[2] * d2[2];
+    double f = d2[0] * r[0] + d2[1] * r[1] + d2[2] * r[2];
+    double s = 0.0, t = 0.0;
+    if (a <= epsilon && e <= epsilon) {
+        s = t = 0.0;
+    } else if (a <= epsilon) {
+        t = clamp01(f / e);
+    } else {
+        double c = d1[0] * r[0] + d1[1] * r[1] + d1[2] * r[2];
+        if (e <= epsilon) {
+            s = clamp01(-c / a);
+        } else {
+            double b = d1[0] * d2[0] + d1[1] * d2[1] + d1[2] * d2[2];
+            double denom = a * e - b * b;
+            s = denom != 0.0 ? clamp01((b * f - c * e) / denom) : 0.0;
+            t = (b * s + f) / e;
+            if (t < 0.0) {
+                t = 0.0;
+                s = clamp01(-c / a);
+            } else if (t > 1.0) {
+                t = 1.0;
+                s = clamp01((b - c) / a);
+            }
+        }
+    }
+    double distanceSq = 0.0;
+    for (int k = 0; k < 3; ++k) {
+        double w = p1[k] + d1[k] * s - p2[k] - d2[k] * t;
+        distanceSq += w * w;
+    }
+    return std::sqrt(distanceSq);
+}
+
+} // namespace
+
+void ArmCollisionGuard::Capsules::set(int i, const double start[3], const double end[3], double r) {
+    x[i] = start[0];
+    y[i] = start[1];
+    z[i] = start[2];
+    dx[i] = end[0] - start[0];
+    dy[i] = end[1] - start[1];
+    dz[i] = end[2] - start[2];
+    double lengthSq = dx[i] * dx[i] + dy[i] * dy[i] + dz[i] * dz[i];
+    inverseLengthSq[i] = lengthSq > 1e-12 ? 1.0 / lengthSq : 0.0;
+    radius[i] = r;
+}
+
+void ArmCollisionGuard::Capsules::clear() {
+    static const double placeholder[3] = {kPlaceholder, kPlaceholder, kPlaceholder};
+    for (int i = 0; i < kMaxCapsules; ++i) {
+        set(i, placeholder, placeholder, 0.0);
+    }
+    count = 0;
+}
+
+ArmCollisionGuard::ArmCollisionGuard(const Params& params)
+    : m_params(params),
+      m_checks(0), m_clamped(0), m_vetoed(0), m_staleChecks(0), m_staleVetoes(0), m_belowMargin(0),
+      m_minClearanceUm(std::numeric_limits<uint64_t>::max()),
+      m_checkTime(1000000) {
+    for (int i = 0; i < kMaxArms; ++i) {
+        Arm& arm = m_arms[i];
+        arm.registered = false;
+        arm.modeled = false;
+        arm.hasModel = false;
+        arm.stateTimestampNs = 0;
+        arm.commanding = false;
+        arm.links = 0;
+        arm.repulsedBy = -1;
+        arm.capsules.clear();
+        for (int k = 0; k < 3; ++k) {
+            arm.position[k] = 0.0;
+            arm.tool[k] = 0.0;
+            arm.commanded[k] = 0.0;
+            arm.repulsion[k] = 0.0;
+        }
+    }
+}
+
+bool ArmCollisionGuard::registerArm(int index, const ArmKinematics::Model& model, const double toolOffsetMm[3],
+                                    const Mount& mount, const StateReader& reader) {
+    if (index < 0 || index >= kMaxArms) {
+        return false;
+    }
+    Arm& arm = m_arms[index];
+    arm.kinematics.configure(model, ArmKinematics::Params());
+    arm.kinematics.setToolOffset(toolOffsetMm[0], toolOffsetMm[1], toolOffsetMm[2]);
+    arm.reader = reader;
+    ArmKinematics::rotationFromEuler(mount.rotationDeg[0] * kDegToRad, mount.rotationDeg[1] * kDegToRad,
+                                     mount.rotationDeg[2] * kDegToRad, arm.rotation);
+    for (int k = 0; k < 3; ++k) {
+        arm.position[k] = mount.position[k];
+    }
+    arm.registered = true;
+    return true;
+}
+
+void ArmCollisionGuard::toWorld(const Arm& arm, const Pose& pose, double world[3]) const {
+    double local[3] = {pose[0] / 1000.0, pose[1] / 1000.0, pose[2] / 1000.0};
+    for (int row = 0; row < 3; ++row) {
+        world[row] = arm.position[row] + arm.rotation[row * 3] * local[0] +
+                     arm.rotation[row * 3 + 1] * local[1] + arm.rotation[row * 3 + 2] * local[2];
+    }
+}
+
+void ArmCollisionGuard::setSweep(Arm& arm, const double target[3]) {
+    arm.capsules.set(arm.links, arm.tool, target, m_params.toolRadiusMm);
+    arm.capsules.count = arm.links + 1;
+}
+
+void ArmCollisionGuard::refresh(int index, uint64_t nowNs) {
+    Arm& arm = m_arms[index];
+    ArmRealtimeState state;
+    uint64_t timeoutNs = static_cast<uint64_t>(m_params.stateTimeoutMs * 1e6);
+    if (!arm.reader || !arm.reader(state) || !(state.fields & ArmRealtimeState::FieldJointStatus)) {
+        // 读取冲突时沿用已有模型，直到其过期
+        arm.modeled = arm.modeled && !(nowNs > arm.stateTimestampNs && nowNs - arm.stateTimestampNs > timeoutNs);
+        return;
+    }
+    if (nowNs > state.timestampNs && nowNs - state.timestampNs > timeoutNs) {
+        arm.modeled = false;
+        return;
+    }
+    if (arm.modeled && state.timestampNs == arm.stateTimestampNs) {
+        return;
+    }
+
+    ArmKinematics::Joints q;
+    for (int i = 0; i < ArmKinematics::kJoints; ++i) {
+        q[i] = state.jointPosition[i];
+    }
+    double local[ArmKinematics::kLinkPoints][3];
+    arm.kinematics.linkPoints(q, local);
+    double world[ArmKinematics::kLinkPoints][3];
+    for (int p = 0; p < ArmKinematics::kLinkPoints; ++p) {
+        for (int row = 0; row < 3; ++row) {
+            world[p][row] = arm.position[row] + arm.rotation[row * 3] * local[p][0] +
+                            arm.rotation[row * 3 + 1] * local[p][1] + arm.rotation[row * 3 + 2] * local[p][2];
+        }
+    }
+
+    // 跳过零长度连杆；最后一段（法兰→工具点）使用末端半径
+    arm.capsules.clear();
+    int links = 0;
+    for (int p = 0; p + 1 < ArmKinematics::kLinkPoints; ++p) {
+        double length = std::sqrt((world[p + 1][0] - world[p][0]) * (world[p + 1][0] - world[p][0]) +
+                                  (world[p + 1][1] - world[p][1]) * (world[p + 1][1] - world[p][1]) +
+                                  (world[p + 1][2] - world[p][2]) * (world[p + 1][2] - world[p][2]));
+        if (length < kMinLinkLength) {
+            continue;
+        }
+        bool tool = p + 2 == ArmKinematics::kLinkPoints;
+        arm.capsules.set(links++, world[p], world[p + 1], tool ? m_params.toolRadiusMm : m_params.linkRadiusMm);
+    }
+    arm.links = links;
+    for (int row = 0; row < 3; ++row) {
+        arm.tool[row] = world[ArmKinematics::kLinkPoints - 1][row];
+    }
+    setSweep(arm, arm.commanding ? arm.commanded : arm.tool);
+    arm.stateTimestampNs = state.timestampNs;
+    arm.modeled = true;
+    arm.hasModel = true;
+}
+
+void ArmCollisionGuard::nearest(const Capsules& a, int begin, int end, const Capsules& b, int partner,
+                                Closest& closest) {
+    double distanceSq[kMaxCapsules];
+    for (int i = begin; i < end; ++i) {
+        const double px = a.x[i], py = a.y[i], pz = a.z[i];
+        const double ux = a.dx[i], uy = a.dy[i], uz = a.dz[i];
+        const double inverseA = a.inverseLengthSq[i];
+        const double aa = ux * ux + uy * uy + uz * uz;
+        const double ra = a.radius[i];
+
+        // 对 b 的全部胶囊体同时计算（无分支），钳位顺序见 referenceSegmentDistance
+        for (int j = 0; j < kMaxCapsules; ++j) {
+            double rx = px - b.x[j], ry = py - b.y[j], rz = pz - b.z[j];
+            double vx = b.dx[j], vy = b.dy[j], vz = b.dz[j];
+            double bb = ux * vx + uy * vy + uz * vz;
+            double c = ux * rx + uy * ry + uz * rz;
+            double f = vx * rx + vy * ry + vz * rz;
+            double e = vx * vx + vy * vy + vz * vz;
+            double denom = std::max(aa * e - bb * bb, 1e-9);
+            double s = clamp01((bb * f - c * e) / denom);
+            double t = clamp01((bb * s + f) * b.inverseLengthSq[j]);
+            s = clamp01((bb * t - c) * inverseA);
+            double wx = rx + ux * s - vx * t;
+            double wy = ry + uy * s - vy * t;
+            double wz = rz + uz * s - vz * t;
+            distanceSq[j] = wx * wx + wy * wy + wz * wz;
+        }
+
+        // 开方单独成环：sqrt 的 errno 分支会阻止上面的循环向量化
+        int best = -1;
+        for (int j = 0; j < kMaxCapsules; ++j) {
+            double clearance = std::sqrt(distanceSq[j]) - ra - b.radius[j];
+            if (clearance < closest.clearance) {
+                closest.clearance = clearance;
+                best = j;
+            }
+        }
+        if (best < 0) {
+            continue;
+        }
+
+        // 只为新的最近对计算最近点（与核函数相同的公式）
+        double rx = px - b.x[best], ry = py - b.y[best], rz = pz - b.z[best];
+        double vx = b.dx[best], vy = b.dy[best], vz = b.dz[best];
+        double bb = ux * vx + uy * vy + uz * vz;
+        double c = ux * rx + uy * ry + uz * rz;
+        double f = vx * rx + vy * ry + vz * rz;
+        double e = vx * vx + vy * vy + vz * vz;
+        double s = clamp01((bb * f - c * e) / std::max(aa * e - bb * bb, 1e-9));
+        double t = clamp01((bb * s + f) * b.inverseLengthSq[best]);
+        s = clamp01((bb * t - c) * inverseA);
+        closest.onSelf[0] = px + ux * s;
+        closest.onSelf[1] = py + uy * s;
+        closest.onSelf[2] = pz + uz * s;
+        closest.onOther[0] = b.x[best] + vx * t;
+        closest.onOther[1] = b.y[best] + vy * t;
+        closest.onOther[2] = b.z[best] + vz * t;
+        closest.partner = partner;
+    }
+}
+
+void ArmCollisionGuard::clearanceTo(int index, const double target[3], const Closest& links, Closest& closest) {
+    Arm& self = m_arms[index];
+    setSweep(self, target);
+    closest = links;
+    for (int j = 0; j < kMaxArms; ++j) {
+        if (j != index && m_arms[j].registered && m_arms[j].hasModel) {
+            nearest(self.capsules, self.links, self.links + 1, m_arms[j].capsules, j, closest);
+        }
+    }
+}
+
+void ArmCollisionGuard::beginSession(int index, const Pose& anchor, uint64_t nowNs) {
+    if (index < 0 || index >= kMaxArms || !m_arms[index].registered) {
+        return;
+    }
+    Arm& arm = m_arms[index];
+    toWorld(arm, anchor, arm.commanded);
+    arm.commanding = true;
+    refresh(index, nowNs);
+    if (arm.modeled) {
+        setSweep(arm, arm.commanded);
+    }
+}
+
+void ArmCollisionGuard::endSession(int index) {
+    if (index < 0 || index >= kMaxArms || !m_arms[index].registered) {
+        return;
+    }
+    Arm& arm = m_arms[index];
+    arm.commanding = false;
+    if (arm.modeled) {
+        setSweep(arm, arm.tool);
+    }
+    for (int j = 0; j < kMaxArms; ++j) {
+        if (j == index || m_arms[j].repulsedBy == index) {
+            m_arms[j].repulsion[0] = m_arms[j].repulsion[1] = m_arms[j].repulsion[2] = 0.0;
+            m_arms[j].repulsedBy = -1;
+        }
+    }
+}
+
+ArmCollisionGuard::Verdict ArmCollisionGuard::check(int index, Pose& target, uint64_t nowNs, Result& result) {
+    uint64_t startNs = steadyNowNs();
+    bump(m_checks);
+    result.verdict = Clear;
+    result.clearanceMm = kFar;
+    result.partner = -1;
+    result.stale = -1;
+    result.staleHold = false;
+    if (index < 0 || index >= kMaxArms || !m_arms[index].registered) {
+        return Clear;
+    }
+
+    // 本机及其推开的机械臂的排斥力按本次检查重新计算
+    for (int j = 0; j < kMaxArms; ++j) {
+        if (j == index || m_arms[j].repulsedBy == index) {
+            m_arms[j].repulsion[0] = m_arms[j].repulsion[1] = m_arms[j].repulsion[2] = 0.0;
+            m_arms[j].repulsedBy = -1;
+        }
+    }
+
+    // 过期的对方沿用最近一次的模型；本机过期或对方从未建模时无法检查
+    int others = 0;
+    for (int j = 0; j < kMaxArms; ++j) {
+        if (!m_arms[j].registered) {
+            continue;
+        }
+        refresh(j, nowNs);
+        if (!m_arms[j].modeled) {
+            bool hold = j == index || !m_arms[j].hasModel;
+            if (result.stale < 0 || (hold && !result.staleHold)) {
+                result.stale = j;
+            }
+            result.staleHold = result.staleHold || hold;
+        }
+        if (j != index) {
+            ++others;
+        }
+    }
+    if (result.stale >= 0) {
+        bump(m_staleChecks);
+    }
+
+    Arm& self = m_arms[index];
+    double world[3];
+    toWorld(self, target, world);
+    if (!self.commanding) {
+        std::copy(world, world + 3, self.commanded);
+        self.commanding = true;
+    }
+    if (others == 0) {
+        // 没有其他机械臂：放行
+        std::copy(world, world + 3, self.commanded);
+        if (self.hasModel) {
+            setSweep(self, self.commanded);
+        }
+        m_checkTime.record(steadyNowNs() - startNs);
+        return Clear;
+    }
+    if (result.staleHold) {
+        // 无法检查：拒绝，机械臂停在上一次接受的目标（对方看到的扫掠胶囊体也停在该处）
+        result.verdict = Vetoed;
+        result.partner = result.stale;
+        bump(m_staleVetoes);
+        m_checkTime.record(steadyNowNs() - startNs);
+        return Vetoed;
+    }
+
+    // 本机连杆与其他机械臂之间的间隙与指令目标无关，只算一次
+    Closest links;
+    links.clearance = kFar;
+    links.partner = -1;
+    for (int j = 0; j < kMaxArms; ++j) {
+        if (j != index && m_arms[j].registered && m_arms[j].hasModel) {
+            nearest(self.capsules, 0, self.links, m_arms[j].capsules, j, links);
+        }
+    }
+
+    const double margin = m_params.marginMm;
+    Closest requested;
+    clearanceTo(index, world, links, requested);
+    Closest accepted = requested;
+    if (requested.clearance < margin) {
+        bump(m_belowMargin);
+        Closest previous;
+        clearanceTo(index, self.commanded, links, previous);
+        if (accepted.clearance >= previous.clearance) {
+            // 正在远离或平行移动
+        } else if (previous.clearance >= margin) {
+            // 二分出沿上一次目标 → 新目标直线上仍满足安全距离的最远点
+            double low = 0.0, high = 1.0;
+            double point[3];
+            accepted = previous;
+            for (int iteration = 0; iteration < m_params.clampIterations; ++iteration) {
+                double mid = 0.5 * (low + high);
+                for (int k = 0; k < 3; ++k) {
+                    point[k] = self.commanded[k] + mid * (world[k] - self.commanded[k]);
+                }
+                Closest candidate;
+                clearanceTo(index, point, links, candidate);
+                if (candidate.clearance >= margin) {
+                    low = mid;
+                    accepted = candidate;
+                } else {
+                    high = mid;
+                }
+            }
+            for (int k = 0; k < 3; ++k) {
+                world[k] = self.commanded[k] + low * (world[k] - self.commanded[k]);
+            }
+            // 位置写回机械臂基坐标系（微米），姿态不变
+            double offset[3] = {world[0] - self.position[0], world[1] - self.position[1], world[2] - self.position[2]};
+            for (int k = 0; k < 3; ++k) {
+                double local = self.rotation[k] * offset[0] + self.rotation[3 + k] * offset[1] +
+                               self.rotation[6 + k] * offset[2];
+                target[k] = static_cast<int>(std::lround(local * 1000.0));
+            }
+            result.verdict = Clamped;
+            bump(m_clamped);
+        } else {
+            accepted = previous;
+            result.verdict = Vetoed;
+            bump(m_vetoed);
+        }
+    }
+    if (result.verdict != Vetoed) {
+        std::copy(world, world + 3, self.commanded);
+    }
+    setSweep(self, self.commanded);
+
+    // 排斥力按请求的目标计算（截短后操作者继续推入时感受到的墙），沿最近点连线把两台机械臂推开
+    if (requested.clearance < margin && requested.partner >= 0) {
+        double normal[3] = {requested.onSelf[0] - requested.onOther[0], requested.onSelf[1] - requested.onOther[1],
+                            requested.onSelf[2] - requested.onOther[2]};
+        double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length > 1e-9) {
+            double magnitude = std::min(m_params.repulsionStiffness * (margin - requested.clearance), m_params.maxRepulsion);
+            Arm& other = m_arms[requested.partner];
+            for (int k = 0; k < 3; ++k) {
+                normal[k] *= magnitude / length;
+            }
+            for (int k = 0; k < 3; ++k) {
+                self.repulsion[k] = self.rotation[k] * normal[0] + self.rotation[3 + k] * normal[1] +
+                                    self.rotation[6 + k] * normal[2];
+                other.repulsion[k] = -(other.rotation[k] * normal[0] + other.rotation[3 + k] * normal[1] +
+                                       other.rotation[6 + k] * normal[2]);
+            }
+            other.repulsedBy = index;
+        }
+    }
+
+    uint64_t clearanceUm = accepted.clearance > 0.0 ? static_cast<uint64_t>(accepted.clearance * 1000.0) : 0;
+    if (clearanceUm < m_minClearanceUm.load(std::memory_order_relaxed)) {
+        m_minClearanceUm.store(clearanceUm, std::memory_order_relaxed);
+    }
+    result.clearanceMm = accepted.clearance;
+    result.partner = accepted.partner;
+    m_checkTime.record(steadyNowNs() - startNs);
+    return result.verdict;
+}
+
+void ArmCollisionGuard::getRepulsion(int index, double force[3]) const {
+    for (int k = 0; k < 3; ++k) {
+        force[k] = index >= 0 && index < kMaxArms ? m_arms[index].repulsion[k] : 0.0;
+    }
+}
+
+void ArmCollisionGuard::getStats(Stats& stats) const {
+    stats.checks = m_checks.load(std::memory_order_relaxed);
+    stats.clamped = m_clamped.load(std::memory_order_relaxed);
+    stats.vetoed = m_vetoed.load(std::memory_order_relaxed);
+    stats.staleChecks = m_staleChecks.load(std::memory_order_relaxed);
+    stats.staleVetoes = m_staleVetoes.load(std::memory_order_relaxed);
+    stats.belowMargin = m_belowMargin.load(std::memory_order_relaxed);
+    uint64_t minClearanceUm = m_minClearanceUm.load(std::memory_order_relaxed);
+    stats.minClearanceMm = minClearanceUm == std::numeric_limits<uint64_t>::max() ? kFar : minClearanceUm / 1000.0;
+    m_checkTime.snapshot(stats.checkTime);
+}
+
+void ArmCollisionGuard::printStats(std::ostream& os) const {
+    Stats stats;
+    getStats(stats);
+    os << "双臂防碰撞: 检查=" << stats.checks << ", 截短=" << stats.clamped << ", 拒绝=" << stats.vetoed
+       << ", 低于安全距离=" << stats.belowMargin << ", 关节角度过期=" << stats.staleChecks << " (拒绝 " << stats.staleVetoes
+       << "), 最小间隙=";
+    if (stats.minClearanceMm < kFar) {
+        os << std::fixed << std::setprecision(1) << stats.minClearanceMm << "mm";
+    } else {
+        os << "-";
+    }
+    os << std::fixed << std::setprecision(2) << ", 耗时 p50=" << stats.checkTime.percentile(0.50) / 1000.0
+       << "us p99=" << stats.checkTime.percentile(0.99) / 1000.0 << "us max=" << stats.checkTime.maxNs / 1000.0
+       << "us" << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+bool ArmCollisionGuard::benchmark(std::ostream& os, const Params& params, const ArmKinematics::Model& model,
+                                  int iterations, uint64_t budgetNs) {
+    // 两台机械臂相距600mm，基座相对（第二台绕Z转180°）
+    ArmRealtimeState* states = new ArmRealtimeState[2]();
+    ArmCollisionGuard* guard = new ArmCollisionGuard(params);
+    static const double kNoTool[3] = {0.0, 0.0, 0.0};
+    Mount mounts[2] = {{{0.0, -300.0, 0.0}, {0.0, 0.0, 0.0}}, {{0.0, 300.0, 0.0}, {0.0, 0.0, 180.0}}};
+    for (int i = 0; i < 2; ++i) {
+        ArmRealtimeState* state = &states[i];
+        guard->registerArm(i, model, kNoTool, mounts[i], [state](ArmRealtimeState& out) {
+            out = *state;
+            return true;
+        });
+    }
+
+    ArmKinematics kinematics;
+    kinematics.configure(model, ArmKinematics::Params());
+    uint32_t random = 12345;
+    uint64_t nowNs = 1000000000ULL;
+    ArmKinematics::Joints q[2];
+
+    // 随机关节角度（限位的80%内）、随机上报时间
+    auto randomize = [&](int arm) {
+        for (int j = 0; j < ArmKinematics::kJoints; ++j) {
+            random = random * 1664525u + 1013904223u;
+            double unit = (random >> 8) / 16777216.0;
+            q[arm][j] = 0.8 * (model.minDeg[j] + unit * (model.maxDeg[j] - model.minDeg[j]));
+            states[arm].jointPosition[j] = static_cast<float>(q[arm][j]);
+            q[arm][j] = states[arm].jointPosition[j];
+        }
+        states[arm].fields = ArmRealtimeState::FieldJointStatus | ArmRealtimeState::FieldPose;
+        states[arm].timestampNs = nowNs;
+    };
+    for (int arm = 0; arm < 2; ++arm) {
+        randomize(arm);
+        guard->beginSession(arm, kinematics.forward(q[arm]), nowNs);
+    }
+
+    uint64_t verdicts[3] = {0, 0, 0};
+    uint64_t below = 0;
+    double maxError = 0.0;
+    for (int n = 0; n < iterations; ++n) {
+        nowNs += 1000000;
+        randomize(0);
+        randomize(1);
+        // 指令目标：当前正解附近 ±60mm
+        int arm = n & 1;
+        Pose target = kinematics.forward(q[arm]);
+        for (int k = 0; k < 3; ++k) {
+            random = random * 1664525u + 1013904223u;
+            target[k] += static_cast<int>(((random >> 8) / 16777216.0 - 0.5) * 120000.0);
+        }
+        Result result;
+        Verdict verdict = guard->check(arm, target, nowNs, result);
+        ++verdicts[verdict];
+        if (result.clearanceMm < params.marginMm) {
+            ++below;
+        }
+
+        // 参考：对检查后的两组胶囊体逐对计算
+        double reference = kFar;
+        const Capsules& a = guard->m_arms[0].capsules;
+        const Capsules& b = guard->m_arms[1].capsules;
+        for (int i = 0; i < a.count; ++i) {
+            double p1[3] = {a.x[i], a.y[i], a.z[i]};
+            double q1[3] = {a.x[i] + a.dx[i], a.y[i] + a.dy[i], a.z[i] + a.dz[i]};
+            for (int j = 0; j < b.count; ++j) {
+                double p2[3] = {b.x[j], b.y[j], b.z[j]};
+                double q2[3] = {b.x[j] + b.dx[j], b.y[j] + b.dy[j], b.z[j] + b.dz[j]};
+                reference = std::min(reference, referenceSegmentDistance(p1, q1, p2, q2) - a.radius[i] - b.radius[j]);
+            }
+        }
+        maxError = std::max(maxError, std::fabs(reference - result.clearanceMm));
+        if (verdict == Clamped && result.clearanceMm < params.marginMm - 1e-6) {
+            maxError = std::max(maxError, params.marginMm - result.clearanceMm);
+        }
+    }
+
+    // 过期保护：第二台上报过期后仍按上一次模型参与检查；注册了但从未上报的机械臂使检查拒绝
+    nowNs += static_cast<uint64_t>(params.stateTimeoutMs * 1e6) + 1000000;
+    randomize(0);
+    Pose current = kinematics.forward(q[0]);
+    Result staleResult;
+    guard->check(0, current, nowNs, staleResult);
+    bool failSafe = staleResult.stale == 1 && !staleResult.staleHold && staleResult.partner == 1 &&
+                    staleResult.clearanceMm < kFar;
+    guard->registerArm(2, model, kNoTool, mounts[0], [](ArmRealtimeState&) { return false; });
+    current = kinematics.forward(q[0]);
+    Verdict holdVerdict = guard->check(0, current, nowNs, staleResult);
+    failSafe = failSafe && holdVerdict == Vetoed && staleResult.stale == 2 && staleResult.staleHold;
+
+    Stats stats;
+    guard->getStats(stats);
+    uint64_t p99 = stats.checkTime.percentile(0.99);
+    bool ok = p99 <= budgetNs && maxError < 1e-6 && failSafe;
+    os << std::fixed << "  两台 " << model.name << " 相距600mm对置，" << iterations
+       << " 次随机关节角度/指令目标（每次两台都重新正解）: check() p50=" << std::setprecision(2)
+       << stats.checkTime.percentile(0.50) / 1000.0 << "us p99=" << p99 / 1000.0
+       << "us max=" << stats.checkTime.maxNs / 1000.0 << "us 平均=" << stats.checkTime.meanNs() / 1000.0
+       << "us（预算 " << budgetNs / 1000.0 << "us）" << std::endl;
+    os << "  放行=" << std::setprecision(1) << 100.0 * verdicts[Clear] / iterations << "%, 截短="
+       << 100.0 * verdicts[Clamped] / iterations << "%, 拒绝=" << 100.0 * verdicts[Vetoed] / iterations
+       << "%, 低于安全距离=" << 100.0 * below / iterations << "%; 与参考实现的最大间隙偏差=" << std::scientific
+       << std::setprecision(1) << maxError << "mm " << (ok ? "✅" : "❌") << std::defaultfloat << std::setprecision(6)
+       << std::endl;
+    os << "  过期保护: 对方上报过期时沿用上一次模型" << (failSafe ? "、从未上报时拒绝目标 ✅" : " 或从未上报时拒绝目标未生效 ❌")
+       << std::endl;
+    delete guard;
+    delete[] states;
+    return ok;
+}
@@ -0,0 +1,206 @@
+#ifndef ARMCOLLISIONGUARD_H
+#define ARMCOLLISIONGUARD_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+
+#include "ArmKinematics.h"
+#include "ArmStateReceiver.h"
+#include "ServoTiming.h"
+
+/**
+ * @class ArmCollisionGuard
+ * @brief 共享工作空间中多台机械臂之间的胶囊体防碰撞检查（所有控制器共用一个）
+ *
+ * 每台机械臂按其运动学模型建模为一串胶囊体：上报关节角度的正解给出各段连杆
+ * （基座→肩→肘→腕→法兰→工具点），再加一段从上报工具点到最新指令目标的扫掠胶囊体，
+ * 覆盖机械臂在下一帧内要扫过的空间。各机械臂的基座位姿把模型放进同一个世界坐标系。
+ * 控制器在发送节拍上调用 check()：
+ * - 与其他机械臂的最小间隙不低于安全距离 → 原样发送
+ * - 低于安全距离但不比上一次接受的目标更近（正在远离或平行移动）→ 原样发送
+ * - 上一次接受的目标在安全距离外 → 沿上一次目标到新目标的直线截短到安全距离处（只改位置）
+ * - 否则拒绝，机械臂停在上一次接受的目标上
+ * 关节角度上报过期的对方机械臂沿用最近一次上报的模型（连杆 + 到其上一次接受目标的扫掠胶囊体；
+ * 过期的机械臂自身的检查拒绝新目标，不会越出该范围）；本机过期或对方从未上报时无法检查，拒绝目标。
+ * 请求的目标间隙低于安全距离时，两台机械臂都得到与侵入深度成正比、沿最近点连线方向相互推开的
+ * 排斥力（各自基坐标系），由各自的控制器叠加到触觉反馈上；目标被截短后继续推入，操作者感受到一面墙。
+ * 距离核函数以结构数组（SoA）存放对方的胶囊体，对一段胶囊体同时计算与对方全部胶囊体的
+ * 线段-线段距离，无分支，可由编译器向量化。
+ * check()/beginSession()/endSession()/getRepulsion() 只在伺服线程中调用（所有设备在同一回调内依次处理），
+ * 不分配、不加锁；统计可在任意线程读取。
+ */
+class ArmCollisionGuard {
+public:
+    static const int kMaxArms = 4;
+    static const int kMaxCapsules = 8;      // 连杆胶囊体（至多7段）+ 扫掠胶囊体
+
+    typedef std::function<bool(ArmRealtimeState& state)> StateReader;
+    typedef std::array<int, 6> Pose;        // 微米/毫弧度（机械臂基坐标系）
+
+    enum Verdict { Clear, Clamped, Vetoed };
+
+    struct Params {
+        double marginMm;              // 两臂胶囊体表面之间的安全距离
+        double linkRadiusMm;          // 连杆胶囊体半径
+        double toolRadiusMm;          // 法兰→工具点以及扫掠胶囊体的半径
+        double repulsionStiffness;    // 排斥力刚度（N/mm，间隙低于安全距离的部分）
+        double maxRepulsion;          // 排斥力上限（N）
+        double stateTimeoutMs;        // 上报关节角度超过该时长视为过期（对方沿用上一次模型，本机拒绝目标）
+        int clampIterations;          // 截短目标的二分次数
+
+        Params()
+            : marginMm(50.0), linkRadiusMm(60.0), toolRadiusMm(45.0), repulsionStiffness(0.05),
+              maxRepulsion(2.0), stateTimeoutMs(200.0), clampIterations(8) {}
+    };
+
+    /**
+     * @brief 机械臂在世界坐标系中的安装位姿
+     */
+    struct Mount {
+        double position[3];           // 基座原点（毫米）
+        double rotationDeg[3];        // 基座姿态（X-Y-Z固定轴欧拉角，度）
+    };
+
+    /**
+     * @brief 单次检查结果
+     */
+    struct Result {
+        Verdict verdict;
+        double clearanceMm;           // 接受的目标（拒绝时为上一次目标）与其他机械臂的最小间隙，没有可比较的机械臂时为极大值
+        int partner;                  // 最近的机械臂序号（0起），-1为没有
+        int stale;                    // 关节角度过期的机械臂序号（0起，导致拒绝的优先），-1为没有
+        bool staleHold;               // 因本机过期或对方从未上报而拒绝
+    };
+
+    struct Stats {
+        uint64_t checks;              // check() 次数
+        uint64_t clamped;             // 目标被截短
+        uint64_t vetoed;              // 目标被拒绝
+        uint64_t staleChecks;         // 本机或对方关节角度过期的检查次数
+        uint64_t staleVetoes;         // 其中无法检查而拒绝的次数
+        uint64_t belowMargin;         // 间隙低于安全距离的检查（含正在远离而放行的）
+        double minClearanceMm;        // 拖动中出现过的最小间隙
+        LatencyHistogram::Snapshot checkTime;
+    };
+
+    explicit ArmCollisionGuard(const Params& params);
+
+    const Params& getParams() const { return m_params; }
+
+    /**
+     * @brief 注册机械臂（启动时、伺服回调开始前调用）
+     * @param index 机械臂序号（0起，与设备序号对应）
+     * @param reader 读取该机械臂最新上报状态（伺服线程调用，需wait-free）
+     */
+    bool registerArm(int index, const ArmKinematics::Model& model, const double toolOffsetMm[3],
+                     const Mount& mount, const StateReader& reader);
+
+    // ---- 以下由伺服线程调用 ----
+
+    /**
+     * @brief 开始拖动：以锚点位姿作为上一次接受的目标
+     */
+    void beginSession(int index, const Pose& anchor, uint64_t nowNs);
+
+    /**
+     * @brief 结束拖动：不再有指令目标，只按上报状态作为障碍物参与检查
+     */
+    void endSession(int index);
+
+    /**
+     * @brief 检查并按需截短本机械臂的指令目标
+     * @param target 指令目标，截短时位置被改写；拒绝时不改写（调用者不应发送）
+     */
+    Verdict check(int index, Pose& target, uint64_t nowNs, Result& result);
+
+    /**
+     * @brief 最近一次检查得到的排斥力（N，该机械臂基坐标系）
+     */
+    void getRepulsion(int index, double force[3]) const;
+
+    // ---- 任意线程 ----
+
+    void getStats(Stats& stats) const;
+    void printStats(std::ostream& os) const;
+
+    /**
+     * @brief 离线基准：两台对置的机械臂在随机关节角度和随机指令目标下的 check() 耗时，
+     *        并与逐对分支实现的参考距离核对
+     * @param budgetNs 单次检查的耗时上限
+     * @return p99 不超过 budgetNs 且距离与参考一致时返回true
+     */
+    static bool benchmark(std::ostream& os, const Params& params, const ArmKinematics::Model& model,
+                          int iterations, uint64_t budgetNs);
+
+private:
+    ArmCollisionGuard(const ArmCollisionGuard&);
+    ArmCollisionGuard& operator=(const ArmCollisionGuard&);
+
+    // 结构数组：起点、方向（终点-起点）、方向长度平方的倒数、半径
+    struct Capsules {
+        double x[kMaxCapsules], y[kMaxCapsules], z[kMaxCapsules];
+        double dx[kMaxCapsules], dy[kMaxCapsules], dz[kMaxCapsules];
+        double inverseLengthSq[kMaxCapsules];
+        double radius[kMaxCapsules];
+        int count;   // 有效胶囊体数（其余为远处的占位，参与计算但不影响最小值）
+
+        void set(int i, const double start[3], const double end[3], double r);
+        void clear();
+    };
+
+    struct Closest {
+        double clearance;
+        double onSelf[3];
+        double onOther[3];
+        int partner;
+    };
+
+    struct Arm {
+        bool registered;
+        ArmKinematics kinematics;
+        StateReader reader;
+        double rotation[9];           // 基座 → 世界
+        double position[3];
+        bool modeled;                 // 连杆胶囊体来自新鲜的上报
+        bool hasModel;                // 曾经建模（过期后 capsules 保留最近一次的模型）
+        uint64_t stateTimestampNs;    // 已建模的上报时间
+        double tool[3];               // 上报工具点（世界坐标）
+        bool commanding;              // 拖动中
+        double commanded[3];          // 上一次接受的指令目标（世界坐标）
+        Capsules capsules;            // [0, links) 连杆，links 为扫掠胶囊体
+        int links;
+        double repulsion[3];          // 基坐标系
+        int repulsedBy;               // 排斥力来自哪台机械臂的检查，-1为没有
+    };
+
+    void refresh(int index, uint64_t nowNs);
+    void setSweep(Arm& arm, const double target[3]);
+    void toWorld(const Arm& arm, const Pose& pose, double world[3]) const;
+
+    // 胶囊体 a[begin, end) 与 b 全部胶囊体之间的最小间隙（核函数），比 closest 更近时更新，partner 为 b 的序号
+    static void nearest(const Capsules& a, int begin, int end, const Capsules& b, int partner, Closest& closest);
+
+    // 本机扫掠胶囊体到 target 时与其他机械臂（含沿用上一次模型的）的最小间隙
+    void clearanceTo(int index, const double target[3], const Closest& links, Closest& closest);
+
+    static void bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Params m_params;
+    Arm m_arms[kMaxArms];
+
+    std::atomic<uint64_t> m_checks;
+    std::atomic<uint64_t> m_clamped;
+    std::atomic<uint64_t> m_vetoed;
+    std::atomic<uint64_t> m_staleChecks;
+    std::atomic<uint64_t> m_staleVetoes;
+    std::atomic<uint64_t> m_belowMargin;
+    std::atomic<uint64_t> m_minClearanceUm;
+    LatencyHistogram m_checkTime;
+};
+
+#endif // ARMCOLLISIONGUARD_H
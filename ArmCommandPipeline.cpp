@@ -0,0 +1,69 @@
+#include "ArmCommandPipeline.h"
+
+#include <chrono>
+
+ArmCommandPipeline::ArmCommandPipeline(SendFunction sender)
+    : m_sender(sender),
+      m_posted(0), m_dropped(0), m_maxDepth(0),
+      m_sent(0), m_sendFailures(0), m_lastLatencyNs(0), m_maxLatencyNs(0) {
+}
+
+uint64_t ArmCommandPipeline::nowNs() {
+    // steady_clock 在Linux上通过vDSO读取，不陷入内核
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool ArmCommandPipeline::post(const std::array<int, 6>& targetPose) {
+    ArmTargetRecord record;
+    record.timestampNs = nowNs();
+    record.targetPose = targetPose;
+
+    if (!m_queue.tryPush(record)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    m_posted.fetch_add(1, std::memory_order_relaxed);
+
+    size_t depth = m_queue.size();
+    if (depth > m_maxDepth.load(std::memory_order_relaxed)) {
+        m_maxDepth.store(depth, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+ArmCommandPipeline::Stats ArmCommandPipeline::getStats() const {
+    Stats stats;
+    stats.depth = m_queue.size();
+    stats.maxDepth = m_maxDepth.load(std::memory_order_relaxed);
+    stats.posted = m_posted.load(std::memory_order_relaxed);
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    stats.sent = m_sent.load(std::memory_order_relaxed);
+    stats.sendFailures = m_sendFailures.load(std::memory_order_relaxed);
+    stats.lastLatencyNs = m_lastLatencyNs.load(std::memory_order_relaxed);
+    stats.maxLatencyNs = m_maxLatencyNs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+size_t ArmCommandPipeline::drain() {
+    ArmTargetRecord record;
+    size_t processed = 0;
+
+    while (m_queue.tryPop(record)) {
+        bool ok = m_sender ? m_sender(record.targetPose) : false;
+
+        uint64_t latency = nowNs() - record.timestampNs;
+        m_lastLatencyNs.store(latency, std::memory_order_relaxed);
+        if (latency > m_maxLatencyNs.load(std::memory_order_relaxed)) {
+            m_maxLatencyNs.store(latency, std::memory_order_relaxed);
+        }
+
+        if (ok) {
+            m_sent.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_sendFailures.fetch_add(1, std::memory_order_relaxed);
+        }
+        ++processed;
+    }
+    return processed;
+}
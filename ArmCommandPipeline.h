@@ -0,0 +1,96 @@
+#ifndef ARMCOMMANDPIPELINE_H
+#define ARMCOMMANDPIPELINE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "SpscQueue.h"
+
+/**
+ * @struct ArmTargetRecord
+ * @brief 伺服线程投递给反应器线程的紧凑目标记录
+ */
+struct ArmTargetRecord {
+    uint64_t timestampNs;           // 伺服线程生成记录的单调时钟时间戳（纳秒）
+    std::array<int, 6> targetPose;  // 目标位姿（微米/毫弧度）
+};
+
+/**
+ * @class ArmCommandPipeline
+ * @brief 触觉伺服线程到机械臂通信反应器的无锁指令管线
+ *
+ * 伺服回调只调用 post() 把 {时间戳, 目标位姿} 写入SPSC环形队列，
+ * 所有机械臂共用的反应器线程（ArmReactor）每个节拍调用 drain() 出队、编码并写入socket。
+ * 这样指令编码和 send() 系统调用都不会出现在1kHz调度线程中。
+ */
+class ArmCommandPipeline {
+public:
+    typedef std::function<bool(const std::array<int, 6>&)> SendFunction;
+
+    /**
+     * @brief 管线统计信息
+     */
+    struct Stats {
+        size_t depth;            // 当前队列深度
+        size_t maxDepth;         // 历史最大队列深度
+        uint64_t posted;         // 成功入队的记录数
+        uint64_t dropped;        // 队列满被丢弃的记录数
+        uint64_t sent;           // 发送成功的记录数
+        uint64_t sendFailures;   // 发送失败的记录数
+        uint64_t lastLatencyNs;  // 最近一条记录从入队到发送完成的延迟
+        uint64_t maxLatencyNs;   // 最大入队到发送完成延迟
+    };
+
+    /**
+     * @brief 构造函数
+     * @param sender 消费者线程中调用的发送函数
+     */
+    explicit ArmCommandPipeline(SendFunction sender);
+
+    /**
+     * @brief 投递目标位姿（伺服线程调用，wait-free，无系统调用）
+     * @param targetPose 目标位姿
+     * @return 队列已满时返回false
+     */
+    bool post(const std::array<int, 6>& targetPose);
+
+    /**
+     * @brief 取出所有已投递的记录并依次发送（消费者线程调用，即反应器线程）
+     * @return 本次处理的记录数
+     */
+    size_t drain();
+
+    /**
+     * @brief 获取统计信息（任意线程可调用）
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief 单调时钟当前时间（纳秒）
+     */
+    static uint64_t nowNs();
+
+private:
+    ArmCommandPipeline(const ArmCommandPipeline&);
+    ArmCommandPipeline& operator=(const ArmCommandPipeline&);
+
+    static const size_t kQueueCapacity = 64;
+
+    SendFunction m_sender;
+    SpscQueue<ArmTargetRecord, kQueueCapacity> m_queue;
+
+    // 生产者侧计数（仅伺服线程写）
+    std::atomic<uint64_t> m_posted;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<size_t> m_maxDepth;
+
+    // 消费者侧计数（仅反应器线程写）
+    std::atomic<uint64_t> m_sent;
+    std::atomic<uint64_t> m_sendFailures;
+    std::atomic<uint64_t> m_lastLatencyNs;
+    std::atomic<uint64_t> m_maxLatencyNs;
+};
+
+#endif // ARMCOMMANDPIPELINE_H
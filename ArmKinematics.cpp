@@ -0,0 +1,355 @@
+#include "ArmKinematics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "OrientationMath.h"
+
+namespace {
+
+const double kDegToRad = M_PI / 180.0;
+const double kRadToDeg = 180.0 / M_PI;
+
+// 内置型号：改进DH参数（alpha, a, d, 零位偏置）与关节限位
+const ArmKinematics::Model kModels[] = {
+    {"rm65",
+     {{0.0, 0.0, 240.5, 0.0},
+      {90.0, 0.0, 0.0, 90.0},
+      {0.0, 256.0, 0.0, 90.0},
+      {90.0, 0.0, 210.0, 0.0},
+      {-90.0, 0.0, 0.0, 0.0},
+      {90.0, 0.0, 144.0, 0.0}},
+     {-178.0, -130.0, -135.0, -178.0, -128.0, -360.0},
+     {178.0, 130.0, 135.0, 178.0, 128.0, 360.0}},
+};
+
+// 6x6行列式（部分主元消去）
+double determinant6(const double m[6][6]) {
+    double a[6][6];
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            a[i][j] = m[i][j];
+        }
+    }
+    double det = 1.0;
+    for (int c = 0; c < 6; ++c) {
+        int pivot = c;
+        for (int r = c + 1; r < 6; ++r) {
+            if (std::fabs(a[r][c]) > std::fabs(a[pivot][c])) {
+                pivot = r;
+            }
+        }
+        if (a[pivot][c] == 0.0) {
+            return 0.0;
+        }
+        if (pivot != c) {
+            for (int j = 0; j < 6; ++j) {
+                std::swap(a[c][j], a[pivot][j]);
+            }
+            det = -det;
+        }
+        det *= a[c][c];
+        for (int r = c + 1; r < 6; ++r) {
+            double k = a[r][c] / a[c][c];
+            for (int j = c; j < 6; ++j) {
+                a[r][j] -= k * a[c][j];
+            }
+        }
+    }
+    return det;
+}
+
+// 对称正定矩阵的Cholesky分解求解 A·x = b（A被改写），失败时返回false
+bool choleskySolve6(double a[6][6], const double b[6], double x[6]) {
+    for (int j = 0; j < 6; ++j) {
+        double d = a[j][j];
+        for (int k = 0; k < j; ++k) {
+            d -= a[j][k] * a[j][k];
+        }
+        if (d <= 0.0) {
+            return false;
+        }
+        a[j][j] = std::sqrt(d);
+        for (int i = j + 1; i < 6; ++i) {
+            double s = a[i][j];
+            for (int k = 0; k < j; ++k) {
+                s -= a[i][k] * a[j][k];
+            }
+            a[i][j] = s / a[j][j];
+        }
+    }
+    double y[6];
+    for (int i = 0; i < 6; ++i) {
+        double s = b[i];
+        for (int k = 0; k < i; ++k) {
+            s -= a[i][k] * y[k];
+        }
+        y[i] = s / a[i][i];
+    }
+    for (int i = 5; i >= 0; --i) {
+        double s = y[i];
+        for (int k = i + 1; k < 6; ++k) {
+            s -= a[k][i] * x[k];
+        }
+        x[i] = s / a[i][i];
+    }
+    return true;
+}
+
+} // namespace
+
+ArmKinematics::ArmKinematics() : m_characteristicLength(1.0) {
+    m_tool[0] = m_tool[1] = m_tool[2] = 0.0;
+    configure(kModels[0], Params());
+}
+
+bool ArmKinematics::findModel(const std::string& name, Model& model) {
+    for (size_t i = 0; i < sizeof(kModels) / sizeof(kModels[0]); ++i) {
+        if (name == kModels[i].name) {
+            model = kModels[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void ArmKinematics::configure(const Model& model, const Params& params) {
+    m_model = model;
+    m_params = params;
+    // 位置误差按臂展的一半换算为弧度量级，与姿态误差同等加权
+    double reach = 0.0;
+    for (int i = 0; i < kJoints; ++i) {
+        reach += std::fabs(m_model.links[i].aMm) + std::fabs(m_model.links[i].dMm);
+    }
+    m_characteristicLength = reach > 0.0 ? reach / 2.0 : 1.0;
+}
+
+void ArmKinematics::setToolOffset(double x, double y, double z) {
+    m_tool[0] = x;
+    m_tool[1] = y;
+    m_tool[2] = z;
+}
+
+void ArmKinematics::rotationFromEuler(double rx, double ry, double rz, double r[9]) {
+    double cx = std::cos(rx), sx = std::sin(rx);
+    double cy = std::cos(ry), sy = std::sin(ry);
+    double cz = std::cos(rz), sz = std::sin(rz);
+    r[0] = cz * cy; r[1] = cz * sy * sx - sz * cx; r[2] = cz * sy * cx + sz * sx;
+    r[3] = sz * cy; r[4] = sz * sy * sx + cz * cx; r[5] = sz * sy * cx - cz * sx;
+    r[6] = -sy;     r[7] = cy * sx;                r[8] = cy * cx;
+}
+
+void ArmKinematics::computeFrames(const Joints& q, Frames& frames) const {
+    // 累积变换 T = A1·A2·…，A = RotX(alpha)·TransX(a)·RotZ(theta)·TransZ(d)
+    double r[9] = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+    double p[3] = {0.0, 0.0, 0.0};
+    for (int i = 0; i < kJoints; ++i) {
+        const Link& link = m_model.links[i];
+        double ca = std::cos(link.alphaDeg * kDegToRad), sa = std::sin(link.alphaDeg * kDegToRad);
+        double theta = (q[i] + link.offsetDeg) * kDegToRad;
+        double ct = std::cos(theta), st = std::sin(theta);
+        double a[9] = {ct, -st, 0.0, st * ca, ct * ca, -sa, st * sa, ct * sa, ca};
+        double t[3] = {link.aMm, -sa * link.dMm, ca * link.dMm};
+
+        double next[9];
+        for (int row = 0; row < 3; ++row) {
+            p[row] += r[row * 3] * t[0] + r[row * 3 + 1] * t[1] + r[row * 3 + 2] * t[2];
+            for (int col = 0; col < 3; ++col) {
+                next[row * 3 + col] = r[row * 3] * a[col] + r[row * 3 + 1] * a[3 + col] + r[row * 3 + 2] * a[6 + col];
+            }
+        }
+        std::copy(next, next + 9, r);
+        for (int row = 0; row < 3; ++row) {
+            frames.axis[i][row] = r[row * 3 + 2];
+            frames.origin[i][row] = p[row];
+        }
+    }
+    std::copy(r, r + 9, frames.rotation);
+    for (int row = 0; row < 3; ++row) {
+        frames.position[row] = p[row] + r[row * 3] * m_tool[0] + r[row * 3 + 1] * m_tool[1] + r[row * 3 + 2] * m_tool[2];
+    }
+}
+
+void ArmKinematics::jacobian(const Frames& frames, double j[6][kJoints]) const {
+    double inverseLength = 1.0 / m_characteristicLength;
+    for (int i = 0; i < kJoints; ++i) {
+        const double* z = frames.axis[i];
+        double d[3] = {frames.position[0] - frames.origin[i][0],
+                       frames.position[1] - frames.origin[i][1],
+                       frames.position[2] - frames.origin[i][2]};
+        j[0][i] = (z[1] * d[2] - z[2] * d[1]) * inverseLength;
+        j[1][i] = (z[2] * d[0] - z[0] * d[2]) * inverseLength;
+        j[2][i] = (z[0] * d[1] - z[1] * d[0]) * inverseLength;
+        j[3][i] = z[0];
+        j[4][i] = z[1];
+        j[5][i] = z[2];
+    }
+}
+
+void ArmKinematics::linkPoints(const Joints& q, double points[kLinkPoints][3]) const {
+    Frames frames;
+    computeFrames(q, frames);
+    for (int row = 0; row < 3; ++row) {
+        points[0][row] = 0.0;
+        for (int i = 0; i < kJoints; ++i) {
+            points[i + 1][row] = frames.origin[i][row];
+        }
+        points[kJoints + 1][row] = frames.position[row];
+    }
+}
+
+ArmKinematics::Pose ArmKinematics::forward(const Joints& q) const {
+    Frames frames;
+    computeFrames(q, frames);
+    const double* r = frames.rotation;
+    double rx = std::atan2(r[7], r[8]);
+    double ry = std::asin(std::max(-1.0, std::min(1.0, -r[6])));
+    double rz = std::atan2(r[3], r[0]);
+    Pose pose = {{static_cast<int>(std::lround(frames.position[0] * 1000.0)),
+                  static_cast<int>(std::lround(frames.position[1] * 1000.0)),
+                  static_cast<int>(std::lround(frames.position[2] * 1000.0)),
+                  static_cast<int>(std::lround(rx * 1000.0)),
+                  static_cast<int>(std::lround(ry * 1000.0)),
+                  static_cast<int>(std::lround(rz * 1000.0))}};
+    return pose;
+}
+
+void ArmKinematics::poseError(const double targetPosition[3], const double targetRotation[9],
+                              const Frames& frames, double error[6], Result& result) {
+    // 姿态误差：R_target·R^T 的旋转向量（基坐标系）
+    OrientationMath::Mat3 current;
+    std::copy(frames.rotation, frames.rotation + 9, current.begin());
+    OrientationMath::Mat3 goal;
+    std::copy(targetRotation, targetRotation + 9, goal.begin());
+    OrientationMath::Vec3 rotationError = OrientationMath::rotationVector(
+        OrientationMath::multiply(goal, OrientationMath::transpose(current)));
+    for (int i = 0; i < 3; ++i) {
+        error[i] = targetPosition[i] - frames.position[i];
+        error[i + 3] = rotationError[i];
+    }
+    result.positionError = std::sqrt(error[0] * error[0] + error[1] * error[1] + error[2] * error[2]);
+    result.rotationError = std::sqrt(error[3] * error[3] + error[4] * error[4] + error[5] * error[5]);
+}
+
+bool ArmKinematics::evaluate(const Pose& target, const Joints& q, Result& result) const {
+    double targetPosition[3] = {target[0] / 1000.0, target[1] / 1000.0, target[2] / 1000.0};
+    double targetRotation[9];
+    rotationFromEuler(target[3] / 1000.0, target[4] / 1000.0, target[5] / 1000.0, targetRotation);
+
+    Frames frames;
+    computeFrames(q, frames);
+    double error[6];
+    poseError(targetPosition, targetRotation, frames, error, result);
+    double j[6][kJoints];
+    jacobian(frames, j);
+    result.manipulability = std::fabs(determinant6(j));
+    result.iterations = 0;
+    result.limitJoint = checkLimits(q);
+    result.converged = result.positionError <= m_params.positionTolerance &&
+                       result.rotationError <= m_params.rotationTolerance;
+    return result.converged;
+}
+
+bool ArmKinematics::inverse(const Pose& target, const Joints& seed, Joints& solution, Result& result) const {
+    double targetPosition[3] = {target[0] / 1000.0, target[1] / 1000.0, target[2] / 1000.0};
+    double targetRotation[9];
+    rotationFromEuler(target[3] / 1000.0, target[4] / 1000.0, target[5] / 1000.0, targetRotation);
+
+    Joints q = seed;
+    for (int i = 0; i < kJoints; ++i) {
+        q[i] = std::max(m_model.minDeg[i], std::min(m_model.maxDeg[i], q[i]));
+    }
+
+    result.converged = false;
+    result.iterations = 0;
+    result.limitJoint = 0;
+    double inverseLength = 1.0 / m_characteristicLength;
+    double maxStepRad = m_params.maxStepDeg * kDegToRad;
+    Frames frames;
+    double j[6][kJoints];
+
+    for (int iteration = 0; ; ++iteration) {
+        computeFrames(q, frames);
+
+        double error[6];
+        poseError(targetPosition, targetRotation, frames, error, result);
+        result.iterations = iteration;
+
+        jacobian(frames, j);
+        result.manipulability = std::fabs(determinant6(j));
+        if (result.positionError <= m_params.positionTolerance && result.rotationError <= m_params.rotationTolerance) {
+            result.converged = true;
+            break;
+        }
+        if (iteration >= m_params.maxIterations) {
+            break;
+        }
+
+        // 可操作度越低阻尼越大：λ² = λmax²·(1 - w/w0)²（Nakamura），远离奇异时退化为高斯-牛顿
+        double lambdaSquared = 1e-9;
+        if (result.manipulability < m_params.manipulabilityThreshold) {
+            double k = 1.0 - result.manipulability / m_params.manipulabilityThreshold;
+            lambdaSquared += m_params.damping * m_params.damping * k * k;
+        }
+
+        // dq = Jᵀ·(J·Jᵀ + λ²I)⁻¹·e
+        double a[6][6];
+        for (int r = 0; r < 6; ++r) {
+            for (int c = r; c < 6; ++c) {
+                double s = 0.0;
+                for (int k = 0; k < kJoints; ++k) {
+                    s += j[r][k] * j[c][k];
+                }
+                a[r][c] = s;
+                a[c][r] = s;
+            }
+            a[r][r] += lambdaSquared;
+        }
+        for (int r = 0; r < 3; ++r) {
+            error[r] *= inverseLength;
+        }
+        double y[6];
+        if (!choleskySolve6(a, error, y)) {
+            break;
+        }
+        double step[kJoints];
+        double largest = 0.0;
+        for (int k = 0; k < kJoints; ++k) {
+            step[k] = 0.0;
+            for (int r = 0; r < 6; ++r) {
+                step[k] += j[r][k] * y[r];
+            }
+            largest = std::max(largest, std::fabs(step[k]));
+        }
+        double scale = largest > maxStepRad ? maxStepRad / largest : 1.0;
+        for (int k = 0; k < kJoints; ++k) {
+            q[k] += step[k] * scale * kRadToDeg;
+            q[k] = std::max(m_model.minDeg[k], std::min(m_model.maxDeg[k], q[k]));
+        }
+    }
+
+    for (int k = 0; k < kJoints && result.limitJoint == 0; ++k) {
+        if (q[k] <= m_model.minDeg[k] || q[k] >= m_model.maxDeg[k]) {
+            result.limitJoint = k + 1;
+        }
+    }
+    solution = q;
+    return result.converged;
+}
+
+int ArmKinematics::checkLimits(const Joints& q) const {
+    for (int i = 0; i < kJoints; ++i) {
+        if (!(q[i] >= m_model.minDeg[i] && q[i] <= m_model.maxDeg[i])) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+double ArmKinematics::maxJointDelta(const Joints& a, const Joints& b) {
+    double largest = 0.0;
+    for (int i = 0; i < kJoints; ++i) {
+        largest = std::max(largest, std::fabs(a[i] - b[i]));
+    }
+    return largest;
+}
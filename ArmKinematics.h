@@ -0,0 +1,162 @@
+#ifndef ARMKINEMATICS_H
+#define ARMKINEMATICS_H
+
+#include <array>
+#include <string>
+
+/**
+ * @class ArmKinematics
+ * @brief 六轴机械臂的改进DH运动学：正解、几何雅可比与阻尼最小二乘（DLS）逆解
+ *
+ * 位姿单位与 movep_follow 及主动上报一致：位置为微米，姿态为X-Y-Z固定轴欧拉角
+ * （毫弧度，R = Rz·Ry·Rx）；关节角度为度。
+ * - 逆解以上一次的解为初值迭代，连续跟随时通常几次迭代即收敛
+ * - 接近奇异位形时按可操作度增大阻尼，单次迭代步长受限，结果夹在关节限位内，
+ *   因此奇异点附近给出的是平滑的近似解而不是跳变或拒绝
+ * - 内置 RM65-B 的出厂DH参数和关节限位（与 RM_API2 的 rm_algo_forward_kinematics 一致）
+ * 对象配置后只读，可在多个线程中同时求解。
+ */
+class ArmKinematics {
+public:
+    static const int kJoints = 6;
+    typedef std::array<double, kJoints> Joints;   // 度
+    typedef std::array<int, 6> Pose;              // 微米/毫弧度
+
+    /**
+     * @brief 改进DH（Craig）连杆参数：alpha(i-1)、a(i-1)、d(i)、关节零位偏置
+     */
+    struct Link {
+        double alphaDeg;
+        double aMm;
+        double dMm;
+        double offsetDeg;
+    };
+
+    /**
+     * @brief 机械臂型号参数
+     */
+    struct Model {
+        const char* name;
+        Link links[kJoints];
+        double minDeg[kJoints];    // 关节下限
+        double maxDeg[kJoints];    // 关节上限
+    };
+
+    /**
+     * @brief 逆解参数
+     */
+    struct Params {
+        int maxIterations;               // 每次求解的最大迭代次数
+        double damping;                  // 奇异位形处的最大阻尼系数
+        double manipulabilityThreshold;  // 归一化可操作度低于该值时开始增大阻尼
+        double positionTolerance;        // 收敛阈值（毫米）
+        double rotationTolerance;        // 收敛阈值（弧度）
+        double maxStepDeg;               // 单次迭代每个关节的最大步长（度）
+
+        Params()
+            : maxIterations(20), damping(0.05), manipulabilityThreshold(0.02),
+              positionTolerance(0.01), rotationTolerance(1e-4), maxStepDeg(10.0) {}
+    };
+
+    /**
+     * @brief 单次逆解结果
+     */
+    struct Result {
+        bool converged;          // 残差在收敛阈值内
+        int iterations;          // 实际迭代次数
+        double positionError;    // 残差（毫米）
+        double rotationError;    // 残差（弧度）
+        double manipulability;   // 解处的归一化可操作度（0为奇异）
+        int limitJoint;          // 被夹在关节限位上的关节序号（1起），0为未触及
+    };
+
+    ArmKinematics();
+
+    /**
+     * @brief 查找内置型号
+     * @param name 型号名（rm65）
+     * @return 找到时返回true
+     */
+    static bool findModel(const std::string& name, Model& model);
+
+    void configure(const Model& model, const Params& params);
+
+    /**
+     * @brief 设置工具点相对法兰的平移（法兰坐标系，毫米），需与控制器当前工具坐标系一致
+     */
+    void setToolOffset(double x, double y, double z);
+
+    const Model& getModel() const { return m_model; }
+    const Params& getParams() const { return m_params; }
+    const double* getToolOffset() const { return m_tool; }
+
+    /**
+     * @brief 正解：关节角度 → 工具位姿
+     */
+    Pose forward(const Joints& q) const;
+
+    /**
+     * @brief 逆解（DLS迭代）
+     * @param target 目标位姿
+     * @param seed 初值（通常为上一次的解）
+     * @param solution 输出关节角度（始终在关节限位内，未收敛时为最后一次迭代的结果）
+     * @param result 收敛信息
+     * @return 收敛时返回true
+     */
+    bool inverse(const Pose& target, const Joints& seed, Joints& solution, Result& result) const;
+
+    /**
+     * @brief 计算给定关节角度相对目标位姿的残差、可操作度和限位（用于校验外部求解器的解）
+     * @return 残差在收敛阈值内时返回true（result.iterations 置0）
+     */
+    bool evaluate(const Pose& target, const Joints& q, Result& result) const;
+
+    /**
+     * @brief 检查关节限位
+     * @return 0为未超限，否则为第一个超限的关节序号（1起）
+     */
+    int checkLimits(const Joints& q) const;
+
+    /**
+     * @brief 两组关节角度之间的最大单关节差（度）
+     */
+    static double maxJointDelta(const Joints& a, const Joints& b);
+    
+    static const int kLinkPoints = kJoints + 2;
+    
+    /**
+     * @brief 连杆端点（基坐标系，毫米）：基座原点、关节1~6坐标系原点、工具点，相邻两点之间为一段连杆
+     *        （重合的点对应零长度连杆，用于碰撞模型）
+     */
+    void linkPoints(const Joints& q, double points[kLinkPoints][3]) const;
+    
+    /**
+     * @brief X-Y-Z固定轴欧拉角（弧度）→ 旋转矩阵（行优先，R = Rz·Ry·Rx）
+     */
+    static void rotationFromEuler(double rx, double ry, double rz, double r[9]);
+
+private:
+    // 各关节坐标系在基坐标系下的姿态和原点，以及工具点
+    struct Frames {
+        double axis[kJoints][3];     // 关节转轴（各坐标系z轴）
+        double origin[kJoints][3];   // 关节坐标系原点（毫米）
+        double rotation[9];          // 工具姿态（行优先）
+        double position[3];          // 工具点（毫米）
+    };
+
+    void computeFrames(const Joints& q, Frames& frames) const;
+
+    // 归一化雅可比（位置行除以特征长度）
+    void jacobian(const Frames& frames, double j[6][kJoints]) const;
+
+    // 位姿误差 [位置(毫米); 旋转向量(弧度)]，同时填写 result 的残差
+    static void poseError(const double targetPosition[3], const double targetRotation[9],
+                          const Frames& frames, double error[6], Result& result);
+
+    Model m_model;
+    Params m_params;
+    double m_tool[3];
+    double m_characteristicLength;   // 位置误差与姿态误差的换算长度（毫米）
+};
+
+#endif // ARMKINEMATICS_H
@@ -0,0 +1,680 @@
+#include "ArmReactor.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+#include "ArmCommandPipeline.h"
+
+namespace {
+
+// 节拍周期：与原先每个发送线程的轮询间隔相同，伺服线程投递时无需任何唤醒系统调用
+const uint64_t kTickNs = 200000;
+
+// 单个连接允许缓存的未写出字节（超过后丢弃新帧）
+const size_t kMaxOutboundBytes = 64 * 1024;
+
+const int kMaxEvents = 16;
+
+void storeMax(std::atomic<uint64_t>& target, uint64_t value) {
+    if (value > target.load(std::memory_order_relaxed)) {
+        target.store(value, std::memory_order_relaxed);
+    }
+}
+
+void increment(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// 指令帧很小且要求低延迟，关闭Nagle合并
+void setNoDelay(int fd) {
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+}
+
+} // namespace
+
+/*******************************************************************************
+ Connection
+*******************************************************************************/
+ArmReactor::Connection::Connection(ArmReactor& reactor, const std::string& name, const std::string& ip,
+                                   int port, Handler* handler)
+    : m_reactor(reactor), m_name(name), m_ip(ip), m_port(port), m_handler(handler),
+      m_fd(-1), m_state(Closed), m_reconnect(false), m_everConnected(false), m_wantWrite(false),
+      m_reconnectAtNs(0), m_connectDeadlineNs(0), m_backoffNs(reactor.m_initialBackoffNs),
+      m_jitterState(static_cast<uint32_t>(std::hash<std::string>()(name) | 1u)),
+      m_outboundOffset(0), m_latestPending(false),
+      m_connectRequested(false), m_closeRequested(false), m_connected(false),
+      m_bytesSent(0), m_bytesReceived(0), m_messages(0), m_shortWrites(0), m_wouldBlock(0),
+      m_superseded(0), m_writeDrops(0), m_disconnects(0), m_reconnects(0), m_connectFailures(0),
+      m_lastBackoffNs(0), m_pendingBytes(0) {
+    m_outbound.reserve(4096);
+    m_latest.reserve(256);
+}
+
+bool ArmReactor::Connection::write(const char* data, size_t length) {
+    if (m_state != Open) {
+        return false;
+    }
+
+    size_t written = 0;
+    if (m_outbound.size() == m_outboundOffset) {
+        // 没有积压时直接写socket
+        if (!sendNow(data, length, written)) {
+            return false;
+        }
+        if (written == length) {
+            return true;
+        }
+    } else if (m_outbound.size() - m_outboundOffset + length > kMaxOutboundBytes) {
+        increment(m_writeDrops);
+        return false;
+    }
+
+    // 剩余部分排在积压数据之后，等EPOLLOUT继续写；已写出一部分的帧必须写完整，不受上限限制
+    appendOutbound(data + written, length - written);
+    updateInterest();
+    return true;
+}
+
+bool ArmReactor::Connection::writeLatest(const char* data, size_t length) {
+    if (m_state != Open) {
+        return false;
+    }
+
+    // 有积压（包括写了一半的帧）时不排队，只保留最新一帧，等积压写完再发
+    if (m_outboundOffset < m_outbound.size() || m_latestPending) {
+        storeLatest(data, length);
+        return true;
+    }
+
+    size_t written = 0;
+    if (!sendNow(data, length, written)) {
+        return false;
+    }
+    if (written == 0) {
+        storeLatest(data, length);
+    } else if (written < length) {
+        appendOutbound(data + written, length - written);
+    }
+    updateInterest();
+    return true;
+}
+
+bool ArmReactor::Connection::sendNow(const char* data, size_t length, size_t& written) {
+    written = 0;
+    while (true) {
+        ssize_t sent = send(m_fd, data, length, MSG_NOSIGNAL);
+        if (sent >= 0) {
+            written = static_cast<size_t>(sent);
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            increment(m_wouldBlock);
+            return true;
+        }
+        m_reactor.fail(*this, "发送失败", errno);
+        return false;
+    }
+    increment(m_bytesSent, written);
+    if (written < length) {
+        increment(m_shortWrites);
+    }
+    return true;
+}
+
+void ArmReactor::Connection::appendOutbound(const char* data, size_t length) {
+    if (m_outboundOffset > 0 && m_outboundOffset == m_outbound.size()) {
+        m_outbound.clear();
+        m_outboundOffset = 0;
+    }
+    m_outbound.insert(m_outbound.end(), data, data + length);
+    updatePendingBytes();
+}
+
+void ArmReactor::Connection::storeLatest(const char* data, size_t length) {
+    if (m_latestPending) {
+        increment(m_superseded);
+    }
+    m_latest.assign(data, data + length);
+    m_latestPending = true;
+    updatePendingBytes();
+}
+
+void ArmReactor::Connection::updatePendingBytes() {
+    size_t pending = m_outbound.size() - m_outboundOffset + (m_latestPending ? m_latest.size() : 0);
+    m_pendingBytes.store(pending, std::memory_order_relaxed);
+}
+
+void ArmReactor::Connection::flush() {
+    while (m_outboundOffset < m_outbound.size()) {
+        ssize_t sent = send(m_fd, &m_outbound[m_outboundOffset], m_outbound.size() - m_outboundOffset,
+                            MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                m_reactor.fail(*this, "发送失败", errno);
+                return;
+            }
+            increment(m_wouldBlock);
+            break;
+        }
+        m_outboundOffset += static_cast<size_t>(sent);
+        increment(m_bytesSent, static_cast<uint64_t>(sent));
+    }
+    if (m_outboundOffset == m_outbound.size()) {
+        m_outbound.clear();
+        m_outboundOffset = 0;
+
+        // 积压写完后发出期间被覆盖后剩下的最新一帧
+        if (m_latestPending) {
+            size_t written = 0;
+            if (!sendNow(m_latest.data(), m_latest.size(), written)) {
+                return;
+            }
+            if (written > 0) {
+                m_latestPending = false;
+                appendOutbound(m_latest.data() + written, m_latest.size() - written);
+            }
+        }
+    }
+    updatePendingBytes();
+    updateInterest();
+}
+
+void ArmReactor::Connection::updateInterest() {
+    bool wantWrite = m_state == Connecting || m_outboundOffset < m_outbound.size() || m_latestPending;
+    if (m_fd < 0 || wantWrite == m_wantWrite) {
+        return;
+    }
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLRDHUP;
+    if (wantWrite) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.ptr = this;
+    epoll_ctl(m_reactor.m_epoll, EPOLL_CTL_MOD, m_fd, &event);
+    m_wantWrite = wantWrite;
+}
+
+ArmReactor::ConnectionStats ArmReactor::Connection::getStats() const {
+    ConnectionStats stats;
+    stats.bytesSent = m_bytesSent.load(std::memory_order_relaxed);
+    stats.bytesReceived = m_bytesReceived.load(std::memory_order_relaxed);
+    stats.messages = m_messages.load(std::memory_order_relaxed);
+    stats.shortWrites = m_shortWrites.load(std::memory_order_relaxed);
+    stats.wouldBlock = m_wouldBlock.load(std::memory_order_relaxed);
+    stats.superseded = m_superseded.load(std::memory_order_relaxed);
+    stats.writeDrops = m_writeDrops.load(std::memory_order_relaxed);
+    stats.disconnects = m_disconnects.load(std::memory_order_relaxed);
+    stats.reconnects = m_reconnects.load(std::memory_order_relaxed);
+    stats.connectFailures = m_connectFailures.load(std::memory_order_relaxed);
+    stats.lastBackoffNs = m_lastBackoffNs.load(std::memory_order_relaxed);
+    stats.pendingBytes = m_pendingBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/*******************************************************************************
+ ArmReactor
+*******************************************************************************/
+ArmReactor::ArmReactor()
+    : m_epoll(-1), m_timer(-1), m_connectionCount(0), m_running(false),
+      m_initialBackoffNs(500000000ULL), m_maxBackoffNs(30000000000ULL), m_connectTimeoutNs(3000000000ULL),
+      m_sendBufferBytes(0), m_ticks(0), m_missedTicks(0), m_maxTickNs(0) {
+    for (size_t i = 0; i < kMaxConnections; ++i) {
+        m_connections[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ArmReactor::~ArmReactor() {
+    stop();
+    size_t count = m_connectionCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count && i < kMaxConnections; ++i) {
+        Connection* connection = m_connections[i].load(std::memory_order_acquire);
+        if (connection) {
+            close(connection);
+            delete connection;
+        }
+    }
+    if (m_timer >= 0) {
+        ::close(m_timer);
+    }
+    if (m_epoll >= 0) {
+        ::close(m_epoll);
+    }
+}
+
+ArmReactor::Connection* ArmReactor::addConnection(const std::string& name, const std::string& ip, int port,
+                                                  Handler* handler) {
+    size_t slot = m_connectionCount.fetch_add(1, std::memory_order_acq_rel);
+    if (slot >= kMaxConnections) {
+        std::cerr << "❌ 反应器连接数超过上限 " << kMaxConnections << "，忽略 " << name << std::endl;
+        return nullptr;
+    }
+    Connection* connection = new Connection(*this, name, ip, port, handler);
+    m_connections[slot].store(connection, std::memory_order_release);
+    return connection;
+}
+
+void ArmReactor::connect(Connection* connection) {
+    if (!connection) {
+        return;
+    }
+    connection->m_closeRequested.store(false, std::memory_order_relaxed);
+    connection->m_connectRequested.store(true, std::memory_order_release);
+}
+
+void ArmReactor::close(Connection* connection) {
+    if (!connection) {
+        return;
+    }
+    if (isRunning() && !isReactorThread()) {
+        // 交给反应器线程关闭，等待其完成
+        connection->m_closeRequested.store(true, std::memory_order_release);
+        for (int i = 0; i < 1000 && connection->m_closeRequested.load(std::memory_order_acquire); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return;
+    }
+    // 反应器未运行（或就在反应器线程中）：直接关闭
+    connection->m_connectRequested.store(false, std::memory_order_relaxed);
+    connection->m_reconnect = false;
+    if (connection->m_fd >= 0) {
+        bool wasOpen = connection->m_state == Connection::Open;
+        closeSocket(*connection);
+        if (wasOpen && connection->m_handler && isReactorThread()) {
+            connection->m_handler->onDisconnected(*connection);
+        }
+    }
+    connection->m_connected.store(false, std::memory_order_release);
+    connection->m_closeRequested.store(false, std::memory_order_release);
+}
+
+void ArmReactor::setReconnectPolicy(int initialDelayMs, int maxDelayMs, int connectTimeoutMs) {
+    if (initialDelayMs > 0) {
+        m_initialBackoffNs = static_cast<uint64_t>(initialDelayMs) * 1000000ULL;
+    }
+    if (maxDelayMs > 0) {
+        m_maxBackoffNs = static_cast<uint64_t>(maxDelayMs) * 1000000ULL;
+    }
+    if (m_maxBackoffNs < m_initialBackoffNs) {
+        m_maxBackoffNs = m_initialBackoffNs;
+    }
+    if (connectTimeoutMs > 0) {
+        m_connectTimeoutNs = static_cast<uint64_t>(connectTimeoutMs) * 1000000ULL;
+    }
+}
+
+bool ArmReactor::start() {
+    if (m_running.load(std::memory_order_acquire)) {
+        return true;
+    }
+    if (m_epoll < 0) {
+        m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    }
+    if (m_timer < 0) {
+        m_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    }
+    if (m_epoll < 0 || m_timer < 0) {
+        std::cerr << "❌ 反应器初始化失败: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_interval.tv_nsec = static_cast<long>(kTickNs);
+    spec.it_value.tv_nsec = static_cast<long>(kTickNs);
+    timerfd_settime(m_timer, 0, &spec, nullptr);
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;   // nullptr 表示节拍定时器
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_timer, &event);
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&ArmReactor::run, this);
+    std::cout << "✅ 机械臂通信反应器已启动（单线程epoll，节拍 " << kTickNs / 1000 << "μs）" << std::endl;
+    return true;
+}
+
+void ArmReactor::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    std::cout << "机械臂通信反应器已停止" << std::endl;
+}
+
+bool ArmReactor::isReactorThread() const {
+    return m_running.load(std::memory_order_acquire) &&
+           std::this_thread::get_id() == m_thread.get_id();
+}
+
+ArmReactor::Stats ArmReactor::getStats() const {
+    Stats stats;
+    stats.ticks = m_ticks.load(std::memory_order_relaxed);
+    stats.missedTicks = m_missedTicks.load(std::memory_order_relaxed);
+    stats.maxTickNs = m_maxTickNs.load(std::memory_order_relaxed);
+    stats.connections = std::min(m_connectionCount.load(std::memory_order_acquire), kMaxConnections);
+    return stats;
+}
+
+void ArmReactor::printStats(std::ostream& os) const {
+    Stats stats = getStats();
+    os << "[通信反应器] 节拍=" << stats.ticks
+       << ", 合并节拍=" << stats.missedTicks
+       << ", 最长节拍处理=" << std::fixed << std::setprecision(3) << (stats.maxTickNs / 1e6) << "ms"
+       << std::defaultfloat << ", 连接数=" << stats.connections << std::endl;
+    for (size_t i = 0; i < stats.connections; ++i) {
+        const Connection* connection = m_connections[i].load(std::memory_order_acquire);
+        if (!connection) {
+            continue;
+        }
+        ConnectionStats connectionStats = connection->getStats();
+        os << "[" << connection->getName() << "] TCP: "
+           << (connection->isConnected() ? "已连接" : "未连接")
+           << ", 发送=" << connectionStats.bytesSent << "字节"
+           << ", 接收=" << connectionStats.bytesReceived << "字节/" << connectionStats.messages << "条"
+           << ", 部分写=" << connectionStats.shortWrites
+           << ", EAGAIN=" << connectionStats.wouldBlock
+           << ", 覆盖=" << connectionStats.superseded
+           << ", 写丢弃=" << connectionStats.writeDrops
+           << ", 待写=" << connectionStats.pendingBytes << "字节"
+           << ", 断开=" << connectionStats.disconnects
+           << ", 重连=" << connectionStats.reconnects
+           << ", 连接失败=" << connectionStats.connectFailures << std::endl;
+    }
+}
+
+void ArmReactor::run() {
+    struct epoll_event events[kMaxEvents];
+    while (m_running.load(std::memory_order_acquire)) {
+        // 超时只用于检查停止标志，正常情况下由timerfd节拍唤醒
+        int count = epoll_wait(m_epoll, events, kMaxEvents, 100);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "❌ 反应器epoll_wait失败: " << strerror(errno) << std::endl;
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.ptr == nullptr) {
+                uint64_t expirations = 0;
+                if (read(m_timer, &expirations, sizeof(expirations)) == sizeof(expirations) && expirations > 1) {
+                    increment(m_missedTicks, expirations - 1);
+                }
+                uint64_t startNs = ArmCommandPipeline::nowNs();
+                tick(startNs);
+                storeMax(m_maxTickNs, ArmCommandPipeline::nowNs() - startNs);
+                increment(m_ticks);
+            } else {
+                handleEvent(*static_cast<Connection*>(events[i].data.ptr), events[i].events);
+            }
+        }
+    }
+}
+
+void ArmReactor::tick(uint64_t nowNs) {
+    size_t count = std::min(m_connectionCount.load(std::memory_order_acquire), kMaxConnections);
+    for (size_t i = 0; i < count; ++i) {
+        Connection* connection = m_connections[i].load(std::memory_order_acquire);
+        if (!connection) {
+            continue;
+        }
+
+        // 其他线程的交接：关闭请求、连接请求（立即发起，不等退避）
+        if (connection->m_closeRequested.load(std::memory_order_acquire)) {
+            close(connection);
+        }
+        if (connection->m_connectRequested.exchange(false, std::memory_order_acq_rel)) {
+            connection->m_reconnect = true;
+            connection->m_backoffNs = m_initialBackoffNs;
+            if (connection->m_state == Connection::Closed) {
+                beginConnect(*connection, nowNs);
+            }
+        }
+
+        // 连接超时和断线重连
+        if (connection->m_state == Connection::Connecting && nowNs >= connection->m_connectDeadlineNs) {
+            fail(*connection, "连接超时", ETIMEDOUT);
+        }
+        if (connection->m_state == Connection::Closed && connection->m_reconnect &&
+            nowNs >= connection->m_reconnectAtNs) {
+            beginConnect(*connection, nowNs);
+        }
+
+        if (connection->m_handler) {
+            connection->m_handler->onTick(*connection, nowNs);
+        }
+    }
+}
+
+void ArmReactor::handleEvent(Connection& connection, uint32_t events) {
+    if (connection.m_state == Connection::Connecting) {
+        finishConnect(connection);
+        return;
+    }
+    if (connection.m_state != Connection::Open) {
+        return;
+    }
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        readAvailable(connection);
+    }
+    if (connection.m_state == Connection::Open && (events & EPOLLOUT)) {
+        connection.flush();
+    }
+}
+
+void ArmReactor::takeOver(Connection& connection, int fd) {
+    if (connection.m_fd >= 0 && connection.m_fd != fd) {
+        closeSocket(connection);
+    }
+    setNonBlocking(fd);
+    setNoDelay(fd);
+
+    bool reconnected = connection.m_everConnected;
+    connection.m_fd = fd;
+    connection.m_state = Connection::Open;
+    connection.m_everConnected = true;
+    connection.m_backoffNs = m_initialBackoffNs;
+    connection.m_reader.reset();
+    connection.m_outbound.clear();
+    connection.m_outboundOffset = 0;
+    connection.m_latestPending = false;
+    connection.m_pendingBytes.store(0, std::memory_order_relaxed);
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.ptr = &connection;
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0 && errno == EEXIST) {
+        epoll_ctl(m_epoll, EPOLL_CTL_MOD, fd, &event);
+    }
+    connection.m_wantWrite = false;
+    connection.m_connected.store(true, std::memory_order_release);
+
+    if (reconnected) {
+        increment(connection.m_reconnects);
+        std::cout << "✅ [" << connection.m_name << "] 已重新连接 " << connection.m_ip << ":"
+                  << connection.m_port << std::endl;
+    } else {
+        std::cout << "✅ [" << connection.m_name << "] 已连接 " << connection.m_ip << ":"
+                  << connection.m_port << std::endl;
+    }
+    if (connection.m_handler) {
+        connection.m_handler->onConnected(connection);
+    }
+}
+
+void ArmReactor::beginConnect(Connection& connection, uint64_t nowNs) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        fail(connection, "创建socket失败", errno);
+        return;
+    }
+    if (m_sendBufferBytes > 0) {
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &m_sendBufferBytes, sizeof(m_sendBufferBytes));
+    }
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(connection.m_port);
+    inet_pton(AF_INET, connection.m_ip.c_str(), &address.sin_addr);
+
+    int result = ::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address));
+    if (result == 0) {
+        takeOver(connection, fd);
+        return;
+    }
+    if (errno != EINPROGRESS) {
+        int error = errno;
+        ::close(fd);
+        fail(connection, "连接失败", error);
+        return;
+    }
+
+    // 等待socket可写后检查连接结果
+    connection.m_fd = fd;
+    connection.m_state = Connection::Connecting;
+    connection.m_connectDeadlineNs = nowNs + m_connectTimeoutNs;
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLOUT;
+    event.data.ptr = &connection;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event);
+    connection.m_wantWrite = true;
+}
+
+void ArmReactor::finishConnect(Connection& connection) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(connection.m_fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0) {
+        error = errno;
+    }
+    if (error != 0) {
+        fail(connection, "连接失败", error);
+        return;
+    }
+    takeOver(connection, connection.m_fd);
+}
+
+void ArmReactor::readAvailable(Connection& connection) {
+    while (connection.m_state == Connection::Open) {
+        size_t available = 0;
+        char* space = connection.m_reader.prepareWrite(1024, available);
+        ssize_t received = recv(connection.m_fd, space, available, 0);
+        if (received == 0) {
+            fail(connection, "对端关闭连接", 0);
+            return;
+        }
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                fail(connection, "接收失败", errno);
+            }
+            return;
+        }
+
+        connection.m_reader.commitWrite(static_cast<size_t>(received));
+        increment(connection.m_bytesReceived, static_cast<uint64_t>(received));
+
+        const char* data;
+        size_t length;
+        while (connection.m_state == Connection::Open && connection.m_reader.nextMessage(data, length)) {
+            increment(connection.m_messages);
+            if (connection.m_handler) {
+                connection.m_handler->onMessage(connection, data, length);
+            }
+        }
+        if (static_cast<size_t>(received) < available) {
+            return;   // 已读空，剩下的等下一次可读事件
+        }
+    }
+}
+
+void ArmReactor::fail(Connection& connection, const char* reason, int error) {
+    bool wasOpen = connection.m_state == Connection::Open;
+    closeSocket(connection);
+
+    // 抖动指数退避：本次等待在当前退避值的 ±20% 内随机，之后退避值翻倍直到上限，
+    // 多台机械臂同时掉线时不会在同一时刻一起重连
+    uint64_t delayNs = nextBackoffDelay(connection);
+    connection.m_reconnectAtNs = ArmCommandPipeline::nowNs() + delayNs;
+    connection.m_lastBackoffNs.store(delayNs, std::memory_order_relaxed);
+
+    if (wasOpen) {
+        increment(connection.m_disconnects);
+    } else {
+        increment(connection.m_connectFailures);
+    }
+    std::cout << (wasOpen ? "🔌 [" : "⚠️  [") << connection.m_name << "] " << reason;
+    if (error != 0) {
+        std::cout << " (" << strerror(error) << ")";
+    }
+    std::cout << "，" << delayNs / 1000000 << "ms后" << (connection.m_everConnected ? "重连" : "重试") << std::endl;
+    if (wasOpen && connection.m_handler) {
+        connection.m_handler->onDisconnected(connection);
+    }
+}
+
+uint64_t ArmReactor::nextBackoffDelay(Connection& connection) {
+    // xorshift32：每个连接独立的种子，不与其他线程共享随机数状态
+    uint32_t x = connection.m_jitterState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    connection.m_jitterState = x;
+
+    uint64_t backoff = connection.m_backoffNs;
+    double factor = 0.8 + 0.4 * (static_cast<double>(x) / 4294967295.0);
+    connection.m_backoffNs = std::min(backoff * 2, m_maxBackoffNs);
+    return static_cast<uint64_t>(static_cast<double>(backoff) * factor);
+}
+
+void ArmReactor::closeSocket(Connection& connection) {
+    if (connection.m_fd >= 0) {
+        if (m_epoll >= 0) {
+            epoll_ctl(m_epoll, EPOLL_CTL_DEL, connection.m_fd, nullptr);
+        }
+        ::close(connection.m_fd);
+        connection.m_fd = -1;
+    }
+    connection.m_state = Connection::Closed;
+    connection.m_wantWrite = false;
+    connection.m_outbound.clear();
+    connection.m_outboundOffset = 0;
+    connection.m_latestPending = false;
+    connection.m_pendingBytes.store(0, std::memory_order_relaxed);
+    connection.m_connected.store(false, std::memory_order_release);
+}
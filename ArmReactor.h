@@ -0,0 +1,277 @@
+#ifndef ARMREACTOR_H
+#define ARMREACTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ArmResponseReader.h"
+
+/**
+ * @class ArmReactor
+ * @brief 所有机械臂TCP连接共用的单线程epoll反应器
+ *
+ * 反应器线程独占所有机械臂socket（非阻塞模式），负责：
+ * - 入站：可读时读取并分帧，每条完整JSON响应交给连接的 Handler::onMessage
+ * - 出站：Handler 在反应器线程中调用 Connection::write()，写不完的部分缓存，
+ *   等socket可写（EPOLLOUT）时继续；流式运动指令用 writeLatest()，
+ *   socket不可写时只保留最新一帧
+ * - 定时：timerfd 周期节拍驱动 Handler::onTick（取走其他线程投递的指令、
+ *   检查请求超时）以及连接超时和断线重连
+ * - 连接：所有连接并行发起非阻塞connect；连接失败或断开后按抖动指数退避
+ *   自动重连，重连成功后 Handler::onConnected 负责重放设置指令
+ * 其他线程不直接接触socket，只通过各 Handler 自己的无锁队列投递请求。
+ * 增加机械臂只增加连接，不增加线程。
+ */
+class ArmReactor {
+public:
+    class Connection;
+
+    /**
+     * @class Handler
+     * @brief 连接回调（全部在反应器线程中调用）
+     */
+    class Handler {
+    public:
+        virtual ~Handler() {}
+
+        /** 连接建立（首次接管或重连成功） */
+        virtual void onConnected(Connection& connection) = 0;
+
+        /** 连接断开（对端关闭、读写错误或主动关闭） */
+        virtual void onDisconnected(Connection& connection) = 0;
+
+        /** 收到一条完整的JSON响应（指向读取缓冲区，回调返回后失效） */
+        virtual void onMessage(Connection& connection, const char* data, size_t length) = 0;
+
+        /** 每个节拍调用一次（无论连接是否打开） */
+        virtual void onTick(Connection& connection, uint64_t nowNs) = 0;
+    };
+
+    /**
+     * @brief 单个连接的统计（任意线程可读）
+     */
+    struct ConnectionStats {
+        uint64_t bytesSent;        // 已写入socket的字节
+        uint64_t bytesReceived;    // 已读取的字节
+        uint64_t messages;         // 切出的完整响应数
+        uint64_t shortWrites;      // send() 只写出一部分的次数
+        uint64_t wouldBlock;       // send() 返回EAGAIN（一个字节都没写出）的次数
+        uint64_t superseded;       // 流式帧还没写出就被更新的帧覆盖的次数
+        uint64_t writeDrops;       // 出站缓存超过上限而丢弃的帧
+        uint64_t disconnects;      // 断开次数
+        uint64_t reconnects;       // 重连成功次数
+        uint64_t connectFailures;  // 连接尝试失败次数（拒绝、超时等）
+        uint64_t lastBackoffNs;    // 最近一次失败或断开后的重连等待（含抖动）
+        uint64_t pendingBytes;     // 当前出站缓存字节数（含最新帧槽位）
+    };
+
+    /**
+     * @class Connection
+     * @brief 反应器管理的一条机械臂TCP连接
+     */
+    class Connection {
+    public:
+        /**
+         * @brief 写入一帧（反应器线程调用，非阻塞）
+         * @return 连接未打开或出站缓存已满时返回false
+         */
+        bool write(const char* data, size_t length);
+
+        /**
+         * @brief 写入一帧流式指令（反应器线程调用，非阻塞，最新帧优先）
+         *
+         * 没有积压时直接写socket；有积压或socket不可写时放入单帧槽位，覆盖尚未
+         * 写出的上一帧，积压写完后再发出。写了一部分的帧总是先写完整，
+         * 下一帧不会插入到半条JSON之后。
+         * @return 连接未打开时返回false
+         */
+        bool writeLatest(const char* data, size_t length);
+
+        /** 连接是否已打开（反应器线程调用） */
+        bool isOpen() const { return m_state == Open; }
+
+        /** 连接是否已建立（任意线程调用） */
+        bool isConnected() const { return m_connected.load(std::memory_order_acquire); }
+
+        const std::string& getName() const { return m_name; }
+
+        ConnectionStats getStats() const;
+
+    private:
+        friend class ArmReactor;
+
+        enum State { Closed, Connecting, Open };
+
+        Connection(ArmReactor& reactor, const std::string& name, const std::string& ip, int port,
+                   Handler* handler);
+        Connection(const Connection&);
+        Connection& operator=(const Connection&);
+
+        void flush();
+        bool sendNow(const char* data, size_t length, size_t& written);
+        void appendOutbound(const char* data, size_t length);
+        void storeLatest(const char* data, size_t length);
+        void updatePendingBytes();
+        void updateInterest();
+
+        ArmReactor& m_reactor;
+        std::string m_name;
+        std::string m_ip;
+        int m_port;
+        Handler* m_handler;
+
+        // 反应器线程状态
+        int m_fd;
+        State m_state;
+        bool m_reconnect;              // 断开后是否自动重连（connect() 之后，close() 之前）
+        bool m_everConnected;          // 是否连接成功过（区分首次连接和重连）
+        bool m_wantWrite;              // 当前是否关注EPOLLOUT
+        uint64_t m_reconnectAtNs;      // 下一次重连时间
+        uint64_t m_connectDeadlineNs;  // 非阻塞connect的截止时间
+        uint64_t m_backoffNs;          // 当前退避值（连接成功后复位）
+        uint32_t m_jitterState;        // 退避抖动的随机数状态
+        ArmResponseReader m_reader;
+        std::vector<char> m_outbound;  // 未写完的出站数据
+        size_t m_outboundOffset;
+        std::vector<char> m_latest;    // 等待发出的最新流式帧（整帧，尚未写出任何字节）
+        bool m_latestPending;
+
+        // 其他线程 → 反应器线程的交接
+        std::atomic<bool> m_connectRequested;  // connect() 请求连接
+        std::atomic<bool> m_closeRequested;    // close() 请求关闭
+        std::atomic<bool> m_connected;
+
+        // 统计（仅反应器线程写）
+        std::atomic<uint64_t> m_bytesSent;
+        std::atomic<uint64_t> m_bytesReceived;
+        std::atomic<uint64_t> m_messages;
+        std::atomic<uint64_t> m_shortWrites;
+        std::atomic<uint64_t> m_wouldBlock;
+        std::atomic<uint64_t> m_superseded;
+        std::atomic<uint64_t> m_writeDrops;
+        std::atomic<uint64_t> m_disconnects;
+        std::atomic<uint64_t> m_reconnects;
+        std::atomic<uint64_t> m_connectFailures;
+        std::atomic<uint64_t> m_lastBackoffNs;
+        std::atomic<uint64_t> m_pendingBytes;
+    };
+
+    /**
+     * @brief 反应器统计
+     */
+    struct Stats {
+        uint64_t ticks;          // 已处理的节拍
+        uint64_t missedTicks;    // 处理不及时而合并的节拍
+        uint64_t maxTickNs;      // 单个节拍最长处理时间
+        size_t connections;      // 连接数
+    };
+
+    ArmReactor();
+
+    /**
+     * @brief 析构函数，停止反应器线程并关闭所有连接
+     */
+    ~ArmReactor();
+
+    /**
+     * @brief 注册一条连接（任意线程，连接对象归反应器所有）
+     * @param name 连接名称（用于日志）
+     * @param ip 机械臂IP（重连使用）
+     * @param port 机械臂端口
+     * @param handler 回调，生命周期须覆盖反应器运行期间
+     * @return 超过最大连接数时返回nullptr
+     */
+    Connection* addConnection(const std::string& name, const std::string& ip, int port, Handler* handler);
+
+    /**
+     * @brief 发起连接（任意线程，立即返回）
+     *
+     * 反应器在下一个节拍发起非阻塞connect，多条连接并行进行；失败或之后断开时
+     * 按抖动指数退避自动重连，直到 close()。用 Connection::isConnected() 查询结果。
+     */
+    void connect(Connection* connection);
+
+    /**
+     * @brief 关闭连接且不再重连（任意线程；反应器运行时等待其完成关闭）
+     */
+    void close(Connection* connection);
+
+    /**
+     * @brief 设置重连退避（初始值、上限）和单次连接超时，<=0 的参数保持原值
+     */
+    void setReconnectPolicy(int initialDelayMs, int maxDelayMs, int connectTimeoutMs);
+
+    /**
+     * @brief 设置之后新建socket的发送缓冲区大小（SO_SNDBUF，<=0 为系统默认）
+     *
+     * 缓冲区越小，对端读取变慢时越早出现EAGAIN，积压的旧目标留在最新帧槽位中被覆盖，
+     * 而不是排在内核缓冲区里等待发出
+     */
+    void setSendBufferSize(int bytes) { m_sendBufferBytes = bytes; }
+
+    /**
+     * @brief 启动反应器线程
+     * @return epoll/timerfd 创建失败时返回false
+     */
+    bool start();
+
+    /**
+     * @brief 停止反应器线程（连接保持打开，由析构或close()关闭）
+     */
+    void stop();
+
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 判断当前线程是否为反应器线程
+     */
+    bool isReactorThread() const;
+
+    Stats getStats() const;
+
+    /**
+     * @brief 打印反应器和各连接的统计
+     */
+    void printStats(std::ostream& os) const;
+
+private:
+    ArmReactor(const ArmReactor&);
+    ArmReactor& operator=(const ArmReactor&);
+
+    void run();
+    void tick(uint64_t nowNs);
+    void handleEvent(Connection& connection, uint32_t events);
+    void takeOver(Connection& connection, int fd);
+    void beginConnect(Connection& connection, uint64_t nowNs);
+    void finishConnect(Connection& connection);
+    void readAvailable(Connection& connection);
+    void fail(Connection& connection, const char* reason, int error);
+    uint64_t nextBackoffDelay(Connection& connection);
+    void closeSocket(Connection& connection);
+
+    static const size_t kMaxConnections = 16;
+
+    int m_epoll;
+    int m_timer;
+    std::atomic<Connection*> m_connections[kMaxConnections];
+    std::atomic<size_t> m_connectionCount;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+
+    uint64_t m_initialBackoffNs;
+    uint64_t m_maxBackoffNs;
+    uint64_t m_connectTimeoutNs;
+    int m_sendBufferBytes;
+
+    // 统计（仅反应器线程写）
+    std::atomic<uint64_t> m_ticks;
+    std::atomic<uint64_t> m_missedTicks;
+    std::atomic<uint64_t> m_maxTickNs;
+};
+
+#endif // ARMREACTOR_H
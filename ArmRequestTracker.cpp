@@ -0,0 +1,260 @@
+#include "ArmRequestTracker.h"
+
+#include <cstring>
+#include <iomanip>
+
+ArmRequestTracker::ArmRequestTracker() : m_inFlightCount(0), m_nextId(0), m_unsolicited(0) {
+}
+
+bool ArmRequestTracker::track(const char* frame, size_t length, uint64_t nowNs, uint64_t timeoutNs,
+                              int retries, const Callback& callback) {
+    // 请求帧本身就是JSON，复用响应解析器取出 command
+    ArmResponse request;
+    if (!ArmResponseReader::parse(frame, length, request) || !(request.fields & ArmResponse::FieldCommand)) {
+        return false;
+    }
+
+    Entry entry;
+    entry.id = ++m_nextId;
+    entry.command = request.command;
+    if (retries > 0) {
+        entry.frame.assign(frame, length);
+    }
+    entry.sentNs = nowNs;
+    entry.deadlineNs = nowNs + timeoutNs;
+    entry.timeoutNs = timeoutNs;
+    entry.attempts = 1;
+    entry.retriesLeft = retries;
+    entry.current = true;
+    entry.answered = false;
+    entry.callback = callback;
+    m_inFlight.push_back(entry);
+    m_inFlightCount.store(m_inFlight.size(), std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    ++statsFor(entry.command).requests;
+    return true;
+}
+
+bool ArmRequestTracker::complete(const ArmResponse& response, uint64_t nowNs) {
+    std::string key;
+    if (requestKey(response, key)) {
+        for (std::deque<Entry>::iterator it = m_inFlight.begin(); it != m_inFlight.end(); ++it) {
+            if (it->command != key) {
+                continue;
+            }
+            // 先移出在途表再回调，回调中可以发出并登记新的请求
+            Entry entry = *it;
+            m_inFlight.erase(it);
+            if (entry.answered) {
+                m_inFlightCount.store(m_inFlight.size(), std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                ++statsFor(entry.command).lateReplies;
+                return true;
+            }
+            answerOthers(entry.id, nowNs);
+            m_inFlightCount.store(m_inFlight.size(), std::memory_order_relaxed);
+
+            uint64_t latency = nowNs - entry.sentNs;
+            {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                CommandStats& stats = statsFor(entry.command);
+                ++stats.replies;
+                stats.lastLatencyNs = latency;
+                stats.totalLatencyNs += latency;
+                if (latency > stats.maxLatencyNs) {
+                    stats.maxLatencyNs = latency;
+                }
+            }
+            // 回调只在最近一次发送上；响应匹配到更早的发送时从那里取
+            Callback callback = entry.callback;
+            for (size_t i = 0; !entry.current && i < m_inFlight.size(); ++i) {
+                if (m_inFlight[i].id == entry.id && m_inFlight[i].current) {
+                    callback.swap(m_inFlight[i].callback);
+                    m_inFlight[i].frame.clear();
+                }
+            }
+            if (callback) {
+                callback(&response);
+            }
+            return true;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    ++m_unsolicited;
+    return false;
+}
+
+void ArmRequestTracker::expire(uint64_t nowNs, const Resend& resend) {
+    // 在途发送很少（通常不超过几个），线性扫描
+    for (size_t i = 0; i < m_inFlight.size();) {
+        Entry& entry = m_inFlight[i];
+        if (entry.deadlineNs > nowNs) {
+            ++i;
+            continue;
+        }
+        if (entry.answered) {
+            // 请求已完成，这次发送的响应没有在超时内到达，不再等待
+            m_inFlight.erase(m_inFlight.begin() + static_cast<std::ptrdiff_t>(i));
+            m_inFlightCount.store(m_inFlight.size(), std::memory_order_relaxed);
+            continue;
+        }
+        if (!entry.current) {
+            // 更早的发送：请求仍在重发，继续占住FIFO位置等待可能迟到的响应
+            ++i;
+            continue;
+        }
+        uint64_t id = entry.id;
+        if (entry.retriesLeft > 0 && resend) {
+            std::string command = entry.command;
+            std::string frame = entry.frame;
+            int attempt = entry.attempts + 1;
+            // 重发失败可能导致连接断开并清空在途表，不能再使用entry
+            if (resend(frame, attempt)) {
+                Entry& previous = m_inFlight[i];
+                Entry next = previous;
+                next.sentNs = nowNs;
+                next.deadlineNs = nowNs + next.timeoutNs;
+                next.attempts = attempt;
+                --next.retriesLeft;
+                previous.current = false;
+                previous.frame.clear();
+                previous.callback = Callback();
+                m_inFlight.push_back(next);
+                m_inFlightCount.store(m_inFlight.size(), std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                ++statsFor(command).retries;
+                ++i;
+                continue;
+            }
+            if (i >= m_inFlight.size() || m_inFlight[i].id != id) {
+                break;
+            }
+        }
+        expireRequest(id);
+        // expireRequest 从在途表中移除了这个请求的全部发送（可能包括 i 之前的），从头重新扫描
+        i = 0;
+    }
+}
+
+void ArmRequestTracker::failAll() {
+    while (!m_inFlight.empty()) {
+        Entry entry = m_inFlight.front();
+        m_inFlight.pop_front();
+        m_inFlightCount.store(m_inFlight.size(), std::memory_order_relaxed);
+        if (!entry.current || entry.answered) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            ++statsFor(entry.command).failures;
+        }
+        if (entry.callback) {
+            entry.callback(nullptr);
+        }
+    }
+}
+
+void ArmRequestTracker::answerOthers(uint64_t id, uint64_t nowNs) {
+    for (size_t i = 0; i < m_inFlight.size(); ++i) {
+        Entry& entry = m_inFlight[i];
+        if (entry.id == id) {
+            entry.answered = true;
+            entry.deadlineNs = nowNs + entry.timeoutNs;
+        }
+    }
+}
+
+void ArmRequestTracker::expireRequest(uint64_t id) {
+    Entry expired;
+    bool found = false;
+    for (size_t i = 0; i < m_inFlight.size();) {
+        if (m_inFlight[i].id != id) {
+            ++i;
+            continue;
+        }
+        if (m_inFlight[i].current) {
+            expired = m_inFlight[i];
+            found = true;
+        }
+        m_inFlight.erase(m_inFlight.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+    m_inFlightCount.store(m_inFlight.size(), std::memory_order_relaxed);
+    if (!found) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        ++statsFor(expired.command).timeouts;
+    }
+    if (expired.callback) {
+        expired.callback(nullptr);
+    }
+}
+
+bool ArmRequestTracker::requestKey(const ArmResponse& response, std::string& key) {
+    if (response.fields & ArmResponse::FieldCommand) {
+        key = response.command;
+        return true;
+    }
+    static const char kCurrentPrefix[] = "current_";
+    if ((response.fields & ArmResponse::FieldState) &&
+        strncmp(response.state, kCurrentPrefix, sizeof(kCurrentPrefix) - 1) == 0) {
+        key = "get_";
+        key += response.state;
+        return true;
+    }
+    return false;
+}
+
+std::vector<ArmRequestTracker::CommandStats> ArmRequestTracker::getStats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_stats;
+}
+
+uint64_t ArmRequestTracker::getUnsolicitedCount() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_unsolicited;
+}
+
+void ArmRequestTracker::printStats(std::ostream& os, const std::string& prefix) const {
+    std::vector<CommandStats> stats = getStats();
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const CommandStats& entry = stats[i];
+        double averageMs = entry.replies > 0 ? entry.totalLatencyNs / 1e6 / entry.replies : 0.0;
+        os << prefix << " " << entry.command << ": "
+           << "请求=" << entry.requests
+           << ", 响应=" << entry.replies
+           << ", 超时=" << entry.timeouts
+           << ", 重发=" << entry.retries
+           << ", 迟到响应=" << entry.lateReplies
+           << ", 断开失败=" << entry.failures
+           << ", 延迟=" << std::fixed << std::setprecision(3) << (entry.lastLatencyNs / 1e6)
+           << "ms/" << averageMs << "ms(平均)/" << (entry.maxLatencyNs / 1e6) << "ms(最大)"
+           << std::endl;
+    }
+    os << prefix << " 在途: " << m_inFlightCount.load(std::memory_order_relaxed)
+       << ", 未请求的响应: " << getUnsolicitedCount() << std::endl;
+}
+
+ArmRequestTracker::CommandStats& ArmRequestTracker::statsFor(const std::string& command) {
+    for (size_t i = 0; i < m_stats.size(); ++i) {
+        if (m_stats[i].command == command) {
+            return m_stats[i];
+        }
+    }
+    CommandStats stats;
+    stats.command = command;
+    stats.requests = 0;
+    stats.replies = 0;
+    stats.timeouts = 0;
+    stats.retries = 0;
+    stats.lateReplies = 0;
+    stats.failures = 0;
+    stats.lastLatencyNs = 0;
+    stats.maxLatencyNs = 0;
+    stats.totalLatencyNs = 0;
+    m_stats.push_back(stats);
+    return m_stats.back();
+}
@@ -0,0 +1,146 @@
+#ifndef ARMREQUESTTRACKER_H
+#define ARMREQUESTTRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ArmResponseReader.h"
+
+/**
+ * @class ArmRequestTracker
+ * @brief 每个机械臂连接一个的在途请求表：按指令类型 + FIFO 把响应对应回请求
+ *
+ * 查询、末端执行器指令、设置指令与高频 movep_follow 共用同一条TCP流，
+ * 而机械臂的响应不带请求ID。机械臂对同一连接上的请求按顺序处理，
+ * 因此同一指令类型的响应一定按发送顺序到达：每条响应只需匹配
+ * 同类型中最早的在途请求，不同类型的请求可以同时在途，无需清空接收缓冲区。
+ *
+ * 响应类型的确定：
+ * - 带 "command" 字段的响应（设置指令、夹爪、Modbus写入等）按 command 匹配
+ * - 只带 "state": "current_xxx" 的响应对应查询指令 "get_current_xxx"
+ * - 其他响应（如轨迹到位事件 current_trajectory_state 无对应查询时）计为未请求的响应
+ *
+ * 超时的请求可按设定次数重发（只用于幂等的查询），最终失败时以空响应回调。
+ * 超时的请求在TCP上通常只是响应慢，旧请求的响应仍会到达，因此每次发送都单独
+ * 占一个FIFO位置：响应总匹配同类型中最早的一次发送，请求在任一次发送得到响应时
+ * 完成（延迟从这次发送算起），其余发送的迟到响应被吸收而不会错配给后发出的请求。
+ * 请求完成后，其余发送再等待一个超时时长，之后放弃。
+ * 除 inFlight()/getStats()/printStats() 外只能在一个线程（通信反应器线程）中使用。
+ */
+class ArmRequestTracker {
+public:
+    /**
+     * @brief 请求完成回调：response 为空表示超时或连接断开
+     */
+    typedef std::function<void(const ArmResponse* response)> Callback;
+
+    /**
+     * @brief 重发函数：重写一次请求帧（attempt 为本次是第几次发送），返回是否写出
+     */
+    typedef std::function<bool(const std::string& frame, int attempt)> Resend;
+
+    /**
+     * @brief 单个指令类型的统计
+     */
+    struct CommandStats {
+        std::string command;       // 指令名
+        uint64_t requests;         // 发出的请求（不含重发）
+        uint64_t replies;          // 匹配到的响应
+        uint64_t timeouts;         // 最终超时的请求
+        uint64_t retries;          // 重发次数
+        uint64_t lateReplies;      // 请求已完成后吸收的重发/原发送的响应
+        uint64_t failures;         // 连接断开时仍在途的请求
+        uint64_t lastLatencyNs;    // 最近一次请求→响应延迟
+        uint64_t maxLatencyNs;     // 最大延迟
+        uint64_t totalLatencyNs;   // 延迟总和（求平均）
+    };
+
+    ArmRequestTracker();
+
+    /**
+     * @brief 登记一个已写出的请求
+     * @param frame 请求帧（JSON，可带\r\n）
+     * @param length 帧长度
+     * @param nowNs 发送时间
+     * @param timeoutNs 单次等待响应的时长
+     * @param retries 超时后的重发次数（>0 时保存帧内容用于重发）
+     * @param callback 完成回调（可为空，只统计延迟）
+     * @return 帧中没有 command 字段（无法匹配）时返回false，不登记
+     */
+    bool track(const char* frame, size_t length, uint64_t nowNs, uint64_t timeoutNs, int retries,
+               const Callback& callback);
+
+    /**
+     * @brief 用一条已解析的响应完成同类型中最早的在途请求
+     * @return 没有对应的在途请求时返回false（计为未请求的响应）
+     */
+    bool complete(const ArmResponse& response, uint64_t nowNs);
+
+    /**
+     * @brief 处理超时：可重发的请求调用 resend 重发，其余以空响应完成
+     */
+    void expire(uint64_t nowNs, const Resend& resend);
+
+    /**
+     * @brief 连接断开：所有在途请求以空响应完成
+     */
+    void failAll();
+
+    /** 等待响应的发送数，含等待迟到响应的发送（任意线程可读） */
+    size_t inFlight() const { return m_inFlightCount.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 响应对应的请求指令名（查询响应 current_xxx → get_current_xxx）
+     * @return 无法确定时返回false
+     */
+    static bool requestKey(const ArmResponse& response, std::string& key);
+
+    std::vector<CommandStats> getStats() const;
+    uint64_t getUnsolicitedCount() const;
+
+    /**
+     * @brief 打印每个指令类型的请求/响应/超时和延迟统计
+     */
+    void printStats(std::ostream& os, const std::string& prefix) const;
+
+private:
+    ArmRequestTracker(const ArmRequestTracker&);
+    ArmRequestTracker& operator=(const ArmRequestTracker&);
+
+    // 一次发送（首次发送或重发）；同一请求的各次发送共用 id
+    struct Entry {
+        uint64_t id;
+        std::string command;
+        std::string frame;         // 可重发时保存的请求帧（只在最近一次发送上）
+        uint64_t sentNs;           // 本次发送时间（延迟从这里算起）
+        uint64_t deadlineNs;
+        uint64_t timeoutNs;
+        int attempts;              // 本次是第几次发送
+        int retriesLeft;           // 剩余重发次数
+        bool current;              // 是否为请求最近一次发送（持有回调，超时后重发或失败）
+        bool answered;             // 请求已由其他发送的响应完成，本次发送只等待吸收迟到的响应
+        Callback callback;
+    };
+
+    void answerOthers(uint64_t id, uint64_t nowNs);
+    void expireRequest(uint64_t id);   // 请求最终超时：移除它的全部发送并以空响应回调
+
+    CommandStats& statsFor(const std::string& command);
+
+    std::deque<Entry> m_inFlight;
+    std::atomic<size_t> m_inFlightCount;
+    uint64_t m_nextId;
+
+    mutable std::mutex m_statsMutex;   // 只在更新/读取统计时持有，不覆盖在途表
+    std::vector<CommandStats> m_stats;
+    uint64_t m_unsolicited;
+};
+
+#endif // ARMREQUESTTRACKER_H
@@ -0,0 +1,410 @@
+#include "ArmResponseReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 解析时允许的最大嵌套深度（机械臂响应通常不超过3层）
+const int kMaxDepth = 32;
+
+// 本程序关心的键
+enum Key { KeyOther, KeyCommand, KeyState, KeyArmState, KeyPose, KeyJoint, KeyErr, KeyArmErr, KeySysErr };
+
+// 当前所在的对象：顶层、arm_state内、其他（只校验结构，不提取字段）
+enum Scope { ScopeRoot, ScopeArmState, ScopeOther };
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool keyEquals(const char* begin, const char* end, const char* key) {
+    size_t length = strlen(key);
+    return static_cast<size_t>(end - begin) == length && memcmp(begin, key, length) == 0;
+}
+
+Key classifyKey(const char* begin, const char* end) {
+    switch (end - begin) {
+        case 3:
+            return keyEquals(begin, end, "err") ? KeyErr : KeyOther;
+        case 4:
+            return keyEquals(begin, end, "pose") ? KeyPose : KeyOther;
+        case 5:
+            if (keyEquals(begin, end, "state")) return KeyState;
+            if (keyEquals(begin, end, "joint")) return KeyJoint;
+            return KeyOther;
+        case 7:
+            if (keyEquals(begin, end, "command")) return KeyCommand;
+            if (keyEquals(begin, end, "arm_err")) return KeyArmErr;
+            if (keyEquals(begin, end, "sys_err")) return KeySysErr;
+            return KeyOther;
+        case 9:
+            return keyEquals(begin, end, "arm_state") ? KeyArmState : KeyOther;
+        default:
+            return KeyOther;
+    }
+}
+
+void copyName(char* out, size_t capacity, const char* begin, const char* end) {
+    size_t length = std::min(static_cast<size_t>(end - begin), capacity - 1);
+    memcpy(out, begin, length);
+    out[length] = '\0';
+}
+
+/**
+ * 递归下降扫描：每个字节只访问一次，按所在位置把已知字段直接写入 ArmResponse
+ */
+class ResponseParser {
+public:
+    ResponseParser(const char* data, size_t length, ArmResponse& response)
+        : m_p(data), m_end(data + length), m_response(response) {}
+
+    bool run() {
+        skipSpace();
+        if (m_p >= m_end || *m_p != '{') {
+            return false;
+        }
+        if (!parseObject(ScopeRoot, 0)) {
+            return false;
+        }
+        skipSpace();
+        return m_p == m_end;
+    }
+
+private:
+    void skipSpace() {
+        while (m_p < m_end && isSpace(*m_p)) {
+            ++m_p;
+        }
+    }
+
+    // m_p指向开头的引号，输出字符串内容范围（不解码转义）
+    bool parseString(const char*& begin, const char*& end) {
+        begin = ++m_p;
+        for (; m_p < m_end; ++m_p) {
+            if (*m_p == '\\') {
+                ++m_p;
+            } else if (*m_p == '"') {
+                end = m_p++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parseNumber(double& value) {
+        const char* q = m_p;
+        bool negative = false;
+        if (q < m_end && *q == '-') {
+            negative = true;
+            ++q;
+        }
+        if (q >= m_end || *q < '0' || *q > '9') {
+            return false;
+        }
+        double result = 0.0;
+        while (q < m_end && *q >= '0' && *q <= '9') {
+            result = result * 10.0 + (*q - '0');
+            ++q;
+        }
+        if (q < m_end && *q == '.') {
+            double scale = 0.1;
+            for (++q; q < m_end && *q >= '0' && *q <= '9'; ++q) {
+                result += (*q - '0') * scale;
+                scale *= 0.1;
+            }
+        }
+        if (q < m_end && (*q == 'e' || *q == 'E')) {
+            ++q;
+            bool negativeExponent = false;
+            if (q < m_end && (*q == '-' || *q == '+')) {
+                negativeExponent = *q == '-';
+                ++q;
+            }
+            int exponent = 0;
+            while (q < m_end && *q >= '0' && *q <= '9') {
+                exponent = std::min(exponent * 10 + (*q - '0'), 400);
+                ++q;
+            }
+            double factor = std::pow(10.0, exponent);
+            result = negativeExponent ? result / factor : result * factor;
+        }
+        value = negative ? -result : result;
+        m_p = q;
+        return true;
+    }
+
+    bool parseLiteral(const char* literal) {
+        size_t length = strlen(literal);
+        if (static_cast<size_t>(m_end - m_p) < length || memcmp(m_p, literal, length) != 0) {
+            return false;
+        }
+        m_p += length;
+        return true;
+    }
+
+    // m_p指向'{'，scope为成员所在的作用域
+    bool parseObject(Scope scope, int depth) {
+        ++m_p;
+        skipSpace();
+        if (m_p < m_end && *m_p == '}') {
+            ++m_p;
+            return true;
+        }
+        while (m_p < m_end) {
+            const char* keyBegin;
+            const char* keyEnd;
+            if (*m_p != '"' || !parseString(keyBegin, keyEnd)) {
+                return false;
+            }
+            skipSpace();
+            if (m_p >= m_end || *m_p != ':') {
+                return false;
+            }
+            ++m_p;
+            skipSpace();
+            Key key = scope == ScopeOther ? KeyOther : classifyKey(keyBegin, keyEnd);
+            if (!parseValue(scope, key, depth + 1)) {
+                return false;
+            }
+            skipSpace();
+            if (m_p < m_end && *m_p == ',') {
+                ++m_p;
+                skipSpace();
+            } else if (m_p < m_end && *m_p == '}') {
+                ++m_p;
+                return true;
+            } else {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool parseArray(Scope scope, Key key, int depth) {
+        ArmResponse& r = m_response;
+        // 只提取 arm_state.pose / arm_state.joint / err
+        Key target = KeyOther;
+        if (scope == ScopeArmState && (key == KeyPose || key == KeyJoint)) {
+            target = key;
+        } else if (scope != ScopeOther && key == KeyErr) {
+            target = KeyErr;
+        }
+
+        ++m_p;
+        skipSpace();
+        int count = 0;
+        if (m_p < m_end && *m_p == ']') {
+            ++m_p;
+        } else {
+            while (true) {
+                double value;
+                if (target != KeyOther && m_p < m_end && (*m_p == '-' || (*m_p >= '0' && *m_p <= '9'))) {
+                    if (!parseNumber(value)) {
+                        return false;
+                    }
+                    if (target == KeyPose && count < 6) {
+                        r.pose[count] = static_cast<int>(std::lround(value));
+                    } else if (target == KeyJoint && count < ArmResponse::kMaxJoints) {
+                        r.joint[count] = static_cast<float>(value);
+                    } else if (target == KeyErr && count < ArmResponse::kMaxErrors) {
+                        r.err[count] = static_cast<int>(value);
+                    }
+                } else if (!parseValue(ScopeOther, KeyOther, depth + 1)) {
+                    return false;
+                }
+                ++count;
+                skipSpace();
+                if (m_p < m_end && *m_p == ',') {
+                    ++m_p;
+                    skipSpace();
+                } else if (m_p < m_end && *m_p == ']') {
+                    ++m_p;
+                    break;
+                } else {
+                    return false;
+                }
+            }
+        }
+
+        if (target == KeyPose && count == 6) {
+            r.fields |= ArmResponse::FieldPose;
+        } else if (target == KeyJoint && count > 0) {
+            r.jointCount = static_cast<uint8_t>(std::min(count, ArmResponse::kMaxJoints));
+            r.fields |= ArmResponse::FieldJoint;
+        } else if (target == KeyErr) {
+            r.errCount = static_cast<uint8_t>(std::min(count, ArmResponse::kMaxErrors));
+            r.fields |= ArmResponse::FieldErrors;
+        }
+        return true;
+    }
+
+    bool parseValue(Scope scope, Key key, int depth) {
+        if (depth > kMaxDepth || m_p >= m_end) {
+            return false;
+        }
+        ArmResponse& r = m_response;
+        char c = *m_p;
+        if (c == '{') {
+            Scope child = ScopeOther;
+            if (scope == ScopeRoot && key == KeyArmState) {
+                child = ScopeArmState;
+                r.fields |= ArmResponse::FieldArmState;
+            }
+            return parseObject(child, depth);
+        }
+        if (c == '[') {
+            return parseArray(scope, key, depth);
+        }
+        if (c == '"') {
+            const char* begin;
+            const char* end;
+            if (!parseString(begin, end)) {
+                return false;
+            }
+            if (scope == ScopeRoot && key == KeyCommand) {
+                copyName(r.command, sizeof(r.command), begin, end);
+                r.fields |= ArmResponse::FieldCommand;
+            } else if (scope == ScopeRoot && key == KeyState) {
+                copyName(r.state, sizeof(r.state), begin, end);
+                r.fields |= ArmResponse::FieldState;
+            }
+            return true;
+        }
+        if (c == 't') return parseLiteral("true");
+        if (c == 'f') return parseLiteral("false");
+        if (c == 'n') return parseLiteral("null");
+
+        double value;
+        if (!parseNumber(value)) {
+            return false;
+        }
+        if (scope != ScopeOther && (key == KeyArmErr || key == KeySysErr)) {
+            (key == KeyArmErr ? r.armErr : r.sysErr) = static_cast<int>(value);
+            r.fields |= ArmResponse::FieldErrors;
+        }
+        return true;
+    }
+
+    const char* m_p;
+    const char* m_end;
+    ArmResponse& m_response;
+};
+
+} // namespace
+
+void ArmResponse::clear() {
+    memset(this, 0, sizeof(*this));
+}
+
+ArmResponseReader::ArmResponseReader(size_t initialCapacity, size_t maxCapacity)
+    : m_buffer(std::max<size_t>(initialCapacity, 64)),
+      m_maxCapacity(std::max(maxCapacity, std::max<size_t>(initialCapacity, 64))),
+      m_readPos(0), m_writePos(0), m_scanPos(0),
+      m_inMessage(false), m_depth(0), m_inString(false), m_escape(false),
+      m_messages(0), m_discardedBytes(0), m_overflows(0) {
+}
+
+void ArmResponseReader::compact() {
+    if (m_readPos == 0) {
+        return;
+    }
+    size_t remaining = m_writePos - m_readPos;
+    if (remaining > 0) {
+        memmove(&m_buffer[0], &m_buffer[m_readPos], remaining);
+    }
+    m_scanPos -= m_readPos;
+    m_writePos = remaining;
+    m_readPos = 0;
+}
+
+char* ArmResponseReader::prepareWrite(size_t minSpace, size_t& available) {
+    if (m_buffer.size() - m_writePos < minSpace) {
+        compact();
+    }
+    if (m_buffer.size() - m_writePos < minSpace) {
+        size_t needed = m_writePos + minSpace;
+        if (needed > m_maxCapacity) {
+            // 半条消息已超过上限：整体丢弃，从下一个 '{' 重新同步
+            ++m_overflows;
+            m_discardedBytes += m_writePos - m_readPos;
+            reset();
+        } else {
+            m_buffer.resize(std::min(std::max(m_buffer.size() * 2, needed), m_maxCapacity));
+        }
+    }
+    available = m_buffer.size() - m_writePos;
+    return &m_buffer[m_writePos];
+}
+
+void ArmResponseReader::commitWrite(size_t bytes) {
+    m_writePos = std::min(m_writePos + bytes, m_buffer.size());
+}
+
+bool ArmResponseReader::nextMessage(const char*& data, size_t& length) {
+    const char* buffer = &m_buffer[0];
+    while (m_scanPos < m_writePos) {
+        char c = buffer[m_scanPos++];
+        if (!m_inMessage) {
+            // 消息之间只应有\r\n，其他字节计为丢弃
+            if (c == '{') {
+                m_inMessage = true;
+                m_depth = 1;
+                m_readPos = m_scanPos - 1;
+            } else {
+                if (!isSpace(c)) {
+                    ++m_discardedBytes;
+                }
+                m_readPos = m_scanPos;
+            }
+            continue;
+        }
+        if (m_inString) {
+            if (m_escape) {
+                m_escape = false;
+            } else if (c == '\\') {
+                m_escape = true;
+            } else if (c == '"') {
+                m_inString = false;
+            }
+        } else if (c == '"') {
+            m_inString = true;
+        } else if (c == '{') {
+            ++m_depth;
+        } else if (c == '}' && --m_depth == 0) {
+            data = buffer + m_readPos;
+            length = m_scanPos - m_readPos;
+            m_readPos = m_scanPos;
+            m_inMessage = false;
+            ++m_messages;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ArmResponseReader::reset() {
+    m_readPos = 0;
+    m_writePos = 0;
+    m_scanPos = 0;
+    m_inMessage = false;
+    m_depth = 0;
+    m_inString = false;
+    m_escape = false;
+}
+
+ArmResponseReader::Stats ArmResponseReader::getStats() const {
+    Stats stats;
+    stats.messages = m_messages;
+    stats.discardedBytes = m_discardedBytes;
+    stats.overflows = m_overflows;
+    stats.capacity = m_buffer.size();
+    return stats;
+}
+
+bool ArmResponseReader::parse(const char* data, size_t length, ArmResponse& response) {
+    response.clear();
+    ResponseParser parser(data, length, response);
+    return parser.run();
+}
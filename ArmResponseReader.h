@@ -0,0 +1,140 @@
+#ifndef ARMRESPONSEREADER_H
+#define ARMRESPONSEREADER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct ArmResponse
+ * @brief 机械臂TCP响应中本程序关心的字段（一次扫描提取，不分配内存）
+ */
+struct ArmResponse {
+    static const int kMaxJoints = 7;
+    static const int kMaxErrors = 24;
+    static const size_t kNameLength = 48;
+
+    // fields 位掩码：本条响应中出现的字段
+    enum Field {
+        FieldCommand = 1 << 0,    // 顶层 "command"
+        FieldState = 1 << 1,      // 顶层 "state"
+        FieldArmState = 1 << 2,   // "arm_state" 对象
+        FieldPose = 1 << 3,       // arm_state.pose（6个值）
+        FieldJoint = 1 << 4,      // arm_state.joint
+        FieldErrors = 1 << 5      // err 数组或 arm_err/sys_err
+    };
+
+    uint32_t fields;
+    char command[kNameLength];     // "command" 的值（截断，以'\0'结尾）
+    char state[kNameLength];       // "state" 的值（截断，以'\0'结尾）
+
+    std::array<int, 6> pose;       // 位姿（微米/毫弧度）
+    float joint[kMaxJoints];       // 关节角度（度）
+    uint8_t jointCount;
+
+    int armErr;                    // 旧协议 arm_err
+    int sysErr;                    // 旧协议 sys_err
+    int err[kMaxErrors];           // 新协议 err 数组
+    uint8_t errCount;
+
+    /**
+     * @brief 清空所有字段
+     */
+    void clear();
+};
+
+/**
+ * @class ArmResponseReader
+ * @brief 每个TCP连接一个的增量式JSON响应分帧器
+ *
+ * 机械臂的响应是连续的JSON对象流（以\r\n分隔，但TCP不保证一次recv恰好一条）。
+ * socket数据追加到读取器的缓冲区，nextMessage() 按括号深度（跳过字符串内容）
+ * 切出每一条完整的顶层对象，跨recv的半条消息保留到下次数据到达，扫描状态
+ * 也一并保留，已扫描的字节不会重复扫描。缓冲区在消息消费后前移复用，
+ * 只有单条消息超过当前容量时才扩容，超过上限时整体丢弃并重新同步。
+ * 单线程使用。
+ */
+class ArmResponseReader {
+public:
+    /**
+     * @brief 统计信息
+     */
+    struct Stats {
+        uint64_t messages;         // 切出的完整消息数
+        uint64_t discardedBytes;   // 消息之间无法识别的字节（不含空白）
+        uint64_t overflows;        // 单条消息超过上限而丢弃的次数
+        size_t capacity;           // 当前缓冲区容量
+    };
+
+    /**
+     * @brief 构造函数
+     * @param initialCapacity 初始缓冲区大小
+     * @param maxCapacity 单条消息允许的最大长度
+     */
+    explicit ArmResponseReader(size_t initialCapacity = 4096, size_t maxCapacity = 1 << 20);
+
+    /**
+     * @brief 获取可写入的缓冲区（会使之前 nextMessage 返回的指针失效）
+     * @param available 输出可写入的字节数（至少 minSpace，达到上限时可能为0）
+     */
+    char* prepareWrite(size_t minSpace, size_t& available);
+
+    /**
+     * @brief 提交写入 prepareWrite 返回区域的字节数
+     */
+    void commitWrite(size_t bytes);
+
+    /**
+     * @brief 取出下一条完整的JSON对象
+     * @param data 输出消息起始位置（指向内部缓冲区，下次 prepareWrite 前有效）
+     * @param length 输出消息长度
+     * @return 没有完整消息时返回false
+     */
+    bool nextMessage(const char*& data, size_t& length);
+
+    /**
+     * @brief 丢弃所有缓冲数据（重连后调用）
+     */
+    void reset();
+
+    /**
+     * @brief 尚未切出的缓冲字节数
+     */
+    size_t buffered() const { return m_writePos - m_readPos; }
+
+    Stats getStats() const;
+
+    /**
+     * @brief 单次扫描解析一条响应，提取 command/state/arm_state.pose/joint/err 等字段
+     * @param data 一条完整的JSON对象
+     * @param length 长度
+     * @param response 输出字段
+     * @return JSON结构有效时返回true（可能不含任何已知字段）
+     */
+    static bool parse(const char* data, size_t length, ArmResponse& response);
+
+private:
+    ArmResponseReader(const ArmResponseReader&);
+    ArmResponseReader& operator=(const ArmResponseReader&);
+
+    void compact();
+
+    std::vector<char> m_buffer;
+    size_t m_maxCapacity;
+    size_t m_readPos;         // 下一条消息的起点（之前的数据已消费）
+    size_t m_writePos;        // 有效数据末尾
+    size_t m_scanPos;         // 已扫描到的位置
+
+    // 跨数据块保留的扫描状态
+    bool m_inMessage;
+    int m_depth;
+    bool m_inString;
+    bool m_escape;
+
+    uint64_t m_messages;
+    uint64_t m_discardedBytes;
+    uint64_t m_overflows;
+};
+
+#endif // ARMRESPONSEREADER_H
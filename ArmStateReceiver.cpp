@@ -0,0 +1,460 @@
+#include "ArmStateReceiver.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+// 单个上报数据包上限（含灵巧手/末端设备数据时约2KB）
+const size_t kMaxPacketBytes = 8192;
+
+// rm_udp_arm_current_status_e 的名称，下标即枚举值
+const char* const kArmStatusNames[] = {
+    "RM_IDLE_E", "RM_MOVE_L_E", "RM_MOVE_J_E", "RM_MOVE_C_E", "RM_MOVE_S_E",
+    "RM_MOVE_THROUGH_JOINT_E", "RM_MOVE_THROUGH_POSE_E", "RM_MOVE_THROUGH_FORCE_POSE_E",
+    "RM_MOVE_THROUGH_CURRENT_E", "RM_STOP_E", "RM_SLOW_STOP_E", "RM_PAUSE_E",
+    "RM_CURRENT_DRAG_E", "RM_SENSOR_DRAG_E", "RM_TECH_DEMONSTRATION_E"
+};
+const int kArmStatusCount = sizeof(kArmStatusNames) / sizeof(kArmStatusNames[0]);
+
+struct Range {
+    const char* begin;
+    const char* end;
+};
+
+const char* skipSpace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        ++p;
+    }
+    return p;
+}
+
+// 跳过字符串（p指向开头的引号），返回结束引号之后的位置
+const char* skipString(const char* p, const char* end) {
+    for (++p; p < end; ++p) {
+        if (*p == '\\') {
+            ++p;
+        } else if (*p == '"') {
+            return p + 1;
+        }
+    }
+    return end;
+}
+
+// 在[begin, end)中查找 "key": ，返回值的起始位置；只匹配完整键名
+const char* findValue(const Range& range, const char* key) {
+    size_t keyLength = strlen(key);
+    const char* p = range.begin;
+    while (p < range.end) {
+        if (*p != '"') {
+            ++p;
+            continue;
+        }
+        const char* nameBegin = p + 1;
+        const char* next = skipString(p, range.end);
+        if (static_cast<size_t>(next - 1 - nameBegin) == keyLength &&
+            memcmp(nameBegin, key, keyLength) == 0) {
+            const char* value = skipSpace(next, range.end);
+            if (value < range.end && *value == ':') {
+                return skipSpace(value + 1, range.end);
+            }
+        }
+        p = next;
+    }
+    return nullptr;
+}
+
+// 取键对应的对象 {...} 范围
+bool findObject(const Range& range, const char* key, Range& object) {
+    const char* p = findValue(range, key);
+    if (!p || *p != '{') {
+        return false;
+    }
+    int depth = 0;
+    for (const char* q = p; q < range.end; ++q) {
+        if (*q == '"') {
+            q = skipString(q, range.end) - 1;
+        } else if (*q == '{') {
+            ++depth;
+        } else if (*q == '}' && --depth == 0) {
+            object.begin = p + 1;
+            object.end = q;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 解析一个JSON数字（整数/小数/指数），成功时前移p
+bool parseNumber(const char*& p, const char* end, double& value) {
+    const char* q = p;
+    bool negative = false;
+    if (q < end && (*q == '-' || *q == '+')) {
+        negative = *q == '-';
+        ++q;
+    }
+    if (q >= end || ((*q < '0' || *q > '9') && *q != '.')) {
+        return false;
+    }
+    double result = 0.0;
+    while (q < end && *q >= '0' && *q <= '9') {
+        result = result * 10.0 + (*q - '0');
+        ++q;
+    }
+    if (q < end && *q == '.') {
+        double scale = 0.1;
+        for (++q; q < end && *q >= '0' && *q <= '9'; ++q) {
+            result += (*q - '0') * scale;
+            scale *= 0.1;
+        }
+    }
+    if (q < end && (*q == 'e' || *q == 'E')) {
+        ++q;
+        bool negativeExponent = false;
+        if (q < end && (*q == '-' || *q == '+')) {
+            negativeExponent = *q == '-';
+            ++q;
+        }
+        int exponent = 0;
+        while (q < end && *q >= '0' && *q <= '9') {
+            exponent = exponent * 10 + (*q - '0');
+            ++q;
+        }
+        double factor = 1.0;
+        for (int i = 0; i < exponent; ++i) {
+            factor *= 10.0;
+        }
+        result = negativeExponent ? result / factor : result * factor;
+    }
+    value = negative ? -result : result;
+    p = q;
+    return true;
+}
+
+// 解析键对应的数字数组，返回解析到的元素数
+int parseArray(const Range& range, const char* key, double* out, int maxCount) {
+    const char* p = findValue(range, key);
+    if (!p || *p != '[') {
+        return 0;
+    }
+    int count = 0;
+    ++p;
+    while (p < range.end && count < maxCount) {
+        p = skipSpace(p, range.end);
+        double value;
+        if (!parseNumber(p, range.end, value)) {
+            break;
+        }
+        out[count++] = value;
+        p = skipSpace(p, range.end);
+        if (p < range.end && *p == ',') {
+            ++p;
+        } else {
+            break;
+        }
+    }
+    return count;
+}
+
+bool parseScalar(const Range& range, const char* key, double& value) {
+    const char* p = findValue(range, key);
+    return p && parseNumber(p, range.end, value);
+}
+
+} // namespace
+
+ArmStateReceiver::ArmStateReceiver(int port)
+    : m_port(port), m_socket(-1), m_running(false),
+      m_received(0), m_parseErrors(0), m_unknownSource(0) {
+}
+
+ArmStateReceiver::~ArmStateReceiver() {
+    stop();
+    for (size_t i = 0; i < m_arms.size(); ++i) {
+        delete m_arms[i].packets;
+    }
+}
+
+void ArmStateReceiver::registerArm(const std::string& ip, PublishFunction publish) {
+    ArmEntry entry;
+    entry.address = 0;
+    if (inet_pton(AF_INET, ip.c_str(), &entry.address) != 1) {
+        std::cerr << "警告：主动上报接收忽略无效的机械臂IP " << ip << std::endl;
+        return;
+    }
+    entry.ip = ip;
+    entry.publish = publish;
+    entry.packets = new std::atomic<uint64_t>(0);
+    m_arms.push_back(entry);
+}
+
+bool ArmStateReceiver::start() {
+    if (m_running.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    m_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (m_socket < 0) {
+        std::cerr << "❌ 创建主动上报接收socket失败: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    // 接收超时用于定期检查停止标志
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 100000;
+    setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(m_port));
+    if (bind(m_socket, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "❌ 绑定主动上报端口 " << m_port << " 失败: " << strerror(errno) << std::endl;
+        close(m_socket);
+        m_socket = -1;
+        return false;
+    }
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&ArmStateReceiver::run, this);
+    std::cout << "✅ 机械臂主动上报接收线程已启动，端口: " << m_port << std::endl;
+    return true;
+}
+
+void ArmStateReceiver::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_socket >= 0) {
+        close(m_socket);
+        m_socket = -1;
+    }
+    std::cout << "机械臂主动上报接收线程已停止" << std::endl;
+}
+
+ArmStateReceiver::Stats ArmStateReceiver::getStats() const {
+    Stats stats;
+    stats.received = m_received.load(std::memory_order_relaxed);
+    stats.parseErrors = m_parseErrors.load(std::memory_order_relaxed);
+    stats.unknownSource = m_unknownSource.load(std::memory_order_relaxed);
+    return stats;
+}
+
+uint64_t ArmStateReceiver::getArmPacketCount(const std::string& ip) const {
+    for (size_t i = 0; i < m_arms.size(); ++i) {
+        if (m_arms[i].ip == ip) {
+            return m_arms[i].packets->load(std::memory_order_relaxed);
+        }
+    }
+    return 0;
+}
+
+void ArmStateReceiver::run() {
+    char buffer[kMaxPacketBytes];
+    ArmRealtimeState state;
+
+    while (m_running.load(std::memory_order_acquire)) {
+        struct sockaddr_in sender;
+        socklen_t senderLength = sizeof(sender);
+        ssize_t received = recvfrom(m_socket, buffer, sizeof(buffer), 0,
+                                    reinterpret_cast<struct sockaddr*>(&sender), &senderLength);
+        if (received <= 0) {
+            continue;   // 超时或被信号中断
+        }
+        uint64_t nowNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        m_received.store(m_received.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        ArmEntry* arm = nullptr;
+        for (size_t i = 0; i < m_arms.size(); ++i) {
+            if (m_arms[i].address == sender.sin_addr.s_addr) {
+                arm = &m_arms[i];
+                break;
+            }
+        }
+        if (!arm) {
+            m_unknownSource.store(m_unknownSource.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            continue;
+        }
+
+        memset(&state, 0, sizeof(state));
+        state.armCurrentStatus = -1;
+        if (!parse(buffer, static_cast<size_t>(received), state)) {
+            m_parseErrors.store(m_parseErrors.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            continue;
+        }
+        state.timestampNs = nowNs;
+        state.source = ArmRealtimeState::SourceUdpPush;
+        strncpy(state.armIp, arm->ip.c_str(), sizeof(state.armIp) - 1);
+
+        arm->publish(state);
+        arm->packets->store(arm->packets->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+bool ArmStateReceiver::parse(const char* data, size_t length, ArmRealtimeState& state) {
+    const int dof = ArmRealtimeState::kArmDof;
+    Range message = {data, data + length};
+    Range object;
+    double values[ArmRealtimeState::kMaxErrors];
+    double value;
+
+    // 当前路点：位置0.001mm（即微米）、欧拉角0.001rad（即毫弧度）、四元数×1e6
+    if (findObject(message, "waypoint", object)) {
+        int positionCount = parseArray(object, "position", values, 3);
+        int eulerCount = parseArray(object, "euler", values + 3, 3);
+        if (positionCount == 3 && eulerCount == 3) {
+            for (int i = 0; i < 6; ++i) {
+                state.pose[i] = static_cast<int>(values[i]);
+            }
+            state.fields |= ArmRealtimeState::FieldPose;
+        }
+        if (parseArray(object, "quat", values, 4) == 4) {
+            for (int i = 0; i < 4; ++i) {
+                state.quaternion[i] = static_cast<float>(values[i] / 1e6);
+            }
+        }
+    } else if (parseArray(message, "pose", values, 6) == 6) {
+        // 兼容直接给出pose数组的固件
+        for (int i = 0; i < 6; ++i) {
+            state.pose[i] = static_cast<int>(values[i]);
+        }
+        state.fields |= ArmRealtimeState::FieldPose;
+    }
+
+    // 关节状态：角度0.001°、速度0.01RPM、电流0.001mA、温度0.001℃、电压0.001V
+    if (findObject(message, "joint_status", object)) {
+        int count = parseArray(object, "joint_position", values, dof);
+        for (int i = 0; i < count; ++i) state.jointPosition[i] = static_cast<float>(values[i] / 1000.0);
+        count = parseArray(object, "joint_speed", values, dof);
+        for (int i = 0; i < count; ++i) state.jointSpeed[i] = static_cast<float>(values[i] / 100.0);
+        count = parseArray(object, "joint_current", values, dof);
+        for (int i = 0; i < count; ++i) state.jointCurrent[i] = static_cast<float>(values[i] / 1000.0);
+        count = parseArray(object, "joint_temperature", values, dof);
+        for (int i = 0; i < count; ++i) state.jointTemperature[i] = static_cast<float>(values[i] / 1000.0);
+        count = parseArray(object, "joint_voltage", values, dof);
+        for (int i = 0; i < count; ++i) state.jointVoltage[i] = static_cast<float>(values[i] / 1000.0);
+        count = parseArray(object, "joint_err_code", values, dof);
+        for (int i = 0; i < count; ++i) state.jointErrCode[i] = static_cast<uint16_t>(values[i]);
+        count = parseArray(object, "joint_en_flag", values, dof);
+        for (int i = 0; i < count; ++i) state.jointEnabled[i] = values[i] != 0.0 ? 1 : 0;
+        state.fields |= ArmRealtimeState::FieldJointStatus;
+    }
+
+    // 力传感器：0.001N / 0.001Nm
+    if (findObject(message, "force_sensor", object)) {
+        int count = parseArray(object, "force", values, 6);
+        for (int i = 0; i < count; ++i) state.force[i] = static_cast<float>(values[i] / 1000.0);
+        count = parseArray(object, "zero_force", values, 6);
+        for (int i = 0; i < count; ++i) state.zeroForce[i] = static_cast<float>(values[i] / 1000.0);
+        if (parseScalar(object, "coordinate", value)) {
+            state.forceCoordinate = static_cast<int>(value);
+        }
+        state.fields |= ArmRealtimeState::FieldForceSensor;
+    }
+
+    // 错误码：新协议为 err 对象，旧协议为 arm_err/sys_err
+    if (findObject(message, "err", object)) {
+        int count = parseArray(object, "err", values, ArmRealtimeState::kMaxErrors);
+        state.errCount = static_cast<uint8_t>(count);
+        for (int i = 0; i < count; ++i) state.err[i] = static_cast<int>(values[i]);
+        state.fields |= ArmRealtimeState::FieldErrors;
+    }
+    if (parseScalar(message, "arm_err", value)) {
+        state.armErr = static_cast<int>(value);
+        state.fields |= ArmRealtimeState::FieldErrors;
+    }
+    if (parseScalar(message, "sys_err", value)) {
+        state.sysErr = static_cast<int>(value);
+        state.fields |= ArmRealtimeState::FieldErrors;
+    }
+
+    // 机械臂状态：数值或枚举名
+    const char* status = findValue(message, "arm_current_status");
+    if (status) {
+        if (*status == '"') {
+            const char* nameEnd = skipString(status, message.end) - 1;
+            size_t nameLength = static_cast<size_t>(nameEnd - status - 1);
+            for (int i = 0; i < kArmStatusCount; ++i) {
+                if (strlen(kArmStatusNames[i]) == nameLength &&
+                    memcmp(kArmStatusNames[i], status + 1, nameLength) == 0) {
+                    state.armCurrentStatus = i;
+                    state.fields |= ArmRealtimeState::FieldArmStatus;
+                    break;
+                }
+            }
+        } else if (parseNumber(status, message.end, value)) {
+            state.armCurrentStatus = static_cast<int>(value);
+            state.fields |= ArmRealtimeState::FieldArmStatus;
+        }
+    }
+
+    return (state.fields & ArmRealtimeState::FieldPose) != 0;
+}
+
+void ArmStateReceiver::printState(std::ostream& os, const ArmRealtimeState& state) {
+    const int dof = ArmRealtimeState::kArmDof;
+    os << std::fixed << std::setprecision(2);
+    if (state.fields & ArmRealtimeState::FieldJointStatus) {
+        os << "  关节角度 (度): [";
+        for (int i = 0; i < dof; ++i) {
+            if (i > 0) os << ", ";
+            os << state.jointPosition[i];
+        }
+        os << "]" << std::endl;
+        os << "  关节电流 (mA): [";
+        for (int i = 0; i < dof; ++i) {
+            if (i > 0) os << ", ";
+            os << state.jointCurrent[i];
+        }
+        os << "]" << std::endl;
+        os << "  关节温度 (℃): [";
+        for (int i = 0; i < dof; ++i) {
+            if (i > 0) os << ", ";
+            os << state.jointTemperature[i];
+        }
+        os << "]" << std::endl;
+    }
+    if (state.fields & ArmRealtimeState::FieldForceSensor) {
+        os << "  外受力 (N/Nm): [";
+        for (int i = 0; i < 6; ++i) {
+            if (i > 0) os << ", ";
+            os << state.zeroForce[i];
+        }
+        os << "] (坐标系 " << state.forceCoordinate << ")" << std::endl;
+    }
+    if (state.fields & ArmRealtimeState::FieldArmStatus) {
+        os << "  机械臂状态: "
+           << (state.armCurrentStatus >= 0 && state.armCurrentStatus < kArmStatusCount
+               ? kArmStatusNames[state.armCurrentStatus] : "未知")
+           << std::endl;
+    }
+    if (state.fields & ArmRealtimeState::FieldErrors) {
+        os << "  错误码: arm_err=" << state.armErr << ", sys_err=" << state.sysErr;
+        if (state.errCount > 0) {
+            os << ", err=[";
+            for (int i = 0; i < state.errCount; ++i) {
+                if (i > 0) os << ", ";
+                os << state.err[i];
+            }
+            os << "]";
+        }
+        os << std::endl;
+    }
+    os << std::defaultfloat;
+}
@@ -0,0 +1,161 @@
+#ifndef ARMSTATERECEIVER_H
+#define ARMSTATERECEIVER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct ArmRealtimeState
+ * @brief 机械臂实时状态（参照RM_API2的 rm_realtime_arm_joint_state_t，固定大小、可平凡拷贝）
+ *
+ * 单位沿用本程序的约定：位姿为微米/毫弧度，关节角度为度，力为牛/牛米。
+ */
+struct ArmRealtimeState {
+    static const int kArmDof = 7;       // 与 RM_API2 的 ARM_DOF 一致
+    static const int kMaxErrors = 24;
+
+    // fields 位掩码：本帧解析到的字段
+    enum Field {
+        FieldPose = 1 << 0,
+        FieldJointStatus = 1 << 1,
+        FieldForceSensor = 1 << 2,
+        FieldErrors = 1 << 3,
+        FieldArmStatus = 1 << 4
+    };
+
+    // 数据来源
+    enum Source { SourceNone = 0, SourceTcpQuery = 1, SourceUdpPush = 2 };
+
+    uint64_t timestampNs;                  // 收到数据时的单调时钟时间（纳秒）
+    uint32_t source;                       // 数据来源
+    uint32_t fields;                       // 有效字段位掩码
+    char armIp[16];                        // 推送数据的机械臂IP
+
+    std::array<int, 6> pose;               // 当前路点位姿（微米/毫弧度）
+    float quaternion[4];                   // 当前路点四元数 (w, x, y, z)
+
+    float jointPosition[kArmDof];          // 关节角度（度）
+    float jointSpeed[kArmDof];             // 关节速度（RPM）
+    float jointCurrent[kArmDof];           // 关节电流（mA）
+    float jointTemperature[kArmDof];       // 关节温度（℃）
+    float jointVoltage[kArmDof];           // 关节电压（V）
+    uint16_t jointErrCode[kArmDof];        // 关节错误码
+    uint8_t jointEnabled[kArmDof];         // 关节使能状态
+
+    float force[6];                        // 力传感器原始数据（N/Nm）
+    float zeroForce[6];                    // 系统外受力数据（N/Nm）
+    int forceCoordinate;                   // 外受力数据坐标系
+
+    int armErr;                            // 机械臂错误码（旧协议）
+    int sysErr;                            // 系统错误码（旧协议）
+    uint8_t errCount;                      // 错误代码个数
+    int err[kMaxErrors];                   // 错误代码
+    int armCurrentStatus;                  // rm_udp_arm_current_status_e，-1为未知
+};
+
+/**
+ * @class ArmStateReceiver
+ * @brief UDP主动上报接收线程
+ *
+ * 绑定 set_realtime_push 配置的本机端口，按数据包源IP分发到已注册的机械臂。
+ * 每个数据包在接收线程内解析为 ArmRealtimeState（不分配内存），
+ * 通过注册时提供的发布回调写入该机械臂的顺序锁。
+ */
+class ArmStateReceiver {
+public:
+    typedef std::function<void(const ArmRealtimeState&)> PublishFunction;
+
+    /**
+     * @brief 接收统计
+     */
+    struct Stats {
+        uint64_t received;        // 收到的数据包
+        uint64_t parseErrors;     // 无法解析出位姿的数据包
+        uint64_t unknownSource;   // 源IP未注册的数据包
+    };
+
+    /**
+     * @brief 构造函数
+     * @param port 本机接收端口
+     */
+    explicit ArmStateReceiver(int port);
+
+    /**
+     * @brief 析构函数，自动停止接收线程
+     */
+    ~ArmStateReceiver();
+
+    /**
+     * @brief 注册机械臂（须在start()之前调用）
+     * @param ip 机械臂IP（数据包源地址）
+     * @param publish 解析成功后在接收线程中调用的发布函数
+     */
+    void registerArm(const std::string& ip, PublishFunction publish);
+
+    /**
+     * @brief 绑定端口并启动接收线程
+     * @return 绑定失败时返回false
+     */
+    bool start();
+
+    /**
+     * @brief 停止接收线程并关闭socket
+     */
+    void stop();
+
+    Stats getStats() const;
+
+    /**
+     * @brief 获取指定机械臂收到的数据包数量
+     */
+    uint64_t getArmPacketCount(const std::string& ip) const;
+
+    int getPort() const { return m_port; }
+
+    /**
+     * @brief 解析一个上报数据包（不分配内存，可用于离线测试）
+     * @param data 数据包内容（JSON）
+     * @param length 长度
+     * @param state 输出状态，只覆盖解析到的字段
+     * @return 解析出位姿时返回true
+     */
+    static bool parse(const char* data, size_t length, ArmRealtimeState& state);
+
+    /**
+     * @brief 打印一个状态的关节和错误信息（非实时线程调用）
+     */
+    static void printState(std::ostream& os, const ArmRealtimeState& state);
+
+private:
+    ArmStateReceiver(const ArmStateReceiver&);
+    ArmStateReceiver& operator=(const ArmStateReceiver&);
+
+    struct ArmEntry {
+        uint32_t address;                     // 网络字节序IPv4地址
+        std::string ip;
+        PublishFunction publish;
+        std::atomic<uint64_t>* packets;
+    };
+
+    void run();
+
+    int m_port;
+    int m_socket;
+    std::vector<ArmEntry> m_arms;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+
+    // 仅接收线程写
+    std::atomic<uint64_t> m_received;
+    std::atomic<uint64_t> m_parseErrors;
+    std::atomic<uint64_t> m_unknownSource;
+};
+
+#endif // ARMSTATERECEIVER_H
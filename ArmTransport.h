@@ -0,0 +1,163 @@
+#ifndef ARMTRANSPORT_H
+#define ARMTRANSPORT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+
+#include "ArmResponseReader.h"
+
+/**
+ * @struct ArmCommand
+ * @brief 与传输后端无关的机械臂指令（设置、末端执行器、状态查询）
+ *
+ * 定长、可直接拷贝，可以放入无锁队列。由传输后端翻译成各自的协议：
+ * JSON后端编码为TCP JSON帧，RM_API2后端调用对应的 rm_* 接口。
+ */
+struct ArmCommand {
+    enum Type {
+        SetArmPower,            // args[0]: 1上电 / 0断电
+        SetAngleTransmission,   // args[0]: 1启用角度透传
+        SetRealtimePush,        // args[0]: 周期, args[1]: 端口; text: 上报目标IP
+        SetTeachFrame,          // args[0]: 示教参考坐标系类型
+        SetToolFrame,           // text: 工具坐标系名称
+        GripperPick,            // args[0]: 速度, args[1]: 力控阈值, args[2]: 阻塞
+        GripperRelease,         // args[0]: 速度, args[1]: 阻塞
+        WriteSingleRegister,    // args[0..3]: 端口, 地址, 数据, 设备
+        GetArmState             // 查询当前位姿和错误码
+    };
+
+    static const size_t kTextCapacity = 32;
+
+    Type type;
+    int args[4];
+    char text[kTextCapacity];
+
+    static ArmCommand make(Type type, int a0 = 0, int a1 = 0, int a2 = 0, int a3 = 0,
+                           const std::string& text = std::string()) {
+        ArmCommand command;
+        command.type = type;
+        command.args[0] = a0;
+        command.args[1] = a1;
+        command.args[2] = a2;
+        command.args[3] = a3;
+        size_t length = text.size() < kTextCapacity - 1 ? text.size() : kTextCapacity - 1;
+        memcpy(command.text, text.data(), length);
+        command.text[length] = '\0';
+        return command;
+    }
+
+    /**
+     * @brief 指令名（与JSON协议的 command 字段一致，用于日志和统计）
+     */
+    const char* name() const {
+        switch (type) {
+            case SetArmPower:          return "set_arm_power";
+            case SetAngleTransmission: return "set_angle_transmission";
+            case SetRealtimePush:      return "set_realtime_push";
+            case SetTeachFrame:        return "set_teach_frame";
+            case SetToolFrame:         return "set_tool_coordinate";
+            case GripperPick:          return "set_gripper_pick";
+            case GripperRelease:       return "set_gripper_release";
+            case WriteSingleRegister:  return "write_single_register";
+            case GetArmState:          return "get_current_arm_state";
+        }
+        return "unknown";
+    }
+};
+
+/**
+ * @class ArmTransport
+ * @brief ArmController 之下的可替换传输后端
+ *
+ * 每个后端有一个“服务线程”（JSON后端为共用的通信反应器线程，RM_API2后端为
+ * 每个机械臂自己的线程），Listener 回调、streamPose/streamJoints/send 以及
+ * 指令完成回调都只在服务线程中执行，ArmController 的管线出队、锚点查询和
+ * 设置序列因此与后端无关。connect/disconnect/isConnected/printStats 可在任意线程调用。
+ *
+ * 后端在 [robotN] transport 中选择：json（默认）或 rm_api2（需编译时启用 USE_RM_API2）。
+ */
+class ArmTransport {
+public:
+    /**
+     * @brief 指令完成回调：response 为空表示失败、超时或连接断开
+     */
+    typedef std::function<void(const ArmResponse* response)> Callback;
+
+    /**
+     * @class Listener
+     * @brief 后端事件（全部在服务线程中调用）
+     */
+    class Listener {
+    public:
+        virtual ~Listener() {}
+
+        /** 连接建立（首次或重连），负责重放设置序列 */
+        virtual void onTransportConnected(ArmTransport& transport) = 0;
+
+        /** 连接断开，在途指令已以空响应完成 */
+        virtual void onTransportDisconnected(ArmTransport& transport) = 0;
+
+        /** 服务线程的周期节拍（无论连接是否打开） */
+        virtual void onTransportTick(ArmTransport& transport, uint64_t nowNs) = 0;
+
+        /** 收到带位姿的机械臂状态（查询响应或未请求的上报） */
+        virtual void onArmState(ArmTransport& transport, const ArmResponse& response) = 0;
+    };
+
+    virtual ~ArmTransport() {}
+
+    /** 后端名称（json / rm_api2） */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief 绑定事件接收者和日志来源（connect 之前调用一次）
+     */
+    virtual void attach(Listener* listener, uint16_t logSource) = 0;
+
+    /** 发起连接（立即返回），失败或断开后在后台自动重连 */
+    virtual bool connect() = 0;
+
+    /** 关闭连接且不再重连（等待服务线程完成关闭） */
+    virtual void disconnect() = 0;
+
+    virtual bool isConnected() const = 0;
+
+    /** 连接尝试失败的累计次数（启动时据此判断首次连接已失败，不必等到超时） */
+    virtual uint64_t getConnectFailures() const = 0;
+
+    /** 当前线程是否为服务线程 */
+    virtual bool isServiceThread() const = 0;
+
+    /**
+     * @brief 发送一帧笛卡尔跟随目标（服务线程，非阻塞，最新帧优先）
+     * @param pose 目标位姿（微米/毫弧度）
+     */
+    virtual bool streamPose(const std::array<int, 6>& pose) = 0;
+
+    /**
+     * @brief 发送一帧关节角度透传（服务线程，非阻塞，最新帧优先）
+     * @param joints 关节角度（度）
+     */
+    virtual bool streamJoints(const std::array<double, 6>& joints) = 0;
+
+    /**
+     * @brief 发出一条指令（服务线程，不等待响应）
+     * @param timeoutNs 单次等待响应的时长
+     * @param retries 失败/超时后的重发次数（只用于幂等的查询）
+     * @param callback 完成回调（服务线程中调用，可为空）
+     * @return 未能发出时返回false，此时不会调用 callback
+     */
+    virtual bool send(const ArmCommand& command, uint64_t timeoutNs, int retries, const Callback& callback) = 0;
+
+    /**
+     * @brief 打印后端的指令统计
+     */
+    virtual void printStats(std::ostream& os, const std::string& prefix) const = 0;
+};
+
+#endif // ARMTRANSPORT_H
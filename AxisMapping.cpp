@@ -0,0 +1,241 @@
+#include "AxisMapping.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+template <int S0, int S1, int S2>
+void AxisMapping::permutedAffine(const AxisMapping& mapping, const double* in, double* out) {
+    out[0] = mapping.m_gain[0] * in[S0] + mapping.m_offset[0];
+    out[1] = mapping.m_gain[1] * in[S1] + mapping.m_offset[1];
+    out[2] = mapping.m_gain[2] * in[S2] + mapping.m_offset[2];
+}
+
+template <int S0, int S1, int S2>
+void AxisMapping::permutedLinear(const AxisMapping& mapping, const double* in, double* out) {
+    out[0] = mapping.m_gain[0] * in[S0];
+    out[1] = mapping.m_gain[1] * in[S1];
+    out[2] = mapping.m_gain[2] * in[S2];
+}
+
+void AxisMapping::genericAffine(const AxisMapping& mapping, const double* in, double* out) {
+    const double* m = mapping.m_matrix.data();
+    out[0] = m[0] * in[0] + m[1] * in[1] + m[2] * in[2] + m[3];
+    out[1] = m[4] * in[0] + m[5] * in[1] + m[6] * in[2] + m[7];
+    out[2] = m[8] * in[0] + m[9] * in[1] + m[10] * in[2] + m[11];
+}
+
+void AxisMapping::genericLinear(const AxisMapping& mapping, const double* in, double* out) {
+    const double* m = mapping.m_matrix.data();
+    out[0] = m[0] * in[0] + m[1] * in[1] + m[2] * in[2];
+    out[1] = m[4] * in[0] + m[5] * in[1] + m[6] * in[2];
+    out[2] = m[8] * in[0] + m[9] * in[1] + m[10] * in[2];
+}
+
+// 名称按目标X/Y/Z轴依次列出源轴
+const AxisMapping::KernelEntry AxisMapping::kKernelTable[AxisMapping::kPermutations] = {
+    {{0, 1, 2}, "perm_xyz", &AxisMapping::permutedAffine<0, 1, 2>, &AxisMapping::permutedLinear<0, 1, 2>},
+    {{0, 2, 1}, "perm_xzy", &AxisMapping::permutedAffine<0, 2, 1>, &AxisMapping::permutedLinear<0, 2, 1>},
+    {{1, 0, 2}, "perm_yxz", &AxisMapping::permutedAffine<1, 0, 2>, &AxisMapping::permutedLinear<1, 0, 2>},
+    {{1, 2, 0}, "perm_yzx", &AxisMapping::permutedAffine<1, 2, 0>, &AxisMapping::permutedLinear<1, 2, 0>},
+    {{2, 0, 1}, "perm_zxy", &AxisMapping::permutedAffine<2, 0, 1>, &AxisMapping::permutedLinear<2, 0, 1>},
+    {{2, 1, 0}, "perm_zyx", &AxisMapping::permutedAffine<2, 1, 0>, &AxisMapping::permutedLinear<2, 1, 0>},
+};
+
+AxisMapping::AxisMapping() : m_scale(1.0), m_mode(KernelAuto) {
+    m_matrix.fill(0.0);
+    for (int i = 0; i < 3; ++i) {
+        m_matrix[i * 4 + i] = 1.0;
+        m_source[i] = i;
+        m_sign[i] = 1;
+    }
+    selectKernel(KernelAuto);
+}
+
+AxisMapping AxisMapping::compile(const int source[3], const int sign[3], double scale,
+                                 const Vec3& offset, KernelMode mode) {
+    AxisMapping mapping;
+    mapping.m_matrix.fill(0.0);
+    for (int i = 0; i < 3; ++i) {
+        int column = (source[i] >= 0 && source[i] < 3) ? source[i] : i;
+        mapping.m_matrix[i * 4 + column] = static_cast<double>(sign[i]) * scale;
+        mapping.m_matrix[i * 4 + 3] = offset[i];
+        mapping.m_source[i] = column;
+        mapping.m_sign[i] = sign[i];
+    }
+    mapping.m_scale = scale;
+    mapping.m_mode = mode;
+    mapping.selectKernel(mode);
+    return mapping;
+}
+
+AxisMapping AxisMapping::withScale(double scale) const {
+    Vec3 offset = {{m_matrix[3], m_matrix[7], m_matrix[11]}};
+    return compile(m_source, m_sign, scale, offset, m_mode);
+}
+
+AxisMapping AxisMapping::inverse() const {
+    const double* m = m_matrix.data();
+    double a[9] = {m[0], m[1], m[2], m[4], m[5], m[6], m[8], m[9], m[10]};
+
+    // 伴随矩阵 / 行列式
+    double inv[9] = {
+        a[4] * a[8] - a[5] * a[7], a[2] * a[7] - a[1] * a[8], a[1] * a[5] - a[2] * a[4],
+        a[5] * a[6] - a[3] * a[8], a[0] * a[8] - a[2] * a[6], a[2] * a[3] - a[0] * a[5],
+        a[3] * a[7] - a[4] * a[6], a[1] * a[6] - a[0] * a[7], a[0] * a[4] - a[1] * a[3]
+    };
+    double det = a[0] * inv[0] + a[1] * inv[3] + a[2] * inv[6];
+    double maxEntry = 0.0;
+    for (int i = 0; i < 9; ++i) {
+        maxEntry = std::max(maxEntry, std::fabs(a[i]));
+    }
+
+    if (std::fabs(det) > 1e-12 * maxEntry * maxEntry * maxEntry && maxEntry > 0.0) {
+        for (int i = 0; i < 9; ++i) {
+            inv[i] /= det;
+        }
+    } else {
+        // 轴索引重复时不可逆：与轴置换矩阵的逆（转置）保持一致
+        for (int row = 0; row < 3; ++row) {
+            double norm = a[row * 3] * a[row * 3] + a[row * 3 + 1] * a[row * 3 + 1] + a[row * 3 + 2] * a[row * 3 + 2];
+            double k = norm > 0.0 ? 1.0 / norm : 0.0;
+            for (int column = 0; column < 3; ++column) {
+                inv[column * 3 + row] = a[row * 3 + column] * k;
+            }
+        }
+    }
+
+    AxisMapping result;
+    for (int i = 0; i < 3; ++i) {
+        result.m_matrix[i * 4] = inv[i * 3];
+        result.m_matrix[i * 4 + 1] = inv[i * 3 + 1];
+        result.m_matrix[i * 4 + 2] = inv[i * 3 + 2];
+        result.m_matrix[i * 4 + 3] = -(inv[i * 3] * m[3] + inv[i * 3 + 1] * m[7] + inv[i * 3 + 2] * m[11]);
+        result.m_source[i] = i;
+        result.m_sign[i] = 1;
+    }
+    result.m_scale = m_scale != 0.0 ? 1.0 / m_scale : 0.0;
+    result.m_mode = m_mode;
+    result.selectKernel(m_mode);
+    if (result.m_permutation >= 0) {
+        for (int i = 0; i < 3; ++i) {
+            result.m_source[i] = kKernelTable[result.m_permutation].source[i];
+            result.m_sign[i] = result.m_gain[i] < 0.0 ? -1 : 1;
+        }
+    }
+    return result;
+}
+
+const char* AxisMapping::kernelName() const {
+    return m_permutation >= 0 ? kKernelTable[m_permutation].name : "generic";
+}
+
+void AxisMapping::selectKernel(KernelMode mode) {
+    m_permutation = -1;
+    m_affineKernel = &AxisMapping::genericAffine;
+    m_linearKernel = &AxisMapping::genericLinear;
+
+    int columns[3];
+    for (int i = 0; i < 3; ++i) {
+        m_offset[i] = m_matrix[i * 4 + 3];
+        m_gain[i] = 0.0;
+        columns[i] = -1;
+        for (int column = 0; column < 3; ++column) {
+            if (m_matrix[i * 4 + column] == 0.0) {
+                continue;
+            }
+            if (columns[i] >= 0) {
+                return;  // 一行有多个非零元
+            }
+            columns[i] = column;
+            m_gain[i] = m_matrix[i * 4 + column];
+        }
+        if (columns[i] < 0) {
+            return;  // 系数为0的行
+        }
+    }
+    if (mode == KernelGeneric) {
+        return;
+    }
+
+    for (int p = 0; p < kPermutations; ++p) {
+        const int* source = kKernelTable[p].source;
+        if (source[0] == columns[0] && source[1] == columns[1] && source[2] == columns[2]) {
+            m_permutation = p;
+            m_affineKernel = kKernelTable[p].affine;
+            m_linearKernel = kKernelTable[p].linear;
+            return;
+        }
+    }
+}
+
+bool AxisMapping::benchmark(std::ostream& os, const char* label, const int source[3], const int sign[3],
+                            double scale, const Vec3& offset, uint64_t iterations) {
+    // 固定的输入集合（±100mm范围内的设备坐标），循环使用
+    static const int kInputs = 256;
+    Vec3 inputs[kInputs];
+    uint32_t seed = 12345;
+    for (int i = 0; i < kInputs; ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            seed = seed * 1664525u + 1013904223u;
+            inputs[i][axis] = (static_cast<double>(seed >> 8) / 16777216.0 - 0.5) * 200.0;
+        }
+    }
+
+    AxisMapping variants[2] = {
+        compile(source, sign, scale, offset, KernelGeneric),
+        compile(source, sign, scale, offset, KernelAuto)
+    };
+
+    // 结果一致性：正向、线性，以及（轴置换可逆时）正逆往返
+    bool invertible = variants[1].isSpecialized();
+    bool consistent = true;
+    for (int i = 0; i < kInputs && consistent; ++i) {
+        Vec3 expected = variants[0].apply(inputs[i]);
+        Vec3 actual = variants[1].apply(inputs[i]);
+        Vec3 expectedLinear = variants[0].applyLinear(inputs[i]);
+        Vec3 actualLinear = variants[1].applyLinear(inputs[i]);
+        Vec3 roundTrip = variants[1].inverse().apply(actual);
+        for (int axis = 0; axis < 3; ++axis) {
+            double tolerance = 1e-9 * (1.0 + std::fabs(expected[axis]));
+            if (std::fabs(expected[axis] - actual[axis]) > tolerance ||
+                std::fabs(expectedLinear[axis] - actualLinear[axis]) > tolerance ||
+                (invertible && std::fabs(roundTrip[axis] - inputs[i][axis]) > 1e-9 * (1.0 + std::fabs(inputs[i][axis])))) {
+                consistent = false;
+            }
+        }
+    }
+
+    os << "  " << std::left << std::setw(12) << label << std::right;
+    for (int v = 0; v < 2; ++v) {
+        // 经volatile指针访问映射，避免编译器把内核选择常量化
+        AxisMapping forward = variants[v];
+        AxisMapping backward = variants[v].inverse();
+        const AxisMapping* volatile forwardPtr = &forward;
+        const AxisMapping* volatile backwardPtr = &backward;
+        double nsPerCall[3];
+        double checksum = 0.0;
+        for (int kind = 0; kind < 3; ++kind) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (uint64_t n = 0; n < iterations; ++n) {
+                const Vec3& in = inputs[n & (kInputs - 1)];
+                Vec3 out = kind == 0 ? forwardPtr->apply(in)
+                         : kind == 1 ? forwardPtr->applyLinear(in)
+                         : backwardPtr->apply(in);
+                checksum += out[0] + out[1] + out[2];
+            }
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            nsPerCall[kind] = iterations > 0
+                ? std::chrono::duration<double, std::nano>(end - start).count() / iterations : 0.0;
+        }
+        volatile double sink = checksum;
+        (void)sink;
+        os << "  " << std::setw(8) << forward.kernelName() << std::fixed << std::setprecision(2)
+           << " 正向 " << std::setw(5) << nsPerCall[0] << "ns 线性 " << std::setw(5) << nsPerCall[1]
+           << "ns 逆向 " << std::setw(5) << nsPerCall[2] << "ns";
+    }
+    os << (consistent ? "  ✅" : "  ❌ 结果不一致") << std::endl;
+    os.unsetf(std::ios::fixed);
+    return consistent;
+}
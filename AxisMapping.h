@@ -0,0 +1,129 @@
+#ifndef AXISMAPPING_H
+#define AXISMAPPING_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @class AxisMapping
+ * @brief 触觉设备坐标 → 机械臂坐标的预编译仿射映射（轴置换 × 符号 × 系数 + 偏移）
+ *
+ * 配置加载（或离合时系数变化）时调用 compile() 合成一个3x4齐次变换
+ * out = A * in + t，并按轴置换选择专用内核：
+ * - 6种轴置换各有一个模板实例化的内核，源轴索引是编译期常量，
+ *   每轴只有一次乘加（符号和系数已合并进每行的增益）
+ * - 轴索引重复等非置换配置使用通用3x3矩阵内核
+ * 内核经函数指针表选择，伺服线程每帧只做一次间接调用，无分支、无分配。
+ * inverse() 给出机械臂 → 触觉设备方向的映射（同样使用专用内核），供力反馈使用。
+ */
+class AxisMapping {
+public:
+    typedef std::array<double, 3> Vec3;
+    typedef std::array<double, 12> Affine;   // 3x4 行优先 [A | t]
+
+    enum KernelMode {
+        KernelAuto,      // 轴置换使用专用内核，其余使用通用内核
+        KernelGeneric    // 总是使用通用矩阵内核（基准测试对照）
+    };
+
+    AxisMapping();
+
+    /**
+     * @brief 合成映射：目标第i轴 = sign[i] * scale * 源第source[i]轴 + offset[i]
+     * @param source 源轴索引 (0=X,1=Y,2=Z)，越界时取 i
+     * @param sign 符号 (1或-1)
+     * @param scale 系数
+     * @param offset 目标坐标系中的偏移
+     */
+    static AxisMapping compile(const int source[3], const int sign[3], double scale,
+                               const Vec3& offset, KernelMode mode = KernelAuto);
+
+    /**
+     * @brief 逆映射（机械臂 → 触觉设备）；线性部分奇异时退回转置除以行范数平方
+     */
+    AxisMapping inverse() const;
+
+    /**
+     * @brief 保持轴置换、符号、偏移和内核模式，以新系数重新合成
+     */
+    AxisMapping withScale(double scale) const;
+
+    /**
+     * @brief 完整仿射变换 out = A * in + t（位置）
+     */
+    Vec3 apply(const Vec3& in) const {
+        Vec3 out;
+        m_affineKernel(*this, in.data(), out.data());
+        return out;
+    }
+
+    /**
+     * @brief 只用线性部分 out = A * in（速度、旋转向量等增量）
+     */
+    Vec3 applyLinear(const Vec3& in) const {
+        Vec3 out;
+        m_linearKernel(*this, in.data(), out.data());
+        return out;
+    }
+
+    const Affine& matrix() const { return m_matrix; }
+
+    /**
+     * @brief 配置的源轴索引和符号（调试日志用）
+     */
+    int source(int axis) const { return m_source[axis]; }
+    int sign(int axis) const { return m_sign[axis]; }
+    double scale() const { return m_scale; }
+
+    bool isSpecialized() const { return m_permutation >= 0; }
+
+    /**
+     * @brief 内核名称，例如 "perm_zxy" 或 "generic"
+     */
+    const char* kernelName() const;
+
+    /**
+     * @brief 微基准：对同一组输入分别用通用内核和本映射的内核各执行 iterations 次
+     *        正向、逆向和线性变换，输出每次调用的耗时并校验结果一致
+     * @return 专用内核与通用内核结果一致时返回true
+     */
+    static bool benchmark(std::ostream& os, const char* label, const int source[3], const int sign[3],
+                          double scale, const Vec3& offset, uint64_t iterations);
+
+private:
+    typedef void (*Kernel)(const AxisMapping& mapping, const double* in, double* out);
+
+    struct KernelEntry {
+        int source[3];
+        const char* name;
+        Kernel affine;
+        Kernel linear;
+    };
+
+    static const int kPermutations = 6;
+    static const KernelEntry kKernelTable[kPermutations];
+
+    template <int S0, int S1, int S2>
+    static void permutedAffine(const AxisMapping& mapping, const double* in, double* out);
+    template <int S0, int S1, int S2>
+    static void permutedLinear(const AxisMapping& mapping, const double* in, double* out);
+    static void genericAffine(const AxisMapping& mapping, const double* in, double* out);
+    static void genericLinear(const AxisMapping& mapping, const double* in, double* out);
+
+    // 按线性部分的结构（每行恰有一个非零元、各列互不相同）选择内核
+    void selectKernel(KernelMode mode);
+
+    Affine m_matrix;       // 通用内核使用
+    double m_gain[3];      // 专用内核：第i行唯一非零元
+    double m_offset[3];
+    int m_source[3];
+    int m_sign[3];
+    double m_scale;
+    KernelMode m_mode;
+    int m_permutation;     // kKernelTable 索引，通用内核为 -1
+    Kernel m_affineKernel;
+    Kernel m_linearKernel;
+};
+
+#endif // AXISMAPPING_H
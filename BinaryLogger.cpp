@@ -0,0 +1,328 @@
+#include "BinaryLogger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+
+namespace {
+
+const char* const kEventFormats[] = {
+#define TOUCH_LOG_EVENT_FORMAT(name, format) format,
+    TOUCH_LOG_EVENTS(TOUCH_LOG_EVENT_FORMAT)
+#undef TOUCH_LOG_EVENT_FORMAT
+};
+
+// 每个线程的日志缓冲指针（首次使用时注册）
+thread_local void* t_threadBuffer = nullptr;
+
+} // namespace
+
+BinaryLogger& BinaryLogger::instance() {
+    static BinaryLogger logger;
+    return logger;
+}
+
+BinaryLogger::BinaryLogger()
+    : m_running(false), m_bufferCount(0),
+      m_sink(Console), m_maxFileBytes(10 * 1024 * 1024), m_maxFiles(3),
+      m_fileBytes(0), m_reportedDrops(0), m_wallOffsetNs(0) {
+    // 来源ID 0 保留为“无来源”
+    m_sources.push_back("");
+}
+
+BinaryLogger::~BinaryLogger() {
+    stop();
+    // 缓冲在进程生命周期内保持有效，线程退出后也不释放
+    size_t count = m_bufferCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        delete m_buffers[i];
+    }
+}
+
+uint64_t BinaryLogger::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void BinaryLogger::configure(Sink sink, const std::string& filename, size_t maxFileBytes, int maxFiles) {
+    m_sink = sink;
+    m_filename = filename;
+    m_maxFileBytes = maxFileBytes;
+    m_maxFiles = maxFiles < 1 ? 1 : maxFiles;
+}
+
+void BinaryLogger::start() {
+    if (m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    int64_t wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    m_wallOffsetNs = wallNs - static_cast<int64_t>(nowNs());
+
+    if (m_sink == File) {
+        m_file.open(m_filename.c_str(), std::ios::out | std::ios::app);
+        if (!m_file.is_open()) {
+            std::cerr << "警告：无法打开日志文件 " << m_filename << "，日志将输出到控制台" << std::endl;
+            m_sink = Console;
+        } else {
+            m_file.seekp(0, std::ios::end);
+            m_fileBytes = static_cast<size_t>(m_file.tellp());
+        }
+    }
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&BinaryLogger::run, this);
+
+    if (m_sink == File) {
+        std::cout << "📝 二进制日志已启动，输出到文件: " << m_filename << std::endl;
+    } else {
+        std::cout << "📝 二进制日志已启动，输出到控制台" << std::endl;
+    }
+}
+
+void BinaryLogger::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    uint64_t drops = getDropCount();
+    if (drops > 0) {
+        std::cout << "⚠️  二进制日志共丢弃 " << drops << " 条记录（缓冲区已满）" << std::endl;
+    }
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+}
+
+uint16_t BinaryLogger::registerSource(const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    m_sources.push_back(name);
+    return static_cast<uint16_t>(m_sources.size() - 1);
+}
+
+BinaryLogger::ThreadBuffer* BinaryLogger::currentBuffer() {
+    if (t_threadBuffer) {
+        return static_cast<ThreadBuffer*>(t_threadBuffer);
+    }
+
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    size_t count = m_bufferCount.load(std::memory_order_relaxed);
+    if (count >= kMaxThreads) {
+        return nullptr;
+    }
+    ThreadBuffer* buffer = new ThreadBuffer();
+    m_buffers[count] = buffer;
+    m_bufferCount.store(count + 1, std::memory_order_release);
+    t_threadBuffer = buffer;
+    return buffer;
+}
+
+void BinaryLogger::prepareThread() {
+    currentBuffer();
+}
+
+void BinaryLogger::push(const LogRecord& record) {
+    ThreadBuffer* buffer = currentBuffer();
+    if (!buffer) {
+        return;
+    }
+    if (!buffer->queue.tryPush(record)) {
+        buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+void BinaryLogger::logText(LogEvent event, uint16_t sourceId, const char* text, size_t length) {
+    if (!m_running.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ThreadBuffer* buffer = currentBuffer();
+    if (!buffer) {
+        return;
+    }
+
+    if (length > kMaxTextLength) {
+        length = kMaxTextLength;
+    }
+
+    LogRecord record;
+    const size_t chunkSize = sizeof(record.text);
+    size_t chunks = length == 0 ? 1 : (length + chunkSize - 1) / chunkSize;
+
+    // 先确认剩余空间足够放下全部分片，避免写入半条文本（只有消费者会增加空间）
+    if (buffer->queue.size() + chunks > buffer->queue.capacity()) {
+        buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    record.timestampNs = nowNs();
+    record.eventId = static_cast<uint16_t>(event);
+    record.sourceId = sourceId;
+    record.kind = LogRecord::Text;
+    record.reserved = 0;
+
+    size_t offset = 0;
+    for (size_t i = 0; i < chunks; ++i) {
+        size_t n = std::min(chunkSize, length - offset);
+        memcpy(record.text, text + offset, n);
+        record.textLength = static_cast<uint8_t>(n);
+        record.lastChunk = (i + 1 == chunks) ? 1 : 0;
+        buffer->queue.tryPush(record);
+        offset += n;
+    }
+}
+
+uint64_t BinaryLogger::getDropCount() const {
+    uint64_t total = 0;
+    size_t count = m_bufferCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        total += m_buffers[i]->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::string BinaryLogger::formatPrefix(uint64_t timestampNs, uint16_t sourceId) {
+    int64_t wallNs = static_cast<int64_t>(timestampNs) + m_wallOffsetNs;
+    time_t seconds = static_cast<time_t>(wallNs / 1000000000);
+    int millis = static_cast<int>((wallNs / 1000000) % 1000);
+
+    struct tm local;
+    localtime_r(&seconds, &local);
+
+    char prefix[32];
+    snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%03d ",
+             local.tm_hour, local.tm_min, local.tm_sec, millis);
+
+    std::string result(prefix);
+    if (sourceId != 0) {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        if (sourceId < m_sources.size()) {
+            result += "[" + m_sources[sourceId] + "] ";
+        }
+    }
+    return result;
+}
+
+void BinaryLogger::formatRecord(ThreadBuffer& buffer, const LogRecord& record,
+                                std::vector<FormattedLine>& lines) {
+    const char* format = record.eventId < LOG_EVENT_COUNT ? kEventFormats[record.eventId] : "未知事件";
+    char message[2048];
+
+    if (record.kind == LogRecord::Text) {
+        if (buffer.pendingText.empty()) {
+            buffer.textStartNs = record.timestampNs;
+            buffer.textEvent = record.eventId;
+            buffer.textSource = record.sourceId;
+        }
+        buffer.pendingText.append(record.text, record.textLength);
+        if (!record.lastChunk) {
+            return;
+        }
+        format = buffer.textEvent < LOG_EVENT_COUNT ? kEventFormats[buffer.textEvent] : "%s";
+        snprintf(message, sizeof(message), format, buffer.pendingText.c_str());
+
+        FormattedLine line;
+        line.timestampNs = buffer.textStartNs;
+        line.text = formatPrefix(buffer.textStartNs, buffer.textSource) + message;
+        lines.push_back(line);
+        buffer.pendingText.clear();
+        return;
+    }
+
+    snprintf(message, sizeof(message), format,
+             record.fields[0], record.fields[1], record.fields[2],
+             record.fields[3], record.fields[4], record.fields[5]);
+
+    FormattedLine line;
+    line.timestampNs = record.timestampNs;
+    line.text = formatPrefix(record.timestampNs, record.sourceId) + message;
+    lines.push_back(line);
+}
+
+size_t BinaryLogger::drain(std::vector<FormattedLine>& lines) {
+    size_t count = m_bufferCount.load(std::memory_order_acquire);
+    size_t records = 0;
+    LogRecord record;
+
+    for (size_t i = 0; i < count; ++i) {
+        ThreadBuffer& buffer = *m_buffers[i];
+        while (buffer.queue.tryPop(record)) {
+            formatRecord(buffer, record, lines);
+            ++records;
+        }
+    }
+
+    // 各线程缓冲内部有序，合并后按时间戳排序输出
+    std::stable_sort(lines.begin(), lines.end());
+    for (size_t i = 0; i < lines.size(); ++i) {
+        write(lines[i].text);
+    }
+    lines.clear();
+
+    uint64_t drops = getDropCount();
+    if (drops != m_reportedDrops) {
+        char message[96];
+        snprintf(message, sizeof(message), "⚠️  [日志] 缓冲区已满，新丢弃 %llu 条记录",
+                 static_cast<unsigned long long>(drops - m_reportedDrops));
+        write(formatPrefix(nowNs(), 0) + message);
+        m_reportedDrops = drops;
+    }
+
+    if (records > 0) {
+        if (m_sink == File) {
+            m_file.flush();
+        } else {
+            std::cout.flush();
+        }
+    }
+    return records;
+}
+
+void BinaryLogger::write(const std::string& line) {
+    if (m_sink == File) {
+        rotateIfNeeded();
+        m_file << line << '\n';
+        m_fileBytes += line.size() + 1;
+    } else {
+        std::cout << line << '\n';
+    }
+}
+
+void BinaryLogger::rotateIfNeeded() {
+    if (m_fileBytes < m_maxFileBytes) {
+        return;
+    }
+
+    m_file.close();
+    // file.(n-1) → file.n, ..., file → file.1
+    for (int i = m_maxFiles - 1; i >= 1; --i) {
+        std::string from = m_filename + "." + std::to_string(i);
+        std::string to = m_filename + "." + std::to_string(i + 1);
+        std::rename(from.c_str(), to.c_str());
+    }
+    std::string first = m_filename + ".1";
+    std::rename(m_filename.c_str(), first.c_str());
+
+    m_file.open(m_filename.c_str(), std::ios::out | std::ios::trunc);
+    m_fileBytes = 0;
+}
+
+void BinaryLogger::run() {
+    std::vector<FormattedLine> lines;
+    lines.reserve(kBufferCapacity);
+
+    while (m_running.load(std::memory_order_acquire)) {
+        if (drain(lines) == 0) {
+            // 生产者从不唤醒格式化线程，空闲时定期轮询
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+
+    // 退出前输出剩余记录
+    drain(lines);
+}
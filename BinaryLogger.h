@@ -0,0 +1,198 @@
+#ifndef BINARYLOGGER_H
+#define BINARYLOGGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LogEvents.h"
+#include "SpscQueue.h"
+
+/**
+ * @struct LogRecord
+ * @brief 定长二进制日志记录（64字节，一条缓存行）
+ *
+ * 数值记录携带最多6个double字段；文本记录把原始字节切分为48字节的分片，
+ * 同一条文本的分片在线程缓冲中连续存放，由格式化线程重新拼接。
+ */
+struct LogRecord {
+    enum Kind { Numeric = 0, Text = 1 };
+
+    uint64_t timestampNs;   // 单调时钟时间戳（纳秒）
+    uint16_t eventId;       // LogEvent
+    uint16_t sourceId;      // registerSource() 返回的来源ID，0表示无来源
+    uint8_t kind;           // Numeric / Text
+    uint8_t textLength;     // 文本分片有效字节数
+    uint8_t lastChunk;      // 文本的最后一个分片
+    uint8_t reserved;
+    union {
+        double fields[6];
+        char text[48];
+    };
+};
+
+/**
+ * @class BinaryLogger
+ * @brief 控制热路径使用的无锁二进制日志
+ *
+ * 特性：
+ * - 每个线程一个SPSC环形缓冲，log() 只写入时间戳、事件ID和原始数值，不做格式化、不加锁、不进行系统调用
+ * - 缓冲区满时直接丢弃并计数，从不阻塞调用线程
+ * - 后台格式化线程按时间戳合并各线程记录，输出到控制台或按大小轮转的日志文件
+ *
+ * 线程首次记录日志时会分配自己的缓冲（加锁一次），
+ * 实时线程应在进入循环前调用 prepareThread()。
+ */
+class BinaryLogger {
+public:
+    enum Sink { Console, File };
+
+    static BinaryLogger& instance();
+
+    /**
+     * @brief 配置输出目标（须在start()之前调用）
+     * @param sink 输出目标
+     * @param filename 日志文件名（File模式）
+     * @param maxFileBytes 单个日志文件最大字节数，超过后轮转
+     * @param maxFiles 保留的历史文件数量
+     */
+    void configure(Sink sink, const std::string& filename, size_t maxFileBytes, int maxFiles);
+
+    /**
+     * @brief 启动后台格式化线程
+     */
+    void start();
+
+    /**
+     * @brief 停止后台格式化线程并输出剩余记录
+     */
+    void stop();
+
+    /**
+     * @brief 注册日志来源（如设备名、机械臂名），在初始化阶段调用
+     * @return 来源ID
+     */
+    uint16_t registerSource(const std::string& name);
+
+    /**
+     * @brief 为当前线程预先分配日志缓冲
+     */
+    void prepareThread();
+
+    /**
+     * @brief 记录数值事件（wait-free）
+     * @param event 事件ID
+     * @param sourceId 来源ID
+     * @param args 最多6个数值字段
+     */
+    template <typename... Args>
+    void log(LogEvent event, uint16_t sourceId, Args... args) {
+        static_assert(sizeof...(Args) <= 6, "日志事件最多6个数值字段");
+        if (!m_running.load(std::memory_order_relaxed)) {
+            return;
+        }
+        LogRecord record;
+        record.timestampNs = nowNs();
+        record.eventId = static_cast<uint16_t>(event);
+        record.sourceId = sourceId;
+        record.kind = LogRecord::Numeric;
+        record.textLength = 0;
+        record.lastChunk = 1;
+        record.reserved = 0;
+        const double values[6] = { static_cast<double>(args)... };
+        memcpy(record.fields, values, sizeof(values));
+        push(record);
+    }
+
+    /**
+     * @brief 记录文本事件（只拷贝原始字节，格式串中对应一个 %s）
+     * @param event 事件ID
+     * @param sourceId 来源ID
+     * @param text 文本内容
+     * @param length 文本长度（超过 kMaxTextLength 时截断）
+     */
+    void logText(LogEvent event, uint16_t sourceId, const char* text, size_t length);
+
+    void logText(LogEvent event, uint16_t sourceId, const std::string& text) {
+        logText(event, sourceId, text.data(), text.size());
+    }
+
+    void logText(LogEvent event, uint16_t sourceId, const char* text) {
+        logText(event, sourceId, text, strlen(text));
+    }
+
+    /**
+     * @brief 所有线程累计丢弃的记录数
+     */
+    uint64_t getDropCount() const;
+
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    static uint64_t nowNs();
+
+    static const size_t kBufferCapacity = 2048;
+    static const size_t kMaxTextLength = 1024;
+
+private:
+    struct ThreadBuffer {
+        ThreadBuffer() : dropped(0), textStartNs(0), textEvent(0), textSource(0) {}
+
+        SpscQueue<LogRecord, kBufferCapacity> queue;
+        std::atomic<uint64_t> dropped;   // 仅所属线程写
+
+        // 以下仅格式化线程访问：跨多轮读取拼接文本
+        std::string pendingText;
+        uint64_t textStartNs;
+        uint16_t textEvent;
+        uint16_t textSource;
+    };
+
+    struct FormattedLine {
+        uint64_t timestampNs;
+        std::string text;
+        bool operator<(const FormattedLine& other) const { return timestampNs < other.timestampNs; }
+    };
+
+    BinaryLogger();
+    ~BinaryLogger();
+    BinaryLogger(const BinaryLogger&);
+    BinaryLogger& operator=(const BinaryLogger&);
+
+    ThreadBuffer* currentBuffer();
+    void push(const LogRecord& record);
+
+    void run();
+    size_t drain(std::vector<FormattedLine>& lines);
+    void formatRecord(ThreadBuffer& buffer, const LogRecord& record, std::vector<FormattedLine>& lines);
+    std::string formatPrefix(uint64_t timestampNs, uint16_t sourceId);
+    void write(const std::string& line);
+    void rotateIfNeeded();
+
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+
+    static const size_t kMaxThreads = 64;
+
+    std::mutex m_registryMutex;   // 只在注册线程/来源和格式化来源名称时使用
+    ThreadBuffer* m_buffers[kMaxThreads];   // 只追加，先写槽位再以release发布数量
+    std::atomic<size_t> m_bufferCount;
+    std::vector<std::string> m_sources;
+
+    Sink m_sink;
+    std::string m_filename;
+    size_t m_maxFileBytes;
+    int m_maxFiles;
+    std::ofstream m_file;
+    size_t m_fileBytes;
+    uint64_t m_reportedDrops;
+
+    // 单调时钟到系统时钟的偏移，用于格式化墙上时间
+    int64_t m_wallOffsetNs;
+};
+
+#endif // BINARYLOGGER_H
@@ -0,0 +1,162 @@
+#include "CommandEncoder.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// 超过该值的关节角度视为无效（保证放大1e6后不溢出int64）
+const double kMaxFixedValue = 1e12;
+
+// 写入无符号整数，按两位一组从末尾向前填充
+char* formatUnsigned(char* out, uint64_t value) {
+    char digits[20];
+    char* p = digits + sizeof(digits);
+    while (value >= 100) {
+        unsigned pair = static_cast<unsigned>(value % 100) * 2;
+        value /= 100;
+        *--p = kDigitPairs[pair + 1];
+        *--p = kDigitPairs[pair];
+    }
+    if (value >= 10) {
+        unsigned pair = static_cast<unsigned>(value) * 2;
+        *--p = kDigitPairs[pair + 1];
+        *--p = kDigitPairs[pair];
+    } else {
+        *--p = static_cast<char>('0' + value);
+    }
+    size_t length = digits + sizeof(digits) - p;
+    memcpy(out, p, length);
+    return out + length;
+}
+
+char* append(char* out, const char* text) {
+    size_t length = strlen(text);
+    memcpy(out, text, length);
+    return out + length;
+}
+
+const char* boolText(bool value) {
+    return value ? "true" : "false";
+}
+
+} // namespace
+
+CommandEncoder::CommandEncoder()
+    : m_length(0), m_template(TemplateNone), m_prefixLength(0) {
+    m_buffer[0] = '\0';
+}
+
+char* CommandEncoder::formatInt(char* out, int64_t value) {
+    if (value < 0) {
+        *out++ = '-';
+        // 先转为无符号再取负，INT64_MIN 也不会溢出
+        return formatUnsigned(out, 0 - static_cast<uint64_t>(value));
+    }
+    return formatUnsigned(out, static_cast<uint64_t>(value));
+}
+
+char* CommandEncoder::formatFixed6(char* out, double value) {
+    if (!(std::fabs(value) < kMaxFixedValue)) {
+        return nullptr;   // NaN / Inf / 超范围
+    }
+    int64_t scaled = static_cast<int64_t>(std::llround(value * 1e6));
+    if (scaled < 0) {
+        *out++ = '-';
+        scaled = -scaled;
+    }
+    uint64_t integer = static_cast<uint64_t>(scaled) / 1000000;
+    uint32_t fraction = static_cast<uint32_t>(static_cast<uint64_t>(scaled) % 1000000);
+    out = formatUnsigned(out, integer);
+    *out++ = '.';
+    for (int i = 5; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    return out + 6;
+}
+
+char* CommandEncoder::begin(Template type, const char* prefix) {
+    if (m_template != type) {
+        m_prefixLength = strlen(prefix);
+        memcpy(m_buffer, prefix, m_prefixLength);
+        m_template = type;
+    }
+    return m_buffer + m_prefixLength;
+}
+
+size_t CommandEncoder::finish(char* end, const char* suffix) {
+    end = append(end, suffix);
+    m_length = end - m_buffer;
+    return m_length;
+}
+
+size_t CommandEncoder::encodeMovePFollow(const std::array<int, 6>& pose) {
+    char* p = begin(TemplateMovePFollow, "{ \"command\": \"movep_follow\", \"pose\": [");
+    for (int i = 0; i < 6; ++i) {
+        if (i > 0) {
+            *p++ = ',';
+            *p++ = ' ';
+        }
+        p = formatInt(p, pose[i]);
+    }
+    return finish(p, "] }\r\n");
+}
+
+size_t CommandEncoder::encodeJointAngles(const std::array<double, 6>& jointAngles) {
+    char* p = begin(TemplateJointAngles, "{ \"command\": \"set_joint_angle_transmission\", \"joint\": [");
+    for (int i = 0; i < 6; ++i) {
+        if (i > 0) {
+            *p++ = ',';
+            *p++ = ' ';
+        }
+        p = formatFixed6(p, jointAngles[i]);
+        if (!p) {
+            m_length = 0;
+            return 0;
+        }
+    }
+    return finish(p, "] }\r\n");
+}
+
+size_t CommandEncoder::encodeWriteSingleRegister(int port, int address, int data, int device) {
+    char* p = begin(TemplateWriteRegister, "{ \"command\": \"write_single_register\", \"port\": ");
+    p = formatInt(p, port);
+    p = append(p, ", \"address\": ");
+    p = formatInt(p, address);
+    p = append(p, ", \"data\": ");
+    p = formatInt(p, data);
+    p = append(p, ", \"device\": ");
+    p = formatInt(p, device);
+    return finish(p, " }\r\n");
+}
+
+size_t CommandEncoder::encodeGripperPick(int speed, int force, bool block) {
+    char* p = begin(TemplateGripperPick, "{ \"command\": \"set_gripper_pick\", \"speed\": ");
+    p = formatInt(p, speed);
+    p = append(p, ", \"force\": ");
+    p = formatInt(p, force);
+    p = append(p, ", \"block\": ");
+    p = append(p, boolText(block));
+    return finish(p, " }\r\n");
+}
+
+size_t CommandEncoder::encodeGripperRelease(int speed, bool block) {
+    char* p = begin(TemplateGripperRelease, "{ \"command\": \"set_gripper_release\", \"speed\": ");
+    p = formatInt(p, speed);
+    p = append(p, ", \"block\": ");
+    p = append(p, boolText(block));
+    return finish(p, " }\r\n");
+}
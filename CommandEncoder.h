@@ -0,0 +1,98 @@
+#ifndef COMMANDENCODER_H
+#define COMMANDENCODER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class CommandEncoder
+ * @brief 机械臂JSON指令编码器（固定缓冲区，零分配）
+ *
+ * 每个连接的每个发送线程持有一个实例。指令的固定前缀（如
+ * `{ "command": "movep_follow", "pose": [`）只在切换指令类型时拷贝一次，
+ * 之后每次编码只改写前缀之后的数值字段和结尾的 `] }\r\n`。
+ * 整数和定点小数为手写格式化，不经过iostream/locale，输出格式与原先
+ * ostringstream 生成的文本相同（定点小数在舍入边界上可能相差最后一位）。
+ */
+class CommandEncoder {
+public:
+    static const size_t kCapacity = 256;
+
+    CommandEncoder();
+
+    /**
+     * @brief movep_follow 笛卡尔跟随指令
+     * @param pose 目标位姿（微米/毫弧度）
+     * @return 帧长度（含\r\n）
+     */
+    size_t encodeMovePFollow(const std::array<int, 6>& pose);
+
+    /**
+     * @brief set_joint_angle_transmission 关节角度透传指令（6位小数）
+     * @return 帧长度，角度不是有限值时返回0（不应发送）
+     */
+    size_t encodeJointAngles(const std::array<double, 6>& jointAngles);
+
+    /**
+     * @brief write_single_register Modbus写单个寄存器指令
+     */
+    size_t encodeWriteSingleRegister(int port, int address, int data, int device);
+
+    /**
+     * @brief set_gripper_pick 夹爪力控抓取指令
+     */
+    size_t encodeGripperPick(int speed, int force, bool block);
+
+    /**
+     * @brief set_gripper_release 夹爪释放指令
+     */
+    size_t encodeGripperRelease(int speed, bool block);
+
+    /**
+     * @brief 最近一次编码的帧（含\r\n）
+     */
+    const char* data() const { return m_buffer; }
+    size_t size() const { return m_length; }
+
+    /**
+     * @brief 最近一次编码的JSON正文长度（不含\r\n，用于日志）
+     */
+    size_t payloadSize() const { return m_length >= 2 ? m_length - 2 : 0; }
+
+    /**
+     * @brief 写入十进制整数
+     * @return 写入后的末尾指针（调用者保证至少20字节空间）
+     */
+    static char* formatInt(char* out, int64_t value);
+
+    /**
+     * @brief 写入6位小数的定点数（等价于 std::fixed << std::setprecision(6)）
+     * @return 写入后的末尾指针，非有限值或超出范围时返回nullptr
+     */
+    static char* formatFixed6(char* out, double value);
+
+private:
+    CommandEncoder(const CommandEncoder&);
+    CommandEncoder& operator=(const CommandEncoder&);
+
+    enum Template {
+        TemplateNone,
+        TemplateMovePFollow,
+        TemplateJointAngles,
+        TemplateWriteRegister,
+        TemplateGripperPick,
+        TemplateGripperRelease
+    };
+
+    // 确保缓冲区以指定模板的前缀开头，返回前缀之后的写入位置
+    char* begin(Template type, const char* prefix);
+    size_t finish(char* end, const char* suffix);
+
+    char m_buffer[kCapacity];
+    size_t m_length;
+    Template m_template;
+    size_t m_prefixLength;
+};
+
+#endif // COMMANDENCODER_H
@@ -0,0 +1,80 @@
+#include "DeadlineScheduler.h"
+
+#include <iomanip>
+
+DeadlineScheduler::DeadlineScheduler(double rateHz)
+    : m_rateHz(100.0), m_periodNs(10000000),
+      m_deadlineNs(0), m_lastFireNs(0), m_started(false),
+      m_ticks(0), m_skipped(0), m_intervals(0), m_activeNs(0) {
+    setRate(rateHz);
+}
+
+void DeadlineScheduler::setRate(double rateHz) {
+    if (rateHz <= 0.0) {
+        return;
+    }
+    m_rateHz = rateHz;
+    m_periodNs = static_cast<uint64_t>(1e9 / rateHz + 0.5);
+}
+
+void DeadlineScheduler::start(uint64_t nowNs) {
+    m_deadlineNs = nowNs;
+    m_lastFireNs = 0;
+    m_started = true;
+}
+
+bool DeadlineScheduler::poll(uint64_t nowNs) {
+    if (!m_started) {
+        start(nowNs);
+    }
+    if (nowNs < m_deadlineNs) {
+        return false;
+    }
+
+    m_phaseJitter.record(nowNs - m_deadlineNs);
+
+    // 推进绝对截止时间；落后超过一个周期时跳过错过的节拍，保持原有相位
+    m_deadlineNs += m_periodNs;
+    if (nowNs >= m_deadlineNs) {
+        uint64_t missed = (nowNs - m_deadlineNs) / m_periodNs + 1;
+        m_deadlineNs += missed * m_periodNs;
+        m_skipped.store(m_skipped.load(std::memory_order_relaxed) + missed, std::memory_order_relaxed);
+    }
+
+    // 只统计连续发送期间的间隔（新的发送流第一个节拍不计入）
+    if (m_lastFireNs != 0) {
+        m_intervals.store(m_intervals.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        m_activeNs.store(m_activeNs.load(std::memory_order_relaxed) + (nowNs - m_lastFireNs), std::memory_order_relaxed);
+    }
+    m_lastFireNs = nowNs;
+    m_ticks.store(m_ticks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return true;
+}
+
+DeadlineScheduler::Stats DeadlineScheduler::getStats() const {
+    Stats stats;
+    stats.targetRateHz = m_rateHz;
+    stats.ticks = m_ticks.load(std::memory_order_relaxed);
+    stats.skipped = m_skipped.load(std::memory_order_relaxed);
+    uint64_t intervals = m_intervals.load(std::memory_order_relaxed);
+    uint64_t activeNs = m_activeNs.load(std::memory_order_relaxed);
+    stats.achievedRateHz = activeNs > 0 ? intervals * 1e9 / activeNs : 0.0;
+    return stats;
+}
+
+void DeadlineScheduler::printStats(std::ostream& os, const std::string& name) const {
+    Stats stats = getStats();
+    LatencyHistogram::Snapshot jitter;
+    m_phaseJitter.snapshot(jitter);
+
+    os << "[" << name << "] 指令节拍: 目标=" << std::fixed << std::setprecision(1) << stats.targetRateHz << "Hz"
+       << ", 实际=" << stats.achievedRateHz << "Hz"
+       << ", 次数=" << stats.ticks
+       << ", 跳过=" << stats.skipped;
+    if (jitter.count > 0) {
+        os << ", 相位抖动 p50=" << jitter.percentile(0.50) / 1000.0 << "us"
+           << " p99=" << jitter.percentile(0.99) / 1000.0 << "us"
+           << " max=" << jitter.maxNs / 1000.0 << "us";
+    }
+    os << std::defaultfloat << std::endl;
+}
@@ -0,0 +1,91 @@
+#ifndef DEADLINESCHEDULER_H
+#define DEADLINESCHEDULER_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "ServoTiming.h"
+
+/**
+ * @class DeadlineScheduler
+ * @brief 基于绝对截止时间的指令发送节拍器（每个控制器一个实例）
+ *
+ * 伺服线程每帧调用 poll(now)，到达截止时间时返回true并把截止时间推进一个周期
+ * （deadline += period，而不是 now + period），因此周期不会因毫秒截断或调用抖动而漂移。
+ * 落后超过一个周期时跳过错过的节拍并计数，不会连续补发。
+ * 统计实际发送频率和相位抖动（触发时刻相对截止时间的延迟），供键盘线程读取。
+ */
+class DeadlineScheduler {
+public:
+    /**
+     * @brief 统计信息
+     */
+    struct Stats {
+        double targetRateHz;      // 配置的发送频率
+        double achievedRateHz;    // 实际发送频率（只统计连续发送期间）
+        uint64_t ticks;           // 触发次数
+        uint64_t skipped;         // 因落后而跳过的节拍数
+    };
+
+    /**
+     * @brief 构造函数
+     * @param rateHz 发送频率（Hz）
+     */
+    explicit DeadlineScheduler(double rateHz = 100.0);
+
+    /**
+     * @brief 设置发送频率（从下一个节拍起生效）
+     * @param rateHz 发送频率（Hz），非正值时保持原值
+     */
+    void setRate(double rateHz);
+
+    double getRate() const { return m_rateHz; }
+
+    /**
+     * @brief 开始新的发送流，第一个节拍立即到期
+     * @param nowNs 当前单调时钟时间（纳秒）
+     */
+    void start(uint64_t nowNs);
+
+    /**
+     * @brief 检查是否到达截止时间（伺服线程调用，无锁、无分配）
+     * @param nowNs 当前单调时钟时间（纳秒）
+     * @return 到期时返回true
+     */
+    bool poll(uint64_t nowNs);
+
+    /**
+     * @brief 获取统计信息（任意线程可调用）
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief 打印频率和相位抖动统计（非实时线程调用）
+     * @param os 输出流
+     * @param name 控制器名称
+     */
+    void printStats(std::ostream& os, const std::string& name) const;
+
+private:
+    DeadlineScheduler(const DeadlineScheduler&);
+    DeadlineScheduler& operator=(const DeadlineScheduler&);
+
+    double m_rateHz;
+    uint64_t m_periodNs;
+
+    // 仅伺服线程访问
+    uint64_t m_deadlineNs;
+    uint64_t m_lastFireNs;
+    bool m_started;
+
+    // 伺服线程写，其他线程读
+    std::atomic<uint64_t> m_ticks;
+    std::atomic<uint64_t> m_skipped;
+    std::atomic<uint64_t> m_intervals;      // 连续发送期间的节拍间隔数
+    std::atomic<uint64_t> m_activeNs;       // 连续发送期间的累计时长
+    LatencyHistogram m_phaseJitter;         // 触发时刻相对截止时间的延迟
+};
+
+#endif // DEADLINESCHEDULER_H
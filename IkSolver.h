@@ -0,0 +1,46 @@
+#ifndef IKSOLVER_H
+#define IKSOLVER_H
+
+#include "ArmKinematics.h"
+
+/**
+ * @class IkSolver
+ * @brief 关节空间流式控制使用的逆解接口（只在 IkWorker 的工作线程中调用）
+ *
+ * - builtin：ArmKinematics 的DLS迭代，不依赖厂商库
+ * - rm_algo：RM_API2 的 rm_algo_inverse_kinematics（编译时定义 USE_RM_API2 才可用）
+ */
+class IkSolver {
+public:
+    virtual ~IkSolver() {}
+
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief 以 seed 为初值求解，result 中的残差按 ArmKinematics 的正解重新计算
+     * @return 求解器报告成功时返回true（是否接受由调用者按残差、限位和连续性判断）
+     */
+    virtual bool solve(const ArmKinematics::Pose& target, const ArmKinematics::Joints& seed,
+                       ArmKinematics::Joints& solution, ArmKinematics::Result& result) = 0;
+};
+
+/**
+ * @class DlsIkSolver
+ * @brief 内置DLS逆解
+ */
+class DlsIkSolver : public IkSolver {
+public:
+    explicit DlsIkSolver(const ArmKinematics& kinematics) : m_kinematics(kinematics) {}
+
+    const char* name() const override { return "builtin"; }
+
+    bool solve(const ArmKinematics::Pose& target, const ArmKinematics::Joints& seed,
+               ArmKinematics::Joints& solution, ArmKinematics::Result& result) override {
+        return m_kinematics.inverse(target, seed, solution, result);
+    }
+
+private:
+    ArmKinematics m_kinematics;
+};
+
+#endif // IKSOLVER_H
@@ -0,0 +1,178 @@
+#include "IkWorker.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace {
+
+uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+IkWorker::IkWorker(IkSolver* solver, const SendFunction& send, const Params& params)
+    : m_solver(solver), m_send(send), m_params(params),
+      m_session(0), m_sequence(0), m_workerSession(0), m_workerSequence(0),
+      m_running(false),
+      m_posted(0), m_solved(0), m_converged(0), m_approximate(0), m_residualRejects(0),
+      m_limitRejects(0), m_continuityRejects(0), m_stepLimited(0), m_sent(0), m_sendFailures(0), m_superseded(0),
+      m_sessions(0), m_lastManipulabilityPpm(0), m_maxJointStepMdeg(0),
+      m_solveTime(1000000), m_postToSend(1000000) {
+    m_sessionSeed.fill(0.0);
+    m_lastAccepted.fill(0.0);
+}
+
+IkWorker::~IkWorker() {
+    stop();
+    delete m_solver;
+}
+
+bool IkWorker::start() {
+    if (m_running.load(std::memory_order_acquire)) {
+        return true;
+    }
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&IkWorker::run, this);
+    return true;
+}
+
+void IkWorker::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void IkWorker::beginSession(const ArmKinematics::Joints& seed) {
+    ++m_session;
+    m_sessionSeed = seed;
+}
+
+void IkWorker::post(const ArmKinematics::Pose& target) {
+    Target value;
+    value.session = m_session;
+    value.sequence = ++m_sequence;
+    value.postedNs = steadyNowNs();
+    value.pose = target;
+    value.seed = m_sessionSeed;
+    m_target.store(value);
+    bump(m_posted);
+}
+
+bool IkWorker::getLastSolution(ArmKinematics::Joints& joints) const {
+    return m_lastSolution.tryLoad(joints);
+}
+
+void IkWorker::run() {
+    Target target;
+    while (m_running.load(std::memory_order_acquire)) {
+        if (!m_target.tryLoad(target) || target.sequence == m_workerSequence) {
+            std::this_thread::sleep_for(std::chrono::microseconds(m_params.pollIntervalUs));
+            continue;
+        }
+        process(target);
+    }
+}
+
+void IkWorker::process(const Target& target) {
+    if (target.sequence > m_workerSequence + 1) {
+        m_superseded.store(m_superseded.load(std::memory_order_relaxed) + (target.sequence - m_workerSequence - 1),
+                           std::memory_order_relaxed);
+    }
+    m_workerSequence = target.sequence;
+
+    // 新会话从机械臂实际关节角度开始
+    if (target.session != m_workerSession) {
+        m_workerSession = target.session;
+        m_lastAccepted = target.seed;
+        bump(m_sessions);
+    }
+
+    ArmKinematics::Joints solution;
+    ArmKinematics::Result result;
+    uint64_t startNs = steadyNowNs();
+    bool solved = m_solver->solve(target.pose, m_lastAccepted, solution, result);
+    m_solveTime.record(steadyNowNs() - startNs);
+    bump(m_solved);
+    m_lastManipulabilityPpm.store(static_cast<uint64_t>(result.manipulability * 1e6), std::memory_order_relaxed);
+
+    if (!solved && (result.positionError > m_params.acceptPositionMm ||
+                    result.rotationError > m_params.acceptRotationRad)) {
+        bump(m_residualRejects);
+        return;
+    }
+    if (result.limitJoint != 0) {
+        bump(m_limitRejects);
+        return;
+    }
+    double step = ArmKinematics::maxJointDelta(solution, m_lastAccepted);
+    if (!(step <= m_params.branchJumpDeg)) {
+        bump(m_continuityRejects);
+        return;
+    }
+    bump(result.converged ? m_converged : m_approximate);
+    uint64_t stepMdeg = static_cast<uint64_t>(step * 1000.0);
+    if (stepMdeg > m_maxJointStepMdeg.load(std::memory_order_relaxed)) {
+        m_maxJointStepMdeg.store(stepMdeg, std::memory_order_relaxed);
+    }
+    if (step > m_params.maxJointStepDeg) {
+        // 沿关节空间直线缩短，各关节同比例，保持运动方向
+        double scale = m_params.maxJointStepDeg / step;
+        for (int i = 0; i < ArmKinematics::kJoints; ++i) {
+            solution[i] = m_lastAccepted[i] + (solution[i] - m_lastAccepted[i]) * scale;
+        }
+        bump(m_stepLimited);
+    }
+
+    m_lastAccepted = solution;
+    m_lastSolution.store(solution);
+    if (m_send(solution)) {
+        bump(m_sent);
+        m_postToSend.record(steadyNowNs() - target.postedNs);
+    } else {
+        bump(m_sendFailures);
+    }
+}
+
+void IkWorker::getStats(Stats& stats) const {
+    stats.posted = m_posted.load(std::memory_order_relaxed);
+    stats.solved = m_solved.load(std::memory_order_relaxed);
+    stats.converged = m_converged.load(std::memory_order_relaxed);
+    stats.approximate = m_approximate.load(std::memory_order_relaxed);
+    stats.residualRejects = m_residualRejects.load(std::memory_order_relaxed);
+    stats.limitRejects = m_limitRejects.load(std::memory_order_relaxed);
+    stats.continuityRejects = m_continuityRejects.load(std::memory_order_relaxed);
+    stats.stepLimited = m_stepLimited.load(std::memory_order_relaxed);
+    stats.sent = m_sent.load(std::memory_order_relaxed);
+    stats.sendFailures = m_sendFailures.load(std::memory_order_relaxed);
+    stats.superseded = m_superseded.load(std::memory_order_relaxed);
+    stats.sessions = m_sessions.load(std::memory_order_relaxed);
+    stats.lastManipulability = m_lastManipulabilityPpm.load(std::memory_order_relaxed) / 1e6;
+    stats.maxJointStepDeg = m_maxJointStepMdeg.load(std::memory_order_relaxed) / 1000.0;
+    m_solveTime.snapshot(stats.solveTime);
+    m_postToSend.snapshot(stats.postToSend);
+}
+
+void IkWorker::printStats(std::ostream& os, const std::string& label) const {
+    Stats stats;
+    getStats(stats);
+    os << "[" << label << "] 关节空间逆解(" << solverName() << "): 投递=" << stats.posted
+       << ", 求解=" << stats.solved << " (收敛=" << stats.converged << ", 近似=" << stats.approximate << ")"
+       << ", 覆盖=" << stats.superseded
+       << ", 拒绝: 残差=" << stats.residualRejects << " 限位=" << stats.limitRejects
+       << " 跳变=" << stats.continuityRejects << ", 步长缩短=" << stats.stepLimited
+       << ", 已发送=" << stats.sent << ", 发送失败=" << stats.sendFailures << std::endl;
+    os << "[" << label << "]   求解耗时 p50=" << std::fixed << std::setprecision(1)
+       << stats.solveTime.percentile(0.50) / 1000.0 << "us p99=" << stats.solveTime.percentile(0.99) / 1000.0
+       << "us max=" << stats.solveTime.maxNs / 1000.0 << "us"
+       << ", 投递→发送 p50=" << stats.postToSend.percentile(0.50) / 1000.0
+       << "us p99=" << stats.postToSend.percentile(0.99) / 1000.0 << "us"
+       << ", 最大单关节步长=" << std::setprecision(3) << stats.maxJointStepDeg << "°"
+       << ", 可操作度=" << std::setprecision(4) << stats.lastManipulability
+       << std::defaultfloat << std::endl;
+}
@@ -0,0 +1,154 @@
+#ifndef IKWORKER_H
+#define IKWORKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include "IkSolver.h"
+#include "SeqLock.h"
+#include "ServoTiming.h"
+
+/**
+ * @class IkWorker
+ * @brief 关节空间流式控制的逆解工作线程（每个触觉设备控制器一个）
+ *
+ * 伺服线程在发送节拍上只把最新目标位姿写入顺序锁（wait-free，不分配、不加锁），
+ * 工作线程取最新目标、以上一次接受的解为初值求解，校验后交给发送函数：
+ * - 残差超过接受阈值（奇异点附近DLS给出的近似解可能达不到收敛阈值）→ 拒绝
+ * - 解触及关节限位 → 拒绝
+ * - 与上一次接受的解相比单关节变化超过 branchJumpDeg（解跳到另一分支）→ 拒绝
+ * - 单关节变化超过 maxJointStepDeg（奇异点附近腕部需要快速转动）→ 整体按比例缩到该步长后发送，
+ *   下一帧以缩短后的解为初值继续追赶，不会因为一次超限就停在原地
+ * 被拒绝的目标不发送，机械臂停在上一个有效解上。工作线程来不及处理时只解最新一帧，
+ * 被跳过的目标计入 superseded。每次拖动以机械臂实际关节角度开始新的会话。
+ */
+class IkWorker {
+public:
+    typedef std::function<bool(const ArmKinematics::Joints& joints)> SendFunction;
+
+    struct Params {
+        double maxJointStepDeg;       // 相邻两次发送之间的最大单关节变化（度），超过时按比例缩短
+        double branchJumpDeg;         // 单关节变化超过该值视为解跳到另一分支并拒绝（度）
+        double acceptPositionMm;      // 接受近似解的位置残差上限（毫米）
+        double acceptRotationRad;     // 接受近似解的姿态残差上限（弧度）
+        int pollIntervalUs;           // 没有新目标时工作线程的轮询间隔
+
+        Params() : maxJointStepDeg(5.0), branchJumpDeg(30.0), acceptPositionMm(0.5), acceptRotationRad(0.005), pollIntervalUs(100) {}
+    };
+
+    struct Stats {
+        uint64_t posted;              // 伺服线程投递的目标数
+        uint64_t solved;              // 完成的求解数
+        uint64_t converged;           // 收敛到阈值内的解
+        uint64_t approximate;         // 未收敛但残差在接受阈值内的解（已接受）
+        uint64_t residualRejects;     // 残差过大被拒绝
+        uint64_t limitRejects;        // 触及关节限位被拒绝
+        uint64_t continuityRejects;   // 相对上一次的解跳变被拒绝
+        uint64_t stepLimited;         // 单关节变化超过 maxJointStepDeg 被缩短（已发送）
+        uint64_t sent;                // 已交给发送函数
+        uint64_t sendFailures;        // 发送函数返回失败
+        uint64_t superseded;          // 未求解就被更新的目标覆盖
+        uint64_t sessions;            // 拖动会话数
+        double lastManipulability;    // 最近一次解的归一化可操作度
+        double maxJointStepDeg;       // 相邻两次发送之间的最大单关节变化（缩短前）
+        LatencyHistogram::Snapshot solveTime;   // 单次求解耗时
+        LatencyHistogram::Snapshot postToSend;  // 伺服线程投递 → 交给发送函数
+    };
+
+    /**
+     * @param solver 逆解器（所有权交给本对象）
+     * @param send 发送函数（在工作线程中调用）
+     */
+    IkWorker(IkSolver* solver, const SendFunction& send, const Params& params);
+    ~IkWorker();
+
+    bool start();
+    void stop();
+
+    // ---- 以下由伺服线程调用（wait-free） ----
+
+    /**
+     * @brief 开始新的拖动会话，seed 为机械臂当前的实际关节角度
+     */
+    void beginSession(const ArmKinematics::Joints& seed);
+
+    /**
+     * @brief 投递本会话的最新目标位姿（覆盖未处理的旧目标）
+     */
+    void post(const ArmKinematics::Pose& target);
+
+    // ---- 以下任意线程调用 ----
+
+    const char* solverName() const { return m_solver->name(); }
+    const Params& getParams() const { return m_params; }
+
+    /**
+     * @brief 最近一次接受的解（用于日志或诊断），从未接受过时返回false
+     */
+    bool getLastSolution(ArmKinematics::Joints& joints) const;
+
+    void getStats(Stats& stats) const;
+    void printStats(std::ostream& os, const std::string& label) const;
+
+private:
+    IkWorker(const IkWorker&);
+    IkWorker& operator=(const IkWorker&);
+
+    // 伺服线程 → 工作线程
+    struct Target {
+        uint32_t session;
+        uint64_t sequence;
+        uint64_t postedNs;
+        ArmKinematics::Pose pose;
+        ArmKinematics::Joints seed;
+    };
+
+    void run();
+    void process(const Target& target);
+
+    static void bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    IkSolver* m_solver;
+    SendFunction m_send;
+    Params m_params;
+
+    // 伺服线程独占
+    uint32_t m_session;
+    uint64_t m_sequence;
+    ArmKinematics::Joints m_sessionSeed;
+    SeqLock<Target> m_target;
+
+    // 工作线程独占
+    uint32_t m_workerSession;
+    uint64_t m_workerSequence;
+    ArmKinematics::Joints m_lastAccepted;
+    SeqLock<ArmKinematics::Joints> m_lastSolution;   // 发布给其他线程
+
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+
+    std::atomic<uint64_t> m_posted;
+    std::atomic<uint64_t> m_solved;
+    std::atomic<uint64_t> m_converged;
+    std::atomic<uint64_t> m_approximate;
+    std::atomic<uint64_t> m_residualRejects;
+    std::atomic<uint64_t> m_limitRejects;
+    std::atomic<uint64_t> m_continuityRejects;
+    std::atomic<uint64_t> m_stepLimited;
+    std::atomic<uint64_t> m_sent;
+    std::atomic<uint64_t> m_sendFailures;
+    std::atomic<uint64_t> m_superseded;
+    std::atomic<uint64_t> m_sessions;
+    std::atomic<uint64_t> m_lastManipulabilityPpm;   // 可操作度 ×1e6
+    std::atomic<uint64_t> m_maxJointStepMdeg;        // 毫度
+    LatencyHistogram m_solveTime;
+    LatencyHistogram m_postToSend;
+};
+
+#endif // IKWORKER_H
@@ -0,0 +1,225 @@
+#include "JsonArmTransport.h"
+
+#include <cerrno>
+#include <sstream>
+
+#include "ArmCommandPipeline.h"
+#include "BinaryLogger.h"
+
+JsonArmTransport::JsonArmTransport(ArmReactor& reactor, const std::string& ip, int port)
+    : m_reactor(reactor), m_connection(nullptr), m_listener(nullptr), m_logSource(0),
+      m_streamCounter(0) {
+    m_connection = m_reactor.addConnection("机械臂 " + ip, ip, port, this);
+}
+
+JsonArmTransport::~JsonArmTransport() {
+    disconnect();
+}
+
+void JsonArmTransport::attach(Listener* listener, uint16_t logSource) {
+    m_listener = listener;
+    m_logSource = logSource;
+}
+
+bool JsonArmTransport::connect() {
+    if (!m_connection) {
+        return false;
+    }
+    m_reactor.connect(m_connection);
+    return true;
+}
+
+void JsonArmTransport::disconnect() {
+    if (m_connection) {
+        m_reactor.close(m_connection);
+    }
+}
+
+bool JsonArmTransport::isConnected() const {
+    return m_connection && m_connection->isConnected();
+}
+
+uint64_t JsonArmTransport::getConnectFailures() const {
+    return m_connection ? m_connection->getStats().connectFailures : 0;
+}
+
+bool JsonArmTransport::isServiceThread() const {
+    return m_reactor.isReactorThread();
+}
+
+bool JsonArmTransport::streamPose(const std::array<int, 6>& pose) {
+    BinaryLogger& logger = BinaryLogger::instance();
+    if (!m_connection || !m_connection->isOpen()) {
+        logger.log(LOG_TCP_NOT_CONNECTED, m_logSource);
+        return false;
+    }
+
+    // 使用movep_follow实现笛卡尔空间跟随运动（最快跟随控制），只改写位姿数值
+    size_t length = m_poseEncoder.encodeMovePFollow(pose);
+
+    // 每50次显示一次详细TCP日志（避免日志过多）
+    int debugCounter = ++m_streamCounter;
+    bool showDebug = (debugCounter % 50 == 0);
+    if (showDebug) {
+        logger.log(LOG_ASYNC_SEND_TARGET, m_logSource, pose[0], pose[1], pose[2], pose[3], pose[4], pose[5]);
+    }
+
+    // 非阻塞写入：socket不可写时只保留最新目标，写了一半的帧由反应器在socket可写时写完
+    bool ok = m_connection->writeLatest(m_poseEncoder.data(), length);
+
+    if (showDebug) {
+        logger.log(LOG_ASYNC_SEND_RESULT, m_logSource, debugCounter, ok ? 1 : 0, length, ok ? 0 : errno);
+    }
+    return ok;
+}
+
+bool JsonArmTransport::streamJoints(const std::array<double, 6>& joints) {
+    if (!m_connection || !m_connection->isOpen()) {
+        return false;
+    }
+    // 角度中有NaN/Inf时不发送
+    size_t length = m_jointEncoder.encodeJointAngles(joints);
+    if (length == 0) {
+        return false;
+    }
+    return m_connection->writeLatest(m_jointEncoder.data(), length);
+}
+
+bool JsonArmTransport::send(const ArmCommand& command, uint64_t timeoutNs, int retries, const Callback& callback) {
+    BinaryLogger& logger = BinaryLogger::instance();
+    if (!m_connection || !m_connection->isOpen()) {
+        logger.log(LOG_TCP_SEND_FAILED, m_logSource, ENOTCONN);
+        return false;
+    }
+
+    const char* frame = nullptr;
+    size_t length = encode(command, frame);
+
+    // 帧末尾的\r\n不记录
+    logger.logText(LOG_TCP_SEND_TEXT, m_logSource, frame, length - 2);
+    if (!m_connection->write(frame, length)) {
+        logger.log(LOG_TCP_SEND_FAILED, m_logSource, m_connection->isOpen() ? ENOBUFS : ENOTCONN);
+        return false;
+    }
+    logger.log(LOG_TCP_SEND_OK, m_logSource, length, length);
+
+    // 登记为在途请求，响应到达（或超时）时回调
+    if (!m_tracker.track(frame, length, ArmCommandPipeline::nowNs(), timeoutNs, retries, callback) && callback) {
+        // 没有command字段的帧无法对应响应，写出即视为完成
+        ArmResponse empty;
+        empty.clear();
+        callback(&empty);
+    }
+    return true;
+}
+
+void JsonArmTransport::printStats(std::ostream& os, const std::string& prefix) const {
+    m_tracker.printStats(os, prefix);
+}
+
+void JsonArmTransport::onConnected(ArmReactor::Connection& connection) {
+    (void)connection;
+    if (m_listener) {
+        m_listener->onTransportConnected(*this);
+    }
+}
+
+void JsonArmTransport::onDisconnected(ArmReactor::Connection& connection) {
+    (void)connection;
+    // 连接上的响应不会再到达：在途请求全部失败（等待方立即返回，锚点请求给出无效结果）
+    m_tracker.failAll();
+    if (m_listener) {
+        m_listener->onTransportDisconnected(*this);
+    }
+}
+
+void JsonArmTransport::onMessage(ArmReactor::Connection& connection, const char* data, size_t length) {
+    (void)connection;
+    BinaryLogger& logger = BinaryLogger::instance();
+    ArmResponse response;
+    if (!ArmResponseReader::parse(data, length, response)) {
+        logger.log(LOG_TCP_RECV_MALFORMED, m_logSource, length);
+        return;
+    }
+    logger.logText(LOG_TCP_RECV_TEXT, m_logSource, data, length);
+
+    // 带位姿的arm_state无论是否对应在途请求都发布为最新状态
+    if ((response.fields & ArmResponse::FieldArmState) && (response.fields & ArmResponse::FieldPose)) {
+        const std::array<int, 6>& pose = response.pose;
+        logger.log(LOG_POSE_QUERY_RESULT, m_logSource, pose[0], pose[1], pose[2], pose[3], pose[4], pose[5]);
+        if (m_listener) {
+            m_listener->onArmState(*this, response);
+        }
+    }
+
+    // 按指令类型交给同类型中最早的在途请求
+    m_tracker.complete(response, ArmCommandPipeline::nowNs());
+}
+
+void JsonArmTransport::onTick(ArmReactor::Connection& connection, uint64_t nowNs) {
+    if (m_listener) {
+        m_listener->onTransportTick(*this, nowNs);
+    }
+
+    // 请求超时：查询重发，其余请求以失败完成
+    m_tracker.expire(nowNs, [this, &connection](const std::string& frame, int attempt) {
+        if (!connection.isOpen()) {
+            return false;
+        }
+        BinaryLogger::instance().log(LOG_POSE_QUERY_RETRY, m_logSource, attempt - 1);
+        return connection.write(frame.data(), frame.size());
+    });
+}
+
+size_t JsonArmTransport::encode(const ArmCommand& command, const char*& frame) {
+    const int* args = command.args;
+    switch (command.type) {
+        case ArmCommand::GripperPick:
+            m_commandEncoder.encodeGripperPick(args[0], args[1], args[2] != 0);
+            frame = m_commandEncoder.data();
+            return m_commandEncoder.size();
+        case ArmCommand::GripperRelease:
+            m_commandEncoder.encodeGripperRelease(args[0], args[1] != 0);
+            frame = m_commandEncoder.data();
+            return m_commandEncoder.size();
+        case ArmCommand::WriteSingleRegister:
+            m_commandEncoder.encodeWriteSingleRegister(args[0], args[1], args[2], args[3]);
+            frame = m_commandEncoder.data();
+            return m_commandEncoder.size();
+        case ArmCommand::GetArmState: {
+            static const char kQuery[] = "{ \"command\": \"get_current_arm_state\" }\r\n";
+            frame = kQuery;
+            return sizeof(kQuery) - 1;
+        }
+        default:
+            break;
+    }
+
+    // 设置指令只在连接后发出几次，直接用字符串流编码
+    std::ostringstream oss;
+    oss << "{ \"command\": \"" << command.name() << "\", ";
+    switch (command.type) {
+        case ArmCommand::SetArmPower:
+            oss << "\"enable\": " << (args[0] ? "true" : "false");
+            break;
+        case ArmCommand::SetAngleTransmission:
+            oss << "\"state\": " << (args[0] ? "true" : "false");
+            break;
+        case ArmCommand::SetRealtimePush:
+            oss << "\"cycle\": " << args[0] << ", \"port\": " << args[1]
+                << ", \"force_coordinate\": 0, \"ip\": \"" << command.text << "\"";
+            break;
+        case ArmCommand::SetTeachFrame:
+            oss << "\"frame_type\": " << args[0];
+            break;
+        case ArmCommand::SetToolFrame:
+            oss << "\"tool_name\": \"" << command.text << "\"";
+            break;
+        default:
+            break;
+    }
+    oss << " }\r\n";
+    m_commandFrame = oss.str();
+    frame = m_commandFrame.data();
+    return m_commandFrame.size();
+}
@@ -0,0 +1,67 @@
+#ifndef JSONARMTRANSPORT_H
+#define JSONARMTRANSPORT_H
+
+#include <string>
+
+#include "ArmReactor.h"
+#include "ArmRequestTracker.h"
+#include "ArmTransport.h"
+#include "CommandEncoder.h"
+
+/**
+ * @class JsonArmTransport
+ * @brief 默认传输后端：JSON指令直接走机械臂TCP端口
+ *
+ * 连接由共用的 ArmReactor 驱动，服务线程即反应器线程：
+ * - 流式位姿编码为 movep_follow，关节角度编码为 set_joint_angle_transmission，
+ *   都通过 Connection::writeLatest() 写出（socket不可写时只保留最新一帧）
+ * - 其他指令编码后写出并登记到在途请求表，响应按指令类型 + FIFO 对应回回调
+ * - 查询超时按设定次数重发，连接断开时在途指令全部以空响应完成
+ */
+class JsonArmTransport : public ArmTransport, private ArmReactor::Handler {
+public:
+    JsonArmTransport(ArmReactor& reactor, const std::string& ip, int port);
+    ~JsonArmTransport();
+
+    const char* name() const override { return "json"; }
+    void attach(Listener* listener, uint16_t logSource) override;
+    bool connect() override;
+    void disconnect() override;
+    bool isConnected() const override;
+    uint64_t getConnectFailures() const override;
+    bool isServiceThread() const override;
+    bool streamPose(const std::array<int, 6>& pose) override;
+    bool streamJoints(const std::array<double, 6>& joints) override;
+    bool send(const ArmCommand& command, uint64_t timeoutNs, int retries, const Callback& callback) override;
+    void printStats(std::ostream& os, const std::string& prefix) const override;
+
+    /** 没有对应在途请求的响应数（如轨迹到位事件，任意线程可读） */
+    uint64_t getUnsolicitedCount() const { return m_tracker.getUnsolicitedCount(); }
+
+private:
+    JsonArmTransport(const JsonArmTransport&);
+    JsonArmTransport& operator=(const JsonArmTransport&);
+
+    void onConnected(ArmReactor::Connection& connection) override;
+    void onDisconnected(ArmReactor::Connection& connection) override;
+    void onMessage(ArmReactor::Connection& connection, const char* data, size_t length) override;
+    void onTick(ArmReactor::Connection& connection, uint64_t nowNs) override;
+
+    // 把指令编码为完整的JSON帧（含\r\n），返回帧长度
+    size_t encode(const ArmCommand& command, const char*& frame);
+
+    ArmReactor& m_reactor;
+    ArmReactor::Connection* m_connection;
+    Listener* m_listener;
+    uint16_t m_logSource;
+
+    // 以下只在反应器线程中使用
+    ArmRequestTracker m_tracker;     // 在途请求表（统计可从任意线程读取）
+    CommandEncoder m_poseEncoder;    // movep_follow 只改写位姿数值
+    CommandEncoder m_jointEncoder;
+    CommandEncoder m_commandEncoder;
+    std::string m_commandFrame;      // 设置指令（低频）的编码缓冲区
+    int m_streamCounter;             // 流式发送计数（每50帧记录一次日志）
+};
+
+#endif // JSONARMTRANSPORT_H
@@ -0,0 +1,67 @@
+#ifndef LOGEVENTS_H
+#define LOGEVENTS_H
+
+/**
+ * @file LogEvents.h
+ * @brief 二进制日志事件表
+ *
+ * 热路径只记录 {时间戳, 事件ID, 来源ID, 最多6个数值} 或一段原始文本，
+ * 由后台格式化线程按下表的printf格式生成文本。
+ * 数值事件的格式串只能使用浮点占位符（整数用 %.0f），文本事件只能使用一个 %s。
+ */
+#define TOUCH_LOG_EVENTS(X) \
+    /* ArmController: TCP收发 */ \
+    X(LOG_TCP_NOT_CONNECTED,   "❌ TCP错误: 机械臂未连接") \
+    X(LOG_TCP_SEND_TEXT,       "📤 [TCP发送] 内容: %s") \
+    X(LOG_TCP_SEND_OK,         "✅ 发送成功: %.0f/%.0f 字节") \
+    X(LOG_TCP_SEND_FAILED,     "❌ TCP错误: 发送命令失败, errno=%.0f") \
+    X(LOG_TCP_RECV_TEXT,       "📥 [TCP接收] 内容: %s") \
+    X(LOG_TCP_RECV_MALFORMED,  "⚠️  TCP响应不是有效的JSON对象: %.0f 字节") \
+    X(LOG_ASYNC_SEND_TARGET,   "🚀 [TCP高频发送] 目标位姿: [%.0f, %.0f, %.0f, %.0f, %.0f, %.0f]") \
+    X(LOG_ASYNC_SEND_RESULT,   "🚀 [TCP高频发送] 频率计数: %.0f, 结果: %.0f/%.0f 字节, errno=%.0f") \
+    X(LOG_POSE_QUERY_RETRY,    "未收到arm_state响应，重试第%.0f次...") \
+    X(LOG_POSE_QUERY_RESULT,   "成功获取机械臂当前位姿: [%.0f, %.0f, %.0f, %.0f, %.0f, %.0f]") \
+    X(LOG_POSE_QUERY_NO_POSE,  "警告: 响应中未找到arm_state/pose字段") \
+    X(LOG_RM_STREAM_RESULT,    "🚀 [RM_API2高频发送] 频率计数: %.0f, 返回码: %.0f, 调用耗时: %.0f μs") \
+    X(LOG_RM_COMMAND_FAILED,   "❌ RM_API2指令失败: 指令类型=%.0f, 返回码=%.0f") \
+    X(LOG_SCISSORS_NOT_CONNECTED, "❌ 剪刀控制失败: 机械臂未连接") \
+    X(LOG_SCISSORS_COMMAND,    "🔧 发送剪刀控制命令: write_single_register port=%.0f, address=%.0f, data=%.0f, device=%.0f") \
+    X(LOG_GRIPPER_NOT_CONNECTED, "❌ 夹抓控制错误: 机械臂未连接") \
+    X(LOG_GRIPPER_RELEASE,     "🤏 [夹抓控制] 释放夹抓 (速度: %.0f)") \
+    X(LOG_GRIPPER_PICK,        "🤏 [夹抓控制] 力矩抓取 (速度: %.0f, 力矩: %.0f)") \
+    /* TouchArmController: 离合与位置控制 */ \
+    X(LOG_CLUTCH_BUSY,         "拖动控制已在进行中，请先松开按钮") \
+    X(LOG_CLUTCH_PENDING,      "=== 开始新的拖动控制，等待机械臂锚点位姿 ===") \
+    X(LOG_CLUTCH_HAPTIC_ONLY,  "=== 触觉反馈模式激活: 机械臂未连接，机械臂不会移动 ===") \
+    X(LOG_CLUTCH_ANCHOR_FAIL,  "警告: 获取机械臂位姿失败，无法开始拖动控制，请检查机械臂连接和状态") \
+    X(LOG_CLUTCH_CANCELLED,    "按钮在锚点位姿返回前松开，取消本次拖动") \
+    X(LOG_CLUTCH_ARM_LOST,     "机械臂连接中断，本次拖动切换为仅触觉反馈（重连后重新按下按钮恢复控制）") \
+    X(LOG_CLUTCH_RELEASED,     "=== 结束拖动控制 (机械臂连接: %.0f) ===") \
+    X(LOG_IK_SEED_STALE,       "⚠️  关节空间模式: 没有新鲜的关节角度上报，本次拖动改用笛卡尔跟随") \
+    X(LOG_IK_SEED_MISMATCH,    "⚠️  关节空间模式: 关节角度正解与锚点位姿不一致 (%.3f mm, %.4f rad)，本次拖动改用笛卡尔跟随") \
+    X(LOG_COLLISION_CLAMP,     "⚠️  双臂防碰撞: 与机械臂%.0f间隙低于安全距离，指令目标截短 (间隙 %.1f mm)") \
+    X(LOG_COLLISION_VETO,      "⛔ 双臂防碰撞: 与机械臂%.0f间隙 %.1f mm，拒绝指令目标，机械臂停在上一目标") \
+    X(LOG_EE_HAND_TOGGLE,      "🖐️  [灵巧手控制] 按钮2按下 - 灵巧手切换为%s") \
+    X(LOG_EE_SCISSORS_TOGGLE,  "✂️  [剪刀控制] 按钮2按下 - 剪刀切换为%s") \
+    X(LOG_EE_GRIPPER_TOGGLE,   "🤏 [夹爪控制] 按钮2按下 - 夹爪切换为%s") \
+    X(LOG_EE_UNAVAILABLE,      "❌ 按钮2按下 - 无可用的末端控制设备: %s") \
+    X(LOG_COLLISION_CLEAR,     "✅ 双臂防碰撞: 恢复正常发送 (间隙 %.1f mm)") \
+    X(LOG_COLLISION_STALE,     "⚠️  双臂防碰撞: 机械臂%.0f关节角度上报过期，按其上一次的位置和指令目标继续检查") \
+    X(LOG_COLLISION_STALE_HOLD, "⛔ 双臂防碰撞: 机械臂%.0f没有可用的关节角度，拒绝指令目标，机械臂停在上一目标") \
+    X(LOG_COLLISION_FRESH,     "✅ 双臂防碰撞: 关节角度上报恢复") \
+    X(LOG_CTRL_TOUCH_DELTA,    "触觉设备变化: [%.3f, %.3f, %.3f] mm (X,Y,Z)") \
+    X(LOG_CTRL_AXIS_MAP,       "坐标轴映射: 触觉设备[%.0f,%.0f,%.0f]→机械臂[X,Y,Z], 姿态轴映射: 触觉设备[%.0f,%.0f,%.0f]→机械臂[RX,RY,RZ]") \
+    X(LOG_CTRL_SIGNS,          "符号调整: [%.0f,%.0f,%.0f,%.0f,%.0f,%.0f]") \
+    X(LOG_CTRL_ROT_DELTA,      "触觉姿态变化(旋转向量): [%.2f, %.2f, %.2f] deg (RX,RY,RZ)") \
+    X(LOG_CTRL_MAPPED,         "映射后增量: [%.1f, %.1f, %.1f] μm, 映射后姿态: [%.1f, %.1f, %.1f] mrad") \
+    X(LOG_CTRL_TARGET,         "机械臂目标位姿: [%.0f, %.0f, %.0f, %.0f, %.0f, %.0f] (前3个为μm, 后3个为mrad)") \
+    X(LOG_CTRL_SCALES,         "位置映射系数: %.2f, 姿态映射系数: %.3f")
+
+enum LogEvent {
+#define TOUCH_LOG_EVENT_ENUM(name, format) name,
+    TOUCH_LOG_EVENTS(TOUCH_LOG_EVENT_ENUM)
+#undef TOUCH_LOG_EVENT_ENUM
+    LOG_EVENT_COUNT
+};
+
+#endif // LOGEVENTS_H
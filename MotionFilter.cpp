@@ -0,0 +1,241 @@
+#include "MotionFilter.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <vector>
+
+MotionFilter::MotionFilter()
+    : m_initialized(false), m_lastNs(0), m_windowCount(0) {
+    for (int i = 0; i < kAxes; ++i) {
+        m_value[i] = 0.0;
+        m_rate[i] = 0.0;
+        m_lastInput[i] = 0.0;
+        m_windowSum[i] = 0.0;
+    }
+}
+
+void MotionFilter::configure(const Params& params) {
+    m_params = params;
+    if (m_params.minCutoffHz <= 0.0) m_params.minCutoffHz = 2.0;
+    if (m_params.derivativeCutoffHz <= 0.0) m_params.derivativeCutoffHz = 1.0;
+    if (m_params.cutoffHz <= 0.0) m_params.cutoffHz = 8.0;
+    if (m_params.betaPosition < 0.0) m_params.betaPosition = 0.0;
+    if (m_params.betaRotation < 0.0) m_params.betaRotation = 0.0;
+    m_initialized = false;
+}
+
+bool MotionFilter::parseType(const std::string& name, Type& type) {
+    if (name == "none") {
+        type = None;
+    } else if (name == "one_euro") {
+        type = OneEuro;
+    } else if (name == "critically_damped") {
+        type = CriticallyDamped;
+    } else if (name == "moving_average") {
+        type = MovingAverage;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* MotionFilter::typeName(Type type) {
+    switch (type) {
+        case OneEuro: return "one_euro";
+        case CriticallyDamped: return "critically_damped";
+        case MovingAverage: return "moving_average";
+        default: return "none";
+    }
+}
+
+double MotionFilter::smoothingFactor(double cutoffHz, double dt) {
+    double tau = 1.0 / (2.0 * M_PI * cutoffHz);
+    return dt / (dt + tau);
+}
+
+void MotionFilter::reset(const double sample[kAxes], uint64_t nowNs) {
+    for (int i = 0; i < kAxes; ++i) {
+        m_value[i] = sample[i];
+        m_rate[i] = 0.0;
+        m_lastInput[i] = sample[i];
+        m_windowSum[i] = 0.0;
+    }
+    m_windowCount = 0;
+    m_lastNs = nowNs;
+    m_initialized = true;
+}
+
+void MotionFilter::push(const double sample[kAxes], uint64_t nowNs) {
+    if (!m_initialized) {
+        reset(sample, nowNs);
+    }
+
+    // 伺服回调间隔不是严格的1ms，按实际时间步长离散
+    double dt = nowNs > m_lastNs ? (nowNs - m_lastNs) * 1e-9 : 0.001;
+    m_lastNs = nowNs;
+
+    switch (m_params.type) {
+        case OneEuro: {
+            double alphaRate = smoothingFactor(m_params.derivativeCutoffHz, dt);
+            for (int i = 0; i < kAxes; ++i) {
+                double rawRate = (sample[i] - m_lastInput[i]) / dt;
+                m_lastInput[i] = sample[i];
+                m_rate[i] += alphaRate * (rawRate - m_rate[i]);
+                double beta = i < 3 ? m_params.betaPosition : m_params.betaRotation;
+                double cutoff = m_params.minCutoffHz + beta * std::fabs(m_rate[i]);
+                m_value[i] += smoothingFactor(cutoff, dt) * (sample[i] - m_value[i]);
+            }
+            break;
+        }
+        case CriticallyDamped: {
+            // x'' = ω²(u - x) - 2ωx'，隐式欧拉：v1 = (v0 + dtω²(u - x0)) / (1 + 2ωdt + ω²dt²)
+            double omega = 2.0 * M_PI * m_params.cutoffHz;
+            double k = omega * omega * dt;
+            double denom = 1.0 + 2.0 * omega * dt + k * dt;
+            for (int i = 0; i < kAxes; ++i) {
+                m_rate[i] = (m_rate[i] + k * (sample[i] - m_value[i])) / denom;
+                m_value[i] += dt * m_rate[i];
+            }
+            break;
+        }
+        case MovingAverage:
+            for (int i = 0; i < kAxes; ++i) {
+                m_windowSum[i] += sample[i];
+                m_value[i] = sample[i];
+            }
+            ++m_windowCount;
+            break;
+        default:
+            for (int i = 0; i < kAxes; ++i) {
+                m_value[i] = sample[i];
+            }
+            break;
+    }
+}
+
+void MotionFilter::take(double out[kAxes]) {
+    if (m_params.type == MovingAverage && m_windowCount > 0) {
+        double inv = 1.0 / m_windowCount;
+        for (int i = 0; i < kAxes; ++i) {
+            out[i] = m_windowSum[i] * inv;
+            m_windowSum[i] = 0.0;
+        }
+        m_windowCount = 0;
+        return;
+    }
+    for (int i = 0; i < kAxes; ++i) {
+        out[i] = m_value[i];
+    }
+}
+
+double MotionFilter::nominalLagMs(double sendRateHz) const {
+    switch (m_params.type) {
+        case OneEuro:
+            // 低速时退化为一阶低通，群时延 τ = 1/(2πfc)
+            return 1000.0 / (2.0 * M_PI * m_params.minCutoffHz);
+        case CriticallyDamped:
+            // 临界阻尼二阶低通低频群时延 2/ω
+            return 2000.0 / (2.0 * M_PI * m_params.cutoffHz);
+        case MovingAverage:
+            // 平均窗口中心落后窗口末端半个发送周期
+            return sendRateHz > 0.0 ? 500.0 / sendRateHz : 0.0;
+        default:
+            return 0.0;
+    }
+}
+
+bool MotionFilter::benchmark(std::ostream& os, const Params& params, double sendRateHz) {
+    const double kTwoPi = 2.0 * M_PI;
+    const int kInputRateHz = 1000;
+    const int kTicks = 10 * kInputRateHz;       // 10秒输入，循环使用
+    const int kWarmupTicks = 2 * kInputRateHz;  // 前2秒为滤波器的过渡过程，不计入分析
+    const int kTimedTicks = 200000;
+    const double kMotionHz = 0.5, kMotionAmplitude = 20000.0;   // 微米
+    const double kTremorHz = 10.0, kTremorAmplitude = 500.0;
+    const uint64_t tickNs = 1000000000ULL / kInputRateHz;
+    const uint64_t sendPeriodNs = static_cast<uint64_t>(1e9 / sendRateHz);
+
+    // 六轴输入：X 为运动+震颤，其余轴为不同相位的同类信号（姿态轴按毫弧度缩放）
+    std::vector<double> input(static_cast<size_t>(kTicks) * kAxes);
+    for (int n = 0; n < kTicks; ++n) {
+        double t = static_cast<double>(n) / kInputRateHz;
+        for (int i = 0; i < kAxes; ++i) {
+            double scale = i < 3 ? 1.0 : 0.01;
+            input[n * kAxes + i] = scale * (kMotionAmplitude * std::sin(kTwoPi * kMotionHz * t + 0.7 * i) +
+                                            kTremorAmplitude * std::sin(kTwoPi * kTremorHz * t + 0.3 * i));
+        }
+    }
+
+    bool ok = true;
+    const Type types[4] = {None, OneEuro, CriticallyDamped, MovingAverage};
+    for (int k = 0; k < 4; ++k) {
+        Params typeParams = params;
+        typeParams.type = types[k];
+
+        // 1. 精度：发送节拍上的 X 输出按锁相法取 0.5Hz 和 10Hz 分量
+        MotionFilter filter;
+        filter.configure(typeParams);
+        uint64_t nowNs = 1000000000ULL;
+        uint64_t nextSendNs = nowNs;
+        double out[kAxes];
+        double motionI = 0.0, motionQ = 0.0, tremorI = 0.0, tremorQ = 0.0;
+        int sends = 0;
+        bool finite = true;
+        for (int n = 0; n < kTicks; ++n) {
+            filter.push(&input[n * kAxes], nowNs);
+            if (nowNs >= nextSendNs) {
+                nextSendNs += sendPeriodNs;
+                filter.take(out);
+                if (n >= kWarmupTicks) {
+                    double t = static_cast<double>(n) / kInputRateHz;
+                    motionI += out[0] * std::sin(kTwoPi * kMotionHz * t);
+                    motionQ += out[0] * std::cos(kTwoPi * kMotionHz * t);
+                    tremorI += out[0] * std::sin(kTwoPi * kTremorHz * t);
+                    tremorQ += out[0] * std::cos(kTwoPi * kTremorHz * t);
+                    ++sends;
+                }
+                for (int i = 0; i < kAxes; ++i) {
+                    finite &= std::isfinite(out[i]);
+                }
+            }
+            nowNs += tickNs;
+        }
+        // y = G·A·sin(ω(t - τ)) 时 I ∝ G·cos(ωτ)，Q ∝ -G·sin(ωτ)
+        double motionGain = 2.0 * std::sqrt(motionI * motionI + motionQ * motionQ) / sends / kMotionAmplitude;
+        double lagMs = std::atan2(-motionQ, motionI) / (kTwoPi * kMotionHz) * 1000.0;
+        double tremorGain = 2.0 * std::sqrt(tremorI * tremorI + tremorQ * tremorQ) / sends / kTremorAmplitude;
+
+        // 2. 单帧耗时：每个1kHz采样 push()，到发送节拍时 take()
+        filter.configure(typeParams);
+        nowNs = 1000000000ULL;
+        nextSendNs = nowNs;
+        double checksum = 0.0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int n = 0; n < kTimedTicks; ++n) {
+            filter.push(&input[(n % kTicks) * kAxes], nowNs);
+            if (nowNs >= nextSendNs) {
+                nextSendNs += sendPeriodNs;
+                filter.take(out);
+                checksum += out[0];
+            }
+            nowNs += tickNs;
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        volatile double sink = checksum;
+        (void)sink;
+        double nsPerTick = std::chrono::duration<double, std::nano>(end - start).count() / kTimedTicks;
+
+        if (std::fabs(lagMs) < 0.05) {
+            lagMs = 0.0;
+        }
+        os << "  " << std::left << std::setw(18) << typeName(types[k]) << std::right << std::fixed
+           << std::setprecision(1) << " 单帧 " << std::setw(5) << nsPerTick << "ns  0.5Hz滞后 " << std::setw(5)
+           << lagMs << "ms (标称 " << filter.nominalLagMs(sendRateHz) << "ms) 增益 " << std::setprecision(3)
+           << motionGain << "  10Hz震颤增益 " << tremorGain
+           << (types[k] == params.type ? "  ← 当前配置" : "") << std::endl;
+        ok &= finite;
+    }
+    os << std::defaultfloat << std::setprecision(6);
+    return ok;
+}
@@ -0,0 +1,109 @@
+#ifndef MOTIONFILTER_H
+#define MOTIONFILTER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * @class MotionFilter
+ * @brief 1kHz触觉采样与机械臂指令流之间的六轴平滑/抽取滤波器
+ *
+ * 伺服线程每帧以相对锚点的偏移量（X/Y/Z微米，RX/RY/RZ毫弧度）调用 push()，
+ * 到达发送节拍时调用 take() 取出要发送的值。状态为固定大小数组，无分配、无锁。
+ * 支持的类型：
+ * - None：直通，发送节拍上的最新采样
+ * - OneEuro：one-euro 自适应低通，慢速时强平滑去抖，快速时提高截止频率减小滞后
+ * - CriticallyDamped：临界阻尼二阶低通（隐式欧拉离散，任意dt下稳定）
+ * - MovingAverage：对两次发送之间的全部采样取平均（抽取前的抗混叠）
+ */
+class MotionFilter {
+public:
+    enum Type { None, OneEuro, CriticallyDamped, MovingAverage };
+
+    static const int kAxes = 6;
+
+    /**
+     * @brief 滤波参数
+     */
+    struct Params {
+        Type type;
+        double minCutoffHz;        // OneEuro: 静止时的截止频率
+        double betaPosition;       // OneEuro: 位置轴速度系数 (1/微米)
+        double betaRotation;       // OneEuro: 姿态轴速度系数 (1/毫弧度)
+        double derivativeCutoffHz; // OneEuro: 速度估计的截止频率
+        double cutoffHz;           // CriticallyDamped: 自然频率
+
+        Params()
+            : type(None), minCutoffHz(2.0), betaPosition(0.0002), betaRotation(0.02),
+              derivativeCutoffHz(1.0), cutoffHz(8.0) {}
+    };
+
+    MotionFilter();
+
+    /**
+     * @brief 设置滤波参数（在伺服线程外、拖动开始前调用）
+     */
+    void configure(const Params& params);
+
+    const Params& getParams() const { return m_params; }
+
+    /**
+     * @brief 从配置字符串解析滤波类型
+     * @param name none / one_euro / critically_damped / moving_average
+     * @param type 输出类型
+     * @return 名称有效时返回true
+     */
+    static bool parseType(const std::string& name, Type& type);
+
+    static const char* typeName(Type type);
+
+    /**
+     * @brief 以当前偏移量重置滤波状态（离合开始时调用）
+     * @param sample 六轴初始值
+     * @param nowNs 当前单调时钟时间（纳秒）
+     */
+    void reset(const double sample[kAxes], uint64_t nowNs);
+
+    /**
+     * @brief 输入一个采样（伺服线程每帧调用）
+     * @param sample 六轴偏移量
+     * @param nowNs 采样时间（纳秒）
+     */
+    void push(const double sample[kAxes], uint64_t nowNs);
+
+    /**
+     * @brief 取出发送节拍的输出；MovingAverage会同时开始新的平均窗口
+     * @param out 六轴输出
+     */
+    void take(double out[kAxes]);
+
+    /**
+     * @brief 估计低速输入下的相位滞后（毫秒），用于日志和调参
+     * @param sendRateHz 发送频率（MovingAverage的窗口由它决定）
+     */
+    double nominalLagMs(double sendRateHz) const;
+
+    /**
+     * @brief 离线基准：四种滤波类型（参数取自 params）在1kHz输入、给定发送频率下的
+     *        单帧耗时（push + 发送节拍的 take），以及 X 轴 20mm@0.5Hz 正弦叠加 0.5mm@10Hz 震颤时
+     *        0.5Hz 的相位滞后和 10Hz 震颤增益
+     * @return 所有输出均为有限值时返回true
+     */
+    static bool benchmark(std::ostream& os, const Params& params, double sendRateHz);
+
+private:
+    static double smoothingFactor(double cutoffHz, double dt);
+
+    Params m_params;
+    bool m_initialized;
+    uint64_t m_lastNs;
+
+    double m_value[kAxes];        // 滤波输出（OneEuro/CriticallyDamped）或最新采样
+    double m_rate[kAxes];         // OneEuro: 滤波后的速度；CriticallyDamped: 状态速度
+    double m_lastInput[kAxes];    // OneEuro: 上一个原始采样
+    double m_windowSum[kAxes];    // MovingAverage: 当前窗口累计
+    uint32_t m_windowCount;       // MovingAverage: 当前窗口采样数
+};
+
+#endif // MOTIONFILTER_H
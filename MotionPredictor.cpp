@@ -0,0 +1,248 @@
+#include "MotionPredictor.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+
+// 会话中相邻采样间隔超过该值视为新的拖动段
+const uint64_t kSegmentGapNs = 50000000;
+
+// 按向量长度限幅，保持外推方向不变
+void clampLead(double* lead, double limit) {
+    double norm = std::sqrt(lead[0] * lead[0] + lead[1] * lead[1] + lead[2] * lead[2]);
+    if (norm > limit && norm > 0.0) {
+        double scale = limit / norm;
+        lead[0] *= scale;
+        lead[1] *= scale;
+        lead[2] *= scale;
+    }
+}
+
+} // namespace
+
+MotionPredictor::MotionPredictor()
+    : m_initialized(false), m_lastNs(0), m_latencyMs(0.0), m_horizonUs(0) {
+    for (int i = 0; i < kAxes; ++i) {
+        m_lastOffset[i] = 0.0;
+        m_velocity[i] = 0.0;
+        m_acceleration[i] = 0.0;
+    }
+    updateHorizon();
+}
+
+void MotionPredictor::configure(const Params& params) {
+    m_params = params;
+    if (m_params.horizonMs < 0.0) m_params.horizonMs = 0.0;
+    if (m_params.maxHorizonMs < m_params.horizonMs) m_params.maxHorizonMs = m_params.horizonMs;
+    if (m_params.maxLeadPosition < 0.0) m_params.maxLeadPosition = 0.0;
+    if (m_params.maxLeadRotation < 0.0) m_params.maxLeadRotation = 0.0;
+    if (m_params.velocityCutoffHz <= 0.0) m_params.velocityCutoffHz = 15.0;
+    if (m_params.latencyGain < 0.0) m_params.latencyGain = 0.0;
+    m_initialized = false;
+    updateHorizon();
+}
+
+bool MotionPredictor::parseMode(const std::string& name, Mode& mode) {
+    if (name == "off") {
+        mode = Off;
+    } else if (name == "velocity") {
+        mode = Velocity;
+    } else if (name == "constant_acceleration") {
+        mode = ConstantAcceleration;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* MotionPredictor::modeName(Mode mode) {
+    switch (mode) {
+        case Velocity: return "velocity";
+        case ConstantAcceleration: return "constant_acceleration";
+        default: return "off";
+    }
+}
+
+void MotionPredictor::reset(const double offset[kAxes], uint64_t nowNs) {
+    for (int i = 0; i < kAxes; ++i) {
+        m_lastOffset[i] = offset[i];
+        m_velocity[i] = 0.0;
+        m_acceleration[i] = 0.0;
+    }
+    m_lastNs = nowNs;
+    m_initialized = true;
+}
+
+void MotionPredictor::setMeasuredLatency(uint64_t oneWayNs) {
+    // 单次测量抖动较大，用指数平均平滑
+    double sampleMs = oneWayNs / 1e6;
+    m_latencyMs = m_latencyMs == 0.0 ? sampleMs : m_latencyMs + 0.1 * (sampleMs - m_latencyMs);
+    updateHorizon();
+}
+
+void MotionPredictor::updateHorizon() {
+    double horizonMs = m_params.horizonMs;
+    if (m_params.adaptive) {
+        horizonMs += m_params.latencyGain * m_latencyMs;
+    }
+    if (horizonMs > m_params.maxHorizonMs) {
+        horizonMs = m_params.maxHorizonMs;
+    }
+    m_horizonUs.store(static_cast<uint64_t>(horizonMs * 1000.0), std::memory_order_relaxed);
+}
+
+double MotionPredictor::getHorizonMs() const {
+    return m_horizonUs.load(std::memory_order_relaxed) / 1000.0;
+}
+
+void MotionPredictor::predict(const double offset[kAxes], const double* velocity,
+                              uint64_t nowNs, double out[kAxes]) {
+    if (!m_initialized) {
+        reset(offset, nowNs);
+    }
+
+    double dt = nowNs > m_lastNs ? (nowNs - m_lastNs) * 1e-9 : 0.001;
+    m_lastNs = nowNs;
+    double alpha = dt / (dt + 1.0 / (2.0 * M_PI * m_params.velocityCutoffHz));
+
+    // 差分速度/加速度估计在Off模式下也保持更新，切换模式时无需预热
+    for (int i = 0; i < kAxes; ++i) {
+        double rawVelocity = (offset[i] - m_lastOffset[i]) / dt;
+        double previousVelocity = m_velocity[i];
+        m_velocity[i] += alpha * (rawVelocity - m_velocity[i]);
+        m_acceleration[i] += alpha * ((m_velocity[i] - previousVelocity) / dt - m_acceleration[i]);
+        m_lastOffset[i] = offset[i];
+    }
+
+    if (m_params.mode == Off) {
+        for (int i = 0; i < kAxes; ++i) {
+            out[i] = offset[i];
+        }
+        return;
+    }
+
+    double h = m_horizonUs.load(std::memory_order_relaxed) * 1e-6;
+    double lead[kAxes];
+    for (int i = 0; i < kAxes; ++i) {
+        if (m_params.mode == ConstantAcceleration) {
+            lead[i] = m_velocity[i] * h + 0.5 * m_acceleration[i] * h * h;
+        } else {
+            double v = (velocity && i < 3) ? velocity[i] : m_velocity[i];
+            lead[i] = v * h;
+        }
+    }
+    clampLead(lead, m_params.maxLeadPosition);
+    clampLead(lead + 3, m_params.maxLeadRotation);
+
+    for (int i = 0; i < kAxes; ++i) {
+        out[i] = offset[i] + lead[i];
+    }
+}
+
+bool MotionPredictor::loadSession(const std::string& filename, std::vector<MotionSample>& samples) {
+    std::ifstream file(filename.c_str());
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#' || line[0] == 't') {
+            continue;   // 注释或表头
+        }
+        MotionSample sample;
+        unsigned long long timestamp = 0;
+        int fields = sscanf(line.c_str(), "%llu,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf", &timestamp,
+                            &sample.offset[0], &sample.offset[1], &sample.offset[2],
+                            &sample.offset[3], &sample.offset[4], &sample.offset[5],
+                            &sample.velocity[0], &sample.velocity[1], &sample.velocity[2]);
+        if (fields < 7) {
+            continue;
+        }
+        if (fields < 10) {
+            sample.velocity[0] = sample.velocity[1] = sample.velocity[2] = 0.0;
+        }
+        sample.timestampNs = timestamp;
+        samples.push_back(sample);
+    }
+    return !samples.empty();
+}
+
+void MotionPredictor::evaluate(const std::vector<MotionSample>& samples, const Params& params,
+                               double latencyMs, Report& report) {
+    MotionPredictor predictor;
+    predictor.configure(params);
+    if (params.adaptive) {
+        predictor.setMeasuredLatency(static_cast<uint64_t>(latencyMs * 1e6));
+    }
+
+    report.samples = 0;
+    report.horizonMs = predictor.getHorizonMs();
+    double baselinePos = 0.0, predictedPos = 0.0, baselineRot = 0.0, predictedRot = 0.0;
+    uint64_t latencyNs = static_cast<uint64_t>(latencyMs * 1e6);
+
+    // 逐段回放：第i帧发送的目标在 t_i + latency 时由机械臂到达，与该时刻的触觉位置比较
+    size_t future = 0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const MotionSample& sample = samples[i];
+        if (i == 0 || sample.timestampNs < samples[i - 1].timestampNs ||
+            sample.timestampNs - samples[i - 1].timestampNs > kSegmentGapNs) {
+            future = i;
+            predictor.reset(sample.offset, sample.timestampNs);
+        }
+
+        double predicted[kAxes];
+        predictor.predict(sample.offset, sample.velocity, sample.timestampNs, predicted);
+
+        // 找到同一段内 t_i + latency 时刻的采样
+        if (future < i) {
+            future = i;
+        }
+        while (future + 1 < samples.size() &&
+               samples[future].timestampNs < sample.timestampNs + latencyNs &&
+               samples[future + 1].timestampNs >= samples[future].timestampNs &&
+               samples[future + 1].timestampNs - samples[future].timestampNs <= kSegmentGapNs) {
+            ++future;
+        }
+        if (samples[future].timestampNs < sample.timestampNs + latencyNs) {
+            continue;   // 本段剩余时长不足一个延迟
+        }
+
+        const double* actual = samples[future].offset;
+        for (int axis = 0; axis < kAxes; ++axis) {
+            double baseline = actual[axis] - sample.offset[axis];
+            double error = actual[axis] - predicted[axis];
+            if (axis < 3) {
+                baselinePos += baseline * baseline;
+                predictedPos += error * error;
+            } else {
+                baselineRot += baseline * baseline;
+                predictedRot += error * error;
+            }
+        }
+        ++report.samples;
+    }
+
+    double n = report.samples > 0 ? static_cast<double>(report.samples) : 1.0;
+    report.baselinePositionRms = std::sqrt(baselinePos / n);
+    report.predictedPositionRms = std::sqrt(predictedPos / n);
+    report.baselineRotationRms = std::sqrt(baselineRot / n);
+    report.predictedRotationRms = std::sqrt(predictedRot / n);
+}
+
+void MotionPredictor::printReport(std::ostream& os, const Report& report) {
+    double positionGain = report.baselinePositionRms > 0.0
+        ? 100.0 * (1.0 - report.predictedPositionRms / report.baselinePositionRms) : 0.0;
+    double rotationGain = report.baselineRotationRms > 0.0
+        ? 100.0 * (1.0 - report.predictedRotationRms / report.baselineRotationRms) : 0.0;
+    os << std::fixed << std::setprecision(1)
+       << "  预测时长 " << std::setw(6) << report.horizonMs << "ms, 样本 " << report.samples
+       << " | 位置RMS " << report.baselinePositionRms << " → " << report.predictedPositionRms
+       << "μm (" << positionGain << "%)"
+       << " | 姿态RMS " << report.baselineRotationRms << " → " << report.predictedRotationRms
+       << "mrad (" << rotationGain << "%)"
+       << std::defaultfloat << std::endl;
+}
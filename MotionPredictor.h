@@ -0,0 +1,146 @@
+#ifndef MOTIONPREDICTOR_H
+#define MOTIONPREDICTOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct MotionSample
+ * @brief 一帧映射后的运动采样（用于会话录制和离线回放）
+ */
+struct MotionSample {
+    uint64_t timestampNs;   // 单调时钟时间戳（纳秒）
+    double offset[6];       // 相对锚点的偏移量（X/Y/Z微米，RX/RY/RZ毫弧度）
+    double velocity[3];     // 映射后的设备速度（微米/秒）
+};
+
+/**
+ * @class MotionPredictor
+ * @brief 机械臂目标流的延迟补偿预测器
+ *
+ * 机械臂相对触觉笔的滞后 = 网络延迟 + 控制器跟随滞后。预测器在映射之后、滤波之前，
+ * 把目标偏移量沿当前运动外推一个预测时长：
+ * - Velocity：位置轴使用设备速度（HD_CURRENT_VELOCITY），姿态轴使用差分速度
+ * - ConstantAcceleration：所有轴使用差分估计的速度和加速度
+ * 外推量按位置/姿态分别限幅。开启自适应后，预测时长 = 基础时长 + 系数 × 测得的单程延迟。
+ * 伺服线程调用，状态为固定大小数组，无分配、无锁。
+ */
+class MotionPredictor {
+public:
+    enum Mode { Off, Velocity, ConstantAcceleration };
+
+    static const int kAxes = 6;
+
+    /**
+     * @brief 预测参数
+     */
+    struct Params {
+        Mode mode;
+        double horizonMs;          // 基础预测时长（覆盖控制器跟随滞后）
+        double maxHorizonMs;       // 预测时长上限
+        double maxLeadPosition;    // 位置外推量上限（微米）
+        double maxLeadRotation;    // 姿态外推量上限（毫弧度）
+        double velocityCutoffHz;   // 差分速度/加速度估计的低通截止频率
+        bool adaptive;             // 是否根据测得的延迟自动调整预测时长
+        double latencyGain;        // 自适应时测得延迟的系数
+
+        Params()
+            : mode(Off), horizonMs(30.0), maxHorizonMs(150.0),
+              maxLeadPosition(20000.0), maxLeadRotation(200.0),
+              velocityCutoffHz(15.0), adaptive(false), latencyGain(1.0) {}
+    };
+
+    /**
+     * @brief 离线回放评估结果（跟踪误差为RMS）
+     */
+    struct Report {
+        size_t samples;
+        double horizonMs;              // 评估使用的预测时长
+        double baselinePositionRms;    // 不预测时的位置跟踪误差（微米）
+        double predictedPositionRms;   // 预测后的位置跟踪误差（微米）
+        double baselineRotationRms;    // 不预测时的姿态跟踪误差（毫弧度）
+        double predictedRotationRms;   // 预测后的姿态跟踪误差（毫弧度）
+    };
+
+    MotionPredictor();
+
+    /**
+     * @brief 设置预测参数（在伺服线程外、拖动开始前调用）
+     */
+    void configure(const Params& params);
+
+    const Params& getParams() const { return m_params; }
+
+    /**
+     * @brief 从配置字符串解析预测模式
+     * @param name off / velocity / constant_acceleration
+     * @param mode 输出模式
+     * @return 名称有效时返回true
+     */
+    static bool parseMode(const std::string& name, Mode& mode);
+
+    static const char* modeName(Mode mode);
+
+    /**
+     * @brief 重置运动估计（离合开始时调用）
+     */
+    void reset(const double offset[kAxes], uint64_t nowNs);
+
+    /**
+     * @brief 更新测得的单程延迟（自适应模式使用）
+     * @param oneWayNs 指令从生成到机械臂接收的估计延迟（纳秒）
+     */
+    void setMeasuredLatency(uint64_t oneWayNs);
+
+    /**
+     * @brief 输入一帧采样并输出外推后的偏移量（伺服线程每帧调用）
+     * @param offset 映射后的六轴偏移量
+     * @param velocity 映射后的位置轴速度（微米/秒），为空时使用差分速度
+     * @param nowNs 采样时间（纳秒）
+     * @param out 外推后的六轴偏移量
+     */
+    void predict(const double offset[kAxes], const double* velocity, uint64_t nowNs, double out[kAxes]);
+
+    /**
+     * @brief 当前使用的预测时长（毫秒，任意线程可调用）
+     */
+    double getHorizonMs() const;
+
+    /**
+     * @brief 读取录制的会话文件（CSV: t_ns,x,y,z,rx,ry,rz,vx,vy,vz）
+     * @return 文件无法打开或没有有效行时返回false
+     */
+    static bool loadSession(const std::string& filename, std::vector<MotionSample>& samples);
+
+    /**
+     * @brief 离线回放：假设机械臂在 latencyMs 后到达发送的目标，比较预测前后的跟踪误差
+     * @param samples 录制的会话（同一次拖动内的连续采样）
+     * @param params 预测参数（自适应模式下把 latencyMs 作为测得延迟）
+     * @param latencyMs 回放时假设的端到端延迟
+     * @param report 输出评估结果
+     */
+    static void evaluate(const std::vector<MotionSample>& samples, const Params& params,
+                         double latencyMs, Report& report);
+
+    /**
+     * @brief 打印评估结果
+     */
+    static void printReport(std::ostream& os, const Report& report);
+
+private:
+    void updateHorizon();
+
+    Params m_params;
+    bool m_initialized;
+    uint64_t m_lastNs;
+    double m_lastOffset[kAxes];
+    double m_velocity[kAxes];       // 差分速度估计（单位/秒）
+    double m_acceleration[kAxes];   // 差分加速度估计（单位/秒²）
+    double m_latencyMs;             // 测得单程延迟的平滑值
+    std::atomic<uint64_t> m_horizonUs;   // 当前预测时长（微秒）
+};
+
+#endif // MOTIONPREDICTOR_H
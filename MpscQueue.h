@@ -0,0 +1,108 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class MpscQueue
+ * @brief 有界多生产者/单消费者无锁环形队列
+ *
+ * 特性：
+ * - 每个槽位带序号，生产者用CAS抢占写位置，写完后发布槽位序号
+ * - 消费者只在槽位序号就绪时读取，push/pop 均不加锁、不分配内存、不进行系统调用
+ * - 队列满时 tryPush 直接返回 false，由调用方处理
+ * 用于伺服线程、键盘线程和主线程向反应器线程提交请求。
+ *
+ * @tparam T        元素类型（可拷贝赋值）
+ * @tparam Capacity 容量，必须为2的幂
+ */
+template <typename T, size_t Capacity>
+class MpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "MpscQueue容量必须为2的幂");
+
+public:
+    MpscQueue() : m_head(0), m_tail(0) {
+        for (size_t i = 0; i < Capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 生产者入队（任意线程）
+     * @param item 待入队元素
+     * @return 队列已满时返回false
+     */
+    bool tryPush(const T& item) {
+        size_t position = m_tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &m_cells[position & (Capacity - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;   // 消费者还没读走这一圈的元素
+            } else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = item;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 消费者出队（只能由一个线程调用）
+     * @param item 输出元素
+     * @return 队列为空（或队首元素仍在写入中）时返回false
+     */
+    bool tryPop(T& item) {
+        size_t position = m_head.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[position & (Capacity - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+        item = cell.value;
+        cell.sequence.store(position + Capacity, std::memory_order_release);
+        m_head.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief 当前队列深度（任意线程可调用，结果为近似值）
+     */
+    size_t size() const {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    static size_t capacity() { return Capacity; }
+
+private:
+    MpscQueue(const MpscQueue&);
+    MpscQueue& operator=(const MpscQueue&);
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // 消费者和生产者索引用填充隔开，避免伪共享（同SpscQueue，不使用alignas）
+    static const size_t kCacheLine = 64;
+
+    char m_pad0[kCacheLine];
+    std::atomic<size_t> m_head;   // 消费者读位置
+    char m_pad1[kCacheLine - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_tail;   // 生产者抢占的写位置
+    char m_pad2[kCacheLine - sizeof(std::atomic<size_t>)];
+    Cell m_cells[Capacity];
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,157 @@
+#ifndef ORIENTATIONMATH_H
+#define ORIENTATIONMATH_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+/**
+ * @class OrientationMath
+ * @brief 姿态映射使用的3x3旋转矩阵运算
+ *
+ * 用于替代逐帧的欧拉角提取与相减：
+ * - 离合时预先计算锚点旋转的逆（转置）
+ * - 每帧只组合一次相对旋转 R_rel = R_cur * R_anchor^T，再取旋转向量（对数映射）
+ * - 轴置换、符号和系数由 AxisMapping 预先合成
+ * - 发送节拍上把映射后的旋转向量左乘到机械臂锚点姿态上 R_target = R(v) * R_euler(anchor)，
+ *   再转换一次回控制器的欧拉角
+ * 旋转向量在±180°附近和万向节锁处仍然连续，每帧只需一次atan2和一次sqrt。
+ */
+class OrientationMath {
+public:
+    typedef std::array<double, 9> Mat3;   // 行优先
+    typedef std::array<double, 3> Vec3;
+
+    static Mat3 identity() {
+        Mat3 m = {{1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0}};
+        return m;
+    }
+
+    /**
+     * @brief 从OpenHaptics的4x4变换矩阵（列优先）提取旋转部分
+     */
+    static Mat3 rotationFromTransform(const std::array<double, 16>& transform) {
+        Mat3 r = {{transform[0], transform[4], transform[8],
+                   transform[1], transform[5], transform[9],
+                   transform[2], transform[6], transform[10]}};
+        return r;
+    }
+
+    static Mat3 transpose(const Mat3& a) {
+        Mat3 t = {{a[0], a[3], a[6],
+                   a[1], a[4], a[7],
+                   a[2], a[5], a[8]}};
+        return t;
+    }
+
+    static Mat3 multiply(const Mat3& a, const Mat3& b) {
+        Mat3 c;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                c[i * 3 + j] = a[i * 3] * b[j] + a[i * 3 + 1] * b[3 + j] + a[i * 3 + 2] * b[6 + j];
+            }
+        }
+        return c;
+    }
+
+    static Vec3 multiply(const Mat3& a, const Vec3& v) {
+        Vec3 r = {{a[0] * v[0] + a[1] * v[1] + a[2] * v[2],
+                   a[3] * v[0] + a[4] * v[1] + a[5] * v[2],
+                   a[6] * v[0] + a[7] * v[1] + a[8] * v[2]}};
+        return r;
+    }
+
+    /**
+     * @brief 旋转向量（轴*角，弧度）→ 旋转矩阵（Rodrigues公式）
+     */
+    static Mat3 fromRotationVector(const Vec3& v) {
+        double angle = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        if (angle < 1e-12) {
+            return identity();
+        }
+        double x = v[0] / angle, y = v[1] / angle, z = v[2] / angle;
+        double c = std::cos(angle), s = std::sin(angle), t = 1.0 - c;
+        Mat3 r = {{t * x * x + c,     t * x * y - s * z, t * x * z + s * y,
+                   t * x * y + s * z, t * y * y + c,     t * y * z - s * x,
+                   t * x * z - s * y, t * y * z + s * x, t * z * z + c}};
+        return r;
+    }
+
+    /**
+     * @brief 机械臂控制器的X-Y-Z固定轴欧拉角（弧度）→ 旋转矩阵，R = Rz * Ry * Rx
+     */
+    static Mat3 fromEuler(const Vec3& euler) {
+        double cx = std::cos(euler[0]), sx = std::sin(euler[0]);
+        double cy = std::cos(euler[1]), sy = std::sin(euler[1]);
+        double cz = std::cos(euler[2]), sz = std::sin(euler[2]);
+        Mat3 r = {{cz * cy, cz * sy * sx - sz * cx, cz * sy * cx + sz * sx,
+                   sz * cy, sz * sy * sx + cz * cx, sz * sy * cx - cz * sx,
+                   -sy,     cy * sx,                cy * cx}};
+        return r;
+    }
+
+    /**
+     * @brief 旋转矩阵 → X-Y-Z固定轴欧拉角（弧度），fromEuler 的逆
+     * @param reference 各角加减2π后取离 reference 最近的值（以锚点为参考，±180°附近不跳变）
+     */
+    static Vec3 eulerAngles(const Mat3& r, const Vec3& reference) {
+        Vec3 euler = {{std::atan2(r[7], r[8]),
+                       std::asin(std::max(-1.0, std::min(1.0, -r[6]))),
+                       std::atan2(r[3], r[0])}};
+        for (int i = 0; i < 3; ++i) {
+            euler[i] += 2.0 * M_PI * std::floor((reference[i] - euler[i]) / (2.0 * M_PI) + 0.5);
+        }
+        return euler;
+    }
+
+    /**
+     * @brief 两个旋转之间的夹角（弧度）
+     */
+    static double angleBetween(const Mat3& a, const Mat3& b) {
+        Vec3 v = rotationVector(multiply(transpose(a), b));
+        return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    }
+
+    /**
+     * @brief 旋转矩阵的旋转向量（轴*角，弧度），角度范围[0, π]
+     */
+    static Vec3 rotationVector(const Mat3& r) {
+        // sin(θ)*轴 = 反对称部分，cos(θ) = (trace-1)/2
+        Vec3 w = {{0.5 * (r[7] - r[5]), 0.5 * (r[2] - r[6]), 0.5 * (r[3] - r[1])}};
+        double sinAngle = std::sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+        double cosAngle = 0.5 * (r[0] + r[4] + r[8] - 1.0);
+        double angle = std::atan2(sinAngle, cosAngle);
+
+        if (sinAngle > 1e-6) {
+            double k = angle / sinAngle;
+            Vec3 v = {{w[0] * k, w[1] * k, w[2] * k}};
+            return v;
+        }
+
+        if (cosAngle > 0.0) {
+            // θ≈0：旋转向量≈反对称部分
+            return w;
+        }
+
+        // θ≈π：反对称部分消失，由对角线恢复转轴，符号参考非对角项
+        Vec3 axis;
+        double denom = 1.0 - cosAngle;
+        axis[0] = std::sqrt(std::max(0.0, (r[0] - cosAngle) / denom));
+        axis[1] = std::sqrt(std::max(0.0, (r[4] - cosAngle) / denom));
+        axis[2] = std::sqrt(std::max(0.0, (r[8] - cosAngle) / denom));
+        if (axis[0] >= axis[1] && axis[0] >= axis[2]) {
+            axis[1] = std::copysign(axis[1], r[1] + r[3]);
+            axis[2] = std::copysign(axis[2], r[2] + r[6]);
+        } else if (axis[1] >= axis[2]) {
+            axis[0] = std::copysign(axis[0], r[1] + r[3]);
+            axis[2] = std::copysign(axis[2], r[5] + r[7]);
+        } else {
+            axis[0] = std::copysign(axis[0], r[2] + r[6]);
+            axis[1] = std::copysign(axis[1], r[5] + r[7]);
+        }
+        Vec3 v = {{axis[0] * angle, axis[1] * angle, axis[2] * angle}};
+        return v;
+    }
+};
+
+#endif // ORIENTATIONMATH_H
@@ -0,0 +1,71 @@
+#include "RmAlgoIkSolver.h"
+
+#include <cstring>
+#include <mutex>
+
+#include "rm_interface.h"
+
+namespace {
+
+// 算法库参数为进程全局状态
+std::mutex g_algoMutex;
+bool g_algoInitialized = false;
+
+} // namespace
+
+RmAlgoIkSolver::RmAlgoIkSolver(const ArmKinematics& kinematics)
+    : m_kinematics(kinematics), m_lastError(0) {
+    const double* tool = kinematics.getToolOffset();
+    for (int i = 0; i < 3; ++i) {
+        m_toolOffset[i] = tool[i];
+    }
+    std::lock_guard<std::mutex> lock(g_algoMutex);
+    if (!g_algoInitialized) {
+        rm_algo_init_sys_data(RM_MODEL_RM_65_E, RM_MODEL_RM_B_E);
+        rm_algo_set_redundant_parameter_traversal_mode(false);
+        g_algoInitialized = true;
+    }
+}
+
+bool RmAlgoIkSolver::solve(const ArmKinematics::Pose& target, const ArmKinematics::Joints& seed,
+                           ArmKinematics::Joints& solution, ArmKinematics::Result& result) {
+    rm_inverse_kinematics_params_t params;
+    memset(&params, 0, sizeof(params));
+    for (int i = 0; i < ArmKinematics::kJoints; ++i) {
+        params.q_in[i] = static_cast<float>(seed[i]);
+    }
+    params.q_pose.position.x = static_cast<float>(target[0] / 1e6);
+    params.q_pose.position.y = static_cast<float>(target[1] / 1e6);
+    params.q_pose.position.z = static_cast<float>(target[2] / 1e6);
+    params.q_pose.euler.rx = static_cast<float>(target[3] / 1000.0);
+    params.q_pose.euler.ry = static_cast<float>(target[4] / 1000.0);
+    params.q_pose.euler.rz = static_cast<float>(target[5] / 1000.0);
+    params.flag = 1;
+
+    float out[ARM_DOF] = {0};
+    {
+        std::lock_guard<std::mutex> lock(g_algoMutex);
+        rm_frame_t tool;
+        memset(&tool, 0, sizeof(tool));
+        strncpy(tool.frame_name, "ik_tool", sizeof(tool.frame_name) - 1);
+        tool.pose.position.x = static_cast<float>(m_toolOffset[0] / 1000.0);
+        tool.pose.position.y = static_cast<float>(m_toolOffset[1] / 1000.0);
+        tool.pose.position.z = static_cast<float>(m_toolOffset[2] / 1000.0);
+        tool.pose.quaternion.w = 1.0f;
+        rm_algo_set_toolframe(&tool);
+        m_lastError = rm_algo_inverse_kinematics(NULL, params, out);
+    }
+
+    if (m_lastError != 0) {
+        solution = seed;
+        m_kinematics.evaluate(target, seed, result);
+        result.converged = false;
+        return false;
+    }
+    for (int i = 0; i < ArmKinematics::kJoints; ++i) {
+        solution[i] = out[i];
+    }
+    m_kinematics.evaluate(target, solution, result);
+    result.iterations = 1;
+    return true;
+}
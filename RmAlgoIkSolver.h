@@ -0,0 +1,42 @@
+#ifndef RMALGOIKSOLVER_H
+#define RMALGOIKSOLVER_H
+
+#include "IkSolver.h"
+
+/**
+ * @class RmAlgoIkSolver
+ * @brief RM_API2 算法库的逆解（编译时定义 USE_RM_API2 才可用）
+ *
+ * - 不连接机械臂（句柄为NULL），按型号初始化算法数据，使用单步模式
+ *   （自动调整冗余参数，适合连续周期控制）
+ * - 算法库的型号、工具坐标系等参数是进程全局状态，所有实例的调用用同一个互斥量串行化，
+ *   每次求解前重新设置本实例的工具坐标系
+ * - 解的残差和可操作度由 ArmKinematics 按同一模型计算，与内置求解器的统计口径一致
+ */
+class RmAlgoIkSolver : public IkSolver {
+public:
+    /**
+     * @param kinematics 与控制器一致的模型和工具偏移（用于校验残差）
+     */
+    explicit RmAlgoIkSolver(const ArmKinematics& kinematics);
+
+    const char* name() const override { return "rm_algo"; }
+
+    bool solve(const ArmKinematics::Pose& target, const ArmKinematics::Joints& seed,
+               ArmKinematics::Joints& solution, ArmKinematics::Result& result) override;
+
+    /**
+     * @brief 最近一次 rm_algo_inverse_kinematics 的返回码（0成功，1失败，-1初值超限位，-2姿态非法）
+     */
+    int getLastError() const { return m_lastError; }
+
+private:
+    RmAlgoIkSolver(const RmAlgoIkSolver&);
+    RmAlgoIkSolver& operator=(const RmAlgoIkSolver&);
+
+    ArmKinematics m_kinematics;
+    double m_toolOffset[3];   // 毫米
+    int m_lastError;
+};
+
+#endif // RMALGOIKSOLVER_H
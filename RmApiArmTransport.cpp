@@ -0,0 +1,518 @@
+#include "RmApiArmTransport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include "ArmCommandPipeline.h"
+#include "BinaryLogger.h"
+#include "rm_interface.h"
+
+namespace {
+
+// 服务线程节拍：与通信反应器相同
+const uint64_t kTickNs = 200000;
+
+// RM_API2 全局初始化（双线程模式：库内接收线程负责分拣响应，不占用UDP上报端口）
+std::once_flag g_rmInitOnce;
+
+void storeMax(std::atomic<uint64_t>& target, uint64_t value) {
+    if (value > target.load(std::memory_order_relaxed)) {
+        target.store(value, std::memory_order_relaxed);
+    }
+}
+
+void increment(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+// 微米/毫弧度 → 米/弧度；四元数全为0时控制器使用欧拉角
+rm_pose_t toRmPose(const std::array<int, 6>& pose) {
+    rm_pose_t result;
+    memset(&result, 0, sizeof(result));
+    result.position.x = static_cast<float>(pose[0] * 1e-6);
+    result.position.y = static_cast<float>(pose[1] * 1e-6);
+    result.position.z = static_cast<float>(pose[2] * 1e-6);
+    result.euler.rx = static_cast<float>(pose[3] * 1e-3);
+    result.euler.ry = static_cast<float>(pose[4] * 1e-3);
+    result.euler.rz = static_cast<float>(pose[5] * 1e-3);
+    return result;
+}
+
+void fromRmState(const rm_current_arm_state_t& state, ArmResponse& response) {
+    response.clear();
+    response.fields = ArmResponse::FieldState | ArmResponse::FieldArmState | ArmResponse::FieldPose |
+                      ArmResponse::FieldJoint | ArmResponse::FieldErrors;
+    strncpy(response.state, "current_arm_state", ArmResponse::kNameLength - 1);
+    response.pose[0] = static_cast<int>(std::lround(state.pose.position.x * 1e6));
+    response.pose[1] = static_cast<int>(std::lround(state.pose.position.y * 1e6));
+    response.pose[2] = static_cast<int>(std::lround(state.pose.position.z * 1e6));
+    response.pose[3] = static_cast<int>(std::lround(state.pose.euler.rx * 1e3));
+    response.pose[4] = static_cast<int>(std::lround(state.pose.euler.ry * 1e3));
+    response.pose[5] = static_cast<int>(std::lround(state.pose.euler.rz * 1e3));
+    response.jointCount = ArmResponse::kMaxJoints < ARM_DOF ? ArmResponse::kMaxJoints : ARM_DOF;
+    for (int i = 0; i < response.jointCount; ++i) {
+        response.joint[i] = state.joint[i];
+    }
+    int errCount = std::min<int>(state.err.err_len, ArmResponse::kMaxErrors);
+    for (int i = 0; i < errCount; ++i) {
+        response.err[i] = state.err.err[i];
+    }
+    response.errCount = static_cast<uint8_t>(errCount);
+}
+
+} // namespace
+
+RmApiArmTransport::RmApiArmTransport(const std::string& ip, int port, int trajectoryMode, int radio)
+    : m_ip(ip), m_port(port), m_name("机械臂 " + ip), m_trajectoryMode(trajectoryMode), m_radio(radio),
+      m_listener(nullptr), m_logSource(0),
+      m_running(false), m_connected(false), m_handle(nullptr),
+      m_streamKind(StreamNone), m_streamPose({0, 0, 0, 0, 0, 0}), m_streamJoints({0, 0, 0, 0, 0, 0}),
+      m_everConnected(false), m_reconnectAtNs(0),
+      m_backoffNs(500000000ULL), m_initialBackoffNs(500000000ULL), m_maxBackoffNs(30000000000ULL),
+      m_streamCounter(0), m_deferredSinceNs(0),
+      m_streamed(0), m_superseded(0), m_lastStreamCallNs(0), m_maxStreamCallNs(0),
+      m_deferredTicks(0), m_maxDeferNs(0),
+      m_commandsOk(0), m_commandsFailed(0), m_lastCommandNs(0), m_maxCommandNs(0),
+      m_connectFailures(0), m_disconnects(0), m_reconnects(0) {
+}
+
+RmApiArmTransport::~RmApiArmTransport() {
+    disconnect();
+}
+
+void RmApiArmTransport::setReconnectPolicy(int initialDelayMs, int maxDelayMs) {
+    if (initialDelayMs > 0) {
+        m_initialBackoffNs = static_cast<uint64_t>(initialDelayMs) * 1000000ULL;
+        m_backoffNs = m_initialBackoffNs;
+    }
+    if (maxDelayMs > 0) {
+        m_maxBackoffNs = static_cast<uint64_t>(maxDelayMs) * 1000000ULL;
+    }
+}
+
+void RmApiArmTransport::attach(Listener* listener, uint16_t logSource) {
+    m_listener = listener;
+    m_logSource = logSource;
+}
+
+bool RmApiArmTransport::connect() {
+    if (m_running.load(std::memory_order_acquire)) {
+        return true;
+    }
+    m_running.store(true, std::memory_order_release);
+    m_serviceThread = std::thread(&RmApiArmTransport::serviceLoop, this);
+    return true;
+}
+
+void RmApiArmTransport::disconnect() {
+    if (!m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_commandMutex);
+        m_running.store(false, std::memory_order_release);
+    }
+    m_commandReady.notify_all();
+    if (m_serviceThread.joinable()) {
+        m_serviceThread.join();
+    }
+}
+
+bool RmApiArmTransport::isServiceThread() const {
+    return std::this_thread::get_id() == m_serviceThread.get_id();
+}
+
+bool RmApiArmTransport::streamPose(const std::array<int, 6>& pose) {
+    if (!isConnected()) {
+        BinaryLogger::instance().log(LOG_TCP_NOT_CONNECTED, m_logSource);
+        return false;
+    }
+    if (m_streamKind != StreamNone) {
+        increment(m_superseded);
+    }
+    m_streamKind = StreamPose;
+    m_streamPose = pose;
+    return flushStream();
+}
+
+bool RmApiArmTransport::streamJoints(const std::array<double, 6>& joints) {
+    if (!isConnected()) {
+        return false;
+    }
+    for (int i = 0; i < 6; ++i) {
+        if (!std::isfinite(joints[i])) {
+            return false;
+        }
+    }
+    if (m_streamKind != StreamNone) {
+        increment(m_superseded);
+    }
+    m_streamKind = StreamJoints;
+    m_streamJoints = joints;
+    return flushStream();
+}
+
+bool RmApiArmTransport::send(const ArmCommand& command, uint64_t timeoutNs, int retries, const Callback& callback) {
+    // 响应超时由RM_API2自身处理
+    (void)timeoutNs;
+    if (!isConnected()) {
+        BinaryLogger::instance().log(LOG_TCP_SEND_FAILED, m_logSource, ENOTCONN);
+        return false;
+    }
+    PendingCommand pending;
+    pending.command = command;
+    pending.retries = retries;
+    pending.sentNs = ArmCommandPipeline::nowNs();
+    pending.callback = callback;
+    {
+        std::lock_guard<std::mutex> lock(m_commandMutex);
+        m_commands.push_back(pending);
+    }
+    m_commandReady.notify_one();
+    return true;
+}
+
+void RmApiArmTransport::printStats(std::ostream& os, const std::string& prefix) const {
+    os << prefix << " RM_API2: "
+       << "流式=" << m_streamed.load(std::memory_order_relaxed)
+       << ", 覆盖=" << m_superseded.load(std::memory_order_relaxed)
+       << ", canfd调用=" << std::fixed << std::setprecision(3)
+       << (m_lastStreamCallNs.load(std::memory_order_relaxed) / 1e6) << "ms/"
+       << (m_maxStreamCallNs.load(std::memory_order_relaxed) / 1e6) << "ms(最大)"
+       << ", 句柄忙推迟=" << m_deferredTicks.load(std::memory_order_relaxed) << "节拍/"
+       << (m_maxDeferNs.load(std::memory_order_relaxed) / 1e6) << "ms(最长)"
+       << ", 指令成功=" << m_commandsOk.load(std::memory_order_relaxed)
+       << ", 失败=" << m_commandsFailed.load(std::memory_order_relaxed)
+       << ", 指令延迟=" << (m_lastCommandNs.load(std::memory_order_relaxed) / 1e6) << "ms/"
+       << (m_maxCommandNs.load(std::memory_order_relaxed) / 1e6) << "ms(最大)"
+       << ", 断开=" << m_disconnects.load(std::memory_order_relaxed)
+       << ", 重连=" << m_reconnects.load(std::memory_order_relaxed)
+       << ", 连接失败=" << m_connectFailures.load(std::memory_order_relaxed) << std::endl;
+}
+
+void RmApiArmTransport::serviceLoop() {
+    m_commandThread = std::thread(&RmApiArmTransport::commandLoop, this);
+
+    uint64_t nextTickNs = ArmCommandPipeline::nowNs();
+    while (m_running.load(std::memory_order_acquire)) {
+        uint64_t nowNs = ArmCommandPipeline::nowNs();
+        if (!m_handle && nowNs >= m_reconnectAtNs) {
+            open(nowNs);
+            nowNs = ArmCommandPipeline::nowNs();
+        }
+
+        deliverCompleted(nowNs);
+        flushStream();
+        if (m_listener) {
+            m_listener->onTransportTick(*this, nowNs);
+        }
+
+        nextTickNs += kTickNs;
+        uint64_t afterNs = ArmCommandPipeline::nowNs();
+        if (nextTickNs <= afterNs) {
+            nextTickNs = afterNs + kTickNs;   // 处理不及时（如重连阻塞）时不补发节拍
+        }
+        std::this_thread::sleep_for(std::chrono::nanoseconds(nextTickNs - afterNs));
+    }
+
+    m_commandReady.notify_all();
+    if (m_commandThread.joinable()) {
+        m_commandThread.join();
+    }
+
+    // 关闭：未执行的指令以失败完成，句柄删除后不再重连
+    {
+        std::lock_guard<std::mutex> lock(m_commandMutex);
+        while (!m_commands.empty()) {
+            CompletedCommand completed;
+            completed.pending = m_commands.front();
+            completed.result = -1;
+            m_completed.push_back(completed);
+            m_commands.pop_front();
+        }
+    }
+    if (m_handle) {
+        m_connected.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(m_handleMutex);
+            rm_delete_robot_arm(m_handle);
+            m_handle = nullptr;
+        }
+        if (m_listener) {
+            m_listener->onTransportDisconnected(*this);
+        }
+        std::cout << "[" << m_name << "] RM_API2连接已关闭" << std::endl;
+    }
+    deliverCompleted(ArmCommandPipeline::nowNs());
+}
+
+void RmApiArmTransport::commandLoop() {
+    while (true) {
+        PendingCommand pending;
+        {
+            std::unique_lock<std::mutex> lock(m_commandMutex);
+            m_commandReady.wait(lock, [this] {
+                return !m_running.load(std::memory_order_acquire) || !m_commands.empty();
+            });
+            if (!m_running.load(std::memory_order_acquire)) {
+                return;
+            }
+            pending = m_commands.front();
+            m_commands.pop_front();
+        }
+
+        CompletedCommand completed;
+        completed.pending = pending;
+        completed.response.clear();
+        for (int attempt = 0; ; ++attempt) {
+            completed.result = execute(pending.command, completed.response);
+            if (completed.result == 0 || attempt >= pending.retries || !m_running.load(std::memory_order_acquire)) {
+                break;
+            }
+            BinaryLogger::instance().log(LOG_POSE_QUERY_RETRY, m_logSource, attempt + 1);
+        }
+
+        std::lock_guard<std::mutex> lock(m_commandMutex);
+        m_completed.push_back(completed);
+    }
+}
+
+void RmApiArmTransport::open(uint64_t nowNs) {
+    std::call_once(g_rmInitOnce, [] { rm_init(RM_DUAL_MODE_E); });
+
+    // 阻塞连接并读取机械臂信息（只阻塞本机械臂的服务线程）
+    rm_robot_handle* handle = rm_create_robot_arm(m_ip.c_str(), m_port);
+    if (!handle || handle->id <= 0) {
+        if (handle) {
+            rm_delete_robot_arm(handle);
+        }
+        increment(m_connectFailures);
+        uint64_t delayNs = m_backoffNs;
+        m_backoffNs = std::min(m_backoffNs * 2, m_maxBackoffNs);
+        m_reconnectAtNs = nowNs + delayNs;
+        std::cout << "⚠️  [" << m_name << "] RM_API2连接失败，" << delayNs / 1000000 << "ms后"
+                  << (m_everConnected ? "重连" : "重试") << std::endl;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_handleMutex);
+        m_handle = handle;
+    }
+    m_backoffNs = m_initialBackoffNs;
+    if (m_everConnected) {
+        increment(m_reconnects);
+        std::cout << "✅ [" << m_name << "] 已重新连接 " << m_ip << ":" << m_port << " (RM_API2)" << std::endl;
+    } else {
+        std::cout << "✅ [" << m_name << "] 已连接 " << m_ip << ":" << m_port << " (RM_API2)" << std::endl;
+    }
+    m_everConnected = true;
+    m_connected.store(true, std::memory_order_release);
+    if (m_listener) {
+        m_listener->onTransportConnected(*this);
+    }
+}
+
+void RmApiArmTransport::close(const char* reason, int result, uint64_t nowNs) {
+    m_connected.store(false, std::memory_order_release);
+    m_streamKind = StreamNone;
+    m_deferredSinceNs = 0;
+    {
+        // 等待指令线程完成当前调用后再删除句柄；之后排队的指令以失败完成
+        std::lock_guard<std::mutex> lock(m_handleMutex);
+        rm_delete_robot_arm(m_handle);
+        m_handle = nullptr;
+    }
+    increment(m_disconnects);
+
+    uint64_t delayNs = m_backoffNs;
+    m_backoffNs = std::min(m_backoffNs * 2, m_maxBackoffNs);
+    m_reconnectAtNs = nowNs + delayNs;
+    std::cout << "🔌 [" << m_name << "] " << reason << " (RM_API2返回 " << result << ")，"
+              << delayNs / 1000000 << "ms后重连" << std::endl;
+    if (m_listener) {
+        m_listener->onTransportDisconnected(*this);
+    }
+}
+
+bool RmApiArmTransport::flushStream() {
+    if (m_streamKind == StreamNone) {
+        return true;
+    }
+
+    // 指令线程正在调用时不等待：保留最新一帧，下一个节拍再发
+    std::unique_lock<std::mutex> lock(m_handleMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        increment(m_deferredTicks);
+        if (m_deferredSinceNs == 0) {
+            m_deferredSinceNs = ArmCommandPipeline::nowNs();
+        }
+        return true;
+    }
+    if (!m_handle) {
+        m_streamKind = StreamNone;
+        m_deferredSinceNs = 0;
+        return false;
+    }
+
+    uint64_t startNs = ArmCommandPipeline::nowNs();
+    int result = callStream();
+    uint64_t costNs = ArmCommandPipeline::nowNs() - startNs;
+    lock.unlock();
+
+    m_streamKind = StreamNone;
+    if (m_deferredSinceNs != 0) {
+        storeMax(m_maxDeferNs, startNs - m_deferredSinceNs);
+        m_deferredSinceNs = 0;
+    }
+    m_lastStreamCallNs.store(costNs, std::memory_order_relaxed);
+    storeMax(m_maxStreamCallNs, costNs);
+
+    int debugCounter = ++m_streamCounter;
+    if (debugCounter % 50 == 0) {
+        BinaryLogger::instance().log(LOG_RM_STREAM_RESULT, m_logSource, debugCounter, result, costNs / 1000);
+    }
+
+    // 透传接口不等待响应，只有数据发送失败（连接断开）时返回非0
+    if (result != 0) {
+        close("流式发送失败", result, startNs + costNs);
+        return false;
+    }
+    increment(m_streamed);
+    return true;
+}
+
+int RmApiArmTransport::callStream() {
+    if (m_streamKind == StreamPose) {
+        rm_movep_canfd_mode_t config;
+        config.pose = toRmPose(m_streamPose);
+        config.follow = true;
+        config.trajectory_mode = m_trajectoryMode;
+        config.radio = m_radio;
+        return rm_movep_canfd(m_handle, config);
+    }
+
+    float joint[ARM_DOF] = {0};
+    for (int i = 0; i < 6; ++i) {
+        joint[i] = static_cast<float>(m_streamJoints[i]);
+    }
+    rm_movej_canfd_mode_t config;
+    config.joint = joint;
+    config.expand = 0;
+    config.follow = true;
+    config.trajectory_mode = m_trajectoryMode;
+    config.radio = m_radio;
+    return rm_movej_canfd(m_handle, config);
+}
+
+int RmApiArmTransport::execute(const ArmCommand& command, ArmResponse& response) {
+    std::lock_guard<std::mutex> lock(m_handleMutex);
+    if (!m_handle) {
+        return -1;
+    }
+
+    const int* args = command.args;
+    switch (command.type) {
+        case ArmCommand::SetArmPower:
+            return rm_set_arm_power(m_handle, args[0]);
+        case ArmCommand::SetAngleTransmission:
+            // CANFD透传接口不需要单独开启角度透传模式
+            return 0;
+        case ArmCommand::SetRealtimePush: {
+            rm_realtime_push_config_t config;
+            memset(&config, 0, sizeof(config));
+            config.cycle = args[0];
+            config.enable = true;
+            config.port = args[1];
+            config.force_coordinate = 0;
+            // ip 字段只有28字节，比 ArmCommand 文本短：超长时截断并保证结尾
+            size_t length = std::min(strlen(command.text), sizeof(config.ip) - 1);
+            memcpy(config.ip, command.text, length);
+            config.ip[length] = '\0';
+            // 自定义上报项保持控制器当前设置
+            config.custom_config.joint_speed = -1;
+            config.custom_config.lift_state = -1;
+            config.custom_config.expand_state = -1;
+            config.custom_config.hand_state = -1;
+            config.custom_config.arm_current_status = -1;
+            config.custom_config.aloha_state = -1;
+            config.custom_config.plus_base = -1;
+            config.custom_config.plus_state = -1;
+            return rm_set_realtime_push(m_handle, config);
+        }
+        case ArmCommand::SetTeachFrame:
+            return rm_set_teach_frame(m_handle, args[0]);
+        case ArmCommand::SetToolFrame:
+            return rm_change_tool_frame(m_handle, command.text);
+        case ArmCommand::GripperPick:
+            return rm_set_gripper_pick_on(m_handle, args[0], args[1], false, 0);
+        case ArmCommand::GripperRelease:
+            return rm_set_gripper_release(m_handle, args[0], false, 0);
+        case ArmCommand::WriteSingleRegister: {
+            rm_peripheral_read_write_params_t params;
+            params.port = args[0];
+            params.address = args[1];
+            params.device = args[3];
+            params.num = 1;
+            return rm_write_single_register(m_handle, params, args[2]);
+        }
+        case ArmCommand::GetArmState: {
+            rm_current_arm_state_t state;
+            memset(&state, 0, sizeof(state));
+            int result = rm_get_current_arm_state(m_handle, &state);
+            if (result == 0) {
+                fromRmState(state, response);
+            }
+            return result;
+        }
+    }
+    return -1;
+}
+
+void RmApiArmTransport::deliverCompleted(uint64_t nowNs) {
+    std::deque<CompletedCommand> completed;
+    {
+        std::lock_guard<std::mutex> lock(m_commandMutex);
+        if (m_completed.empty()) {
+            return;
+        }
+        completed.swap(m_completed);
+    }
+
+    BinaryLogger& logger = BinaryLogger::instance();
+    for (size_t i = 0; i < completed.size(); ++i) {
+        CompletedCommand& entry = completed[i];
+        uint64_t latencyNs = nowNs - entry.pending.sentNs;
+        m_lastCommandNs.store(latencyNs, std::memory_order_relaxed);
+        storeMax(m_maxCommandNs, latencyNs);
+
+        if (entry.result != 0) {
+            increment(m_commandsFailed);
+            logger.log(LOG_RM_COMMAND_FAILED, m_logSource, static_cast<int>(entry.pending.command.type), entry.result);
+            if (entry.pending.callback) {
+                entry.pending.callback(nullptr);
+            }
+            continue;
+        }
+
+        increment(m_commandsOk);
+        ArmResponse& response = entry.response;
+        if (!(response.fields & ArmResponse::FieldArmState)) {
+            response.fields |= ArmResponse::FieldCommand;
+            strncpy(response.command, entry.pending.command.name(), ArmResponse::kNameLength - 1);
+        } else {
+            const std::array<int, 6>& pose = response.pose;
+            logger.log(LOG_POSE_QUERY_RESULT, m_logSource, pose[0], pose[1], pose[2], pose[3], pose[4], pose[5]);
+            if (m_listener) {
+                m_listener->onArmState(*this, response);
+            }
+        }
+        if (entry.pending.callback) {
+            entry.pending.callback(&response);
+        }
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef RMAPIARMTRANSPORT_H
+#define RMAPIARMTRANSPORT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ArmTransport.h"
+#include "rm_define.h"
+
+/**
+ * @class RmApiArmTransport
+ * @brief 睿尔曼 RM_API2 传输后端（编译时定义 USE_RM_API2 才可用）
+ *
+ * - 流式位姿用 rm_movep_canfd，关节角度用 rm_movej_canfd，均为高跟随模式
+ *   （follow=true），trajectory_mode/radio 控制控制器侧的平滑
+ * - RM_API2 的设置/查询接口是阻塞调用，由每个机械臂自己的指令线程执行，
+ *   完成结果交回服务线程后回调，流式发送不会等待指令响应
+ * - 同一句柄上的调用用互斥量串行化：指令线程调用期间服务线程不等待，
+ *   只保留最新一帧，在句柄空出后的第一个节拍发出。流式帧因此推迟一个
+ *   指令往返（状态查询约数毫秒），推迟次数与最长推迟时间见 printStats
+ * - 夹爪指令总以非阻塞方式下发（只等待控制器确认），避免长时间占用句柄
+ * - UDP主动上报仍由 ArmStateReceiver 接收（不使用RM_API2的三线程模式），
+ *   所有机械臂共用本机同一个上报端口
+ */
+class RmApiArmTransport : public ArmTransport {
+public:
+    /**
+     * @param trajectoryMode 高跟随模式下的轨迹模式：0完全透传、1曲线拟合、2滤波
+     * @param radio 曲线拟合（0~100）或滤波（0~1000）的平滑系数
+     */
+    RmApiArmTransport(const std::string& ip, int port, int trajectoryMode, int radio);
+    ~RmApiArmTransport();
+
+    /**
+     * @brief 设置重连退避（初始值、上限），<=0 的参数保持原值
+     */
+    void setReconnectPolicy(int initialDelayMs, int maxDelayMs);
+
+    const char* name() const override { return "rm_api2"; }
+    void attach(Listener* listener, uint16_t logSource) override;
+    bool connect() override;
+    void disconnect() override;
+    bool isConnected() const override { return m_connected.load(std::memory_order_acquire); }
+    uint64_t getConnectFailures() const override { return m_connectFailures.load(std::memory_order_relaxed); }
+    bool isServiceThread() const override;
+    bool streamPose(const std::array<int, 6>& pose) override;
+    bool streamJoints(const std::array<double, 6>& joints) override;
+    bool send(const ArmCommand& command, uint64_t timeoutNs, int retries, const Callback& callback) override;
+    void printStats(std::ostream& os, const std::string& prefix) const override;
+
+private:
+    RmApiArmTransport(const RmApiArmTransport&);
+    RmApiArmTransport& operator=(const RmApiArmTransport&);
+
+    struct PendingCommand {
+        ArmCommand command;
+        int retries;
+        uint64_t sentNs;
+        Callback callback;
+    };
+
+    struct CompletedCommand {
+        PendingCommand pending;
+        int result;              // rm_* 返回码（0为成功）
+        ArmResponse response;
+    };
+
+    enum StreamKind { StreamNone, StreamPose, StreamJoints };
+
+    void serviceLoop();
+    void commandLoop();
+    void open(uint64_t nowNs);
+    void close(const char* reason, int result, uint64_t nowNs);
+    bool flushStream();
+    int callStream();
+    int execute(const ArmCommand& command, ArmResponse& response);
+    void deliverCompleted(uint64_t nowNs);
+
+    std::string m_ip;
+    int m_port;
+    std::string m_name;
+    int m_trajectoryMode;
+    int m_radio;
+    Listener* m_listener;
+    uint16_t m_logSource;
+
+    std::thread m_serviceThread;
+    std::thread m_commandThread;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_connected;
+
+    // 句柄由服务线程创建/删除；任何 rm_* 调用期间持有 m_handleMutex
+    std::mutex m_handleMutex;
+    rm_robot_handle* m_handle;
+
+    // 服务线程 → 指令线程 → 服务线程
+    std::mutex m_commandMutex;
+    std::condition_variable m_commandReady;
+    std::deque<PendingCommand> m_commands;
+    std::deque<CompletedCommand> m_completed;
+
+    // 服务线程状态
+    StreamKind m_streamKind;             // 等待发出的最新流式帧
+    std::array<int, 6> m_streamPose;
+    std::array<double, 6> m_streamJoints;
+    bool m_everConnected;
+    uint64_t m_reconnectAtNs;
+    uint64_t m_backoffNs;
+    uint64_t m_initialBackoffNs;
+    uint64_t m_maxBackoffNs;
+    int m_streamCounter;
+    uint64_t m_deferredSinceNs;          // 当前帧首次因句柄忙推迟的时刻，0表示未推迟
+
+    // 统计（各自只有一个写线程）
+    std::atomic<uint64_t> m_streamed;          // 成功发出的流式帧
+    std::atomic<uint64_t> m_superseded;        // 句柄忙时被更新帧覆盖的流式帧
+    std::atomic<uint64_t> m_lastStreamCallNs;  // 最近一次 rm_movep/movej_canfd 调用耗时
+    std::atomic<uint64_t> m_maxStreamCallNs;
+    std::atomic<uint64_t> m_deferredTicks;     // 指令线程占用句柄、流式帧推迟发出的节拍数
+    std::atomic<uint64_t> m_maxDeferNs;        // 流式帧从首次推迟到发出的最长时间
+    std::atomic<uint64_t> m_commandsOk;
+    std::atomic<uint64_t> m_commandsFailed;
+    std::atomic<uint64_t> m_lastCommandNs;     // 最近一次指令投递→完成的延迟
+    std::atomic<uint64_t> m_maxCommandNs;
+    std::atomic<uint64_t> m_connectFailures;
+    std::atomic<uint64_t> m_disconnects;
+    std::atomic<uint64_t> m_reconnects;
+};
+
+#endif // RMAPIARMTRANSPORT_H
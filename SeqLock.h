@@ -0,0 +1,77 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @class SeqLock
+ * @brief 单写者/多读者的顺序锁，用于把最新状态发布给1kHz伺服线程
+ *
+ * 写者递增序号（奇数表示写入中）后拷贝数据，再递增序号发布；
+ * 读者在前后两次读到相同的偶数序号时才接受拷贝。
+ * 写者从不等待读者，读者最多重试有限次数，因此两侧都不会阻塞。
+ *
+ * @tparam T 状态类型（必须可平凡拷贝）
+ */
+template <typename T>
+class SeqLock {
+public:
+    SeqLock() : m_sequence(0) {
+        memset(&m_value, 0, sizeof(m_value));
+    }
+
+    /**
+     * @brief 发布新状态（只能由一个线程调用）
+     */
+    void store(const T& value) {
+        uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&m_value, &value, sizeof(T));
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief 读取最新状态（任意线程，wait-free）
+     * @param out 读取成功时写入的状态
+     * @param maxAttempts 与写者冲突时的最大重试次数
+     * @return 从未发布过或连续冲突时返回false，out保持不变
+     */
+    bool tryLoad(T& out, int maxAttempts = 4) const {
+        for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+            uint32_t before = m_sequence.load(std::memory_order_acquire);
+            if (before == 0) {
+                return false;
+            }
+            if (before & 1) {
+                continue;
+            }
+            T copy;
+            memcpy(&copy, &m_value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == before) {
+                out = copy;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 已发布的版本数
+     */
+    uint32_t version() const {
+        return m_sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    SeqLock(const SeqLock&);
+    SeqLock& operator=(const SeqLock&);
+
+    std::atomic<uint32_t> m_sequence;
+    T m_value;
+};
+
+#endif // SEQLOCK_H
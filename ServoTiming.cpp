@@ -0,0 +1,244 @@
+#include "ServoTiming.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+// ==================== LatencyHistogram ====================
+
+LatencyHistogram::LatencyHistogram(uint64_t overrunThresholdNs)
+    : m_overrunThresholdNs(overrunThresholdNs),
+      m_count(0), m_sumNs(0), m_maxNs(0), m_overruns(0) {
+    for (int i = 0; i < kBucketCount; ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+int LatencyHistogram::bucketIndex(uint64_t valueNs) {
+    if (valueNs < static_cast<uint64_t>(kSubBuckets)) {
+        return static_cast<int>(valueNs);
+    }
+    int msb = 63 - __builtin_clzll(valueNs);
+    int shift = msb - kSubBucketBits;
+    int sub = static_cast<int>((valueNs >> shift) & (kSubBuckets - 1));
+    return (shift + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index) {
+    if (index < kSubBuckets) {
+        return static_cast<uint64_t>(index);
+    }
+    int shift = index / kSubBuckets - 1;
+    uint64_t sub = static_cast<uint64_t>(index % kSubBuckets);
+    uint64_t lower = (static_cast<uint64_t>(kSubBuckets) + sub) << shift;
+    return lower + ((static_cast<uint64_t>(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t valueNs) {
+    // 单写者：用relaxed读-改-写代替带锁前缀的fetch_add
+    std::atomic<uint64_t>& bucket = m_buckets[bucketIndex(valueNs)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_sumNs.store(m_sumNs.load(std::memory_order_relaxed) + valueNs, std::memory_order_relaxed);
+    if (valueNs > m_maxNs.load(std::memory_order_relaxed)) {
+        m_maxNs.store(valueNs, std::memory_order_relaxed);
+    }
+    if (valueNs > m_overrunThresholdNs) {
+        m_overruns.store(m_overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    // count最后以release发布，读者先读count再读桶
+    m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void LatencyHistogram::snapshot(Snapshot& out) const {
+    out.count = m_count.load(std::memory_order_acquire);
+    out.sumNs = m_sumNs.load(std::memory_order_relaxed);
+    out.maxNs = m_maxNs.load(std::memory_order_relaxed);
+    out.overruns = m_overruns.load(std::memory_order_relaxed);
+
+    // 桶的总和可能略多于count（读取期间写者仍在记录），以桶总和为准
+    uint64_t total = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        out.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += out.buckets[i];
+    }
+    out.count = total;
+}
+
+uint64_t LatencyHistogram::Snapshot::percentile(double quantile) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count)));
+    if (target == 0) {
+        target = 1;
+    }
+
+    uint64_t cumulative = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        cumulative += buckets[i];
+        if (cumulative >= target) {
+            uint64_t upper = bucketUpperBound(i);
+            return (maxNs != 0 && upper > maxNs) ? maxNs : upper;
+        }
+    }
+    return maxNs;
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::Snapshot::since(const Snapshot& earlier) const {
+    Snapshot delta;
+    for (int i = 0; i < kBucketCount; ++i) {
+        delta.buckets[i] = buckets[i] - earlier.buckets[i];
+    }
+    delta.count = count - earlier.count;
+    delta.sumNs = sumNs - earlier.sumNs;
+    delta.maxNs = maxNs;
+    delta.overruns = overruns - earlier.overruns;
+    return delta;
+}
+
+// ==================== ServoTimingMonitor ====================
+
+ServoTimingMonitor::ServoTimingMonitor(uint64_t overrunThresholdNs)
+    : m_period(overrunThresholdNs), m_duty(overrunThresholdNs),
+      m_channelCount(0), m_lastEntryNs(0), m_updateRateMilliHz(0), m_ticks(0),
+      m_reporterRunning(false) {
+}
+
+ServoTimingMonitor::~ServoTimingMonitor() {
+    stopReporter();
+}
+
+uint64_t ServoTimingMonitor::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void ServoTimingMonitor::beginTick() {
+    uint64_t now = nowNs();
+    if (m_lastEntryNs != 0) {
+        m_period.record(now - m_lastEntryNs);
+    }
+    m_lastEntryNs = now;
+}
+
+void ServoTimingMonitor::endTick(double schedulerTimeStampSec) {
+    if (schedulerTimeStampSec > 0.0) {
+        m_duty.record(static_cast<uint64_t>(schedulerTimeStampSec * 1e9));
+    }
+    m_ticks.store(m_ticks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void ServoTimingMonitor::recordChannel(int channel, uint64_t elapsedNs) {
+    if (channel >= 0 && channel < kMaxChannels) {
+        m_channels[channel].record(elapsedNs);
+    }
+}
+
+void ServoTimingMonitor::setUpdateRate(double rateHz) {
+    m_updateRateMilliHz.store(static_cast<uint64_t>(rateHz * 1000.0), std::memory_order_relaxed);
+}
+
+void ServoTimingMonitor::setChannelName(int channel, const std::string& name) {
+    if (channel >= 0 && channel < kMaxChannels) {
+        m_channelNames[channel] = name;
+        if (channel + 1 > m_channelCount.load(std::memory_order_relaxed)) {
+            m_channelCount.store(channel + 1, std::memory_order_release);
+        }
+    }
+}
+
+void ServoTimingMonitor::startReporter(int intervalMs) {
+    if (intervalMs <= 0 || m_reporterRunning.load(std::memory_order_acquire)) {
+        return;
+    }
+    m_reporterRunning.store(true, std::memory_order_release);
+    m_reporter = std::thread(&ServoTimingMonitor::reporterLoop, this, intervalMs);
+}
+
+void ServoTimingMonitor::stopReporter() {
+    if (!m_reporterRunning.exchange(false)) {
+        return;
+    }
+    if (m_reporter.joinable()) {
+        m_reporter.join();
+    }
+}
+
+void ServoTimingMonitor::reporterLoop(int intervalMs) {
+    LatencyHistogram::Snapshot previous;
+    LatencyHistogram::Snapshot current;
+    m_duty.snapshot(previous);
+    uint64_t lastPeriodOverruns = 0;
+
+    const int stepMs = 50;
+    int elapsedMs = 0;
+    while (m_reporterRunning.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(stepMs));
+        elapsedMs += stepMs;
+        if (elapsedMs < intervalMs) {
+            continue;
+        }
+        elapsedMs = 0;
+
+        // 只在出现新的超限节拍时告警，避免刷屏
+        m_duty.snapshot(current);
+        LatencyHistogram::Snapshot delta = current.since(previous);
+        LatencyHistogram::Snapshot period;
+        m_period.snapshot(period);
+        uint64_t newPeriodOverruns = period.overruns - lastPeriodOverruns;
+        lastPeriodOverruns = period.overruns;
+
+        if (delta.overruns > 0 || newPeriodOverruns > 0) {
+            std::cout << "⚠️  [伺服时序] 最近" << intervalMs << "ms: 占空超限 " << delta.overruns
+                      << " 次, 周期超限 " << newPeriodOverruns << " 次, 占空p99 "
+                      << std::fixed << std::setprecision(1) << delta.percentile(0.99) / 1000.0
+                      << "us (阈值 " << m_duty.getOverrunThresholdNs() / 1000 << "us)"
+                      << std::defaultfloat << std::endl;
+        }
+        previous = current;
+    }
+}
+
+void ServoTimingMonitor::printHistogram(std::ostream& os, const char* label,
+                                        const LatencyHistogram::Snapshot& snap,
+                                        uint64_t thresholdNs) {
+    os << "  " << std::left << std::setw(16) << label << std::right;
+    if (snap.count == 0) {
+        os << "无样本" << std::endl;
+        return;
+    }
+    os << std::fixed << std::setprecision(1)
+       << "n=" << snap.count
+       << " mean=" << snap.meanNs() / 1000.0 << "us"
+       << " p50=" << snap.percentile(0.50) / 1000.0 << "us"
+       << " p99=" << snap.percentile(0.99) / 1000.0 << "us"
+       << " p99.9=" << snap.percentile(0.999) / 1000.0 << "us"
+       << " max=" << snap.maxNs / 1000.0 << "us"
+       << " >" << thresholdNs / 1000 << "us: " << snap.overruns
+       << std::defaultfloat << std::endl;
+}
+
+void ServoTimingMonitor::printReport(std::ostream& os) const {
+    LatencyHistogram::Snapshot snap;
+
+    os << "=== 伺服回调时序 ===" << std::endl;
+    os << "  回调次数: " << m_ticks.load(std::memory_order_relaxed)
+       << ", 瞬时更新频率: " << std::fixed << std::setprecision(1)
+       << m_updateRateMilliHz.load(std::memory_order_relaxed) / 1000.0 << "Hz"
+       << std::defaultfloat << std::endl;
+
+    m_period.snapshot(snap);
+    printHistogram(os, "回调周期", snap, m_period.getOverrunThresholdNs());
+    m_duty.snapshot(snap);
+    printHistogram(os, "占空时间", snap, m_duty.getOverrunThresholdNs());
+
+    int channelCount = m_channelCount.load(std::memory_order_acquire);
+    for (int i = 0; i < channelCount; ++i) {
+        m_channels[i].snapshot(snap);
+        std::string label = m_channelNames[i] + "处理";
+        printHistogram(os, label.c_str(), snap, m_channels[i].getOverrunThresholdNs());
+    }
+    os << "====================" << std::endl;
+}
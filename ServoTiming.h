@@ -0,0 +1,182 @@
+#ifndef SERVOTIMING_H
+#define SERVOTIMING_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+
+/**
+ * @class LatencyHistogram
+ * @brief 对数分桶的无锁耗时直方图（单写者/多读者）
+ *
+ * 每个2的幂区间再均分为8个子桶，相对误差不超过12.5%。
+ * 写者（伺服线程）只做一次桶下标计算和若干relaxed原子读写，
+ * 不分配内存、不加锁；读者通过 snapshot() 获取一致性足够的副本，
+ * 对两次快照做差即可得到区间统计，无需复位。
+ */
+class LatencyHistogram {
+public:
+    static const int kSubBucketBits = 3;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+    static const int kBucketCount = 64 * kSubBuckets;
+
+    /**
+     * @brief 直方图快照（普通内存，供非实时线程计算分位数）
+     */
+    struct Snapshot {
+        uint64_t buckets[kBucketCount];
+        uint64_t count;
+        uint64_t sumNs;
+        uint64_t maxNs;
+        uint64_t overruns;
+
+        /**
+         * @brief 计算分位数
+         * @param quantile 分位（0~1）
+         * @return 对应桶的上界（纳秒），无样本时返回0
+         */
+        uint64_t percentile(double quantile) const;
+
+        double meanNs() const { return count ? static_cast<double>(sumNs) / count : 0.0; }
+
+        /**
+         * @brief 计算与较早快照之间的区间增量（maxNs保留为本快照的历史最大值）
+         */
+        Snapshot since(const Snapshot& earlier) const;
+    };
+
+    /**
+     * @brief 构造函数
+     * @param overrunThresholdNs 超限阈值，超过该值的样本计入overruns
+     */
+    explicit LatencyHistogram(uint64_t overrunThresholdNs = 1000000);
+
+    /**
+     * @brief 记录一个样本（仅限单一写者线程调用）
+     * @param valueNs 样本值（纳秒）
+     */
+    void record(uint64_t valueNs);
+
+    /**
+     * @brief 读取快照（任意线程可调用）
+     */
+    void snapshot(Snapshot& out) const;
+
+    uint64_t getOverrunThresholdNs() const { return m_overrunThresholdNs; }
+
+    static int bucketIndex(uint64_t valueNs);
+    static uint64_t bucketUpperBound(int index);
+
+private:
+    LatencyHistogram(const LatencyHistogram&);
+    LatencyHistogram& operator=(const LatencyHistogram&);
+
+    uint64_t m_overrunThresholdNs;
+    std::atomic<uint64_t> m_buckets[kBucketCount];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sumNs;
+    std::atomic<uint64_t> m_maxNs;
+    std::atomic<uint64_t> m_overruns;
+};
+
+/**
+ * @class ServoTimingMonitor
+ * @brief 触觉伺服回调的时序监测
+ *
+ * 参考 OpenHaptics 示例 ServoLoopDutyCycle / ServoLoopRate：
+ * - 回调周期：相邻两次回调入口之间的单调时钟间隔
+ * - 占空时间：hdGetSchedulerTimeStamp() 在回调出口的值，即本伺服节拍开始到回调结束的耗时
+ * - 通道耗时：每个设备通道采样、计算和输出力的耗时
+ * - 更新频率：HD_INSTANTANEOUS_UPDATE_RATE
+ * 伺服线程只写直方图；后台报告线程周期性读取，发现新的超限节拍时打印告警。
+ */
+class ServoTimingMonitor {
+public:
+    static const int kMaxChannels = 8;
+
+    /**
+     * @brief 构造函数
+     * @param overrunThresholdNs 超限阈值（默认1ms，即一个1kHz伺服周期）
+     */
+    explicit ServoTimingMonitor(uint64_t overrunThresholdNs = 1000000);
+
+    /**
+     * @brief 析构函数，自动停止报告线程
+     */
+    ~ServoTimingMonitor();
+
+    /**
+     * @brief 回调入口（伺服线程调用），记录回调周期
+     */
+    void beginTick();
+
+    /**
+     * @brief 回调出口（伺服线程调用），记录占空时间
+     * @param schedulerTimeStampSec hdGetSchedulerTimeStamp() 返回值（秒）
+     */
+    void endTick(double schedulerTimeStampSec);
+
+    /**
+     * @brief 记录单个设备通道的处理耗时（伺服线程调用）
+     * @param channel 通道下标（0开始）
+     * @param elapsedNs 耗时（纳秒）
+     */
+    void recordChannel(int channel, uint64_t elapsedNs);
+
+    /**
+     * @brief 记录设备瞬时更新频率（伺服线程调用）
+     */
+    void setUpdateRate(double rateHz);
+
+    /**
+     * @brief 设置通道名称（须在调度器启动前调用）
+     */
+    void setChannelName(int channel, const std::string& name);
+
+    /**
+     * @brief 启动后台报告线程
+     * @param intervalMs 检查间隔（毫秒），<=0 表示不启动
+     */
+    void startReporter(int intervalMs);
+
+    /**
+     * @brief 停止后台报告线程
+     */
+    void stopReporter();
+
+    /**
+     * @brief 打印完整的时序报告（非实时线程调用）
+     */
+    void printReport(std::ostream& os) const;
+
+    /**
+     * @brief 单调时钟当前时间（纳秒）
+     */
+    static uint64_t nowNs();
+
+private:
+    ServoTimingMonitor(const ServoTimingMonitor&);
+    ServoTimingMonitor& operator=(const ServoTimingMonitor&);
+
+    void reporterLoop(int intervalMs);
+    static void printHistogram(std::ostream& os, const char* label,
+                               const LatencyHistogram::Snapshot& snap,
+                               uint64_t thresholdNs);
+
+    LatencyHistogram m_period;
+    LatencyHistogram m_duty;
+    LatencyHistogram m_channels[kMaxChannels];
+    std::string m_channelNames[kMaxChannels];
+    std::atomic<int> m_channelCount;
+
+    uint64_t m_lastEntryNs;                // 仅伺服线程访问
+    std::atomic<uint64_t> m_updateRateMilliHz;
+    std::atomic<uint64_t> m_ticks;
+
+    std::thread m_reporter;
+    std::atomic<bool> m_reporterRunning;
+};
+
+#endif // SERVOTIMING_H
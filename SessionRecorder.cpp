@@ -0,0 +1,77 @@
+#include "SessionRecorder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+SessionRecorder::SessionRecorder(const std::string& filename)
+    : m_filename(filename), m_running(false), m_written(0), m_dropped(0) {
+}
+
+SessionRecorder::~SessionRecorder() {
+    stop();
+}
+
+bool SessionRecorder::start() {
+    if (m_running.load(std::memory_order_acquire)) {
+        return true;
+    }
+    m_file.open(m_filename.c_str(), std::ios::out | std::ios::app);
+    if (!m_file.is_open()) {
+        std::cerr << "警告：无法打开会话录制文件 " << m_filename << std::endl;
+        return false;
+    }
+    m_file.seekp(0, std::ios::end);
+    if (m_file.tellp() == 0) {
+        m_file << "t_ns,x,y,z,rx,ry,rz,vx,vy,vz\n";
+    }
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&SessionRecorder::run, this);
+    std::cout << "📼 会话录制已启动: " << m_filename << std::endl;
+    return true;
+}
+
+void SessionRecorder::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_file.close();
+    std::cout << "📼 会话录制已停止: " << m_filename << ", 共 " << getRecordedCount()
+              << " 帧, 丢弃 " << getDropCount() << " 帧" << std::endl;
+}
+
+void SessionRecorder::record(const MotionSample& sample) {
+    if (!m_queue.tryPush(sample)) {
+        m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+void SessionRecorder::drain() {
+    MotionSample sample;
+    char line[256];
+    uint64_t written = 0;
+    while (m_queue.tryPop(sample)) {
+        snprintf(line, sizeof(line), "%llu,%.1f,%.1f,%.1f,%.2f,%.2f,%.2f,%.1f,%.1f,%.1f\n",
+                 static_cast<unsigned long long>(sample.timestampNs),
+                 sample.offset[0], sample.offset[1], sample.offset[2],
+                 sample.offset[3], sample.offset[4], sample.offset[5],
+                 sample.velocity[0], sample.velocity[1], sample.velocity[2]);
+        m_file << line;
+        ++written;
+    }
+    if (written > 0) {
+        m_written.store(m_written.load(std::memory_order_relaxed) + written, std::memory_order_relaxed);
+        m_file.flush();
+    }
+}
+
+void SessionRecorder::run() {
+    while (m_running.load(std::memory_order_acquire)) {
+        drain();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    drain();
+}
@@ -0,0 +1,72 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "MotionPredictor.h"
+#include "SpscQueue.h"
+
+/**
+ * @class SessionRecorder
+ * @brief 拖动会话录制器（供预测器离线回放评估）
+ *
+ * 伺服线程只调用 record() 把采样写入SPSC环形队列，后台线程写CSV文件：
+ * t_ns,x,y,z,rx,ry,rz,vx,vy,vz（偏移量为微米/毫弧度，速度为微米/秒）。
+ * 队列满时丢弃采样并计数，不会阻塞伺服线程。
+ */
+class SessionRecorder {
+public:
+    /**
+     * @brief 构造函数
+     * @param filename CSV文件名
+     */
+    explicit SessionRecorder(const std::string& filename);
+
+    /**
+     * @brief 析构函数，自动停止写文件线程
+     */
+    ~SessionRecorder();
+
+    /**
+     * @brief 打开文件并启动写文件线程
+     * @return 文件无法打开时返回false
+     */
+    bool start();
+
+    /**
+     * @brief 写出剩余采样并停止写文件线程
+     */
+    void stop();
+
+    /**
+     * @brief 记录一帧采样（伺服线程调用，wait-free）
+     */
+    void record(const MotionSample& sample);
+
+    uint64_t getRecordedCount() const { return m_written.load(std::memory_order_relaxed); }
+    uint64_t getDropCount() const { return m_dropped.load(std::memory_order_relaxed); }
+    const std::string& getFilename() const { return m_filename; }
+
+private:
+    SessionRecorder(const SessionRecorder&);
+    SessionRecorder& operator=(const SessionRecorder&);
+
+    void run();
+    void drain();
+
+    static const size_t kQueueCapacity = 4096;
+
+    std::string m_filename;
+    std::ofstream m_file;
+    SpscQueue<MotionSample, kQueueCapacity> m_queue;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<uint64_t> m_written;
+    std::atomic<uint64_t> m_dropped;
+};
+
+#endif // SESSIONRECORDER_H
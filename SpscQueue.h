@@ -0,0 +1,89 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class SpscQueue
+ * @brief 有界单生产者/单消费者无锁环形队列
+ *
+ * 特性：
+ * - 生产者与消费者各自只写自己的索引，push/pop 均为 wait-free
+ * - 不分配内存、不加锁、不进行系统调用，可在1kHz触觉伺服线程中调用
+ * - 队列满时 tryPush 直接返回 false，由调用方统计丢弃
+ *
+ * @tparam T        元素类型（应为可平凡拷贝的小结构体）
+ * @tparam Capacity 容量，必须为2的幂
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue容量必须为2的幂");
+
+public:
+    SpscQueue() : m_head(0), m_tail(0) {}
+
+    /**
+     * @brief 生产者入队
+     * @param item 待入队元素
+     * @return 队列已满时返回false
+     */
+    bool tryPush(const T& item) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        m_buffer[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 消费者出队
+     * @param item 输出元素
+     * @return 队列为空时返回false
+     */
+    bool tryPop(T& item) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = m_buffer[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 当前队列深度（任意线程可调用，结果为近似值）
+     */
+    size_t size() const {
+        // 先读 head 再读 tail：两者只增不减，且 tail 始终不小于 head，
+        // 第三方线程（如统计）读取时结果不会下溢；两次读取之间的入队可能使结果暂时超过容量
+        const size_t head = m_head.load(std::memory_order_acquire);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        return tail > head ? std::min(tail - head, Capacity) : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    static size_t capacity() { return Capacity; }
+
+private:
+    SpscQueue(const SpscQueue&);
+    SpscQueue& operator=(const SpscQueue&);
+
+    // 生产者和消费者索引用填充隔开，避免伪共享
+    // （不使用alignas：C++11的new不保证超对齐，队列常作为堆对象成员）
+    static const size_t kCacheLine = 64;
+
+    char m_pad0[kCacheLine];
+    std::atomic<size_t> m_head;   // 消费者读位置
+    char m_pad1[kCacheLine - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_tail;   // 生产者写位置
+    char m_pad2[kCacheLine - sizeof(std::atomic<size_t>)];
+    T m_buffer[Capacity];
+};
+
+#endif // SPSCQUEUE_H
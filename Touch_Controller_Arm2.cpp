@@ -4,6 +4,8 @@
  功能：
  - 同时使用两个触觉设备分别控制两个机械臂
  - Device1控制机械臂1，Device2控制机械臂2
+ - 设备数量由 system.device_count 配置，第N个设备控制机械臂N（robotN节）
+ - 所有设备在同一个伺服回调中依次处理（DeviceChannel）
  - 每个设备独立按钮控制对应机械臂
  - 使用TCP连接和JSON协议与机械臂通信
  
@@ -21,7 +23,7 @@
  - 设备2按钮1：控制机械臂2位置姿态  
  - 设备2按钮2：控制机械臂2夹抓（力控抓取/释放）
  - 键盘 'q' 退出程序
- - 键盘 '1'/'2' 选择调整设备1或设备2的参数
+ - 键盘 '1'~'9' 选择要调整参数的设备
  - 键盘 '+'/'-' 调整当前选择设备的位置映射系数
  - 键盘 '['/']' 调整当前选择设备的姿态映射系数
 *****************************************************************************/
@@ -35,6 +37,12 @@
 #include <iomanip>
 #include <exception>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstring>
+#include <future>
+#include <thread>
 
 #if defined(WIN32)
 # include <windows.h>
@@ -44,12 +52,14 @@
 #pragma comment(lib, "ws2_32.lib")
 #else
 # include <unistd.h>
+# include <time.h>
 extern "C" {
 # include "conio.h"
 }
 # include <string.h>
 # include <errno.h>
 # include <sys/socket.h>
+# include <sys/select.h>
 # include <arpa/inet.h>
 # include <netinet/in.h>
 #endif
@@ -59,6 +69,33 @@ extern "C" {
 #include <HDU/hduError.h>
 #include <HDU/hduVector.h>
 #include "ConfigLoader.h"
+#include "ArmCommandPipeline.h"
+#include "ServoTiming.h"
+#include "BinaryLogger.h"
+#include "OrientationMath.h"
+#include "AxisMapping.h"
+#include "DeadlineScheduler.h"
+#include "MotionFilter.h"
+#include "MotionPredictor.h"
+#include "TrajectoryGenerator.h"
+#include "VirtualFixtures.h"
+#include "SessionRecorder.h"
+#include "SeqLock.h"
+#include "ArmStateReceiver.h"
+#include "ArmResponseReader.h"
+#include "CommandEncoder.h"
+#include "AllocationCounter.h"
+#include "MpscQueue.h"
+#include "ArmReactor.h"
+#include "ArmTransport.h"
+#include "JsonArmTransport.h"
+#include "ArmKinematics.h"
+#include "IkWorker.h"
+#include "ArmCollisionGuard.h"
+#ifdef USE_RM_API2
+#include "RmApiArmTransport.h"
+#include "RmAlgoIkSolver.h"
+#endif
 
 // 添加Python支持的头文件
 #include <Python.h>
@@ -432,11 +469,46 @@ private:
     // ...existing code...
 };
 
-// 机械臂控制类
-class ArmController {
+// 机械臂请求结果（其他线程通过future等待）
+struct ArmReply {
+    bool ok;                 // 收到了对应的响应（超时、连接断开或发送失败时为false）
+    ArmResponse response;    // 查询的响应（指令为空）
+};
+
+// 连接后设置序列各阶段的耗时（纳秒，0表示该阶段未完成）
+struct ArmSetupTimings {
+    static const int kMaxSteps = 4;
+    uint64_t connectNs;               // connect() → 连接建立（重连时为0）
+    uint64_t powerNs;                 // 连接建立 → 上电确认（含重试）
+    uint64_t configureNs;             // 上电确认 → 其余设置指令全部完成
+    uint64_t totalNs;                 // 连接建立 → 就绪
+    int powerAttempts;                // 上电指令发送次数
+    int stepCount;
+    const char* stepNames[kMaxSteps];
+    uint64_t stepNs[kMaxSteps];       // 各设置指令发出 → 确认
+    bool stepOk[kMaxSteps];
+};
+
+// 其他线程投递给传输后端服务线程的请求
+struct ArmRequest {
+    enum Kind { Command, StreamJoints };   // StreamJoints：最新帧优先，可被后续帧覆盖
+    Kind kind;
+    ArmCommand command;
+    std::array<double, 6> joints;
+    std::promise<ArmReply>* reply;   // 为空时不回复（伺服线程投递，不分配内存）
+};
+
+// 机械臂控制类：收发由传输后端的服务线程完成（JSON后端为通信反应器线程），其他线程只投递请求
+class ArmController : private ArmTransport::Listener {
 private:
-    int m_socket;
-    bool m_connected;
+    // 位姿查询单次等待arm_state响应的时长
+    static const uint64_t kPoseQueryTimeoutNs = 500000000ULL;
+    // 位姿查询超时后的重发次数
+    static const int kPoseQueryRetries = 3;
+    // 指令等待响应的时长（阻塞模式的夹爪指令在动作完成后才响应）
+    static const uint64_t kCommandTimeoutNs = 5000000000ULL;
+    
+    ArmTransport* m_transport;                  // 传输后端（由本类释放）
     std::string m_robotIP;
     int m_robotPort;
     
@@ -446,11 +518,85 @@ private:
     int m_gripperForceThreshold;
     bool m_gripperBlockMode;
     
+    // 伺服线程 → 服务线程的无锁指令管线
+    ArmCommandPipeline m_pipeline;
+    std::atomic<uint64_t> m_offThreadSends;  // 不在服务线程中发生的流式发送次数（应始终为0）
+    
+    // 其他线程 → 服务线程的请求队列（设置指令、末端执行器指令、状态查询）
+    static const size_t kRequestQueueCapacity = 32;
+    MpscQueue<ArmRequest, kRequestQueueCapacity> m_requests;
+    
+    // 锚点位姿请求：伺服线程只递增请求序号，服务线程取得位姿后按序号发布结果
+    std::atomic<uint32_t> m_anchorRequestSeq;   // 最新请求序号（伺服线程写）
+    std::atomic<uint32_t> m_anchorResultSeq;    // 已发布结果对应的请求序号（服务线程写）
+    uint32_t m_anchorServedSeq;                 // 服务线程已处理的请求序号
+    uint64_t m_anchorStartNs;                   // 服务线程开始处理当前请求的时间
+    std::array<int, 6> m_anchorResultPose;      // 结果位姿，由m_anchorResultSeq的release/acquire保护
+    bool m_anchorResultValid;                   // 结果是否有效
+    std::atomic<uint64_t> m_lastAnchorQueryNs;  // 最近一次位姿查询耗时
+    
+    // 指令往返时间：服务线程对每条得到响应的指令（含定期探测查询）按 1/8 权重更新滑动平均
+    std::atomic<uint64_t> m_commandRttNs;       // 往返时间滑动平均（0=尚未测得）
+    std::atomic<uint64_t> m_rttProbeIntervalNs; // 往返探测查询的间隔（0=不探测）
+    uint64_t m_nextRttProbeNs;                  // 下一次探测时间（服务线程）
+    bool m_rttProbeInFlight;                    // 探测查询在途（服务线程）
+    
+    // 最近一次的实际状态（UDP主动上报或查询发布，伺服线程无阻塞读取）
+    SeqLock<ArmRealtimeState> m_realtimeState;
+    std::mutex m_realtimeStateWriteMutex;       // 只在发布者之间互斥（接收线程/服务线程），读者不加锁
+    
+    // UDP主动上报配置
+    std::string m_pushHostIp;                   // 上报目标（本机）IP
+    int m_pushPort;                             // 上报目标端口
+    int m_pushCycle;                            // 上报周期（set_realtime_push的cycle参数）
+    uint64_t m_pushMaxAgeNs;                    // 上报状态在该时长内视为有效，否则退回查询
+    
+    bool m_pushEnabled;                         // 是否在设置序列中启用主动上报（本机接收已启动）
+    
+    // 连接（或重连）后的设置序列，由控制器确认驱动：上电 → 上电确认后同时发出
+    // 角度透传、主动上报、示教坐标系、工具坐标系 → 全部确认（或失败）后就绪
+    enum SetupPhase { SetupIdle, SetupPowering, SetupPowerRetry, SetupConfiguring, SetupDone };
+    static const uint64_t kPowerRetryDelayNs = 1000000000ULL;   // 上电失败后的重试间隔
+    int m_teachFrameType;
+    std::string m_toolName;
+    // 以下设置序列状态服务线程独占
+    SetupPhase m_setupPhase;
+    uint32_t m_setupGeneration;                 // 每次连接/断开递增，旧连接的回调不再生效
+    uint64_t m_setupStartNs;                    // 连接建立时间
+    uint64_t m_powerAckNs;
+    uint64_t m_setupDueNs;                      // 上电重试时间
+    int m_setupPending;                         // 未完成的设置指令数
+    ArmSetupTimings m_setupProgress;
+    std::atomic<uint64_t> m_connectStartNs;     // connect() 调用时间（调用线程写，首次连接后清零）
+    mutable std::mutex m_setupTimingsMutex;
+    ArmSetupTimings m_setupTimings;             // 最近一次完成的设置序列耗时
+    std::atomic<bool> m_ready;                  // 设置序列已完成（服务线程写）
+    
+    uint16_t m_logSource;                       // 二进制日志来源ID
+    
 public:
-    ArmController(const std::string& ip = "192.168.10.18", int port = 8080) 
-        : m_socket(-1), m_connected(false), m_robotIP(ip), m_robotPort(port),
+    // transport 由调用者创建（按 [robotN] transport 选择后端），所有权交给本对象
+    ArmController(ArmTransport* transport, const std::string& ip = "192.168.10.18", int port = 8080) 
+        : m_transport(transport), m_robotIP(ip), m_robotPort(port),
           m_gripperPickSpeed(500), m_gripperReleaseSpeed(500), 
-          m_gripperForceThreshold(200), m_gripperBlockMode(true) {
+          m_gripperForceThreshold(200), m_gripperBlockMode(true),
+          m_pipeline([this](const std::array<int, 6>& pose) {
+              return moveToTargetAsync(pose, 90);
+          }),
+          m_offThreadSends(0),
+          m_anchorRequestSeq(0), m_anchorResultSeq(0), m_anchorServedSeq(0), m_anchorStartNs(0),
+          m_anchorResultPose({0, 0, 0, 0, 0, 0}), m_anchorResultValid(false),
+          m_lastAnchorQueryNs(0),
+          m_commandRttNs(0), m_rttProbeIntervalNs(0), m_nextRttProbeNs(0), m_rttProbeInFlight(false),
+          m_pushHostIp("192.168.10.100"), m_pushPort(8089), m_pushCycle(5), m_pushMaxAgeNs(50000000),
+          m_pushEnabled(false), m_teachFrameType(1), m_toolName("Arm_Tip"),
+          m_setupPhase(SetupIdle), m_setupGeneration(0), m_setupStartNs(0), m_powerAckNs(0),
+          m_setupDueNs(0), m_setupPending(0), m_connectStartNs(0), m_ready(false),
+          m_logSource(BinaryLogger::instance().registerSource("机械臂 " + ip)) {
+        memset(&m_setupProgress, 0, sizeof(m_setupProgress));
+        memset(&m_setupTimings, 0, sizeof(m_setupTimings));
+        // 流式发送、锚点查询和请求处理都在后端服务线程的回调中串行执行
+        m_transport->attach(this, m_logSource);
         #if defined(WIN32)
         WSADATA wsaData;
         WSAStartup(MAKEWORD(2, 2), &wsaData);
@@ -459,535 +605,204 @@ public:
     
     ~ArmController() {
         disconnect();
+        delete m_transport;
         #if defined(WIN32)
         WSACleanup();
         #endif
     }
     
+    // 发起非阻塞连接（立即返回）：后端在后台连接，断开后自动重连并重放设置指令
     bool connect() {
-        std::cout << "🔄 正在连接机械臂 " << m_robotIP << ":" << m_robotPort << " ..." << std::endl;
-        
-        // 创建socket
-        m_socket = socket(AF_INET, SOCK_STREAM, 0);
-        if (m_socket < 0) {
-            std::cerr << "❌ 创建socket失败" << std::endl;
-            return false;
-        }
-        
-        // 设置连接超时
-        struct timeval timeout;
-        timeout.tv_sec = 3;   // 3秒超时
-        timeout.tv_usec = 0;
-        
-        #if defined(WIN32)
-        // Windows socket超时设置
-        DWORD timeoutMs = 3000;
-        setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeoutMs, sizeof(timeoutMs));
-        setsockopt(m_socket, SOL_SOCKET, SO_SNDTIMEO, (char*)&timeoutMs, sizeof(timeoutMs));
-        #else
-        // Linux socket超时设置
-        setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout));
-        setsockopt(m_socket, SOL_SOCKET, SO_SNDTIMEO, (char*)&timeout, sizeof(timeout));
-        #endif
-        
-        // 设置服务器地址
-        struct sockaddr_in serverAddr;
-        memset(&serverAddr, 0, sizeof(serverAddr));
-        serverAddr.sin_family = AF_INET;
-        serverAddr.sin_port = htons(m_robotPort);
-        inet_pton(AF_INET, m_robotIP.c_str(), &serverAddr.sin_addr);
-        
-        // 连接到服务器
-        if (::connect(m_socket, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
-            std::cerr << "❌ 连接机械臂失败: " << m_robotIP << ":" << m_robotPort;
-            #if defined(WIN32)
-            int errorCode = WSAGetLastError();
-            if (errorCode == WSAETIMEDOUT) {
-                std::cerr << " (连接超时)" << std::endl;
-            } else {
-                std::cerr << " (错误代码: " << errorCode << ")" << std::endl;
-            }
-            closesocket(m_socket);
-            #else
-            if (errno == ETIMEDOUT || errno == ECONNREFUSED) {
-                std::cerr << " (连接超时或拒绝连接)" << std::endl;
-            } else {
-                std::cerr << " (错误: " << strerror(errno) << ")" << std::endl;
-            }
-            close(m_socket);
-            #endif
-            m_socket = -1;
-            return false;
-        }
-        
-        m_connected = true;
-        std::cout << "✅ 成功连接到机械臂: " << m_robotIP << ":" << m_robotPort << std::endl;
-        return true;
+        std::cout << "🔄 正在连接机械臂 " << m_robotIP << ":" << m_robotPort
+                  << " (后端: " << m_transport->name() << ") ..." << std::endl;
+        m_connectStartNs.store(ArmCommandPipeline::nowNs(), std::memory_order_relaxed);
+        return m_transport->connect();
     }
     
+    // 关闭连接并停止自动重连
     void disconnect() {
-        if (m_connected && m_socket >= 0) {
-            #if defined(WIN32)
-            closesocket(m_socket);
-            #else
-            close(m_socket);
-            #endif
-            m_connected = false;
+        bool wasConnected = isConnected();
+        m_transport->disconnect();
+        if (wasConnected) {
             std::cout << "机械臂连接已断开" << std::endl;
         }
     }
     
-    bool sendCommand(const std::string& command) {
-        if (!m_connected) {
-            std::cerr << "❌ TCP错误: 机械臂未连接" << std::endl;
+    // 任意线程（包括伺服线程）调用：把指令交给服务线程发送，不等待、不分配内存
+    bool post(const ArmCommand& command) {
+        BinaryLogger& logger = BinaryLogger::instance();
+        if (!isConnected()) {
+            logger.log(LOG_TCP_NOT_CONNECTED, m_logSource);
             return false;
         }
-        
-        // 添加换行符
-        std::string cmdWithNewline = command + "\r\n";
-        
-        // 获取当前时间戳
-        auto now = std::chrono::high_resolution_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-        
-        std::cout << "\n📤 [TCP发送] " << std::put_time(std::localtime(&time_t), "%H:%M:%S") 
-                  << "." << std::setfill('0') << std::setw(3) << ms.count() << std::endl;
-        std::cout << "   长度: " << cmdWithNewline.length() << " 字节" << std::endl;
-        std::cout << "   内容: " << command << std::endl;
-        std::cout << "   原始: " << cmdWithNewline << std::endl;
-        
-        // 发送命令
-        ssize_t sent = send(m_socket, cmdWithNewline.c_str(), cmdWithNewline.length(), 0);
-        if (sent < 0) {
-            std::cerr << "❌ TCP错误: 发送命令失败, errno=" << errno << std::endl;
+        ArmRequest request;
+        request.kind = ArmRequest::Command;
+        request.command = command;
+        request.reply = nullptr;
+        if (!m_requests.tryPush(request)) {
+            logger.log(LOG_TCP_SEND_FAILED, m_logSource, ENOBUFS);
             return false;
         }
-        
-        std::cout << "✅ 发送成功: " << sent << "/" << cmdWithNewline.length() << " 字节" << std::endl;
         return true;
     }
     
-    std::string receiveResponse() {
-        if (!m_connected) {
-            std::cerr << "❌ TCP错误: 连接未建立" << std::endl;
-            return "";
-        }
-        
-        char buffer[4096];
-        std::string fullResponse = "";
-        
-        // 设置接收超时
-        #if defined(WIN32)
-        DWORD timeout = 2000; // 2秒超时
-        setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout));
-        #else
-        struct timeval tv;
-        tv.tv_sec = 2;  // 2秒超时
-        tv.tv_usec = 0;
-        setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, (const char*)&tv, sizeof(tv));
-        #endif
-        
-        // 获取当前时间戳
-        auto now = std::chrono::high_resolution_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+    // 非伺服线程调用：投递指令，结果通过future返回（队列满时立即失败）
+    std::future<ArmReply> submit(const ArmCommand& command) {
+        std::promise<ArmReply>* reply = new std::promise<ArmReply>();
+        std::future<ArmReply> future = reply->get_future();
         
-        std::cout << "\n📥 [TCP接收] " << std::put_time(std::localtime(&time_t), "%H:%M:%S") 
-                  << "." << std::setfill('0') << std::setw(3) << ms.count() << std::endl;
-        
-        // 尝试接收数据
-        ssize_t received = recv(m_socket, buffer, sizeof(buffer) - 1, 0);
-        if (received > 0) {
-            buffer[received] = '\0';
-            fullResponse = std::string(buffer);
-            std::cout << "✅ 接收成功: " << received << " 字节" << std::endl;
-            std::cout << "   内容: " << fullResponse << std::endl;
-            
-            // 检查是否是完整的JSON
-            if (fullResponse.find("{") != std::string::npos && fullResponse.find("}") != std::string::npos) {
-                std::cout << "📋 JSON格式: 完整" << std::endl;
-            } else {
-                std::cout << "⚠️  JSON格式: 可能不完整" << std::endl;
-            }
-        } else if (received == 0) {
-            std::cout << "❌ TCP状态: 连接已关闭" << std::endl;
-        } else {
-            std::cout << "⏱️  TCP状态: 接收超时或错误, errno=" << errno << std::endl;
+        ArmRequest request;
+        request.kind = ArmRequest::Command;
+        request.command = command;
+        request.reply = reply;
+        if (!m_requests.tryPush(request)) {
+            completeReply(reply, nullptr);
         }
-        
-        return fullResponse;
+        return future;
     }
     
     std::array<int, 6> getCurrentArmPose() {
-        // 清空接收缓冲区，避免读取到旧的运动指令确认
-        std::cout << "清空接收缓冲区..." << std::endl;
-        
-        // 先读取并丢弃所有待处理的响应
-        for (int i = 0; i < 5; ++i) {
-            char buffer[4096];
-            #if defined(WIN32)
-            DWORD timeout = 100; // 100ms超时
-            setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout));
-            #else
-            struct timeval tv;
-            tv.tv_sec = 0;
-            tv.tv_usec = 100000; // 100ms超时
-            setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, (const char*)&tv, sizeof(tv));
-            #endif
-            
-            ssize_t received = recv(m_socket, buffer, sizeof(buffer) - 1, 0);
-            if (received <= 0) {
-                break; // 没有更多数据了
-            }
-            std::cout << "丢弃缓冲区数据: " << std::string(buffer, received) << std::endl;
-        }
-        
-        std::cout << "发送获取机械臂状态命令..." << std::endl;
-        
-        // 发送获取当前状态命令
-        if (!sendCommand("{ \"command\": \"get_current_arm_state\" }")) {
-            return {0, 0, 0, 0, 0, 0};
-        }
-        
-        // 等待一下确保命令被处理
-        #if defined(WIN32)
-        Sleep(200);
-        #else
-        usleep(200000); // 200ms
-        #endif
-        
-        // 接收响应并解析JSON中的pose字段
-        std::string response = receiveResponse();
-        
-        // 如果第一次没有收到正确的arm_state响应，再尝试几次
-        int attempts = 0;
-        while (attempts < 3 && response.find("\"arm_state\"") == std::string::npos) {
-            std::cout << "未收到arm_state响应，重试第" << (attempts + 1) << "次..." << std::endl;
-            
-            // 再次发送命令
-            if (!sendCommand("{ \"command\": \"get_current_arm_state\" }")) {
-                return {0, 0, 0, 0, 0, 0};
-            }
-            
-            #if defined(WIN32)
-            Sleep(300);
-            #else
-            usleep(300000); // 300ms
-            #endif
-            
-            response = receiveResponse();
-            attempts++;
-        }
-        
-        // 简单的JSON解析来提取arm_state中的pose数组
         std::array<int, 6> pose = {0, 0, 0, 0, 0, 0};
-        
-        std::cout << "接收到的完整响应: " << response << std::endl;
-        
-        // 首先查找 "arm_state" 字段
-        size_t armStatePos = response.find("\"arm_state\"");
-        if (armStatePos != std::string::npos) {
-            // 在arm_state内查找 "pose" 字段
-            size_t posePos = response.find("\"pose\"", armStatePos);
-            if (posePos != std::string::npos) {
-                // 查找数组开始位置
-                size_t arrayStart = response.find("[", posePos);
-                size_t arrayEnd = response.find("]", posePos);
-                
-                if (arrayStart != std::string::npos && arrayEnd != std::string::npos) {
-                    std::string poseArray = response.substr(arrayStart + 1, arrayEnd - arrayStart - 1);
-                    std::cout << "提取到的pose数组字符串: " << poseArray << std::endl;
-                    
-                    // 解析数组中的6个值
-                    std::istringstream iss(poseArray);
-                    std::string token;
-                    int index = 0;
-                    
-                    while (std::getline(iss, token, ',') && index < 6) {
-                        // 移除空格
-                        token.erase(0, token.find_first_not_of(" \t"));
-                        token.erase(token.find_last_not_of(" \t") + 1);
-                        
-                        try {
-                            pose[index] = std::stoi(token);
-                            std::cout << "解析pose[" << index << "] = " << pose[index] << std::endl;
-                            index++;
-                        } catch (const std::exception& e) {
-                            std::cerr << "解析pose数据错误: " << e.what() << std::endl;
-                            break;
-                        }
-                    }
-                    
-                    if (index == 6) {
-                        std::cout << "成功获取机械臂当前位姿: [";
-                        for (int i = 0; i < 6; ++i) {
-                            if (i > 0) std::cout << ", ";
-                            std::cout << pose[i];
-                        }
-                        std::cout << "]" << std::endl;
-                    } else {
-                        std::cerr << "警告: 只解析到 " << index << " 个pose值" << std::endl;
-                    }
-                } else {
-                    std::cerr << "警告: 无法找到pose数组边界" << std::endl;
-                }
-            } else {
-                std::cerr << "警告: 在arm_state中未找到pose字段" << std::endl;
-            }
-        } else {
-            std::cerr << "警告: 响应中未找到arm_state字段" << std::endl;
+        uint64_t ageNs = 0;
+        if (!tryGetPushedPose(pose, ageNs)) {
+            tryGetCurrentArmPose(pose);
         }
-        
         return pose;
     }
     
-    bool moveToTarget(const std::array<int, 6>& targetPose, int velocity = 50) {
-        std::ostringstream oss;
-        // 使用movep_follow实现笛卡尔空间跟随运动
-        oss << "{ \"command\": \"movep_follow\", \"pose\": [";
-        for (int i = 0; i < 6; ++i) {
-            if (i > 0) oss << ", ";
-            oss << targetPose[i];
+    // 从UDP主动上报的最新状态中取位姿（微秒级），没有上报或已过期时返回false
+    bool tryGetPushedPose(std::array<int, 6>& pose, uint64_t& ageNs) const {
+        ArmRealtimeState state;
+        if (!m_realtimeState.tryLoad(state) || state.source != ArmRealtimeState::SourceUdpPush) {
+            return false;
         }
-        oss << "] }";
-        
-        return sendCommand(oss.str());
+        ageNs = ArmCommandPipeline::nowNs() - state.timestampNs;
+        if (ageNs > m_pushMaxAgeNs) {
+            return false;
+        }
+        pose = state.pose;
+        return true;
     }
     
-    bool moveToTargetAsync(const std::array<int, 6>& targetPose, int velocity = 50) {
-        if (!m_connected) {
-            std::cerr << "❌ TCP错误: 机械臂未连接" << std::endl;
+    // 非服务线程调用：查询机械臂当前位姿，成功取得6个pose值时返回true
+    bool tryGetCurrentArmPose(std::array<int, 6>& pose) {
+        pose = {0, 0, 0, 0, 0, 0};
+        if (!isConnected()) {
+            BinaryLogger::instance().log(LOG_TCP_NOT_CONNECTED, m_logSource);
             return false;
         }
         
-        // 定期清理接收缓冲区，避免积压（每100次清理一次）
-        static int clearCounter = 0;
-        static int debugCounter = 0;
-        clearCounter++;
-        debugCounter++;
-        
-        if (clearCounter >= 100) {
-            clearReceiveBuffer();
-            clearCounter = 0;
-        }
-        
-        std::ostringstream oss;
-        // 使用movep_follow实现笛卡尔空间跟随运动（最快跟随控制）
-        oss << "{ \"command\": \"movep_follow\", \"pose\": [";
-        for (int i = 0; i < 6; ++i) {
-            if (i > 0) oss << ", ";
-            oss << targetPose[i];
-        }
-        oss << "] }";
-        
-        // 每50次显示一次详细TCP日志（避免日志过多）
-        bool showDebug = (debugCounter % 50 == 0);
-        
-        if (showDebug) {
-            auto now = std::chrono::high_resolution_clock::now();
-            auto time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-            
-            std::cout << "\n🚀 [TCP高频发送] " << std::put_time(std::localtime(&time_t), "%H:%M:%S") 
-                      << "." << std::setfill('0') << std::setw(3) << ms.count() << std::endl;
-            std::cout << "   频率计数: " << debugCounter << " (每50次显示)" << std::endl;
-            std::cout << "   目标位姿: [" << targetPose[0] << ", " << targetPose[1] << ", " 
-                      << targetPose[2] << ", " << targetPose[3] << ", " << targetPose[4] << ", " << targetPose[5] << "]" << std::endl;
-            std::cout << "   命令内容: " << oss.str() << std::endl;
-        }
-        
-        // 异步发送：只发送不等待响应，确保100Hz频率
-        std::string cmdWithNewline = oss.str() + "\r\n";
-        ssize_t sent = send(m_socket, cmdWithNewline.c_str(), cmdWithNewline.length(), MSG_DONTWAIT | MSG_NOSIGNAL);
-        
-        if (showDebug) {
-            if (sent > 0) {
-                std::cout << "✅ 异步发送成功: " << sent << "/" << cmdWithNewline.length() << " 字节" << std::endl;
-            } else {
-                std::cout << "❌ 异步发送失败: errno=" << errno << std::endl;
-            }
-        }
+        std::future<ArmReply> reply = submit(ArmCommand::make(ArmCommand::GetArmState));
         
-        return sent > 0;
-    }
-    
-    // 新增：启用机械臂电源（必须）
-    bool enableArmPower() {
-        if (!m_connected) {
+        // 后端负责超时重发，这里只需等待它给出最终结果
+        uint64_t waitNs = kPoseQueryTimeoutNs * (kPoseQueryRetries + 1) + 500000000ULL;
+        if (reply.wait_for(std::chrono::nanoseconds(waitNs)) != std::future_status::ready) {
             return false;
         }
-        
-        std::string cmd = "{ \"command\": \"set_arm_power\", \"enable\": true }";
-        bool result = sendCommand(cmd);
-        if (result) {
-            usleep(500000); // 等待500ms确保启用完成
+        ArmReply result = reply.get();
+        if (!result.ok || !(result.response.fields & ArmResponse::FieldPose)) {
+            return false;
         }
-        return result;
+        pose = result.response.pose;
+        return true;
     }
     
-    // 新增：启用角度透传模式（最快响应）
-    bool enableAngleTransmission() {
-        if (!m_connected) {
+    // 服务线程调用（管线出队）：交给后端发送笛卡尔跟随目标
+    bool moveToTargetAsync(const std::array<int, 6>& targetPose, int velocity = 50) {
+        (void)velocity;
+        // 后端连接只能在服务线程中使用
+        if (!m_transport->isServiceThread()) {
+            m_offThreadSends.fetch_add(1, std::memory_order_relaxed);
             return false;
         }
-        
-        // 启用角度透传模式，实现最快响应
-        std::string cmd = "{ \"command\": \"set_angle_transmission\", \"state\": true }";
-        return sendCommand(cmd);
+        return m_transport->streamPose(targetPose);
     }
     
-    // 新增：启用UDP主动上报（最快状态反馈）
-    bool enableUDPBroadcast() {
-        if (!m_connected) {
-            return false;
-        }
-        
-        // 启用UDP主动上报，获得最快状态反馈
-        std::string cmd = "{ \"command\": \"set_realtime_push\", \"cycle\": 5, \"port\": 8089, \"force_coordinate\": 0, \"ip\": \"192.168.10.100\" }";
-        return sendCommand(cmd);
+    // 设置UDP主动上报参数（在connect之前调用）
+    void setRealtimePushConfig(const std::string& hostIp, int port, int cycle, int maxAgeMs, bool enabled) {
+        m_pushHostIp = hostIp;
+        m_pushPort = port;
+        m_pushCycle = cycle;
+        m_pushMaxAgeNs = static_cast<uint64_t>(maxAgeMs) * 1000000;
+        m_pushEnabled = enabled;
     }
     
-    // 新增：设置示教参考坐标系
-    bool setTeachFrame(int frameType) {
-        if (!m_connected) {
-            return false;
-        }
-        
-        std::ostringstream oss;
-        oss << "{ \"command\": \"set_teach_frame\", \"frame_type\": " << frameType << " }";
-        return sendCommand(oss.str());
+    // 设置连接后的设置序列参数（示教参考坐标系、工具坐标系名称，在connect之前调用）
+    void setSetupConfig(int teachFrameType, const std::string& toolName) {
+        m_teachFrameType = teachFrameType;
+        m_toolName = toolName;
     }
     
-    // 新增：设置工具坐标系（按名称）
-    bool setToolCoordinateSystem(const std::string& toolName) {
-        if (!m_connected) {
-            return false;
-        }
-        
-        std::ostringstream oss;
-        oss << "{ \"command\": \"set_tool_coordinate\", \"tool_name\": \"" << toolName << "\" }";
-        return sendCommand(oss.str());
+    // 已连接且设置序列已完成，可以开始实时控制（任意线程调用）
+    bool isReady() const { return m_ready.load(std::memory_order_acquire); }
+    
+    // 最近一次完成的设置序列耗时，从未就绪时返回false（任意线程调用）
+    bool getSetupTimings(ArmSetupTimings& timings) const {
+        std::lock_guard<std::mutex> lock(m_setupTimingsMutex);
+        timings = m_setupTimings;
+        return m_setupTimings.totalNs != 0;
     }
     
     // 剪刀控制方法
     bool controlScissors(bool close, int port = 1, int address = 2, int device = 1) {
-        if (!m_connected) {
-            std::cout << "❌ 剪刀控制失败: 机械臂未连接" << std::endl;
+        if (!isConnected()) {
+            BinaryLogger::instance().log(LOG_SCISSORS_NOT_CONNECTED, m_logSource);
             return false;
         }
         
-        std::ostringstream oss;
         int data = close ? 1 : 0;  // 1=闭合剪刀，0=松开剪刀
-        
-        oss << "{ \"command\": \"write_single_register\", \"port\": " << port 
-            << ", \"address\": " << address << ", \"data\": " << data 
-            << ", \"device\": " << device << " }";
-        
-        std::string command = oss.str();
-        std::cout << "🔧 发送剪刀控制命令: " << command << std::endl;
-        
-        return sendCommand(command);
+        return controlScissorsCustom(port, address, data, device);
     }
     
     // 剪刀控制方法（自定义数据值）
     bool controlScissorsCustom(int port, int address, int data, int device) {
-        if (!m_connected) {
-            std::cout << "❌ 剪刀控制失败: 机械臂未连接" << std::endl;
+        BinaryLogger& logger = BinaryLogger::instance();
+        if (!isConnected()) {
+            logger.log(LOG_SCISSORS_NOT_CONNECTED, m_logSource);
             return false;
         }
         
-        std::ostringstream oss;
-        
-        oss << "{ \"command\": \"write_single_register\", \"port\": " << port 
-            << ", \"address\": " << address << ", \"data\": " << data 
-            << ", \"device\": " << device << " }";
-        
-        std::string command = oss.str();
-        std::cout << "🔧 发送剪刀控制命令: " << command << std::endl;
+        logger.log(LOG_SCISSORS_COMMAND, m_logSource, port, address, data, device);
         
-        return sendCommand(command);
+        return post(ArmCommand::make(ArmCommand::WriteSingleRegister, port, address, data, device));
     }
     
     // 新增：直接发送关节角度（最快控制方式）
     bool sendJointAnglesAsync(const std::array<double, 6>& jointAngles) {
-        if (!m_connected) {
+        if (!isConnected()) {
             return false;
         }
         
-        std::ostringstream oss;
-        oss << "{ \"command\": \"set_joint_angle_transmission\", \"joint\": [";
-        for (int i = 0; i < 6; ++i) {
-            if (i > 0) oss << ", ";
-            oss << std::fixed << std::setprecision(6) << jointAngles[i];
-        }
-        oss << "] }";
-        
-        // 异步发送关节角度
-        std::string cmdWithNewline = oss.str() + "\r\n";
-        ssize_t sent = send(m_socket, cmdWithNewline.c_str(), cmdWithNewline.length(), MSG_DONTWAIT | MSG_NOSIGNAL);
-        
-        return sent > 0;
-    }
-    
-    void clearReceiveBuffer() {
-        if (!m_connected) return;
-        
-        // 非阻塞读取并丢弃所有待处理数据
-        char buffer[4096];
-        int totalCleared = 0;
-        int packets = 0;
-        
-        std::cout << "\n🧹 [TCP缓冲区清理] 开始清理..." << std::endl;
-        
-        while (true) {
-            ssize_t received = recv(m_socket, buffer, sizeof(buffer) - 1, MSG_DONTWAIT);
-            if (received <= 0) {
-                break; // 没有更多数据
-            }
-            
-            buffer[received] = '\0';
-            totalCleared += received;
-            packets++;
-            
-            // 显示清理的数据（只显示前100个字符避免过长）
-            std::string data(buffer);
-            if (data.length() > 100) {
-                data = data.substr(0, 100) + "...";
-            }
-            std::cout << "   清理包" << packets << ": " << received << "字节 - " << data << std::endl;
-        }
-        
-        if (totalCleared > 0) {
-            std::cout << "✅ 清理完成: 共" << packets << "个包, " << totalCleared << "字节" << std::endl;
-        } else {
-            std::cout << "✅ 缓冲区已清洁" << std::endl;
+        // 交给服务线程发送（连接不可写时只保留最新的关节角度）
+        ArmRequest request;
+        request.kind = ArmRequest::StreamJoints;
+        request.joints = jointAngles;
+        request.reply = nullptr;
+        if (!m_requests.tryPush(request)) {
+            BinaryLogger::instance().log(LOG_TCP_SEND_FAILED, m_logSource, ENOBUFS);
+            return false;
         }
+        return true;
     }
     
     // 新增：夹抓控制方法 - 使用力矩抓取和释放
     bool controlGripper(bool open) {
-        if (!m_connected) {
-            std::cerr << "❌ 夹抓控制错误: 机械臂未连接" << std::endl;
+        BinaryLogger& logger = BinaryLogger::instance();
+        if (!isConnected()) {
+            logger.log(LOG_GRIPPER_NOT_CONNECTED, m_logSource);
             return false;
         }
         
-        std::ostringstream oss;
         if (open) {
             // 打开夹抓 - 使用释放命令
-            oss << "{ \"command\": \"set_gripper_release\", \"speed\": " << m_gripperReleaseSpeed 
-                << ", \"block\": " << (m_gripperBlockMode ? "true" : "false") << " }";
-            std::cout << "\n🤏 [夹抓控制] 释放夹抓 (速度: " << m_gripperReleaseSpeed << ")" << std::endl;
-        } else {
-            // 关闭夹抓 - 使用力矩抓取
-            oss << "{ \"command\": \"set_gripper_pick\", \"speed\": " << m_gripperPickSpeed 
-                << ", \"force\": " << m_gripperForceThreshold 
-                << ", \"block\": " << (m_gripperBlockMode ? "true" : "false") << " }";
-            std::cout << "\n🤏 [夹抓控制] 力矩抓取 (速度: " << m_gripperPickSpeed 
-                      << ", 力矩: " << m_gripperForceThreshold << ")" << std::endl;
+            logger.log(LOG_GRIPPER_RELEASE, m_logSource, m_gripperReleaseSpeed);
+            return post(ArmCommand::make(ArmCommand::GripperRelease, m_gripperReleaseSpeed, m_gripperBlockMode));
         }
         
-        return sendCommand(oss.str());
+        // 关闭夹抓 - 使用力矩抓取
+        logger.log(LOG_GRIPPER_PICK, m_logSource, m_gripperPickSpeed, m_gripperForceThreshold);
+        return post(ArmCommand::make(ArmCommand::GripperPick, m_gripperPickSpeed, m_gripperForceThreshold,
+                                     m_gripperBlockMode));
     }
     
     // 新增：设置夹爪配置参数
@@ -1003,193 +818,652 @@ public:
                   << ", 阻塞模式=" << (blockMode ? "是" : "否") << std::endl;
     }
     
-    bool isConnected() const { return m_connected; }
-};
-
-// 触觉设备机械臂控制器
-class TouchArmController {
-private:
-    bool m_dragging;
-    std::array<double, 3> m_touchAnchor;      // 触觉设备锚点
-    std::array<double, 16> m_touchAnchorTransform;  // 触觉设备锚点姿态
-    std::array<int, 6> m_armAnchor;           // 机械臂锚点位姿
-    double m_positionScale;    // 位置映射系数
-    double m_rotationScale;    // 姿态映射系数
-    double m_springStiffness;  // 弹簧刚度系数
-    int m_debugFrequency;      // 调试信息显示频率
-    int m_controlFrequency;    // 控制命令发送频率
-    
-    // 坐标映射配置变量
-    int m_touchPosToArmX;      // 触觉设备哪个轴(0=X,1=Y,2=Z)映射到机械臂X轴
-    int m_touchPosToArmY;      // 触觉设备哪个轴(0=X,1=Y,2=Z)映射到机械臂Y轴
-    int m_touchPosToArmZ;      // 触觉设备哪个轴(0=X,1=Y,2=Z)映射到机械臂Z轴
-    int m_touchRotToArmRX;     // 触觉设备哪个旋转轴(0=RX,1=RY,2=RZ)映射到机械臂RX轴
-    int m_touchRotToArmRY;     // 触觉设备哪个旋转轴(0=RX,1=RY,2=RZ)映射到机械臂RY轴
-    int m_touchRotToArmRZ;     // 触觉设备哪个旋转轴(0=RX,1=RY,2=RZ)映射到机械臂RZ轴
-    
-    // 机械臂轴符号调整 (1或-1)
-    int m_armXSign;            // 机械臂X轴符号 (1或-1)
-    int m_armYSign;            // 机械臂Y轴符号 (1或-1)
-    int m_armZSign;            // 机械臂Z轴符号 (1或-1)
-    int m_armRXSign;           // 机械臂RX轴符号 (1或-1)
-    int m_armRYSign;           // 机械臂RY轴符号 (1或-1)
-    int m_armRZSign;           // 机械臂RZ轴符号 (1或-1)
+    // 伺服线程调用：只把目标位姿写入无锁队列，由服务线程完成编码和发送
+    bool postTarget(const std::array<int, 6>& targetPose) {
+        if (!isConnected()) {
+            return false;
+        }
+        return m_pipeline.post(targetPose);
+    }
     
-    ArmController& m_armController;
-    ConfigLoader* m_config;    // 配置文件加载器
-    std::string m_deviceName;  // 设备名称
+    // 伺服线程调用：发起一次锚点位姿请求，返回请求序号（无阻塞、无系统调用）
+    uint32_t requestAnchorPose() {
+        return m_anchorRequestSeq.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
     
-    // 灵巧手相关成员
-    bool m_useDexterousHand;           // 是否使用灵巧手
-    DexterousHandController* m_handController;  // 灵巧手控制器
+    // 伺服线程调用：检查指定请求是否已有结果，有结果时返回true并输出位姿
+    bool pollAnchorPose(uint32_t requestSeq, std::array<int, 6>& pose, bool& valid) const {
+        if (m_anchorResultSeq.load(std::memory_order_acquire) != requestSeq) {
+            return false;
+        }
+        pose = m_anchorResultPose;
+        valid = m_anchorResultValid;
+        return true;
+    }
     
-    // 末端控制器类型和剪刀控制相关成员
-    std::string m_endEffectorType;     // 末端控制器类型 (dexterous_hand, gripper, scissors)
-    int m_scissorsModbusPort;          // 剪刀Modbus端口
-    int m_scissorsModbusAddress;       // 剪刀寄存器地址
-    int m_scissorsModbusDevice;        // 剪刀设备号
-    int m_scissorsOpenData;            // 松开剪刀的数据值
-    int m_scissorsCloseData;           // 闭合剪刀的数据值
-    bool m_scissorsState;              // 剪刀状态 (true=闭合, false=松开)
+    uint64_t getLastAnchorQueryNs() const { return m_lastAnchorQueryNs.load(std::memory_order_relaxed); }
     
-public:
-    TouchArmController(ArmController& armController, ConfigLoader* config = nullptr, const std::string& deviceName = "") 
-        : m_dragging(false), m_armController(armController), m_config(config), m_deviceName(deviceName),
-          m_touchAnchor({0.0, 0.0, 0.0}),
-          m_touchAnchorTransform({1.0,0.0,0.0,0.0, 0.0,1.0,0.0,0.0, 0.0,0.0,1.0,0.0, 0.0,0.0,0.0,1.0}),
-          m_armAnchor({0, 0, 0, 0, 0, 0}),
-          m_touchPosToArmX(2), m_touchPosToArmY(0), m_touchPosToArmZ(1),
-          m_touchRotToArmRX(2), m_touchRotToArmRY(0), m_touchRotToArmRZ(1),
-          m_armXSign(-1), m_armYSign(-1), m_armZSign(1), 
-          m_armRXSign(-1), m_armRYSign(-1), m_armRZSign(1),
-          m_useDexterousHand(false), m_handController(nullptr),
-          m_endEffectorType("gripper"), m_scissorsModbusPort(1), m_scissorsModbusAddress(2),
-          m_scissorsModbusDevice(1), m_scissorsOpenData(0), m_scissorsCloseData(1), m_scissorsState(false) {
-        
-        // 从配置文件加载参数，如果没有配置文件则使用默认值
-        if (m_config) {
-            std::string prefix = m_deviceName.empty() ? "control" : m_deviceName;
-            m_positionScale = m_config->getDouble(prefix + ".position_scale", 1000.0);
-            m_rotationScale = m_config->getDouble(prefix + ".rotation_scale", 1.0);
-            m_springStiffness = m_config->getDouble(prefix + ".spring_stiffness", 0.2);
-            m_debugFrequency = m_config->getInt("system.debug_frequency", 50);
-            m_controlFrequency = m_config->getInt("system.control_frequency", 10);
-            
-            // 加载坐标映射配置
-            std::string mappingPrefix = m_deviceName.empty() ? "mapping" : (m_deviceName + "_mapping");
-            m_touchPosToArmX = m_config->getInt(mappingPrefix + ".touch_pos_to_arm_x", 2);  // 默认：Z→X
-            m_touchPosToArmY = m_config->getInt(mappingPrefix + ".touch_pos_to_arm_y", 0);  // 默认：X→Y
-            m_touchPosToArmZ = m_config->getInt(mappingPrefix + ".touch_pos_to_arm_z", 1);  // 默认：Y→Z
-            m_touchRotToArmRX = m_config->getInt(mappingPrefix + ".touch_rot_to_arm_rx", 2); // 默认：RZ→RX
-            m_touchRotToArmRY = m_config->getInt(mappingPrefix + ".touch_rot_to_arm_ry", 0); // 默认：RX→RY
-            m_touchRotToArmRZ = m_config->getInt(mappingPrefix + ".touch_rot_to_arm_rz", 1); // 默认：RY→RZ
-            
-            // 加载机械臂轴符号调整
-            m_armXSign = m_config->getInt(mappingPrefix + ".arm_x_sign", 1);
-            m_armYSign = m_config->getInt(mappingPrefix + ".arm_y_sign", 1);
-            m_armZSign = m_config->getInt(mappingPrefix + ".arm_z_sign", 1);
-            m_armRXSign = m_config->getInt(mappingPrefix + ".arm_rx_sign", -1);
-            m_armRYSign = m_config->getInt(mappingPrefix + ".arm_ry_sign", -1);
-            m_armRZSign = m_config->getInt(mappingPrefix + ".arm_rz_sign", 1);
-            
-            // 加载末端控制器配置
-            m_endEffectorType = m_config->getString(mappingPrefix + ".end_effector_type", "gripper");
-            
-            // 加载剪刀控制配置
-            m_scissorsModbusPort = m_config->getInt(mappingPrefix + ".scissors_modbus_port", 1);
-            m_scissorsModbusAddress = m_config->getInt(mappingPrefix + ".scissors_modbus_address", 2);
-            m_scissorsModbusDevice = m_config->getInt(mappingPrefix + ".scissors_modbus_device", 1);
-            m_scissorsOpenData = m_config->getInt(mappingPrefix + ".scissors_open_data", 0);
-            m_scissorsCloseData = m_config->getInt(mappingPrefix + ".scissors_close_data", 1);
-            
-            std::cout << "从配置文件加载" << m_deviceName << "控制参数和坐标映射配置" << std::endl;
-        } else {
-            // 使用默认值
-            m_positionScale = 1000.0;
-            m_rotationScale = 1.0;
-            m_springStiffness = 0.2;
-            m_debugFrequency = 50;
-            m_controlFrequency = 10;
-            
-            // 默认映射配置（保持与原代码相同的行为）
-            m_touchPosToArmX = 2;   // 触觉设备Z轴 → 机械臂X轴
-            m_touchPosToArmY = 0;   // 触觉设备X轴 → 机械臂Y轴
-            m_touchPosToArmZ = 1;   // 触觉设备Y轴 → 机械臂Z轴
-            m_touchRotToArmRX = 2;  // 触觉设备RZ轴 → 机械臂RX轴
-            m_touchRotToArmRY = 0;  // 触觉设备RX轴 → 机械臂RY轴
-            m_touchRotToArmRZ = 1;  // 触觉设备RY轴 → 机械臂RZ轴
-            
-            // 默认符号调整
-            m_armXSign = -1;    // 机械臂X轴取反
-            m_armYSign = -1;    // 机械臂Y轴取反
-            m_armZSign = 1;     // 机械臂Z轴正向
-            m_armRXSign = -1;   // 机械臂RX轴取反
-            m_armRYSign = -1;   // 机械臂RY轴取反
-            m_armRZSign = 1;    // 机械臂RZ轴正向
-            
-            std::cout << "使用默认控制参数和坐标映射配置 (" << m_deviceName << ")" << std::endl;
+    // 指令往返时间的滑动平均（任意线程调用，尚未测得时为0）
+    uint64_t getCommandRttNs() const { return m_commandRttNs.load(std::memory_order_relaxed); }
+    
+    // 设置往返探测间隔：就绪后每隔该时长发一次状态查询，使拖动期间（只有不回复的流式帧）也能测得往返时间
+    void setRttProbeInterval(uint64_t intervalNs) {
+        m_rttProbeIntervalNs.store(intervalNs, std::memory_order_relaxed);
+    }
+    
+    // 发布查询到的位姿、关节角度和错误码（非伺服线程调用），保留上一次上报的其他字段
+    void publishReportedState(const ArmResponse& response) {
+        std::lock_guard<std::mutex> lock(m_realtimeStateWriteMutex);
+        ArmRealtimeState state;
+        if (!m_realtimeState.tryLoad(state)) {
+            memset(&state, 0, sizeof(state));
+            state.armCurrentStatus = -1;
         }
-        
-        // 初始化末端控制器配置
-        initializeEndEffector();
-        
-        // 启用机械臂控制模式
-        if (m_armController.isConnected()) {
-            std::cout << "启用机械臂控制模式..." << std::endl;
-            
-            // 0. 启用机械臂电源（必须第一步）
-            m_armController.enableArmPower();
-            
-            // 1. 启用角度透传模式（最快响应）
-            m_armController.enableAngleTransmission();
-            
-            // 2. 启用UDP主动上报（最快状态反馈）
-            m_armController.enableUDPBroadcast();
-            
-            // 3. 设置示教参考坐标系（从配置文件读取）
-            int frameType = 1;  // 默认为工具坐标系
-            if (m_config) {
-                frameType = m_config->getInt("system.teach_frame_type", 1);
+        state.timestampNs = ArmCommandPipeline::nowNs();
+        state.source = ArmRealtimeState::SourceTcpQuery;
+        state.fields |= ArmRealtimeState::FieldPose;
+        state.pose = response.pose;
+        // 查询响应中的关节角度单位为0.001°（与主动上报相同）
+        if ((response.fields & ArmResponse::FieldJoint) && response.jointCount >= 6) {
+            state.fields |= ArmRealtimeState::FieldJointStatus;
+            for (int i = 0; i < response.jointCount && i < ArmRealtimeState::kArmDof; ++i) {
+                state.jointPosition[i] = response.joint[i] / 1000.0f;
             }
-            std::cout << "设置示教参考坐标系为: " << (frameType == 0 ? "基坐标系" : "工具坐标系") << "..." << std::endl;
-            m_armController.setTeachFrame(frameType);
-            
-            // 4. 设置工具坐标系（根据实曼协议）
-            std::string toolName = "Arm_Tip";  // 默认值
-            if (m_config) {
-                toolName = m_config->getString("system.tool_coordinate_name", "Arm_Tip");
+        }
+        if (response.fields & ArmResponse::FieldErrors) {
+            state.fields |= ArmRealtimeState::FieldErrors;
+            state.armErr = response.armErr;
+            state.sysErr = response.sysErr;
+            state.errCount = response.errCount;
+            for (int i = 0; i < response.errCount && i < ArmRealtimeState::kMaxErrors; ++i) {
+                state.err[i] = response.err[i];
             }
-            std::cout << "设置工具坐标系为: " << toolName << "..." << std::endl;
-            m_armController.setToolCoordinateSystem(toolName);
-            
-            // 5. 配置夹爪参数（从配置文件读取）
-            int pickSpeed = 500, releaseSpeed = 500, forceThreshold = 200;
-            bool blockMode = true;
-            if (m_config) {
-                pickSpeed = m_config->getInt("gripper.pick_speed", 500);
-                releaseSpeed = m_config->getInt("gripper.release_speed", 500);
-                forceThreshold = m_config->getInt("gripper.force_threshold", 200);
-                blockMode = m_config->getBool("gripper.block_mode", true);
-            }
-            std::cout << "配置夹爪参数..." << std::endl;
-            m_armController.setGripperConfig(pickSpeed, releaseSpeed, forceThreshold, blockMode);
-            
-            std::cout << "机械臂控制模式已启用" << std::endl;
-            std::cout << "参考坐标系: " << (frameType == 0 ? "基坐标系" : "工具坐标系") << std::endl;
-            std::cout << "工具坐标系: " << toolName << std::endl;
         }
+        m_realtimeState.store(state);
     }
     
-    // 添加析构函数
-    ~TouchArmController() {
-        if (m_handController) {
-            delete m_handController;
-            m_handController = nullptr;
+    // 接收线程调用：发布UDP主动上报的完整状态
+    void publishRealtimeState(const ArmRealtimeState& state) {
+        std::lock_guard<std::mutex> lock(m_realtimeStateWriteMutex);
+        m_realtimeState.store(state);
+    }
+    
+    // 任意线程（包括伺服线程）调用：读取最近的实际状态（wait-free），从未发布时返回false
+    bool readArmState(ArmRealtimeState& state) const {
+        return m_realtimeState.tryLoad(state);
+    }
+    
+    uint64_t getPushMaxAgeNs() const { return m_pushMaxAgeNs; }
+    const std::string& getRobotIP() const { return m_robotIP; }
+    const char* getTransportName() const { return m_transport->name(); }
+    
+    ArmCommandPipeline::Stats getPipelineStats() const { return m_pipeline.getStats(); }
+    uint64_t getOffThreadSendCount() const { return m_offThreadSends.load(std::memory_order_relaxed); }
+    
+    // 打印指令管线统计
+    void printPipelineStats() const {
+        ArmCommandPipeline::Stats stats = m_pipeline.getStats();
+        std::cout << "[机械臂 " << m_robotIP << "] 指令管线: "
+                  << "深度=" << stats.depth << "/" << stats.maxDepth << "(最大)"
+                  << ", 入队=" << stats.posted
+                  << ", 丢弃=" << stats.dropped
+                  << ", 已发送=" << stats.sent
+                  << ", 发送失败=" << stats.sendFailures
+                  << ", 延迟=" << std::fixed << std::setprecision(3) << (stats.lastLatencyNs / 1e6)
+                  << "ms/" << (stats.maxLatencyNs / 1e6) << "ms(最大)"
+                  << ", 非服务线程发送=" << getOffThreadSendCount()
+                  << ", 请求队列=" << m_requests.size() << "/" << m_requests.capacity() << std::endl;
+        m_transport->printStats(std::cout, "[机械臂 " + m_robotIP + "] 请求");
+    }
+    
+    bool isConnected() const { return m_transport->isConnected(); }
+    
+    // 至少一次连接尝试已失败（之后由后端在后台重连）
+    bool hasConnectFailed() const { return m_transport->getConnectFailures() > 0; }
+    
+private:
+    // ---- 以下全部在传输后端的服务线程中调用 ----
+    
+    void onTransportConnected(ArmTransport& transport) override {
+        (void)transport;
+        // 每次连接（包括重连）都从上电开始重放设置序列，完成前不进入实时控制
+        m_ready.store(false, std::memory_order_release);
+        ++m_setupGeneration;
+        m_setupStartNs = ArmCommandPipeline::nowNs();
+        memset(&m_setupProgress, 0, sizeof(m_setupProgress));
+        uint64_t connectStartNs = m_connectStartNs.exchange(0, std::memory_order_relaxed);
+        if (connectStartNs != 0 && connectStartNs < m_setupStartNs) {
+            m_setupProgress.connectNs = m_setupStartNs - connectStartNs;
         }
+        std::cout << "启用机械臂控制模式 (" << m_robotIP << ")..." << std::endl;
+        startPowerUp();
     }
     
-    // 初始化末端控制器
-    void initializeEndEffector() {
+    void onTransportDisconnected(ArmTransport& transport) override {
+        (void)transport;
+        m_ready.store(false, std::memory_order_release);
+        ++m_setupGeneration;
+        m_setupPhase = SetupIdle;
+    }
+    
+    void onTransportTick(ArmTransport& transport, uint64_t nowNs) override {
+        if (m_setupPhase == SetupPowerRetry && nowNs >= m_setupDueNs && transport.isConnected()) {
+            startPowerUp();
+        }
+        
+        // 伺服线程投递的目标位姿（管线只保留最新的几帧）
+        m_pipeline.drain();
+        serviceAnchorRequest(nowNs);
+        serviceRttProbe(nowNs);
+        
+        ArmRequest request;
+        while (m_requests.tryPop(request)) {
+            processRequest(request);
+        }
+    }
+    
+    void onArmState(ArmTransport& transport, const ArmResponse& response) override {
+        (void)transport;
+        // 查询得到的位姿无论是否对应锚点请求都发布为最新状态
+        publishReportedState(response);
+    }
+    
+    void processRequest(const ArmRequest& request) {
+        if (request.kind == ArmRequest::StreamJoints) {
+            m_transport->streamJoints(request.joints);
+            return;
+        }
+        
+        // 响应到达（或超时）时完成等待方的future
+        std::promise<ArmReply>* reply = request.reply;
+        uint64_t sentNs = ArmCommandPipeline::nowNs();
+        ArmTransport::Callback callback = [this, reply, sentNs](const ArmResponse* response) {
+            if (response) {
+                recordCommandRtt(sentNs);
+            }
+            if (reply) {
+                completeReply(reply, response);
+            }
+        };
+        uint64_t timeoutNs = kCommandTimeoutNs;
+        int retries = 0;
+        if (request.command.type == ArmCommand::GetArmState) {
+            timeoutNs = kPoseQueryTimeoutNs;
+            retries = kPoseQueryRetries;
+        }
+        if (!m_transport->send(request.command, timeoutNs, retries, callback)) {
+            completeReply(reply, nullptr);
+        }
+    }
+    
+    // 处理伺服线程挂起的锚点请求：优先使用主动上报的位姿，否则发出查询（不等待响应）
+    void serviceAnchorRequest(uint64_t nowNs) {
+        uint32_t requestSeq = m_anchorRequestSeq.load(std::memory_order_acquire);
+        if (requestSeq == m_anchorServedSeq) {
+            return;
+        }
+        m_anchorServedSeq = requestSeq;
+        m_anchorStartNs = nowNs;
+        
+        std::array<int, 6> pose = {0, 0, 0, 0, 0, 0};
+        uint64_t ageNs = 0;
+        if (tryGetPushedPose(pose, ageNs)) {
+            publishAnchorResult(requestSeq, pose, true);
+            return;
+        }
+        
+        bool sent = m_transport->send(ArmCommand::make(ArmCommand::GetArmState), kPoseQueryTimeoutNs, kPoseQueryRetries,
+                                      [this, requestSeq](const ArmResponse* response) {
+            // 只发布最新请求的结果，旧请求已被伺服线程放弃
+            if (requestSeq != m_anchorServedSeq) {
+                return;
+            }
+            if (response) {
+                recordCommandRtt(m_anchorStartNs);
+            }
+            bool valid = response && (response->fields & ArmResponse::FieldPose);
+            if (!valid) {
+                BinaryLogger::instance().log(LOG_POSE_QUERY_NO_POSE, m_logSource);
+            }
+            std::array<int, 6> zero = {0, 0, 0, 0, 0, 0};
+            publishAnchorResult(requestSeq, valid ? response->pose : zero, valid);
+        });
+        if (!sent) {
+            publishAnchorResult(requestSeq, pose, false);
+        }
+    }
+    
+    // 就绪后按间隔发出往返探测查询（上一次探测完成前不再发）
+    void serviceRttProbe(uint64_t nowNs) {
+        uint64_t intervalNs = m_rttProbeIntervalNs.load(std::memory_order_relaxed);
+        if (intervalNs == 0 || m_rttProbeInFlight || nowNs < m_nextRttProbeNs || !isReady()) {
+            return;
+        }
+        m_nextRttProbeNs = nowNs + intervalNs;
+        m_rttProbeInFlight = m_transport->send(ArmCommand::make(ArmCommand::GetArmState), kPoseQueryTimeoutNs, 0,
+                                               [this, nowNs](const ArmResponse* response) {
+            m_rttProbeInFlight = false;
+            if (response) {
+                recordCommandRtt(nowNs);
+            }
+        });
+    }
+    
+    // 服务线程调用：记录一次请求→响应的往返时间（滑动平均，首个样本直接采用）
+    void recordCommandRtt(uint64_t sentNs) {
+        uint64_t rttNs = ArmCommandPipeline::nowNs() - sentNs;
+        uint64_t averageNs = m_commandRttNs.load(std::memory_order_relaxed);
+        averageNs = averageNs == 0 ? rttNs : averageNs - averageNs / 8 + rttNs / 8;
+        m_commandRttNs.store(averageNs, std::memory_order_relaxed);
+    }
+    
+    void publishAnchorResult(uint32_t requestSeq, const std::array<int, 6>& pose, bool valid) {
+        m_lastAnchorQueryNs.store(ArmCommandPipeline::nowNs() - m_anchorStartNs, std::memory_order_relaxed);
+        m_anchorResultPose = pose;
+        m_anchorResultValid = valid;
+        m_anchorResultSeq.store(requestSeq, std::memory_order_release);
+    }
+    
+    // 发出上电指令，确认后进入其余设置（发送失败或超时后隔一段时间重试）
+    void startPowerUp() {
+        m_setupPhase = SetupPowering;
+        ++m_setupProgress.powerAttempts;
+        uint32_t generation = m_setupGeneration;
+        bool sent = m_transport->send(ArmCommand::make(ArmCommand::SetArmPower, 1), kCommandTimeoutNs, 0,
+                                      [this, generation](const ArmResponse* response) {
+            onPowerAck(generation, response);
+        });
+        if (!sent) {
+            onPowerAck(generation, nullptr);
+        }
+    }
+    
+    void onPowerAck(uint32_t generation, const ArmResponse* response) {
+        // 旧连接的回调（断开时在途指令以空响应完成）
+        if (generation != m_setupGeneration || m_setupPhase != SetupPowering) {
+            return;
+        }
+        uint64_t nowNs = ArmCommandPipeline::nowNs();
+        if (!response) {
+            if (m_transport->isConnected()) {
+                std::cout << "⚠️  机械臂 " << m_robotIP << " 上电未确认（第" << m_setupProgress.powerAttempts
+                          << "次），" << kPowerRetryDelayNs / 1000000 << "ms后重试" << std::endl;
+            }
+            m_setupPhase = SetupPowerRetry;
+            m_setupDueNs = nowNs + kPowerRetryDelayNs;
+            return;
+        }
+        m_powerAckNs = nowNs;
+        m_setupProgress.powerNs = nowNs - m_setupStartNs;
+        configure();
+    }
+    
+    // 上电确认后同时发出其余设置指令，全部确认（或失败）后就绪
+    void configure() {
+        m_setupPhase = SetupConfiguring;
+        
+        ArmCommand commands[ArmSetupTimings::kMaxSteps];
+        int count = 0;
+        // 启用角度透传模式（最快响应）
+        commands[count++] = ArmCommand::make(ArmCommand::SetAngleTransmission, 1);
+        // 启用UDP主动上报（最快状态反馈），本机接收未启动时跳过
+        if (m_pushEnabled) {
+            commands[count++] = ArmCommand::make(ArmCommand::SetRealtimePush, m_pushCycle, m_pushPort, 0, 0, m_pushHostIp);
+        }
+        // 示教参考坐标系和工具坐标系
+        commands[count++] = ArmCommand::make(ArmCommand::SetTeachFrame, m_teachFrameType);
+        commands[count++] = ArmCommand::make(ArmCommand::SetToolFrame, 0, 0, 0, 0, m_toolName);
+        
+        m_setupProgress.stepCount = count;
+        m_setupPending = count;
+        uint32_t generation = m_setupGeneration;
+        for (int i = 0; i < count; ++i) {
+            m_setupProgress.stepNames[i] = commands[i].name();
+            bool sent = m_transport->send(commands[i], kCommandTimeoutNs, 0,
+                                          [this, generation, i](const ArmResponse* response) {
+                onConfigureAck(generation, i, response);
+            });
+            if (!sent) {
+                onConfigureAck(generation, i, nullptr);
+            }
+        }
+    }
+    
+    void onConfigureAck(uint32_t generation, int step, const ArmResponse* response) {
+        if (generation != m_setupGeneration || m_setupPhase != SetupConfiguring) {
+            return;
+        }
+        // 连接断开导致的失败由断开处理重置，重连后重放整个序列
+        if (!response && !m_transport->isConnected()) {
+            return;
+        }
+        m_setupProgress.stepNs[step] = ArmCommandPipeline::nowNs() - m_powerAckNs;
+        m_setupProgress.stepOk[step] = response != nullptr;
+        if (!response) {
+            // 与之前的行为一致：单项设置失败只告警，不阻止进入实时控制
+            std::cout << "⚠️  机械臂 " << m_robotIP << " 设置指令未确认: " << m_setupProgress.stepNames[step] << std::endl;
+        }
+        if (--m_setupPending == 0) {
+            finishSetup();
+        }
+    }
+    
+    void finishSetup() {
+        uint64_t nowNs = ArmCommandPipeline::nowNs();
+        m_setupProgress.configureNs = nowNs - m_powerAckNs;
+        m_setupProgress.totalNs = nowNs - m_setupStartNs;
+        {
+            std::lock_guard<std::mutex> lock(m_setupTimingsMutex);
+            m_setupTimings = m_setupProgress;
+        }
+        
+        m_setupPhase = SetupDone;
+        m_ready.store(true, std::memory_order_release);
+        std::cout << "✅ 机械臂 " << m_robotIP << " 控制模式已启用 (参考坐标系: "
+                  << (m_teachFrameType == 0 ? "基坐标系" : "工具坐标系") << ", 工具坐标系: " << m_toolName
+                  << ", 上电确认 " << std::fixed << std::setprecision(1) << m_setupProgress.powerNs / 1e6
+                  << "ms, 设置确认 " << m_setupProgress.configureNs / 1e6 << "ms)" << std::endl;
+    }
+    
+    // 完成等待方的future（response为空表示失败/超时）
+    static void completeReply(std::promise<ArmReply>* reply, const ArmResponse* response) {
+        if (!reply) {
+            return;
+        }
+        ArmReply result;
+        result.ok = response != nullptr;
+        if (response) {
+            result.response = *response;
+        } else {
+            result.response.clear();
+        }
+        reply->set_value(result);
+        delete reply;
+    }
+};
+
+// 触觉设备机械臂控制器
+class TouchArmController {
+public:
+    // 控制状态：空闲 → 等待机械臂锚点 → 拖动
+    enum class ControlState { Idle, PendingAnchor, Dragging };
+    
+    // 力反馈模式：锚点弹簧（只拉回触觉设备锚点）/ 机械臂耦合（拉向机械臂实际位置）
+    enum class ForceMode { AnchorSpring, ArmCoupling };
+    
+    // 运动指令：笛卡尔跟随（movep_follow，控制器逆解）/ 关节空间（本机逆解后发送关节角度）
+    enum class MotionMode { Pose, Joint };
+    
+private:
+    std::atomic<ControlState> m_state;
+    uint32_t m_anchorRequestSeq;             // 当前锚点请求序号
+    uint64_t m_clutchStartNs;                // 按下按钮的时间
+    bool m_awaitingFirstCommand;             // 是否还未投递本次拖动的第一条指令
+    bool m_dragLive;                         // 本次拖动是否控制机械臂（否则仅触觉反馈，中途重连也不切换）
+    std::atomic<uint64_t> m_lastClutchLatencyNs;   // 最近一次离合延迟
+    std::atomic<uint64_t> m_maxClutchLatencyNs;    // 最大离合延迟
+    std::atomic<uint64_t> m_totalClutchLatencyNs;  // 离合延迟累计
+    std::atomic<uint64_t> m_clutchCount;           // 离合次数
+    std::array<double, 3> m_touchAnchor;      // 触觉设备锚点
+    OrientationMath::Mat3 m_anchorRotationInv;   // 触觉设备锚点旋转的逆（离合时计算一次）
+    AxisMapping::Vec3 m_mappedTouchAnchor;    // 触觉设备锚点映射到机械臂坐标（离合时计算一次）
+    AxisMapping m_positionMapping;            // 位置映射：设备毫米 → 机械臂微米（置换×符号×系数）
+    AxisMapping m_positionMappingInv;         // 位置映射的逆（机械臂 → 触觉设备，力反馈用）
+    AxisMapping m_rotationMapping;            // 姿态映射：旋转向量弧度 → 机械臂毫弧度
+    std::atomic<uint32_t> m_scaleRevision;    // 键盘线程每次调整系数时递增
+    uint32_t m_appliedScaleRevision;          // 伺服线程已合成进映射的系数版本
+    std::array<int, 6> m_armAnchor;           // 机械臂锚点位姿
+    OrientationMath::Vec3 m_armAnchorEuler;   // 锚点欧拉角（弧度）
+    OrientationMath::Mat3 m_armAnchorRotation;   // 锚点姿态（拖动开始时计算一次）
+    double m_positionScale;    // 位置映射系数
+    double m_rotationScale;    // 姿态映射系数
+    double m_springStiffness;  // 弹簧刚度系数
+    ForceMode m_forceMode;           // 力反馈模式
+    double m_couplingStiffness;      // 机械臂耦合刚度 (N/mm)
+    double m_couplingDamping;        // 机械臂耦合阻尼 (N·s/mm)
+    uint64_t m_couplingTimeoutNs;    // 上报位姿超过该时长视为过期，退回锚点弹簧
+    ArmRealtimeState m_lastArmState; // 伺服线程最近读到的机械臂状态
+    bool m_hasArmState;              // 是否读到过机械臂位姿
+    std::atomic<uint64_t> m_couplingTicks;    // 使用机械臂耦合力的帧数
+    std::atomic<uint64_t> m_fallbackTicks;    // 因位姿过期退回锚点弹簧的帧数
+    int m_debugFrequency;      // 调试信息显示频率
+    int m_debugCounter;        // 调试信息节拍计数
+    DeadlineScheduler m_commandScheduler;  // 指令发送节拍器（每个控制器独立）
+    MotionFilter m_motionFilter;           // 1kHz采样到指令流之间的平滑/抽取滤波
+    MotionPredictor m_predictor;           // 延迟补偿预测
+    TrajectoryGenerator m_trajectory;      // 发送前的速度/加速度/加加速度限制
+    VirtualFixtures m_fixtures;            // 机械臂坐标系中的引导/限位夹具（1kHz约束指令目标）
+    AxisMapping::Vec3 m_fixtureForce;      // 本帧夹具吸附力（N，触觉设备坐标系），叠加到反馈力上
+    SessionRecorder* m_sessionRecorder;    // 拖动会话录制（未配置时为空）
+    
+    // 关节空间流式控制（motion_mode = joint）
+    MotionMode m_motionMode;
+    ArmKinematics m_kinematics;            // 锚点关节角度的正解校验（与逆解相同的模型和工具偏移）
+    IkWorker* m_ikWorker;                  // 逆解工作线程（笛卡尔模式为空）
+    double m_ikSeedTolerance;              // 锚点关节角度正解与锚点位置允许的偏差（毫米）
+    double m_ikSeedRotationTolerance;      // 锚点关节角度正解与锚点姿态允许的偏差（弧度）
+    bool m_jointStreaming;                 // 本次拖动是否发送关节角度
+    std::atomic<uint64_t> m_jointSeedFallbacks;   // 关节角度过期或不一致、本次拖动改用笛卡尔跟随的次数
+    
+    // 双臂防碰撞（collision.enabled，所有控制器共用一个）
+    ArmCollisionGuard* m_collisionGuard;
+    int m_collisionIndex;                  // 本机械臂在防碰撞模型中的序号
+    ArmCollisionGuard::Verdict m_collisionVerdict;   // 上一次检查结果（只在变化时记录日志）
+    int m_collisionStale;                  // 上一次检查时关节角度过期的机械臂（-1为没有，只在变化时记录日志）
+    
+    ArmController& m_armController;
+    ConfigLoader* m_config;    // 配置文件加载器
+    std::string m_deviceName;  // 设备名称
+    uint16_t m_logSource;      // 二进制日志来源ID
+    
+    // 灵巧手相关成员
+    bool m_useDexterousHand;           // 是否使用灵巧手
+    DexterousHandController* m_handController;  // 灵巧手控制器
+    
+    // 末端控制器类型和剪刀控制相关成员
+    std::string m_endEffectorType;     // 末端控制器类型 (dexterous_hand, gripper, scissors)
+    int m_scissorsModbusPort;          // 剪刀Modbus端口
+    int m_scissorsModbusAddress;       // 剪刀寄存器地址
+    int m_scissorsModbusDevice;        // 剪刀设备号
+    int m_scissorsOpenData;            // 松开剪刀的数据值
+    int m_scissorsCloseData;           // 闭合剪刀的数据值
+    bool m_scissorsState;              // 剪刀状态 (true=闭合, false=松开)
+    bool m_gripperClosed;              // 夹爪状态 (true=关闭, false=打开)
+    std::atomic<uint32_t> m_endEffectorRequestSeq;   // 按钮2按下次数（伺服线程写）
+    uint32_t m_endEffectorServedSeq;                 // 主线程已执行的切换次数
+    
+public:
+    TouchArmController(ArmController& armController, ConfigLoader* config = nullptr, const std::string& deviceName = "") 
+        : m_state(ControlState::Idle), m_anchorRequestSeq(0), m_clutchStartNs(0), m_awaitingFirstCommand(false), m_dragLive(false),
+          m_lastClutchLatencyNs(0), m_maxClutchLatencyNs(0), m_totalClutchLatencyNs(0), m_clutchCount(0),
+          m_touchAnchor({0.0, 0.0, 0.0}),
+          m_anchorRotationInv(OrientationMath::identity()),
+          m_mappedTouchAnchor({0.0, 0.0, 0.0}),
+          m_scaleRevision(0), m_appliedScaleRevision(0),
+          m_armAnchor({0, 0, 0, 0, 0, 0}),
+          m_armAnchorEuler({0.0, 0.0, 0.0}), m_armAnchorRotation(OrientationMath::identity()),
+          m_forceMode(ForceMode::AnchorSpring), m_couplingStiffness(0.2), m_couplingDamping(0.0005),
+          m_couplingTimeoutNs(100000000), m_hasArmState(false), m_couplingTicks(0), m_fallbackTicks(0),
+          m_debugCounter(0),
+          m_fixtureForce({0.0, 0.0, 0.0}),
+          m_sessionRecorder(nullptr),
+          m_motionMode(MotionMode::Pose), m_ikWorker(nullptr), m_ikSeedTolerance(2.0), m_ikSeedRotationTolerance(0.02),
+          m_jointStreaming(false), m_jointSeedFallbacks(0),
+          m_collisionGuard(nullptr), m_collisionIndex(-1), m_collisionVerdict(ArmCollisionGuard::Clear),
+          m_collisionStale(-1),
+          m_armController(armController), m_config(config), m_deviceName(deviceName),
+          m_logSource(BinaryLogger::instance().registerSource(deviceName)),
+          m_useDexterousHand(false), m_handController(nullptr),
+          m_endEffectorType("gripper"), m_scissorsModbusPort(1), m_scissorsModbusAddress(2),
+          m_scissorsModbusDevice(1), m_scissorsOpenData(0), m_scissorsCloseData(1), m_scissorsState(false),
+          m_gripperClosed(false), m_endEffectorRequestSeq(0), m_endEffectorServedSeq(0) {
+        
+        // 坐标映射配置只在构造时读取，随后合成为仿射映射
+        int positionSource[3];   // 机械臂X/Y/Z轴分别取触觉设备哪个轴(0=X,1=Y,2=Z)
+        int rotationSource[3];   // 机械臂RX/RY/RZ轴分别取触觉设备哪个旋转轴(0=RX,1=RY,2=RZ)
+        int positionSign[3];     // 机械臂X/Y/Z轴符号 (1或-1)
+        int rotationSign[3];     // 机械臂RX/RY/RZ轴符号 (1或-1)
+        
+        // 从配置文件加载参数，如果没有配置文件则使用默认值
+        if (m_config) {
+            std::string prefix = m_deviceName.empty() ? "control" : m_deviceName;
+            m_positionScale = m_config->getDouble(prefix + ".position_scale", 1000.0);
+            m_rotationScale = m_config->getDouble(prefix + ".rotation_scale", 1.0);
+            m_springStiffness = m_config->getDouble(prefix + ".spring_stiffness", 0.2);
+            m_debugFrequency = m_config->getInt("system.debug_frequency", 50);
+            
+            // 指令发送频率（Hz，支持小数）；未配置时沿用 system.control_frequency 的毫秒周期
+            int controlPeriodMs = m_config->getInt("system.control_frequency", 10);
+            double defaultRateHz = controlPeriodMs > 0 ? 1000.0 / controlPeriodMs : 100.0;
+            m_commandScheduler.setRate(m_config->getDouble(prefix + ".control_rate_hz", defaultRateHz));
+            
+            // 加载指令滤波配置
+            MotionFilter::Params filterParams;
+            loadFilterParams(m_config, prefix, filterParams);
+            m_motionFilter.configure(filterParams);
+            
+            // 加载轨迹生成配置（默认关闭）
+            TrajectoryGenerator::Params trajectoryParams;
+            loadTrajectoryParams(m_config, prefix, trajectoryParams);
+            m_trajectory.configure(trajectoryParams);
+            
+            // 加载虚拟夹具（[deviceN_fixtures] 节，默认没有夹具）
+            VirtualFixtures::Params fixtureParams;
+            std::vector<VirtualFixtures::Fixture> fixtures;
+            loadFixtures(m_config, m_deviceName.empty() ? "fixtures" : (m_deviceName + "_fixtures"),
+                         fixtureParams, fixtures);
+            m_fixtures.configure(fixtureParams, fixtures, std::cerr);
+            
+            // 加载力反馈模式配置
+            std::string forceMode = m_config->getString(prefix + ".force_mode", "anchor_spring");
+            if (forceMode == "arm_coupling") {
+                m_forceMode = ForceMode::ArmCoupling;
+            } else if (forceMode != "anchor_spring") {
+                std::cerr << "警告: " << prefix << ".force_mode=" << forceMode << " 无效，使用 anchor_spring" << std::endl;
+            }
+            m_couplingStiffness = m_config->getDouble(prefix + ".coupling_stiffness", m_couplingStiffness);
+            m_couplingDamping = m_config->getDouble(prefix + ".coupling_damping", m_couplingDamping);
+            m_couplingTimeoutNs = static_cast<uint64_t>(
+                m_config->getDouble(prefix + ".coupling_timeout_ms", m_couplingTimeoutNs / 1e6) * 1e6);
+            
+            // 关节空间流式控制（默认笛卡尔跟随）
+            configureJointStreaming(prefix);
+            
+            // 加载延迟补偿预测配置
+            MotionPredictor::Params predictorParams;
+            loadPredictorParams(m_config, prefix, predictorParams);
+            m_predictor.configure(predictorParams);
+            if (predictorParams.adaptive) {
+                // 拖动期间只有不回复的流式帧，按间隔发状态查询测量指令往返时间
+                int probeMs = m_config->getInt(prefix + ".predictor_rtt_probe_ms", 200);
+                m_armController.setRttProbeInterval(probeMs > 0 ? static_cast<uint64_t>(probeMs) * 1000000 : 0);
+            }
+            
+            // 会话录制（供预测器离线回放评估），文件名为空时不录制
+            std::string recordFile = m_config->getString(prefix + ".record_session", "");
+            if (!recordFile.empty()) {
+                m_sessionRecorder = new SessionRecorder(recordFile);
+                if (!m_sessionRecorder->start()) {
+                    delete m_sessionRecorder;
+                    m_sessionRecorder = nullptr;
+                }
+            }
+            
+            // 加载坐标映射配置
+            std::string mappingPrefix = m_deviceName.empty() ? "mapping" : (m_deviceName + "_mapping");
+            loadAxisMappingConfig(m_config, mappingPrefix, positionSource, positionSign,
+                                  rotationSource, rotationSign);
+            
+            // 加载末端控制器配置
+            m_endEffectorType = m_config->getString(mappingPrefix + ".end_effector_type", "gripper");
+            
+            // 加载剪刀控制配置
+            m_scissorsModbusPort = m_config->getInt(mappingPrefix + ".scissors_modbus_port", 1);
+            m_scissorsModbusAddress = m_config->getInt(mappingPrefix + ".scissors_modbus_address", 2);
+            m_scissorsModbusDevice = m_config->getInt(mappingPrefix + ".scissors_modbus_device", 1);
+            m_scissorsOpenData = m_config->getInt(mappingPrefix + ".scissors_open_data", 0);
+            m_scissorsCloseData = m_config->getInt(mappingPrefix + ".scissors_close_data", 1);
+            
+            std::cout << "从配置文件加载" << m_deviceName << "控制参数和坐标映射配置" << std::endl;
+            std::cout << "  指令频率: " << m_commandScheduler.getRate() << "Hz, 滤波: "
+                      << MotionFilter::typeName(m_motionFilter.getParams().type)
+                      << " (估计滞后 " << m_motionFilter.nominalLagMs(m_commandScheduler.getRate()) << "ms)"
+                      << ", 预测: " << MotionPredictor::modeName(m_predictor.getParams().mode)
+                      << " (" << m_predictor.getHorizonMs() << "ms"
+                      << (m_predictor.getParams().adaptive ? ", 自适应" : "") << ")"
+                      << ", 轨迹: " << TrajectoryGenerator::modeName(m_trajectory.getParams().mode)
+                      << ", 虚拟夹具: " << m_fixtures.getCount() << "个" << std::endl;
+        } else {
+            // 使用默认值
+            m_positionScale = 1000.0;
+            m_rotationScale = 1.0;
+            m_springStiffness = 0.2;
+            m_debugFrequency = 50;
+            m_commandScheduler.setRate(100.0);
+            
+            // 默认映射配置（保持与原代码相同的行为）
+            positionSource[0] = 2;   // 触觉设备Z轴 → 机械臂X轴
+            positionSource[1] = 0;   // 触觉设备X轴 → 机械臂Y轴
+            positionSource[2] = 1;   // 触觉设备Y轴 → 机械臂Z轴
+            rotationSource[0] = 2;   // 触觉设备RZ轴 → 机械臂RX轴
+            rotationSource[1] = 0;   // 触觉设备RX轴 → 机械臂RY轴
+            rotationSource[2] = 1;   // 触觉设备RY轴 → 机械臂RZ轴
+            
+            // 默认符号调整
+            positionSign[0] = -1;    // 机械臂X轴取反
+            positionSign[1] = -1;    // 机械臂Y轴取反
+            positionSign[2] = 1;     // 机械臂Z轴正向
+            rotationSign[0] = -1;    // 机械臂RX轴取反
+            rotationSign[1] = -1;    // 机械臂RY轴取反
+            rotationSign[2] = 1;     // 机械臂RZ轴正向
+            
+            std::cout << "使用默认控制参数和坐标映射配置 (" << m_deviceName << ")" << std::endl;
+        }
+        
+        compileAxisMapping(positionSource, positionSign, rotationSource, rotationSign);
+        
+        // 末端控制器（灵巧手的Python/ROS2初始化较慢）由main在机械臂开始连接后调用 initializeEndEffector()，
+        // 与机械臂的连接和设置序列并行进行
+        
+        // 机械臂设置序列参数：连接（或重连）成功后由ArmController在反应器线程中发出
+        int frameType = 1;  // 默认为工具坐标系
+        std::string toolName = "Arm_Tip";  // 默认值（根据实曼协议）
+        if (m_config) {
+            frameType = m_config->getInt("system.teach_frame_type", 1);
+            toolName = m_config->getString("system.tool_coordinate_name", "Arm_Tip");
+        }
+        m_armController.setSetupConfig(frameType, toolName);
+        
+        // 配置夹爪参数（从配置文件读取）
+        int pickSpeed = 500, releaseSpeed = 500, forceThreshold = 200;
+        bool blockMode = true;
+        if (m_config) {
+            pickSpeed = m_config->getInt("gripper.pick_speed", 500);
+            releaseSpeed = m_config->getInt("gripper.release_speed", 500);
+            forceThreshold = m_config->getInt("gripper.force_threshold", 200);
+            blockMode = m_config->getBool("gripper.block_mode", true);
+        }
+        m_armController.setGripperConfig(pickSpeed, releaseSpeed, forceThreshold, blockMode);
+    }
+    
+    // 添加析构函数
+    ~TouchArmController() {
+        if (m_ikWorker) {
+            delete m_ikWorker;
+            m_ikWorker = nullptr;
+        }
+        if (m_sessionRecorder) {
+            delete m_sessionRecorder;
+            m_sessionRecorder = nullptr;
+        }
+        if (m_handController) {
+            delete m_handController;
+            m_handController = nullptr;
+        }
+    }
+    
+    // 初始化末端控制器
+    void initializeEndEffector() {
         if (m_config) {
             std::string prefix = m_deviceName + "_mapping";
             
@@ -1262,6 +1536,7 @@ public:
     
     void setPositionScale(double scale) {
         m_positionScale = scale;
+        m_scaleRevision.store(m_scaleRevision.load(std::memory_order_relaxed) + 1, std::memory_order_release);
         std::cout << "[" << m_deviceName << "] 位置映射系数设置为: " << scale << std::endl;
         // 保存到配置文件
         if (m_config) {
@@ -1272,6 +1547,7 @@ public:
     
     void setRotationScale(double scale) {
         m_rotationScale = scale;
+        m_scaleRevision.store(m_scaleRevision.load(std::memory_order_relaxed) + 1, std::memory_order_release);
         std::cout << "[" << m_deviceName << "] 姿态映射系数设置为: " << scale << std::endl;
         // 保存到配置文件
         if (m_config) {
@@ -1304,176 +1580,464 @@ public:
     
     void onButtonDown(const std::array<double, 3>& touchPos, 
                      const std::array<double, 16>& touchTransform) {
-        if (!m_dragging) {
-            if (m_armController.isConnected()) {
-                std::cout << "\n=== 开始新的拖动控制 ===" << std::endl;
-            
-            // 记录触觉设备锚点
-            m_touchAnchor = touchPos;
-            m_touchAnchorTransform = touchTransform;
-            
-            std::cout << "步骤1: 记录触觉设备锚点位置和姿态" << std::endl;
-            // 显示配置映射后的坐标信息
-            std::cout << "  触觉设备锚点: [" 
-                      << std::fixed << std::setprecision(2)
-                      << touchPos[0] << ", " << touchPos[1] << ", " << touchPos[2] << "] (原始X,Y,Z)" << std::endl;
-            std::cout << "  坐标映射: 触觉设备[" << m_touchPosToArmX << "," << m_touchPosToArmY << "," << m_touchPosToArmZ << "]→机械臂[X,Y,Z]" << std::endl;
-            
-            std::cout << "步骤2: 获取机械臂当前真实位姿作为锚点..." << std::endl;
-            
-            // 每次按下都重新获取机械臂当前位姿作为锚点
-            std::array<int, 6> newArmPose = m_armController.getCurrentArmPose();
-            
-            // 检查是否成功获取到有效的位姿数据
-            bool validPose = false;
-            for (int i = 0; i < 6; ++i) {
-                if (newArmPose[i] != 0) {
-                    validPose = true;
-                    break;
-                }
-            }
-            
-            if (validPose || (newArmPose[0] == 0 && newArmPose[1] == 0 && newArmPose[2] == 0)) {
-                m_armAnchor = newArmPose;
-                m_dragging = true;
-                
-                std::cout << "步骤3: 成功设置机械臂锚点位姿: [";
-                for (int i = 0; i < 6; ++i) {
-                    if (i > 0) std::cout << ", ";
-                    std::cout << m_armAnchor[i];
-                }
-                std::cout << "]" << std::endl;
-                std::cout << "  位置 (微米): X=" << m_armAnchor[0] << ", Y=" << m_armAnchor[1] << ", Z=" << m_armAnchor[2] << std::endl;
-                std::cout << "  姿态 (毫弧度): RX=" << m_armAnchor[3] << ", RY=" << m_armAnchor[4] << ", RZ=" << m_armAnchor[5] << std::endl;
-                std::cout << "=== 拖动控制已激活 ===\n" << std::endl;
-            } else {
-                std::cout << "警告: 获取机械臂位姿失败，无法开始拖动控制" << std::endl;
-                std::cout << "请检查机械臂连接和状态\n" << std::endl;
-            }
-            } else {
-                // 机械臂未连接，仍然记录触觉设备锚点以提供触觉反馈
-                m_touchAnchor = touchPos;
-                m_touchAnchorTransform = touchTransform;
-                m_dragging = true;
-                
-                std::cout << "\n=== 触觉反馈模式激活 ===" << std::endl;
-                std::cout << "[" << m_deviceName << "] 机械臂未连接，启用纯触觉反馈模式" << std::endl;
-                std::cout << "  触觉设备锚点: [" 
-                          << std::fixed << std::setprecision(2)
-                          << touchPos[0] << ", " << touchPos[1] << ", " << touchPos[2] << "] (原始X,Y,Z)" << std::endl;
-                std::cout << "  坐标映射: 触觉设备[" << m_touchPosToArmX << "," << m_touchPosToArmY << "," << m_touchPosToArmZ << "]→机械臂[X,Y,Z]" << std::endl;
-                std::cout << "🎮 您可以移动设备体验触觉反馈，但机械臂不会移动" << std::endl;
-                std::cout << "=== 触觉反馈模式已激活 ===\n" << std::endl;
-            }
-        } else if (m_dragging) {
-            std::cout << "拖动控制已在进行中，请先松开按钮" << std::endl;
+        BinaryLogger& logger = BinaryLogger::instance();
+        if (m_state.load(std::memory_order_relaxed) != ControlState::Idle) {
+            logger.log(LOG_CLUTCH_BUSY, m_logSource);
+            return;
+        }
+        
+        // 运行中调整的映射系数在离合时合成进映射，拖动中目标不会跳变
+        uint32_t scaleRevision = m_scaleRevision.load(std::memory_order_acquire);
+        if (scaleRevision != m_appliedScaleRevision) {
+            m_appliedScaleRevision = scaleRevision;
+            rescaleAxisMapping();
+        }
+        
+        // 记录触觉设备锚点
+        m_touchAnchor = touchPos;
+        m_mappedTouchAnchor = m_positionMapping.apply(touchPos);
+        m_anchorRotationInv = OrientationMath::transpose(OrientationMath::rotationFromTransform(touchTransform));
+        m_clutchStartNs = ArmCommandPipeline::nowNs();
+        m_awaitingFirstCommand = true;
+        
+        if (m_armController.isReady()) {
+            // 只发起锚点请求，由通信反应器线程取得位姿；伺服线程不做任何阻塞操作
+            m_anchorRequestSeq = m_armController.requestAnchorPose();
+            m_state.store(ControlState::PendingAnchor, std::memory_order_release);
+            logger.log(LOG_CLUTCH_PENDING, m_logSource);
+        } else {
+            // 机械臂未连接（或设置序列未完成），仍然记录触觉设备锚点以提供触觉反馈
+            m_dragLive = false;
+            m_jointStreaming = false;
+            startCommandStream(m_clutchStartNs);
+            m_state.store(ControlState::Dragging, std::memory_order_release);
+            logger.log(LOG_CLUTCH_HAPTIC_ONLY, m_logSource);
         }
     }
     
     void onButtonUp() {
-        if (m_dragging) {
-            m_dragging = false;
-            if (m_armController.isConnected()) {
-                std::cout << "\n=== 结束拖动控制 ===" << std::endl;
-                std::cout << "触觉设备按钮已松开，机械臂控制停止" << std::endl;
-                std::cout << "机械臂将保持在当前位置" << std::endl;
-                std::cout << "下次按下按钮时将重新获取机械臂位姿作为新锚点\n" << std::endl;
-            } else {
-                std::cout << "\n=== 结束触觉反馈模式 ===" << std::endl;
-                std::cout << "[" << m_deviceName << "] 触觉设备按钮已松开，触觉反馈停止" << std::endl;
-                std::cout << "下次按下按钮时将重新启动触觉反馈模式\n" << std::endl;
+        ControlState previous = m_state.exchange(ControlState::Idle, std::memory_order_acq_rel);
+        if (previous == ControlState::PendingAnchor) {
+            // 锚点结果稍后到达时会因请求序号不匹配被忽略
+            BinaryLogger::instance().log(LOG_CLUTCH_CANCELLED, m_logSource);
+        } else if (previous == ControlState::Dragging) {
+            BinaryLogger::instance().log(LOG_CLUTCH_RELEASED, m_logSource, m_armController.isConnected() ? 1 : 0);
+            if (m_collisionGuard && m_dragLive) {
+                m_collisionGuard->endSession(m_collisionIndex);
             }
         }
     }
     
     void update(const std::array<double, 3>& touchPos, 
-               const std::array<double, 16>& touchTransform) {
-        if (!m_dragging) {
-            return;
+               const std::array<double, 16>& touchTransform,
+               const std::array<double, 3>& touchVelocity) {
+        ControlState state = m_state.load(std::memory_order_relaxed);
+        
+        if (state == ControlState::PendingAnchor) {
+            // 等待反应器线程发布锚点位姿，期间只渲染保持力，不发送任何指令
+            std::array<int, 6> anchorPose;
+            bool valid = false;
+            if (!m_armController.pollAnchorPose(m_anchorRequestSeq, anchorPose, valid)) {
+                return;
+            }
+            if (!valid) {
+                m_state.store(ControlState::Idle, std::memory_order_release);
+                BinaryLogger::instance().log(LOG_CLUTCH_ANCHOR_FAIL, m_logSource);
+                return;
+            }
+            m_armAnchor = anchorPose;
+            m_armAnchorEuler = {{anchorPose[3] / 1000.0, anchorPose[4] / 1000.0, anchorPose[5] / 1000.0}};
+            m_armAnchorRotation = OrientationMath::fromEuler(m_armAnchorEuler);
+            m_dragLive = true;
+            m_jointStreaming = m_motionMode == MotionMode::Joint && beginJointSession(anchorPose);
+            startCommandStream(ArmCommandPipeline::nowNs());
+            if (m_collisionGuard) {
+                m_collisionGuard->beginSession(m_collisionIndex, anchorPose, ArmCommandPipeline::nowNs());
+                m_collisionVerdict = ArmCollisionGuard::Clear;
+                m_collisionStale = -1;
+            }
+            m_state.store(ControlState::Dragging, std::memory_order_release);
+            state = ControlState::Dragging;
         }
         
-        // 使用可配置的坐标映射
-        std::array<double, 3> relativeTouchPos = {
-            m_armXSign * (touchPos[m_touchPosToArmX] - m_touchAnchor[m_touchPosToArmX]) * m_positionScale,  // 机械臂X
-            m_armYSign * (touchPos[m_touchPosToArmY] - m_touchAnchor[m_touchPosToArmY]) * m_positionScale,  // 机械臂Y
-            m_armZSign * (touchPos[m_touchPosToArmZ] - m_touchAnchor[m_touchPosToArmZ]) * m_positionScale   // 机械臂Z
-        };
+        if (state != ControlState::Dragging) {
+            return;
+        }
         
-        // 使用可配置的姿态映射
-        std::array<double, 3> currentEuler = extractEulerAngles(touchTransform);
-        std::array<double, 3> anchorEuler = extractEulerAngles(m_touchAnchorTransform);
+        // 位置映射：轴置换、符号和系数已合成为一个映射，减去映射后的锚点得到相对位移（微米）
+        AxisMapping::Vec3 mappedTouchPos = m_positionMapping.apply(touchPos);
+        AxisMapping::Vec3 relativeTouchPos = {{
+            mappedTouchPos[0] - m_mappedTouchAnchor[0],
+            mappedTouchPos[1] - m_mappedTouchAnchor[1],
+            mappedTouchPos[2] - m_mappedTouchAnchor[2]
+        }};
         
-        std::array<double, 3> relativeRotation = {
-            m_armRXSign * (currentEuler[m_touchRotToArmRX] - anchorEuler[m_touchRotToArmRX]) * m_rotationScale * M_PI / 180.0 * 1000, // 机械臂RX
-            m_armRYSign * (currentEuler[m_touchRotToArmRY] - anchorEuler[m_touchRotToArmRY]) * m_rotationScale * M_PI / 180.0 * 1000, // 机械臂RY
-            m_armRZSign * (currentEuler[m_touchRotToArmRZ] - anchorEuler[m_touchRotToArmRZ]) * m_rotationScale * M_PI / 180.0 * 1000  // 机械臂RZ
-        };
+        // 姿态映射：相对锚点的旋转（基坐标系）→ 旋转向量（弧度）→ 轴映射 → 毫弧度
+        OrientationMath::Mat3 relativeMatrix = OrientationMath::multiply(
+            OrientationMath::rotationFromTransform(touchTransform), m_anchorRotationInv);
+        OrientationMath::Vec3 touchRotation = OrientationMath::rotationVector(relativeMatrix);
+        AxisMapping::Vec3 relativeRotation = m_rotationMapping.applyLinear(touchRotation);
         
-        // 计算目标机械臂位姿 (单位：微米和毫弧度)
-        std::array<int, 6> targetPose = {
-            m_armAnchor[0] + static_cast<int>(relativeTouchPos[0]),  // X
-            m_armAnchor[1] + static_cast<int>(relativeTouchPos[1]),  // Y  
-            m_armAnchor[2] + static_cast<int>(relativeTouchPos[2]),  // Z
-            m_armAnchor[3] + static_cast<int>(relativeRotation[0]),  // RX
-            m_armAnchor[4] + static_cast<int>(relativeRotation[1]),  // RY
-            m_armAnchor[5] + static_cast<int>(relativeRotation[2])   // RZ
-        };
+        // 设备速度按位置映射的线性部分转换到机械臂坐标（微米/秒），供预测器外推
+        AxisMapping::Vec3 mappedVelocity = m_positionMapping.applyLinear(touchVelocity);
         
-        // 控制机械臂移动到目标位姿 - 100Hz控制频率
-        static auto lastSendTime = std::chrono::high_resolution_clock::now();
-        static int debugCounter = 0;
+        // 虚拟夹具只在机械臂锚点有效时生效（仅触觉反馈的拖动没有机械臂坐标）
+        m_fixtureForce = {{0.0, 0.0, 0.0}};
+        if (m_dragLive && m_fixtures.isEnabled()) {
+            applyFixtures(relativeTouchPos, mappedVelocity);
+        }
         
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        auto timeSinceLastSend = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - lastSendTime).count();
+        // 每个1kHz采样先做延迟补偿外推，再进入滤波器，发送节拍上只取滤波输出
+        uint64_t nowNs = ArmCommandPipeline::nowNs();
+        MotionSample sample;
+        sample.timestampNs = nowNs;
+        for (int i = 0; i < 3; ++i) {
+            sample.offset[i] = relativeTouchPos[i];
+            sample.offset[i + 3] = relativeRotation[i];
+            sample.velocity[i] = mappedVelocity[i];
+        }
+        if (m_sessionRecorder) {
+            m_sessionRecorder->record(sample);
+        }
+        double predictedOffset[MotionPredictor::kAxes];
+        m_predictor.predict(sample.offset, sample.velocity, nowNs, predictedOffset);
+        m_motionFilter.push(predictedOffset, nowNs);
         
-        // 使用配置文件中的控制频率
-        if (timeSinceLastSend >= m_controlFrequency) {
+        // 控制机械臂移动到目标位姿：按本控制器独立的绝对截止时间发送
+        if (m_commandScheduler.poll(nowNs)) {
+            double filteredOffset[MotionFilter::kAxes];
+            m_motionFilter.take(filteredOffset);
+            if (m_trajectory.isEnabled()) {
+                m_trajectory.step(filteredOffset, nowNs, filteredOffset);
+            }
+            
+            // 姿态：映射后的相对旋转（基坐标系旋转向量，毫弧度）左乘锚点姿态，再转换回控制器的欧拉角
+            OrientationMath::Vec3 rotationOffset = {{filteredOffset[3] / 1000.0, filteredOffset[4] / 1000.0,
+                                                     filteredOffset[5] / 1000.0}};
+            OrientationMath::Vec3 targetEuler = OrientationMath::eulerAngles(OrientationMath::multiply(
+                OrientationMath::fromRotationVector(rotationOffset), m_armAnchorRotation), m_armAnchorEuler);
+            
+            // 计算目标机械臂位姿 (单位：微米和毫弧度)
+            std::array<int, 6> targetPose = {
+                m_armAnchor[0] + static_cast<int>(filteredOffset[0]),  // X
+                m_armAnchor[1] + static_cast<int>(filteredOffset[1]),  // Y
+                m_armAnchor[2] + static_cast<int>(filteredOffset[2]),  // Z
+                static_cast<int>(std::lround(targetEuler[0] * 1000.0)),  // RX
+                static_cast<int>(std::lround(targetEuler[1] * 1000.0)),  // RY
+                static_cast<int>(std::lround(targetEuler[2] * 1000.0))   // RZ
+            };
+            
+            // 限位夹具对最终目标再施加一次：预测外推、滤波和轨迹生成之后的目标可能越过限位平面
+            if (m_dragLive && m_fixtures.hasLimits()) {
+                double position[3] = {targetPose[0] / 1000.0, targetPose[1] / 1000.0, targetPose[2] / 1000.0};
+                if (m_fixtures.enforceLimits(position) != 0) {
+                    for (int i = 0; i < 3; ++i) {
+                        targetPose[i] = static_cast<int>(std::lround(position[i] * 1000.0));
+                    }
+                }
+            }
+            
             // 使用配置文件中的调试频率
-            debugCounter++;
-            if (debugCounter >= m_debugFrequency) {
-                // 更详细的调试信息，包含设备标识
-                std::cout << "=== [" << m_deviceName << "] 位置控制调试 ===" << std::endl;
-                std::cout << "[" << m_deviceName << "] 触觉设备变化: [" << std::fixed << std::setprecision(3)
-                          << (touchPos[m_touchPosToArmX] - m_touchAnchor[m_touchPosToArmX]) << ", " 
-                          << (touchPos[m_touchPosToArmY] - m_touchAnchor[m_touchPosToArmY]) << ", " 
-                          << (touchPos[m_touchPosToArmZ] - m_touchAnchor[m_touchPosToArmZ]) << "] mm (X,Y,Z)" << std::endl;
-                std::cout << "[" << m_deviceName << "] 坐标轴映射: 触觉设备[" << m_touchPosToArmX << "," << m_touchPosToArmY << "," << m_touchPosToArmZ << "]→机械臂[X,Y,Z]" << std::endl;
-                std::cout << "[" << m_deviceName << "] 姿态轴映射: 触觉设备[" << m_touchRotToArmRX << "," << m_touchRotToArmRY << "," << m_touchRotToArmRZ << "]→机械臂[RX,RY,RZ]" << std::endl;
-                std::cout << "[" << m_deviceName << "] 符号调整: [" << m_armXSign << "," << m_armYSign << "," << m_armZSign << "," << m_armRXSign << "," << m_armRYSign << "," << m_armRZSign << "]" << std::endl;
-                std::cout << "[" << m_deviceName << "] 触觉姿态变化: [" << std::fixed << std::setprecision(2)
-                          << (currentEuler[m_touchRotToArmRX] - anchorEuler[m_touchRotToArmRX]) << ", " 
-                          << (currentEuler[m_touchRotToArmRY] - anchorEuler[m_touchRotToArmRY]) << ", " 
-                          << (currentEuler[m_touchRotToArmRZ] - anchorEuler[m_touchRotToArmRZ]) << "] deg (RX,RY,RZ)" << std::endl;
-                std::cout << "[" << m_deviceName << "] 映射后增量: [" << std::fixed << std::setprecision(1)
-                          << relativeTouchPos[0] << ", " << relativeTouchPos[1] << ", " << relativeTouchPos[2] << "] μm" << std::endl;
-                std::cout << "[" << m_deviceName << "] 映射后姿态: [" << std::fixed << std::setprecision(1)
-                          << relativeRotation[0] << ", " << relativeRotation[1] << ", " << relativeRotation[2] << "] mrad" << std::endl;
-                std::cout << "[" << m_deviceName << "] 机械臂目标位姿: [";
-                for (int i = 0; i < 6; ++i) {
-                    if (i > 0) std::cout << ", ";
-                    std::cout << targetPose[i];
+            m_debugCounter++;
+            if (m_debugCounter >= m_debugFrequency) {
+                // 调试信息只记录原始数值，由日志线程格式化输出
+                BinaryLogger& logger = BinaryLogger::instance();
+                const AxisMapping& pos = m_positionMapping;
+                const AxisMapping& rot = m_rotationMapping;
+                logger.log(LOG_CTRL_TOUCH_DELTA, m_logSource,
+                           touchPos[pos.source(0)] - m_touchAnchor[pos.source(0)],
+                           touchPos[pos.source(1)] - m_touchAnchor[pos.source(1)],
+                           touchPos[pos.source(2)] - m_touchAnchor[pos.source(2)]);
+                logger.log(LOG_CTRL_AXIS_MAP, m_logSource,
+                           pos.source(0), pos.source(1), pos.source(2), rot.source(0), rot.source(1), rot.source(2));
+                logger.log(LOG_CTRL_SIGNS, m_logSource,
+                           pos.sign(0), pos.sign(1), pos.sign(2), rot.sign(0), rot.sign(1), rot.sign(2));
+                logger.log(LOG_CTRL_ROT_DELTA, m_logSource,
+                           touchRotation[rot.source(0)] * 180.0 / M_PI,
+                           touchRotation[rot.source(1)] * 180.0 / M_PI,
+                           touchRotation[rot.source(2)] * 180.0 / M_PI);
+                logger.log(LOG_CTRL_MAPPED, m_logSource,
+                           relativeTouchPos[0], relativeTouchPos[1], relativeTouchPos[2],
+                           relativeRotation[0], relativeRotation[1], relativeRotation[2]);
+                logger.log(LOG_CTRL_TARGET, m_logSource,
+                           targetPose[0], targetPose[1], targetPose[2], targetPose[3], targetPose[4], targetPose[5]);
+                logger.log(LOG_CTRL_SCALES, m_logSource, m_positionScale, m_rotationScale);
+                m_debugCounter = 0;
+            }
+            
+            // 拖动中机械臂断开：本次拖动切换为仅触觉反馈，重连后需重新按下按钮（以新的锚点）恢复控制
+            if (m_dragLive && !m_armController.isReady()) {
+                m_dragLive = false;
+                BinaryLogger::instance().log(LOG_CLUTCH_ARM_LOST, m_logSource);
+                if (m_collisionGuard) {
+                    m_collisionGuard->endSession(m_collisionIndex);
                 }
-                std::cout << "] (前3个为μm, 后3个为mrad)" << std::endl;
-                std::cout << "[" << m_deviceName << "] 位置映射系数: " << m_positionScale << ", 姿态映射系数: " << m_rotationScale << std::endl;
-                std::cout << "============================================" << std::endl;
-                debugCounter = 0;
             }
             
-            // 只在机械臂连接时才发送控制命令
-            if (m_armController.isConnected()) {
-                // 使用最快的控制方式：笛卡尔空间跟随运动
-                m_armController.moveToTargetAsync(targetPose, 90);
+            // 只在本次拖动以机械臂锚点开始且机械臂仍可用时才发送控制命令
+            if (m_dragLive) {
+                // 笛卡尔跟随：伺服线程只投递到无锁队列，编码和写入由通信反应器线程完成
+                // 关节空间：目标交给逆解工作线程，解出的关节角度经请求队列由反应器线程发送
+                // 双臂防碰撞：目标可能被截短；被拒绝时本节拍不发送，机械臂停在上一次接受的目标
+                bool posted = true;
+                if (m_collisionGuard && !checkCollision(targetPose, nowNs)) {
+                    posted = false;
+                } else if (m_jointStreaming) {
+                    m_ikWorker->post(targetPose);
+                } else {
+                    posted = m_armController.postTarget(targetPose);
+                }
+                if (posted && m_awaitingFirstCommand) {
+                    recordClutchLatency(ArmCommandPipeline::nowNs() - m_clutchStartNs);
+                }
+                
+                // 自适应预测：单程延迟 ≈ 指令往返时间（滑动平均）的一半 + 发送管线延迟
+                if (m_predictor.getParams().adaptive) {
+                    m_predictor.setMeasuredLatency(m_armController.getCommandRttNs() / 2 +
+                                                   m_armController.getPipelineStats().lastLatencyNs);
+                }
             }
-            lastSendTime = currentTime;
         }
     }
     
-    bool isDragging() const { return m_dragging; }
+    bool isDragging() const { return m_state.load(std::memory_order_acquire) == ControlState::Dragging; }
     
-    std::array<double, 3> getTouchAnchor() const { return m_touchAnchor; }
+    /**
+     * @brief 伺服线程调用：计算反馈力（N，触觉设备坐标系），仅在 isEngaged() 时调用
+     *
+     * ArmCoupling 模式下把机械臂实际位置经映射的逆变换回触觉设备空间，
+     * 在触觉笔与该点之间渲染虚拟耦合（弹簧+阻尼），操作者能感受到机械臂的滞后或受阻。
+     * 等待锚点、机械臂未连接或上报位姿过期时退回锚点弹簧。
+     * 虚拟夹具的吸附力（update() 中按本帧目标计算）和双臂防碰撞的排斥力叠加在两种模式上。
+     */
+    void computeFeedbackForce(const std::array<double, 3>& touchPos,
+                              const std::array<double, 3>& touchVelocity,
+                              double force[3]) {
+        AxisMapping::Vec3 overlayForce = m_fixtureForce;
+        addCollisionForce(overlayForce);
+        if (m_forceMode == ForceMode::ArmCoupling &&
+            m_state.load(std::memory_order_relaxed) == ControlState::Dragging &&
+            m_dragLive) {
+            // 读取冲突时沿用上一次的位姿，伺服线程不等待
+            ArmRealtimeState armState;
+            if (m_armController.readArmState(armState)) {
+                m_lastArmState = armState;
+                m_hasArmState = true;
+            }
+            uint64_t nowNs = ArmCommandPipeline::nowNs();
+            if (m_hasArmState && m_lastArmState.timestampNs >= m_clutchStartNs &&
+                nowNs - m_lastArmState.timestampNs <= m_couplingTimeoutNs) {
+                // 机械臂相对锚点的位移叠加到映射后的设备锚点，再经逆映射回到设备坐标
+                AxisMapping::Vec3 armMapped = {{
+                    m_mappedTouchAnchor[0] + (m_lastArmState.pose[0] - m_armAnchor[0]),
+                    m_mappedTouchAnchor[1] + (m_lastArmState.pose[1] - m_armAnchor[1]),
+                    m_mappedTouchAnchor[2] + (m_lastArmState.pose[2] - m_armAnchor[2])
+                }};
+                AxisMapping::Vec3 armInDevice = m_positionMappingInv.apply(armMapped);
+                for (int i = 0; i < 3; ++i) {
+                    force[i] = m_couplingStiffness * (armInDevice[i] - touchPos[i]) - m_couplingDamping * touchVelocity[i]
+                             + overlayForce[i];
+                }
+                m_couplingTicks.store(m_couplingTicks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return;
+            }
+            m_fallbackTicks.store(m_fallbackTicks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        
+        // 指向锚点的弹簧力（等待锚点位姿期间同样作为保持力），叠加虚拟夹具的吸附力和防碰撞排斥力
+        for (int i = 0; i < 3; ++i) {
+            force[i] = m_springStiffness * (m_touchAnchor[i] - touchPos[i]) + overlayForce[i];
+        }
+    }
     
-    void queryCurrentArmState() {
-        if (m_armController.isConnected()) {
+    // 拖动中或等待锚点时都需要渲染保持力
+    bool isEngaged() const { return m_state.load(std::memory_order_acquire) != ControlState::Idle; }
+    
+    // 打印按下按钮到第一条运动指令投递的延迟统计
+    void printClutchLatencyStats() const {
+        uint64_t count = m_clutchCount.load(std::memory_order_relaxed);
+        std::cout << "[" << m_deviceName << "] 离合延迟: 次数=" << count;
+        if (count > 0) {
+            std::cout << std::fixed << std::setprecision(3)
+                      << ", 最近=" << (m_lastClutchLatencyNs.load(std::memory_order_relaxed) / 1e6) << "ms"
+                      << ", 平均=" << (m_totalClutchLatencyNs.load(std::memory_order_relaxed) / 1e6 / count) << "ms"
+                      << ", 最大=" << (m_maxClutchLatencyNs.load(std::memory_order_relaxed) / 1e6) << "ms"
+                      << ", 位姿查询=" << (m_armController.getLastAnchorQueryNs() / 1e6) << "ms"
+                      << ", 指令往返=" << (m_armController.getCommandRttNs() / 1e6) << "ms";
+        }
+        std::cout << std::endl;
+    }
+    
+    // 打印指令发送节拍统计（实际频率/相位抖动）
+    void printCommandRateStats() const {
+        m_commandScheduler.printStats(std::cout, m_deviceName);
+        if (m_predictor.getParams().mode != MotionPredictor::Off) {
+            std::cout << "[" << m_deviceName << "] 预测: " << MotionPredictor::modeName(m_predictor.getParams().mode)
+                      << ", 当前预测时长=" << m_predictor.getHorizonMs() << "ms" << std::endl;
+        }
+        if (m_trajectory.isEnabled()) {
+            TrajectoryGenerator::Stats stats;
+            m_trajectory.getStats(stats);
+            std::cout << "[" << m_deviceName << "] 轨迹限制: 节拍=" << stats.steps << ", 受限=" << stats.limitedSteps
+                      << ", 最大偏差=" << std::fixed << std::setprecision(3) << stats.maxLagPosition / 1000.0 << "mm/"
+                      << stats.maxLagRotation << "mrad" << std::defaultfloat << std::setprecision(6) << std::endl;
+        }
+        if (m_fixtures.isEnabled()) {
+            VirtualFixtures::Stats stats;
+            m_fixtures.getStats(stats);
+            std::cout << "[" << m_deviceName << "] 虚拟夹具(" << m_fixtures.getCount() << "个): 求解=" << stats.evaluations
+                      << ", 吸附节拍=" << stats.guidedTicks << " (吸附" << stats.snapOns << "次)"
+                      << ", 限位节拍=" << stats.limitTicks << ", 最终目标修正=" << stats.finalLimits
+                      << ", 耗时 p50=" << std::fixed << std::setprecision(2)
+                      << stats.evaluateTime.percentile(0.50) / 1000.0 << "us p99="
+                      << stats.evaluateTime.percentile(0.99) / 1000.0 << "us max=" << stats.evaluateTime.maxNs / 1000.0
+                      << "us" << std::defaultfloat << std::setprecision(6) << std::endl;
+        }
+        if (m_forceMode == ForceMode::ArmCoupling) {
+            std::cout << "[" << m_deviceName << "] 机械臂耦合力: 耦合帧=" << m_couplingTicks.load(std::memory_order_relaxed)
+                      << ", 位姿过期退回锚点弹簧帧=" << m_fallbackTicks.load(std::memory_order_relaxed) << std::endl;
+        }
+        if (m_ikWorker) {
+            m_ikWorker->printStats(std::cout, m_deviceName);
+            std::cout << "[" << m_deviceName << "] 关节角度过期或不一致改用笛卡尔跟随: "
+                      << m_jointSeedFallbacks.load(std::memory_order_relaxed) << " 次" << std::endl;
+        }
+        if (m_sessionRecorder) {
+            std::cout << "[" << m_deviceName << "] 会话录制: " << m_sessionRecorder->getFilename()
+                      << ", 已写入=" << m_sessionRecorder->getRecordedCount()
+                      << ", 丢弃=" << m_sessionRecorder->getDropCount() << std::endl;
+        }
+    }
+    
+    // 从 [prefix] 节读取预测参数（运行时与离线回放共用）
+    static void loadPredictorParams(ConfigLoader* config, const std::string& prefix,
+                                    MotionPredictor::Params& params) {
+        std::string mode = config->getString(prefix + ".predictor_mode", "off");
+        if (!MotionPredictor::parseMode(mode, params.mode)) {
+            std::cerr << "警告: " << prefix << ".predictor_mode=" << mode << " 无效，使用 off" << std::endl;
+        }
+        params.horizonMs = config->getDouble(prefix + ".predictor_horizon_ms", params.horizonMs);
+        params.maxHorizonMs = config->getDouble(prefix + ".predictor_max_horizon_ms", params.maxHorizonMs);
+        params.maxLeadPosition = config->getDouble(prefix + ".predictor_max_lead_um", params.maxLeadPosition);
+        params.maxLeadRotation = config->getDouble(prefix + ".predictor_max_lead_mrad", params.maxLeadRotation);
+        params.velocityCutoffHz = config->getDouble(prefix + ".predictor_velocity_cutoff_hz", params.velocityCutoffHz);
+        params.adaptive = config->getBool(prefix + ".predictor_adaptive", params.adaptive);
+        params.latencyGain = config->getDouble(prefix + ".predictor_latency_gain", params.latencyGain);
+    }
+    
+    // 从 [prefix] 节读取指令滤波参数（运行时与离线基准共用）
+    static void loadFilterParams(ConfigLoader* config, const std::string& prefix, MotionFilter::Params& params) {
+        std::string type = config->getString(prefix + ".filter_type", "none");
+        if (!MotionFilter::parseType(type, params.type)) {
+            std::cerr << "警告: " << prefix << ".filter_type=" << type << " 无效，使用 none" << std::endl;
+        }
+        params.minCutoffHz = config->getDouble(prefix + ".filter_min_cutoff_hz", params.minCutoffHz);
+        params.betaPosition = config->getDouble(prefix + ".filter_beta_position", params.betaPosition);
+        params.betaRotation = config->getDouble(prefix + ".filter_beta_rotation", params.betaRotation);
+        params.derivativeCutoffHz = config->getDouble(prefix + ".filter_derivative_cutoff_hz", params.derivativeCutoffHz);
+        params.cutoffHz = config->getDouble(prefix + ".filter_cutoff_hz", params.cutoffHz);
+    }
+    
+    // 从 [prefix] 节读取轨迹生成参数（运行时与离线基准共用），上限按位置轴/姿态轴分组配置
+    static void loadTrajectoryParams(ConfigLoader* config, const std::string& prefix,
+                                     TrajectoryGenerator::Params& params) {
+        std::string mode = config->getString(prefix + ".trajectory", "off");
+        if (!TrajectoryGenerator::parseMode(mode, params.mode)) {
+            std::cerr << "警告: " << prefix << ".trajectory=" << mode << " 无效，使用 off" << std::endl;
+        }
+        params.setPositionLimits(
+            config->getDouble(prefix + ".trajectory_max_velocity", params.maxVelocity[0] / 1000.0),
+            config->getDouble(prefix + ".trajectory_max_acceleration", params.maxAcceleration[0] / 1000.0),
+            config->getDouble(prefix + ".trajectory_max_jerk", params.maxJerk[0] / 1000.0));
+        params.setRotationLimits(
+            config->getDouble(prefix + ".trajectory_max_angular_velocity", params.maxVelocity[3] / 1000.0),
+            config->getDouble(prefix + ".trajectory_max_angular_acceleration", params.maxAcceleration[3] / 1000.0),
+            config->getDouble(prefix + ".trajectory_max_angular_jerk", params.maxJerk[3] / 1000.0));
+        params.targetVelocity = config->getBool(prefix + ".trajectory_feedforward", params.targetVelocity);
+    }
+    
+    /**
+     * @brief 从 [section] 节读取虚拟夹具（运行时与离线基准共用）
+     *
+     * count = N 个夹具，第K个为 fixtureK_type（plane/line/point）、fixtureK_mode（guide/limit）、
+     * fixtureK_point / fixtureK_normal / fixtureK_end（"x, y, z"，机械臂基坐标系毫米），
+     * 可选 fixtureK_snap_distance、fixtureK_stiffness；定义不完整的夹具被跳过
+     */
+    static void loadFixtures(ConfigLoader* config, const std::string& section,
+                             VirtualFixtures::Params& params, std::vector<VirtualFixtures::Fixture>& fixtures) {
+        params.snapDistance = config->getDouble(section + ".snap_distance", params.snapDistance);
+        params.stiffness = config->getDouble(section + ".stiffness", params.stiffness);
+        int count = config->getInt(section + ".count", 0);
+        for (int i = 1; i <= count; ++i) {
+            std::string key = section + ".fixture" + std::to_string(i);
+            VirtualFixtures::Fixture fixture;
+            std::string type = config->getString(key + "_type", "");
+            std::string mode = config->getString(key + "_mode", "guide");
+            if (!VirtualFixtures::parseType(type, fixture.type) ||
+                !VirtualFixtures::parseBehavior(mode, fixture.behavior)) {
+                std::cerr << "警告: " << key << "_type=" << type << " / _mode=" << mode << " 无效，已跳过" << std::endl;
+                continue;
+            }
+            bool valid = VirtualFixtures::parseVector(config->getString(key + "_point", ""), fixture.point);
+            if (fixture.type == VirtualFixtures::Plane) {
+                valid &= VirtualFixtures::parseVector(config->getString(key + "_normal", ""), fixture.normal);
+            } else if (fixture.type == VirtualFixtures::Line) {
+                valid &= VirtualFixtures::parseVector(config->getString(key + "_end", ""), fixture.end);
+            }
+            if (!valid) {
+                std::cerr << "警告: " << key << " 的坐标应为 \"x, y, z\"（毫米），已跳过" << std::endl;
+                continue;
+            }
+            fixture.snapDistance = config->getDouble(key + "_snap_distance", 0.0);
+            fixture.stiffness = config->getDouble(key + "_stiffness", 0.0);
+            fixtures.push_back(fixture);
+        }
+    }
+    
+    /**
+     * @brief 读取坐标映射配置（轴索引、符号）
+     */
+    static void loadAxisMappingConfig(ConfigLoader* config, const std::string& mappingPrefix,
+                                      int positionSource[3], int positionSign[3],
+                                      int rotationSource[3], int rotationSign[3]) {
+        positionSource[0] = config->getInt(mappingPrefix + ".touch_pos_to_arm_x", 2);  // 默认：Z→X
+        positionSource[1] = config->getInt(mappingPrefix + ".touch_pos_to_arm_y", 0);  // 默认：X→Y
+        positionSource[2] = config->getInt(mappingPrefix + ".touch_pos_to_arm_z", 1);  // 默认：Y→Z
+        rotationSource[0] = config->getInt(mappingPrefix + ".touch_rot_to_arm_rx", 2); // 默认：RZ→RX
+        rotationSource[1] = config->getInt(mappingPrefix + ".touch_rot_to_arm_ry", 0); // 默认：RX→RY
+        rotationSource[2] = config->getInt(mappingPrefix + ".touch_rot_to_arm_rz", 1); // 默认：RY→RZ
+        
+        // 机械臂轴符号调整
+        positionSign[0] = config->getInt(mappingPrefix + ".arm_x_sign", 1);
+        positionSign[1] = config->getInt(mappingPrefix + ".arm_y_sign", 1);
+        positionSign[2] = config->getInt(mappingPrefix + ".arm_z_sign", 1);
+        rotationSign[0] = config->getInt(mappingPrefix + ".arm_rx_sign", -1);
+        rotationSign[1] = config->getInt(mappingPrefix + ".arm_ry_sign", -1);
+        rotationSign[2] = config->getInt(mappingPrefix + ".arm_rz_sign", 1);
+        
+        // 世界坐标偏移不参与映射：离合控制下目标 = 机械臂锚点 + (映射后位置 - 映射后锚点)，
+        // 任何常量偏移都会在相减时抵消。配置了非零值时提示，避免误以为已生效
+        if (config->getDouble(mappingPrefix + ".world_offset_x", 0.0) != 0.0 ||
+            config->getDouble(mappingPrefix + ".world_offset_y", 0.0) != 0.0 ||
+            config->getDouble(mappingPrefix + ".world_offset_z", 0.0) != 0.0) {
+            std::cerr << "警告: " << mappingPrefix << ".world_offset_x/y/z 在离合（相对）控制下不起作用，已忽略"
+                      << std::endl;
+        }
+    }
+    
+    std::array<double, 3> getTouchAnchor() const { return m_touchAnchor; }
+    
+    MotionMode getMotionMode() const { return m_motionMode; }
+    const IkWorker* getIkWorker() const { return m_ikWorker; }
+    
+    // 启动时（伺服回调开始前）设置共用的双臂防碰撞检查，index 为本机械臂在其中注册的序号
+    void setCollisionGuard(ArmCollisionGuard* guard, int index) {
+        m_collisionGuard = guard;
+        m_collisionIndex = index;
+    }
+    
+    void queryCurrentArmState() {
+        if (m_armController.isConnected()) {
             std::cout << "\n=== 查询机械臂当前状态 ===" << std::endl;
             std::array<int, 6> currentPose = m_armController.getCurrentArmPose();
             
@@ -1486,7 +2050,20 @@ public:
             std::cout << "  位置 (微米): X=" << currentPose[0] << ", Y=" << currentPose[1] << ", Z=" << currentPose[2] << std::endl;
             std::cout << "  姿态 (毫弧度): RX=" << currentPose[3] << ", RY=" << currentPose[4] << ", RZ=" << currentPose[5] << std::endl;
             
-            if (m_dragging) {
+            // 主动上报的完整状态（关节/力传感器/错误码）及其新鲜度
+            ArmRealtimeState state;
+            if (m_armController.readArmState(state)) {
+                double ageMs = (ArmCommandPipeline::nowNs() - state.timestampNs) / 1e6;
+                std::cout << "  数据来源: " << (state.source == ArmRealtimeState::SourceUdpPush ? "UDP主动上报" : "TCP查询")
+                          << ", " << std::fixed << std::setprecision(3) << ageMs << "ms前"
+                          << (ageMs * 1e6 > m_armController.getPushMaxAgeNs() ? " (已过期)" : "")
+                          << std::defaultfloat << std::endl;
+                if (state.source == ArmRealtimeState::SourceUdpPush) {
+                    ArmStateReceiver::printState(std::cout, state);
+                }
+            }
+            
+            if (isDragging()) {
                 std::cout << "拖动状态: 活动中 (基于锚点位姿: [";
                 for (int i = 0; i < 6; ++i) {
                     if (i > 0) std::cout << ", ";
@@ -1507,137 +2084,441 @@ public:
         }
     }
     
-    // 新增：夹抓控制方法（根据末端控制器类型切换模式）
+    // 伺服线程调用：按钮2按下只记录一次切换请求，由主线程在 serviceEndEffectorRequests() 中执行
+    // （灵巧手的Python/ROS2调用和末端指令都不在伺服线程中进行）
     void onGripperButtonPressed() {
+        m_endEffectorRequestSeq.store(m_endEffectorRequestSeq.load(std::memory_order_relaxed) + 1,
+                                      std::memory_order_release);
+    }
+    
+    // 主线程调用（初始化灵巧手的同一线程）：执行伺服线程挂起的末端控制器切换（根据末端控制器类型切换模式）
+    void serviceEndEffectorRequests() {
+        uint32_t requestSeq = m_endEffectorRequestSeq.load(std::memory_order_acquire);
+        for (; m_endEffectorServedSeq != requestSeq; ++m_endEffectorServedSeq) {
+            toggleEndEffector();
+        }
+    }
+    
+private:
+    // 主线程调用：切换一次末端控制器状态
+    void toggleEndEffector() {
+        BinaryLogger& logger = BinaryLogger::instance();
         if (m_endEffectorType == "dexterous_hand" && m_useDexterousHand && 
             m_handController && m_handController->isInitialized()) {
             // 使用灵巧手控制
-            std::cout << "\n=== 灵巧手控制 ===" << std::endl;
-            std::cout << "[" << m_deviceName << "] 按钮2按下 - 切换灵巧手状态" << std::endl;
-            
             if (m_handController->isHandOpen()) {
-                std::cout << "灵巧手状态: 张开 → 握拳" << std::endl;
+                logger.logText(LOG_EE_HAND_TOGGLE, m_logSource, "握拳");
                 m_handController->closeHand();
             } else {
-                std::cout << "灵巧手状态: 握拳 → 张开" << std::endl;
+                logger.logText(LOG_EE_HAND_TOGGLE, m_logSource, "张开");
                 m_handController->openHand();
             }
-            
-            std::cout << "当前灵巧手状态: " << (m_handController->isHandOpen() ? "张开" : "握拳") << std::endl;
-            std::cout << "==================\n" << std::endl;
-            
         } else if (m_endEffectorType == "scissors" && m_armController.isConnected()) {
-            // 使用剪刀控制
-            std::cout << "\n=== 剪刀控制 ===" << std::endl;
-            std::cout << "[" << m_deviceName << "] 按钮2按下 - 切换剪刀状态" << std::endl;
-            
-            if (m_scissorsState) {
-                // 当前是闭合状态，切换为松开
-                std::cout << "剪刀状态: 闭合 → 松开" << std::endl;
-                m_armController.controlScissorsCustom(m_scissorsModbusPort, m_scissorsModbusAddress, 
-                                                     m_scissorsOpenData, m_scissorsModbusDevice);
-                m_scissorsState = false;
-            } else {
-                // 当前是松开状态，切换为闭合
-                std::cout << "剪刀状态: 松开 → 闭合" << std::endl;
-                m_armController.controlScissorsCustom(m_scissorsModbusPort, m_scissorsModbusAddress, 
-                                                     m_scissorsCloseData, m_scissorsModbusDevice);
-                m_scissorsState = true;
-            }
-            
-            std::cout << "当前剪刀状态: " << (m_scissorsState ? "闭合" : "松开") << std::endl;
-            std::cout << "================\n" << std::endl;
-            
+            // 使用剪刀控制：当前闭合则松开，否则闭合
+            m_scissorsState = !m_scissorsState;
+            logger.logText(LOG_EE_SCISSORS_TOGGLE, m_logSource, m_scissorsState ? "闭合" : "松开");
+            m_armController.controlScissorsCustom(m_scissorsModbusPort, m_scissorsModbusAddress,
+                                                  m_scissorsState ? m_scissorsCloseData : m_scissorsOpenData,
+                                                  m_scissorsModbusDevice);
         } else if (m_endEffectorType == "gripper" && m_armController.isConnected()) {
-            // 使用夹爪控制
-            static bool gripperClosed = false;  // 记录当前夹抓状态，默认为打开
-            
-            std::cout << "\n=== 夹爪控制 ===" << std::endl;
-            if (gripperClosed) {
-                // 当前是关闭状态，切换为打开
-                std::cout << "[" << m_deviceName << "] 按钮2按下 - 打开夹爪" << std::endl;
-                m_armController.controlGripper(true);   // 打开夹爪
-                gripperClosed = false;
+            // 使用夹爪控制：当前关闭则打开，否则关闭
+            m_gripperClosed = !m_gripperClosed;
+            logger.logText(LOG_EE_GRIPPER_TOGGLE, m_logSource, m_gripperClosed ? "关闭" : "打开");
+            m_armController.controlGripper(!m_gripperClosed);
+        } else if (m_endEffectorType == "dexterous_hand") {
+            logger.logText(LOG_EE_UNAVAILABLE, m_logSource, "灵巧手未正确初始化");
+        } else {
+            logger.logText(LOG_EE_UNAVAILABLE, m_logSource, "机械臂未连接，无法控制末端设备");
+        }
+    }
+    
+    // 伺服线程调用：记录离合延迟（原子计数，供键盘线程读取）
+    void recordClutchLatency(uint64_t latencyNs) {
+        m_awaitingFirstCommand = false;
+        m_lastClutchLatencyNs.store(latencyNs, std::memory_order_relaxed);
+        m_totalClutchLatencyNs.fetch_add(latencyNs, std::memory_order_relaxed);
+        m_clutchCount.fetch_add(1, std::memory_order_relaxed);
+        if (latencyNs > m_maxClutchLatencyNs.load(std::memory_order_relaxed)) {
+            m_maxClutchLatencyNs.store(latencyNs, std::memory_order_relaxed);
+        }
+    }
+    
+    // 开始新的指令流：发送节拍从现在起算，滤波器从零偏移开始
+    void startCommandStream(uint64_t nowNs) {
+        static const double zeroOffset[MotionFilter::kAxes] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        m_motionFilter.reset(zeroOffset, nowNs);
+        m_predictor.reset(zeroOffset, nowNs);
+        m_trajectory.reset(zeroOffset, nowNs);
+        m_fixtures.reset();
+        m_commandScheduler.start(nowNs);
+    }
+    
+    /**
+     * @brief 伺服线程：把本帧目标（相对锚点，微米）约束到虚拟夹具上
+     *
+     * 目标换算到机械臂基坐标系（毫米）求解，约束后的目标和速度写回，
+     * 拉力经位置映射的线性逆变换（机械臂微米 → 设备毫米）得到设备上的吸附力。
+     */
+    void applyFixtures(AxisMapping::Vec3& relativeTouchPos, AxisMapping::Vec3& mappedVelocity) {
+        double target[3];
+        for (int i = 0; i < 3; ++i) {
+            target[i] = (m_armAnchor[i] + relativeTouchPos[i]) / 1000.0;
+        }
+        VirtualFixtures::Result result;
+        m_fixtures.evaluate(target, result);
+        if (!result.constrained()) {
+            return;
+        }
+        AxisMapping::Vec3 pull;
+        for (int i = 0; i < 3; ++i) {
+            relativeTouchPos[i] = result.position[i] * 1000.0 - m_armAnchor[i];
+            pull[i] = result.pull[i] * 1000.0;
+        }
+        m_fixtures.constrainVelocity(result, mappedVelocity.data());
+        m_fixtureForce = m_positionMappingInv.applyLinear(pull);
+    }
+    
+    // 伺服线程（发送节拍）：检查并按需截短目标位姿，被拒绝时返回false；结果变化时记录日志
+    bool checkCollision(std::array<int, 6>& targetPose, uint64_t nowNs) {
+        ArmCollisionGuard::Result result;
+        ArmCollisionGuard::Verdict verdict = m_collisionGuard->check(m_collisionIndex, targetPose, nowNs, result);
+        BinaryLogger& logger = BinaryLogger::instance();
+        if (result.stale != m_collisionStale) {
+            if (result.stale < 0) {
+                logger.log(LOG_COLLISION_FRESH, m_logSource);
+            } else if (result.staleHold) {
+                logger.log(LOG_COLLISION_STALE_HOLD, m_logSource, result.stale + 1);
             } else {
-                // 当前是打开状态，切换为关闭
-                std::cout << "[" << m_deviceName << "] 按钮2按下 - 关闭夹爪" << std::endl;
-                m_armController.controlGripper(false);  // 关闭夹爪
-                gripperClosed = true;
+                logger.log(LOG_COLLISION_STALE, m_logSource, result.stale + 1);
             }
-            std::cout << "当前夹爪状态: " << (gripperClosed ? "关闭" : "打开") << std::endl;
-            std::cout << "================\n" << std::endl;
-        } else {
-            std::cout << "\n=== 末端控制 ===" << std::endl;
-            std::cout << "[" << m_deviceName << "] 按钮2按下 - 无可用的末端控制设备" << std::endl;
-            std::cout << "末端控制器类型: " << m_endEffectorType << std::endl;
-            
-            if (m_endEffectorType == "dexterous_hand") {
-                std::cout << "❌ 灵巧手未正确初始化" << std::endl;
-            } else if (m_endEffectorType == "scissors" || m_endEffectorType == "gripper") {
-                std::cout << "❌ 机械臂未连接，无法控制末端设备" << std::endl;
+            m_collisionStale = result.stale;
+        }
+        // 无法检查而拒绝时已由 LOG_COLLISION_STALE_HOLD 记录
+        if (verdict != m_collisionVerdict && !result.staleHold) {
+            if (verdict == ArmCollisionGuard::Clamped) {
+                logger.log(LOG_COLLISION_CLAMP, m_logSource, result.partner + 1, result.clearanceMm);
+            } else if (verdict == ArmCollisionGuard::Vetoed) {
+                logger.log(LOG_COLLISION_VETO, m_logSource, result.partner + 1, result.clearanceMm);
+            } else {
+                logger.log(LOG_COLLISION_CLEAR, m_logSource, result.clearanceMm);
             }
-            
-            std::cout << "🎮 Touch设备工作正常，但末端控制不可用" << std::endl;
-            std::cout << "🔧 请检查设备连接和配置后重试" << std::endl;
-            std::cout << "================\n" << std::endl;
+            m_collisionVerdict = verdict;
         }
+        return verdict != ArmCollisionGuard::Vetoed;
     }
-
-private:
-    std::array<double, 3> extractEulerAngles(const std::array<double, 16>& transform) const {
-        // 从4x4变换矩阵提取欧拉角（XYZ顺序）
-        double r11 = transform[0];
-        double r12 = transform[4];
-        double r13 = transform[8];
-        double r21 = transform[1];
-        double r22 = transform[5];
-        double r23 = transform[9];
-        double r31 = transform[2];
-        double r32 = transform[6];
-        double r33 = transform[10];
-        
-        double roll, pitch, yaw;
+    
+    // 伺服线程：叠加防碰撞排斥力（机械臂基坐标系，N）；方向经位置映射的线性逆变换到设备坐标，大小不随映射系数缩放
+    void addCollisionForce(AxisMapping::Vec3& force) const {
+        if (!m_collisionGuard) {
+            return;
+        }
+        double repulsion[3];
+        m_collisionGuard->getRepulsion(m_collisionIndex, repulsion);
+        double magnitude = std::sqrt(repulsion[0] * repulsion[0] + repulsion[1] * repulsion[1] + repulsion[2] * repulsion[2]);
+        if (magnitude <= 0.0) {
+            return;
+        }
+        AxisMapping::Vec3 direction = m_positionMappingInv.applyLinear({{repulsion[0], repulsion[1], repulsion[2]}});
+        double length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+        if (length <= 0.0) {
+            return;
+        }
+        for (int i = 0; i < 3; ++i) {
+            force[i] += direction[i] * magnitude / length;
+        }
+    }
+    
+    // 读取关节空间流式控制配置，motion_mode = joint 时创建并启动逆解工作线程（构造时调用一次）
+    void configureJointStreaming(const std::string& prefix) {
+        std::string motionMode = m_config->getString(prefix + ".motion_mode", "pose");
+        if (motionMode != "joint") {
+            if (motionMode != "pose") {
+                std::cerr << "警告: " << prefix << ".motion_mode=" << motionMode << " 无效，使用 pose" << std::endl;
+            }
+            return;
+        }
+        std::string modelName = m_config->getString(prefix + ".ik_model", "rm65");
+        ArmKinematics::Model model;
+        if (!ArmKinematics::findModel(modelName, model)) {
+            std::cerr << "警告: " << prefix << ".ik_model=" << modelName << " 未知，使用 motion_mode = pose" << std::endl;
+            return;
+        }
+        ArmKinematics::Params kinematicsParams;
+        kinematicsParams.maxIterations = m_config->getInt(prefix + ".ik_max_iterations", kinematicsParams.maxIterations);
+        m_kinematics.configure(model, kinematicsParams);
+        m_kinematics.setToolOffset(m_config->getDouble(prefix + ".ik_tool_offset_x", 0.0),
+                                   m_config->getDouble(prefix + ".ik_tool_offset_y", 0.0),
+                                   m_config->getDouble(prefix + ".ik_tool_offset_z", 0.0));
+        m_ikSeedTolerance = m_config->getDouble(prefix + ".ik_seed_tolerance_mm", m_ikSeedTolerance);
+        m_ikSeedRotationTolerance = m_config->getDouble(prefix + ".ik_seed_tolerance_mrad",
+                                                        m_ikSeedRotationTolerance * 1000.0) / 1000.0;
         
-        pitch = std::asin(-r31);
+        IkWorker::Params workerParams;
+        workerParams.maxJointStepDeg = m_config->getDouble(prefix + ".ik_max_joint_step_deg", workerParams.maxJointStepDeg);
+        workerParams.branchJumpDeg = m_config->getDouble(prefix + ".ik_branch_jump_deg", workerParams.branchJumpDeg);
+        workerParams.acceptPositionMm = m_config->getDouble(prefix + ".ik_accept_position_mm", workerParams.acceptPositionMm);
         
-        if (std::cos(pitch) > 0.0001) {
-            roll = std::atan2(r32, r33);
-            yaw = std::atan2(r21, r11);
-        } else {
-            roll = std::atan2(-r23, r22);
-            yaw = 0.0;
+        IkSolver* solver = nullptr;
+        std::string solverName = m_config->getString(prefix + ".ik_solver", "builtin");
+        if (solverName == "rm_algo") {
+#ifdef USE_RM_API2
+            solver = new RmAlgoIkSolver(m_kinematics);
+#else
+            std::cout << "⚠️  " << prefix << ".ik_solver = rm_algo 需要以 USE_RM_API2 编译，改用 builtin" << std::endl;
+#endif
+        } else if (solverName != "builtin") {
+            std::cerr << "警告: " << prefix << ".ik_solver=" << solverName << " 无效，使用 builtin" << std::endl;
+        }
+        if (!solver) {
+            solver = new DlsIkSolver(m_kinematics);
         }
         
-        // 转换为度
-        roll = roll * 180.0 / M_PI;
-        pitch = pitch * 180.0 / M_PI;
-        yaw = yaw * 180.0 / M_PI;
-        
-        return {roll, pitch, yaw};
+        ArmController& arm = m_armController;
+        m_ikWorker = new IkWorker(solver, [&arm](const ArmKinematics::Joints& joints) {
+            return arm.sendJointAnglesAsync(joints);
+        }, workerParams);
+        m_ikWorker->start();
+        m_motionMode = MotionMode::Joint;
+        std::cout << "  运动模式: 关节空间 (逆解: " << solver->name() << ", 模型: " << model.name
+                  << ", 最大单关节步长: " << workerParams.maxJointStepDeg << "°)" << std::endl;
+    }
+    
+    // 伺服线程调用：以机械臂实际关节角度开始逆解会话；关节角度过期或其正解与锚点位姿不一致
+    // （工具偏移或模型配置错误）时返回false，本次拖动改用笛卡尔跟随
+    bool beginJointSession(const std::array<int, 6>& anchorPose) {
+        BinaryLogger& logger = BinaryLogger::instance();
+        ArmRealtimeState state;
+        if (!m_armController.readArmState(state) || !(state.fields & ArmRealtimeState::FieldJointStatus) ||
+            ArmCommandPipeline::nowNs() - state.timestampNs > m_armController.getPushMaxAgeNs()) {
+            logger.log(LOG_IK_SEED_STALE, m_logSource);
+            m_jointSeedFallbacks.store(m_jointSeedFallbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        ArmKinematics::Joints seed;
+        for (int i = 0; i < ArmKinematics::kJoints; ++i) {
+            seed[i] = state.jointPosition[i];
+        }
+        ArmKinematics::Result check;
+        m_kinematics.evaluate(anchorPose, seed, check);
+        if (check.positionError > m_ikSeedTolerance || check.rotationError > m_ikSeedRotationTolerance) {
+            logger.log(LOG_IK_SEED_MISMATCH, m_logSource, check.positionError, check.rotationError);
+            m_jointSeedFallbacks.store(m_jointSeedFallbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        m_ikWorker->beginSession(seed);
+        return true;
+    }
+    
+    // 由配置的轴索引、符号、系数和偏移合成映射（构造时调用一次）
+    void compileAxisMapping(const int positionSource[3], const int positionSign[3],
+                            const int rotationSource[3], const int rotationSign[3]) {
+        static const AxisMapping::Vec3 noOffset = {{0.0, 0.0, 0.0}};
+        m_positionMapping = AxisMapping::compile(positionSource, positionSign, m_positionScale, noOffset);
+        m_positionMappingInv = m_positionMapping.inverse();
+        m_rotationMapping = AxisMapping::compile(rotationSource, rotationSign, m_rotationScale * 1000.0, noOffset);
+        if (!m_positionMapping.isSpecialized() || !m_rotationMapping.isSpecialized()) {
+            std::cerr << "警告: [" << m_deviceName << "] 坐标映射不是轴置换（轴索引重复或系数为0），"
+                      << "位置: " << m_positionMapping.kernelName() << ", 姿态: " << m_rotationMapping.kernelName() << std::endl;
+        }
+    }
+    
+    // 系数调整后保持轴置换和符号重新合成（伺服线程离合时调用）
+    void rescaleAxisMapping() {
+        m_positionMapping = m_positionMapping.withScale(m_positionScale);
+        m_positionMappingInv = m_positionMapping.inverse();
+        m_rotationMapping = m_rotationMapping.withScale(m_rotationScale * 1000.0);
+    }
+};
+
+// 触觉设备能力参数（初始化时查询一次并缓存，伺服循环中不再查询）
+struct DeviceCapabilities {
+    HDdouble maxContinuousForce;    // 最大持续输出力 (N)
+    HDdouble maxForce;              // 最大瞬时输出力 (N)
+    HDdouble usableWorkspace[6];    // 可用工作空间 [minX, minY, minZ, maxX, maxY, maxZ] (mm)
+    HDint inputDof;                 // 输入自由度
+    HDint outputDof;                // 输出自由度
+    int buttonCount;                // 按钮数量
+};
+
+// 单个触觉设备通道：设备句柄 + 控制器 + 缓存的能力参数 + 按钮边沿状态
+// 伺服回调每帧对所有通道依次调用 beginFrame() 和 endFrame()，每帧处理不分配内存
+class DeviceChannel {
+private:
+    int m_index;                        // 设备编号（从1开始）
+    std::string m_name;                 // 设备名称（如 device1）
+    HHD m_handle;                       // 设备句柄
+    TouchArmController* m_controller;   // 对应的触觉机械臂控制器
+    DeviceCapabilities m_caps;          // 缓存的设备能力
+    int m_lastButtons;                  // 上一帧按钮状态
+    bool m_simulated;                   // 模拟通道（--bench-channels）：不访问设备，采样由 setSimulatedSample() 提供
+
+    // 当前帧采样（beginFrame写入，endFrame使用）
+    std::array<double, 3> m_position;
+    std::array<double, 16> m_transform;
+    std::array<double, 3> m_velocity;
+    int m_buttons;
+
+public:
+    DeviceChannel(int index, const std::string& name, HHD handle,
+                  TouchArmController* controller, int buttonCount)
+        : m_index(index), m_name(name), m_handle(handle), m_controller(controller),
+          m_lastButtons(0), m_simulated(false), m_buttons(0) {
+        memset(&m_caps, 0, sizeof(m_caps));
+        m_caps.buttonCount = buttonCount;
+        m_position.fill(0.0);
+        m_transform.fill(0.0);
+        m_velocity.fill(0.0);
+    }
+
+    // 查询并缓存设备能力（须在启动调度器前调用）
+    void queryCapabilities() {
+        hdMakeCurrentDevice(m_handle);
+        hdGetDoublev(HD_NOMINAL_MAX_CONTINUOUS_FORCE, &m_caps.maxContinuousForce);
+        hdGetDoublev(HD_NOMINAL_MAX_FORCE, &m_caps.maxForce);
+        hdGetDoublev(HD_USABLE_WORKSPACE_DIMENSIONS, m_caps.usableWorkspace);
+        hdGetIntegerv(HD_INPUT_DOF, &m_caps.inputDof);
+        hdGetIntegerv(HD_OUTPUT_DOF, &m_caps.outputDof);
+
+        std::cout << "  [" << m_name << "] 最大持续力: " << m_caps.maxContinuousForce << "N"
+                  << ", 最大力: " << m_caps.maxForce << "N"
+                  << ", 输入/输出自由度: " << m_caps.inputDof << "/" << m_caps.outputDof
+                  << ", 按钮数: " << m_caps.buttonCount << std::endl;
+        std::cout << "  [" << m_name << "] 可用工作空间: ["
+                  << m_caps.usableWorkspace[0] << ", " << m_caps.usableWorkspace[1] << ", " << m_caps.usableWorkspace[2] << "] ~ ["
+                  << m_caps.usableWorkspace[3] << ", " << m_caps.usableWorkspace[4] << ", " << m_caps.usableWorkspace[5] << "] mm" << std::endl;
+    }
+
+    // 改为模拟通道：使用给定的设备能力，beginFrame()/endFrame() 不再访问设备
+    void enableSimulation(const DeviceCapabilities& caps) {
+        m_simulated = true;
+        m_caps = caps;
     }
+
+    // 模拟通道：写入下一帧的采样（替代设备读数）
+    void setSimulatedSample(const std::array<double, 3>& position, const std::array<double, 16>& transform,
+                            const std::array<double, 3>& velocity, int buttons) {
+        m_position = position;
+        m_transform = transform;
+        m_velocity = velocity;
+        m_buttons = buttons;
+    }
+
+    // 伺服线程：开始本设备的帧并采样位置、姿态和按钮
+    void beginFrame() {
+        if (m_simulated) {
+            return;
+        }
+        hdBeginFrame(m_handle);
+
+        hduVector3Dd position;
+        hdGetDoublev(HD_CURRENT_POSITION, position);
+        hdGetDoublev(HD_CURRENT_TRANSFORM, m_transform.data());
+        hdGetDoublev(HD_CURRENT_VELOCITY, m_velocity.data());
+        hdGetIntegerv(HD_CURRENT_BUTTONS, &m_buttons);
+
+        m_position[0] = position[0];
+        m_position[1] = position[1];
+        m_position[2] = position[2];
+    }
+
+    // 伺服线程：处理按钮和控制更新，输出力并结束本设备的帧
+    // 返回false表示发生调度器错误，需要停止回调
+    bool endFrame() {
+        int pressed = m_buttons & ~m_lastButtons;
+        int released = ~m_buttons & m_lastButtons;
+
+        // 按钮1控制机械臂位置姿态
+        if (pressed & HD_DEVICE_BUTTON_1) {
+            m_controller->onButtonDown(m_position, m_transform);
+        } else if (released & HD_DEVICE_BUTTON_1) {
+            m_controller->onButtonUp();
+        }
+
+        // 按钮2控制末端执行器
+        if (m_caps.buttonCount >= 2 && (pressed & HD_DEVICE_BUTTON_2)) {
+            m_controller->onGripperButtonPressed();
+        }
+
+        m_controller->update(m_position, m_transform, m_velocity);
+        m_lastButtons = m_buttons;
+
+        // 应用弹簧力反馈
+        hduVector3Dd force(0.0, 0.0, 0.0);
+
+        if (m_controller->isEngaged()) {
+            // 锚点弹簧或机械臂耦合力，由控制器按配置的力反馈模式计算
+            m_controller->computeFeedbackForce(m_position, m_velocity, force);
+
+            // 力限制（使用缓存的最大持续力）
+            double forceMagnitude = sqrt(force[0]*force[0] + force[1]*force[1] + force[2]*force[2]);
+            if (forceMagnitude > m_caps.maxContinuousForce && forceMagnitude > 0.0) {
+                double scale = m_caps.maxContinuousForce / forceMagnitude;
+                force[0] *= scale;
+                force[1] *= scale;
+                force[2] *= scale;
+            }
+        }
+        if (m_simulated) {
+            return true;
+        }
+
+        hdMakeCurrentDevice(m_handle);
+        hdSetDoublev(HD_CURRENT_FORCE, force);
+        hdEndFrame(m_handle);
+
+        HDErrorInfo error;
+        if (HD_DEVICE_ERROR(error = hdGetError()))
+        {
+            hduPrintError(stderr, &error, (m_name + "回调错误").c_str());
+            if (hduIsSchedulerError(&error))
+                return false;
+        }
+        return true;
+    }
+
+    int getIndex() const { return m_index; }
+    const std::string& getName() const { return m_name; }
+    HHD getHandle() const { return m_handle; }
+    const DeviceCapabilities& getCapabilities() const { return m_caps; }
 };
 
-// 全局变量 - 双设备支持
+// 全局变量 - 多设备支持（设备数量由 system.device_count 配置）
 ConfigLoader* g_config = nullptr;  // 改为指针，支持动态配置文件
-ArmController* g_armController1 = nullptr;    // 机械臂1控制器
-ArmController* g_armController2 = nullptr;    // 机械臂2控制器
-TouchArmController* g_touchArmController1 = nullptr;  // 触觉设备1控制器
-TouchArmController* g_touchArmController2 = nullptr;  // 触觉设备2控制器
+std::vector<ArmController*> g_armControllers;             // 机械臂控制器，下标0对应设备1
+std::vector<TouchArmController*> g_touchArmControllers;   // 触觉设备控制器
+std::vector<DeviceChannel*> g_deviceChannels;             // 已初始化的触觉设备通道
+ServoTimingMonitor* g_servoTiming = nullptr;              // 伺服回调时序监测
+ArmStateReceiver* g_armStateReceiver = nullptr;           // 机械臂UDP主动上报接收
+ArmReactor* g_armReactor = nullptr;                       // 所有机械臂TCP连接共用的通信反应器
+ArmCollisionGuard* g_collisionGuard = nullptr;            // 双臂防碰撞（collision.enabled）
 bool g_applicationRunning = true;
-int g_selectedDevice = 1;  // 当前选择的设备（1或2），用于调整参数
+int g_selectedDevice = 1;  // 当前选择的设备（从1开始），用于调整参数
 
-// 双设备句柄
-static HHD g_hHD1 = HD_INVALID_HANDLE;  // 设备1
-static HHD g_hHD2 = HD_INVALID_HANDLE;  // 设备2
-
-// 设备回调函数
-HDCallbackCode HDCALLBACK device1Callback(void *data);
-HDCallbackCode HDCALLBACK device2Callback(void *data);
+// 统一伺服回调：一帧内依次处理所有设备通道
+HDCallbackCode HDCALLBACK servoLoopCallback(void *data);
 
 void handleKeyboard();
 void printInstructions();
 void initializeDevices();
 void cleanupDevices();
+TouchArmController* selectedController();
+void printRealtimePushStats();
+int runPredictorReplay(int argc, char* argv[]);
+int runMappingBenchmark(int argc, char* argv[]);
+int runOrientationBenchmark(int argc, char* argv[]);
+int runIkBenchmark(int argc, char* argv[]);
+int runTrajectoryBenchmark(int argc, char* argv[]);
+int runFilterBenchmark(int argc, char* argv[]);
+int runFixtureBenchmark(int argc, char* argv[]);
+int runCollisionBenchmark(int argc, char* argv[]);
+int runChannelBenchmark(int argc, char* argv[]);
+int runEncoderBenchmark(int argc, char* argv[]);
+int runTransportBenchmark(int argc, char* argv[]);
+int runLoopbackSelftest(int argc, char* argv[]);
+ArmTransport* createArmTransport(const std::string& section, const std::string& ip, int port);
+bool loadCollisionParams(ArmCollisionGuard::Params& params, ArmKinematics::Model& model);
+ArmCollisionGuard* createCollisionGuard();
+void printStartupTimings(double totalMs, double endEffectorMs);
 
 /*******************************************************************************
  主函数
@@ -1645,8 +2526,43 @@ void cleanupDevices();
 int main(int argc, char* argv[])
 {
     // 处理命令行参数
+    // 离线回放模式: Touch_Controller_Arm2 --replay-predictor <会话CSV> [deviceN] [端到端延迟ms]
+    // 映射微基准: Touch_Controller_Arm2 --bench-mapping [每种变换的调用次数]
+    // 运动模式基准: Touch_Controller_Arm2 --bench-ik [每种模式的秒数] [deviceN]（连接配置中的（模拟）机械臂）
+    // 轨迹生成基准: Touch_Controller_Arm2 --bench-trajectory [deviceN] [指令频率Hz...]
+    // 虚拟夹具基准: Touch_Controller_Arm2 --bench-fixtures [deviceN] [合成夹具数...]
+    // 双臂防碰撞基准: Touch_Controller_Arm2 --bench-collision [随机配置数]
+    // 伺服通道基准: Touch_Controller_Arm2 --bench-channels [模拟通道数...]
+    // 姿态映射基准: Touch_Controller_Arm2 --bench-orientation [随机位姿数]
+    // 指令滤波基准: Touch_Controller_Arm2 --bench-filter [deviceN] [发送频率Hz]
+    // 指令编码基准: Touch_Controller_Arm2 --bench-encoder [随机指令数]
+    // 传输后端基准: Touch_Controller_Arm2 --bench-transport [deviceN] [流式帧数] [查询次数]（连接配置中的（模拟）机械臂）
+    // 通信回环自测: Touch_Controller_Arm2 --selftest-loopback <场景> [IP:端口]（对端为 mock_arm_server）
+    static const struct {
+        const char* flag;
+        int (*run)(int argc, char* argv[]);
+    } kOfflineModes[] = {
+        {"--replay-predictor", runPredictorReplay},
+        {"--bench-mapping", runMappingBenchmark},
+        {"--bench-orientation", runOrientationBenchmark},
+        {"--bench-ik", runIkBenchmark},
+        {"--bench-trajectory", runTrajectoryBenchmark},
+        {"--bench-filter", runFilterBenchmark},
+        {"--bench-fixtures", runFixtureBenchmark},
+        {"--bench-collision", runCollisionBenchmark},
+        {"--bench-channels", runChannelBenchmark},
+        {"--bench-encoder", runEncoderBenchmark},
+        {"--bench-transport", runTransportBenchmark},
+        {"--selftest-loopback", runLoopbackSelftest},
+    };
+    int (*offlineMode)(int argc, char* argv[]) = nullptr;
+    for (size_t i = 0; argc > 1 && i < sizeof(kOfflineModes) / sizeof(kOfflineModes[0]); ++i) {
+        if (std::string(argv[1]) == kOfflineModes[i].flag) {
+            offlineMode = kOfflineModes[i].run;
+        }
+    }
     std::string configFile = "config.ini";  // 默认配置文件
-    if (argc > 1) {
+    if (argc > 1 && !offlineMode) {
         configFile = argv[1];
         std::cout << "📄 使用指定配置文件: " << configFile << std::endl;
     } else {
@@ -1659,9 +2575,9 @@ int main(int argc, char* argv[])
             std::cout << "📄 使用默认配置文件: " << configFile << std::endl;
         }
     }
-    
-    // 创建配置加载器（启用注释功能）
-    g_config = new ConfigLoader(configFile, true);
+
+    // 创建配置加载器（启用注释功能）；离线模式只读配置，修改只留在内存中
+    g_config = new ConfigLoader(configFile, offlineMode == nullptr);
 
 #ifdef USE_ROS2
     // 如果编译了ROS2支持，初始化ROS2
@@ -1672,7 +2588,14 @@ int main(int argc, char* argv[])
     // 加载配置文件
     std::cout << "=== 加载配置文件 ===" << std::endl;
     g_config->loadConfig();
-    
+
+    if (offlineMode) {
+        // 离线评估/基准不连接触觉设备，也不改写配置文件
+        int result = offlineMode(argc, argv);
+        delete g_config;
+        return result;
+    }
+
     // 检查是否需要保存配置文件（添加注释）
     bool autoSaveConfig = g_config->getBool("ui.auto_save_config", true);
     if (autoSaveConfig) {
@@ -1680,52 +2603,138 @@ int main(int argc, char* argv[])
         g_config->saveConfigWithComments();
         std::cout << "✅ 配置文件已更新" << std::endl;
     }
-    
-    // 从配置文件获取机械臂连接参数
-    std::string robot1IP = g_config->getString("robot1.ip", "192.168.10.18");
-    int robot1Port = g_config->getInt("robot1.port", 8080);
-    std::string robot2IP = g_config->getString("robot2.ip", "192.168.10.19");
-    int robot2Port = g_config->getInt("robot2.port", 8080);
-    
-    std::cout << "机械臂1 IP: " << robot1IP << ", 端口: " << robot1Port << std::endl;
-    std::cout << "机械臂2 IP: " << robot2IP << ", 端口: " << robot2Port << std::endl;
-    
-    // 创建机械臂控制器
-    g_armController1 = new ArmController(robot1IP, robot1Port);
-    g_armController2 = new ArmController(robot2IP, robot2Port);
-    
-    // 创建触觉控制器（延迟构造以便在配置文件加载后）
-    g_touchArmController1 = new TouchArmController(*g_armController1, g_config, "device1");
-    g_touchArmController2 = new TouchArmController(*g_armController2, g_config, "device2");
+
+    // 启动二进制日志（控制热路径的调试输出由后台线程格式化）
+    std::string logSink = g_config->getString("log.sink", "console");
+    BinaryLogger::instance().configure(logSink == "file" ? BinaryLogger::File : BinaryLogger::Console,
+                                       g_config->getString("log.file", "touch_controller.log"),
+                                       static_cast<size_t>(g_config->getInt("log.max_file_kb", 10240)) * 1024,
+                                       g_config->getInt("log.max_files", 3));
+    BinaryLogger::instance().start();
+
+    // 设备/机械臂站点数量，增加第三、第四个Touch站点只需修改配置
+    int deviceCount = g_config->getInt("system.device_count", 2);
+    if (deviceCount < 1) {
+        deviceCount = 1;
+    }
+
+    // UDP主动上报配置（所有机械臂推送到本机同一端口，按源IP区分）
+    bool pushEnabled = g_config->getBool("realtime_push.enabled", true);
+    std::string pushHostIp = g_config->getString("realtime_push.host_ip", "192.168.10.100");
+    int pushPort = g_config->getInt("realtime_push.port", 8089);
+    int pushCycle = g_config->getInt("realtime_push.cycle", 5);
+    int pushMaxAgeMs = g_config->getInt("realtime_push.max_age_ms", 50);
+    if (pushEnabled) {
+        // 先启动接收，机械臂连接（或重连）后的设置序列才会让其开始推送
+        g_armStateReceiver = new ArmStateReceiver(pushPort);
+        if (!g_armStateReceiver->start()) {
+            std::cout << "⚠️  主动上报接收未启动，位姿查询将使用TCP" << std::endl;
+            delete g_armStateReceiver;
+            g_armStateReceiver = nullptr;
+        }
+    }
+
+    // 所有机械臂的TCP收发都在同一个反应器线程中完成，断开后按抖动指数退避自动重连
+    int connectTimeoutMs = g_config->getInt("system.arm_connect_timeout_ms", 3000);
+    g_armReactor = new ArmReactor();
+    g_armReactor->setReconnectPolicy(g_config->getInt("system.arm_reconnect_initial_ms", 500),
+                                     g_config->getInt("system.arm_reconnect_max_ms", 30000),
+                                     connectTimeoutMs);
+
+    // 为每个站点创建机械臂控制器和触觉控制器
+    for (int i = 1; i <= deviceCount; ++i) {
+        std::string robotSection = "robot" + std::to_string(i);
+        std::string robotIP = g_config->getString(robotSection + ".ip", "192.168.10." + std::to_string(17 + i));
+        int robotPort = g_config->getInt(robotSection + ".port", 8080);
+        std::cout << "机械臂" << i << " IP: " << robotIP << ", 端口: " << robotPort << std::endl;
+
+        ArmController* arm = new ArmController(createArmTransport(robotSection, robotIP, robotPort), robotIP, robotPort);
+        arm->setRealtimePushConfig(pushHostIp, pushPort, pushCycle, pushMaxAgeMs, g_armStateReceiver != nullptr);
+        g_armControllers.push_back(arm);
+        if (g_armStateReceiver) {
+            g_armStateReceiver->registerArm(robotIP, [arm](const ArmRealtimeState& state) {
+                arm->publishRealtimeState(state);
+            });
+        }
+
+        // 创建触觉控制器（延迟构造以便在配置文件加载后）
+        g_touchArmControllers.push_back(new TouchArmController(*arm, g_config, "device" + std::to_string(i)));
+    }
+    g_collisionGuard = createCollisionGuard();
 
     // 连接机械臂
     std::cout << "\n=== 连接机械臂 ===" << std::endl;
-    bool arm1Connected = g_armController1->connect();
-    bool arm2Connected = g_armController2->connect();
-    
-    if (!arm1Connected && !arm2Connected) {
+    auto startupBegin = std::chrono::steady_clock::now();
+    if (!g_armReactor->start()) {
+        std::cout << "⚠️  通信反应器启动失败，机械臂指令将无法发送" << std::endl;
+    }
+    // 并行发起所有连接，设置序列由各自的控制器确认驱动，在后台进行
+    for (size_t i = 0; i < g_armControllers.size(); ++i) {
+        g_armControllers[i]->connect();
+    }
+
+    // 机械臂连接和设置期间初始化末端执行器（同一线程内依次初始化，Python环境只在一个线程中使用）
+    std::cout << "\n=== 初始化末端执行器 ===" << std::endl;
+    auto endEffectorBegin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < g_touchArmControllers.size(); ++i) {
+        g_touchArmControllers[i]->initializeEndEffector();
+    }
+    double endEffectorMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - endEffectorBegin).count();
+
+    // 等待每台机械臂就绪或首次连接失败，最多等待一个连接超时；失败的机械臂由后端在后台继续重试
+    auto connectDeadline = startupBegin + std::chrono::milliseconds(connectTimeoutMs);
+    std::vector<bool> armConnected(g_armControllers.size(), false);
+    int connectedCount = 0;
+    while (true) {
+        connectedCount = 0;
+        int settledCount = 0;
+        for (size_t i = 0; i < g_armControllers.size(); ++i) {
+            armConnected[i] = g_armControllers[i]->isConnected();
+            if (armConnected[i]) {
+                connectedCount++;
+            }
+            if (g_armControllers[i]->isReady() || (!armConnected[i] && g_armControllers[i]->hasConnectFailed())) {
+                settledCount++;
+            }
+        }
+        if (settledCount == static_cast<int>(g_armControllers.size()) ||
+            std::chrono::steady_clock::now() >= connectDeadline) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    printStartupTimings(std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startupBegin).count(), endEffectorMs);
+
+    if (connectedCount == 0) {
         std::cout << "⚠️  警告: 无法连接到任何机械臂！" << std::endl;
         std::cout << "🎮 Touch设备仍可正常工作，仅提供触觉反馈功能" << std::endl;
         std::cout << "📡 机械臂控制功能将被禁用，但所有其他功能正常" << std::endl;
-        std::cout << "🔧 请检查网络连接和机械臂状态，然后重启程序以启用机械臂控制" << std::endl;
+        std::cout << "🔧 后台将自动重连，机械臂上线后按下按钮即可开始控制，无需重启程序" << std::endl;
     } else {
-        if (!arm1Connected) {
-            std::cout << "⚠️  警告: 机械臂1连接失败，Touch设备1仅提供触觉反馈" << std::endl;
-        }
-        if (!arm2Connected) {
-            std::cout << "⚠️  警告: 机械臂2连接失败，Touch设备2仅提供触觉反馈" << std::endl;
+        for (size_t i = 0; i < armConnected.size(); ++i) {
+            if (!armConnected[i]) {
+                std::cout << "⚠️  警告: 机械臂" << (i + 1) << "连接失败，Touch设备" << (i + 1) << "暂时仅提供触觉反馈（后台自动重连）" << std::endl;
+            }
         }
     }
 
+    // 伺服回调时序监测（周期/占空直方图，超过阈值的节拍计为超限）
+    int overrunThresholdUs = g_config->getInt("system.servo_overrun_threshold_us", 1000);
+    g_servoTiming = new ServoTimingMonitor(static_cast<uint64_t>(overrunThresholdUs) * 1000);
+
     // 初始化触觉设备
     std::cout << "\n=== 初始化触觉设备 ===" << std::endl;
     initializeDevices();
+    g_servoTiming->startReporter(g_config->getInt("system.timing_report_interval_ms", 5000));
 
-    printf("=== 双触觉设备双机械臂控制程序 ===\n");
-    printf("机械臂1连接状态: %s\n", arm1Connected ? "已连接" : "未连接");
-    printf("机械臂2连接状态: %s\n", arm2Connected ? "已连接" : "未连接");
+    printf("=== 多触觉设备多机械臂控制程序 ===\n");
+    for (size_t i = 0; i < armConnected.size(); ++i) {
+        printf("机械臂%d连接状态: %s\n", static_cast<int>(i + 1), armConnected[i] ? "已连接" : "未连接");
+    }
     printf("\n");
-    
+
     printInstructions();
 
     // 主循环
@@ -1736,13 +2745,18 @@ int main(int argc, char* argv[])
             handleKeyboard();
         }
 
+        // 执行按钮2挂起的末端控制器切换（灵巧手的Python环境只在本线程中使用）
+        for (size_t i = 0; i < g_touchArmControllers.size(); ++i) {
+            g_touchArmControllers[i]->serviceEndEffectorRequests();
+        }
+
 #ifdef USE_ROS2
         // 处理ROS2回调
         if (rclcpp::ok()) {
             rclcpp::spin_some(rclcpp::Node::make_shared("dummy_spinner"));
         }
 #endif
-        
+
         // 短暂延时
         #if defined(WIN32)
         Sleep(10);
@@ -1753,7 +2767,8 @@ int main(int argc, char* argv[])
 
     // 清理工作
     cleanupDevices();
-    
+    BinaryLogger::instance().stop();
+
     // 释放配置对象内存
     delete g_config;
     g_config = nullptr;
@@ -1763,329 +2778,290 @@ int main(int argc, char* argv[])
 }
 
 /*******************************************************************************
- 初始化两个触觉设备
+ 按 [robotN] transport 创建机械臂传输后端（json / rm_api2）
 *******************************************************************************/
-void initializeDevices()
+ArmTransport* createArmTransport(const std::string& section, const std::string& ip, int port)
 {
-    HDErrorInfo error;
-    HDSchedulerHandle hCallback1, hCallback2;
-
-    std::cout << "=== 初始化触觉设备 ===" << std::endl;
-    
-    // 参考官方HelloSphereDual.cpp示例的标准初始化流程
-    // 重要：所有设备实例需要在启动调度器之前创建
-    
-    // 初始化设备1 - 从配置文件读取设备名称
-    std::string device1Primary = g_config->getString("device_names.device1_primary", "PHANToM 1");
-    std::string device1Fallback = g_config->getString("device_names.device1_fallback", "Default Device");
-    
-    std::cout << "步骤1: 初始化设备1 (" << device1Primary << ")..." << std::endl;
-    g_hHD1 = hdInitDevice(device1Primary.c_str());
-    if (HD_DEVICE_ERROR(error = hdGetError())) 
-    {
-        std::cout << "   " << device1Primary << "未找到，尝试备用设备 (" << device1Fallback << ")..." << std::endl;
-        hdGetError(); // 清除错误
-        
-        if (device1Fallback == "Default Device") {
-            g_hHD1 = hdInitDevice(HD_DEFAULT_DEVICE);
-        } else {
-            g_hHD1 = hdInitDevice(device1Fallback.c_str());
-        }
-        
-        if (HD_DEVICE_ERROR(error = hdGetError())) 
-        {
-            hduPrintError(stderr, &error, "无法初始化任何主设备");
-            g_hHD1 = HD_INVALID_HANDLE;
-        }
+    std::string transport = g_config->getString(section + ".transport", "json");
+    if (transport == "rm_api2") {
+#ifdef USE_RM_API2
+        RmApiArmTransport* rmTransport = new RmApiArmTransport(ip, port,
+                                                               g_config->getInt(section + ".rm_trajectory_mode", 0),
+                                                               g_config->getInt(section + ".rm_radio", 0));
+        rmTransport->setReconnectPolicy(g_config->getInt("system.arm_reconnect_initial_ms", 500),
+                                        g_config->getInt("system.arm_reconnect_max_ms", 30000));
+        return rmTransport;
+#else
+        std::cout << "⚠️  " << section << ".transport = rm_api2 需要以 USE_RM_API2 编译，改用 json 后端" << std::endl;
+#endif
+    } else if (transport != "json") {
+        std::cout << "⚠️  未知的 " << section << ".transport = " << transport << "，使用 json 后端" << std::endl;
     }
-    
-    if (g_hHD1 != HD_INVALID_HANDLE) {
-        hdMakeCurrentDevice(g_hHD1);
-        std::cout << "✅ 发现触觉设备1: " << hdGetString(HD_DEVICE_MODEL_TYPE) 
-                  << " (序列号: " << hdGetString(HD_DEVICE_SERIAL_NUMBER) << ")" << std::endl;
+    return new JsonArmTransport(*g_armReactor, ip, port);
+}
+
+/*******************************************************************************
+ [collision] 双臂防碰撞参数（运行和 --bench-collision 共用）
+*******************************************************************************/
+bool loadCollisionParams(ArmCollisionGuard::Params& params, ArmKinematics::Model& model)
+{
+    params.marginMm = g_config->getDouble("collision.margin_mm", params.marginMm);
+    params.linkRadiusMm = g_config->getDouble("collision.link_radius_mm", params.linkRadiusMm);
+    params.toolRadiusMm = g_config->getDouble("collision.tool_radius_mm", params.toolRadiusMm);
+    params.repulsionStiffness = g_config->getDouble("collision.repulsion_stiffness", params.repulsionStiffness);
+    params.maxRepulsion = g_config->getDouble("collision.max_repulsion", params.maxRepulsion);
+    params.stateTimeoutMs = g_config->getDouble("collision.state_timeout_ms", params.stateTimeoutMs);
+    std::string modelName = g_config->getString("collision.model", "rm65");
+    if (!ArmKinematics::findModel(modelName, model)) {
+        std::cout << "⚠️  collision.model = " << modelName << " 未知，双臂防碰撞未启用" << std::endl;
+        return false;
     }
+    return true;
+}
 
-    // 初始化设备2 - 从配置文件读取设备名称
-    std::string device2Primary = g_config->getString("device_names.device2_primary", "PHANToM 2");
-    std::string device2Fallbacks = g_config->getString("device_names.device2_fallback", "Device1,PHANTOM 2,PHANToM Device 2");
-    
-    std::cout << "步骤2: 初始化设备2 (" << device2Primary << ")..." << std::endl;
-    g_hHD2 = hdInitDevice(device2Primary.c_str());
-    if (HD_DEVICE_ERROR(error = hdGetError())) 
-    {
-        std::cout << "   " << device2Primary << "未找到，尝试备用设备..." << std::endl;
-        hdGetError(); // 清除错误
-        
-        // 解析备用设备名称列表（逗号分隔）
-        std::istringstream fallbackStream(device2Fallbacks);
-        std::string deviceName;
-        bool deviceFound = false;
-        
-        while (std::getline(fallbackStream, deviceName, ',') && !deviceFound) {
-            // 移除前后空格
-            deviceName.erase(0, deviceName.find_first_not_of(" \t"));
-            deviceName.erase(deviceName.find_last_not_of(" \t") + 1);
-            
-            if (!deviceName.empty()) {
-                std::cout << "   尝试设备名称: " << deviceName << std::endl;
-                g_hHD2 = hdInitDevice(deviceName.c_str());
-                if (!HD_DEVICE_ERROR(error = hdGetError())) {
-                    deviceFound = true;
-                    break; // 成功找到设备
-                }
-                hdGetError(); // 清除错误，继续尝试下一个
-            }
-        }
-        
-        if (!deviceFound) {
-            hduPrintError(stderr, &error, "无法初始化第二个设备");
-            std::cout << "⚠️  警告: 只能使用一个触觉设备" << std::endl;
-            g_hHD2 = HD_INVALID_HANDLE;
-        }
+/*******************************************************************************
+ 按 collision.enabled 创建双臂防碰撞检查（需要至少两台机械臂和UDP主动上报的关节角度）
+ 机械臂基座在共同世界坐标系中的位姿取自 [robotN] base_x/base_y/base_z（毫米）和
+ base_rx/base_ry/base_rz（度），工具偏移与关节空间模式相同（deviceN.ik_tool_offset_*）
+*******************************************************************************/
+ArmCollisionGuard* createCollisionGuard()
+{
+    if (!g_config->getBool("collision.enabled", false)) {
+        return nullptr;
     }
-    
-    if (g_hHD2 != HD_INVALID_HANDLE) {
-        hdMakeCurrentDevice(g_hHD2);
-        std::cout << "✅ 发现触觉设备2: " << hdGetString(HD_DEVICE_MODEL_TYPE) 
-                  << " (序列号: " << hdGetString(HD_DEVICE_SERIAL_NUMBER) << ")" << std::endl;
+    if (g_armControllers.size() < 2) {
+        std::cout << "⚠️  双臂防碰撞需要至少两台机械臂，未启用" << std::endl;
+        return nullptr;
     }
-
-    // 步骤3: 为每个有效设备调度回调函数（参考官方示例的顺序）
-    std::cout << "步骤3: 配置设备回调函数..." << std::endl;
-    
-    if (g_hHD1 != HD_INVALID_HANDLE) {
-        hdMakeCurrentDevice(g_hHD1);
-        hCallback1 = hdScheduleAsynchronous(device1Callback, nullptr, HD_MAX_SCHEDULER_PRIORITY);
-        hdEnable(HD_FORCE_OUTPUT);
-        std::cout << "✅ 设备1回调函数已配置" << std::endl;
+    if (!g_armStateReceiver) {
+        std::cout << "⚠️  双臂防碰撞需要主动上报的关节角度（realtime_push.enabled），未启用" << std::endl;
+        return nullptr;
     }
-    
-    if (g_hHD2 != HD_INVALID_HANDLE) {
-        hdMakeCurrentDevice(g_hHD2);
-        hCallback2 = hdScheduleAsynchronous(device2Callback, nullptr, HD_MAX_SCHEDULER_PRIORITY);
-        hdEnable(HD_FORCE_OUTPUT);
-        std::cout << "✅ 设备2回调函数已配置" << std::endl;
-    }
-
-    // 步骤4: 启动调度器（参考官方示例，在所有设备初始化后统一启动）
-    std::cout << "步骤4: 启动触觉调度器..." << std::endl;
-    hdStartScheduler();
-
-    // 检查错误
-    if (HD_DEVICE_ERROR(error = hdGetError()))
-    {
-        hduPrintError(stderr, &error, "无法启动调度器");
-        std::cerr << "❌ 启动调度器失败!" << std::endl;
-        std::cerr << "请检查设备连接和权限" << std::endl;
-        return;
+    ArmCollisionGuard::Params params;
+    ArmKinematics::Model model;
+    if (!loadCollisionParams(params, model)) {
+        return nullptr;
     }
-    
-    std::cout << "✅ 触觉调度器启动成功" << std::endl;
-    
-    // 显示最终状态摘要
-    std::cout << "\n=== 设备初始化完成 ===" << std::endl;
-    std::cout << "活跃设备数量: " << ((g_hHD1 != HD_INVALID_HANDLE ? 1 : 0) + (g_hHD2 != HD_INVALID_HANDLE ? 1 : 0)) << std::endl;
-    if (g_hHD1 != HD_INVALID_HANDLE) {
-        std::cout << "  设备1: 已连接并激活" << std::endl;
+    size_t armCount = g_armControllers.size();
+    if (armCount > static_cast<size_t>(ArmCollisionGuard::kMaxArms)) {
+        std::cout << "⚠️  双臂防碰撞最多支持 " << ArmCollisionGuard::kMaxArms << " 台机械臂，其余不参与检查" << std::endl;
+        armCount = ArmCollisionGuard::kMaxArms;
     }
-    if (g_hHD2 != HD_INVALID_HANDLE) {
-        std::cout << "  设备2: 已连接并激活" << std::endl;
+
+    ArmCollisionGuard* guard = new ArmCollisionGuard(params);
+    for (size_t i = 0; i < armCount; ++i) {
+        std::string robotSection = "robot" + std::to_string(i + 1);
+        std::string deviceSection = "device" + std::to_string(i + 1);
+        ArmCollisionGuard::Mount mount = {
+            {g_config->getDouble(robotSection + ".base_x", 0.0), g_config->getDouble(robotSection + ".base_y", 0.0),
+             g_config->getDouble(robotSection + ".base_z", 0.0)},
+            {g_config->getDouble(robotSection + ".base_rx", 0.0), g_config->getDouble(robotSection + ".base_ry", 0.0),
+             g_config->getDouble(robotSection + ".base_rz", 0.0)}
+        };
+        double toolOffset[3] = {g_config->getDouble(deviceSection + ".ik_tool_offset_x", 0.0),
+                                g_config->getDouble(deviceSection + ".ik_tool_offset_y", 0.0),
+                                g_config->getDouble(deviceSection + ".ik_tool_offset_z", 0.0)};
+        ArmController* arm = g_armControllers[i];
+        guard->registerArm(static_cast<int>(i), model, toolOffset, mount, [arm](ArmRealtimeState& state) {
+            return arm->readArmState(state);
+        });
+        g_touchArmControllers[i]->setCollisionGuard(guard, static_cast<int>(i));
+        std::cout << "  机械臂" << (i + 1) << " 基座: [" << mount.position[0] << ", " << mount.position[1] << ", "
+                  << mount.position[2] << "] mm, [" << mount.rotationDeg[0] << ", " << mount.rotationDeg[1] << ", "
+                  << mount.rotationDeg[2] << "] deg" << std::endl;
     }
-    std::cout << "============================\n" << std::endl;
+    std::cout << "✅ 双臂防碰撞: " << armCount << " 台 " << model.name << ", 安全距离 " << params.marginMm
+              << "mm, 连杆/末端半径 " << params.linkRadiusMm << "/" << params.toolRadiusMm << "mm" << std::endl;
+    return guard;
 }
 
 /*******************************************************************************
- 设备1回调函数
+ 启动耗时：每台机械臂的连接/上电/设置各阶段，以及末端执行器初始化
 *******************************************************************************/
-HDCallbackCode HDCALLBACK device1Callback(void *data)
+void printStartupTimings(double totalMs, double endEffectorMs)
 {
-    if (g_hHD1 == HD_INVALID_HANDLE || !g_touchArmController1) {
-        return HD_CALLBACK_CONTINUE;
+    std::cout << "\n=== 启动耗时 ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < g_armControllers.size(); ++i) {
+        ArmController* arm = g_armControllers[i];
+        std::cout << "机械臂" << (i + 1) << " " << arm->getRobotIP() << " (" << arm->getTransportName() << "): ";
+        ArmSetupTimings timings;
+        if (!arm->getSetupTimings(timings)) {
+            std::cout << (arm->isConnected() ? "设置中" : "未连接") << "（后台继续）" << std::endl;
+            continue;
+        }
+        std::cout << "连接 " << timings.connectNs / 1e6 << "ms, 上电确认 " << timings.powerNs / 1e6 << "ms";
+        if (timings.powerAttempts > 1) {
+            std::cout << "(" << timings.powerAttempts << "次)";
+        }
+        std::cout << ", 设置确认 " << timings.configureNs / 1e6 << "ms [";
+        for (int step = 0; step < timings.stepCount; ++step) {
+            std::cout << (step ? ", " : "") << timings.stepNames[step] << " " << timings.stepNs[step] / 1e6 << "ms"
+                      << (timings.stepOk[step] ? "" : "(未确认)");
+        }
+        std::cout << "], 就绪 " << (timings.connectNs + timings.totalNs) / 1e6 << "ms" << std::endl;
     }
+    std::cout << "末端执行器初始化: " << endEffectorMs << "ms（与机械臂设置并行）" << std::endl;
+    std::cout << "启动总耗时: " << totalMs << "ms" << std::endl;
+}
 
+/*******************************************************************************
+ 按名称初始化触觉设备，主名称失败时依次尝试逗号分隔的备用名称
+*******************************************************************************/
+static HHD initDeviceByName(const std::string& primary, const std::string& fallbacks)
+{
     HDErrorInfo error;
-    hduVector3Dd position;
-    HDdouble transform[16];
-    int buttons;
-
-    hdBeginFrame(g_hHD1);
-
-    // 获取当前位置和姿态
-    hdGetDoublev(HD_CURRENT_POSITION, position);
-    hdGetDoublev(HD_CURRENT_TRANSFORM, transform);
-    hdGetIntegerv(HD_CURRENT_BUTTONS, &buttons);
-
-    // 转换格式
-    std::array<double, 3> pos = {position[0], position[1], position[2]};
-    std::array<double, 16> transformArray;
-    for (int i = 0; i < 16; i++) {
-        transformArray[i] = transform[i];
-    }
-
-    // 检测按钮状态
-    bool button1Pressed = (buttons & HD_DEVICE_BUTTON_1) != 0;
-    bool button2Pressed = (buttons & HD_DEVICE_BUTTON_2) != 0;
-    static bool lastButton1Pressed = false;
-    static bool lastButton2Pressed = false;
-    
-    // 按钮1控制机械臂1位置姿态
-    if (button1Pressed != lastButton1Pressed) {
-        if (button1Pressed) {
-            g_touchArmController1->onButtonDown(pos, transformArray);
-        } else {
-            g_touchArmController1->onButtonUp();
-        }
+
+    HHD hHD = hdInitDevice(primary.c_str());
+    if (!HD_DEVICE_ERROR(error = hdGetError())) {
+        return hHD;
     }
-    
-    // 按钮2控制机械臂1夹抓
-    if (button2Pressed != lastButton2Pressed) {
-        if (button2Pressed) {
-            g_touchArmController1->onGripperButtonPressed();
+
+    std::cout << "   " << primary << "未找到，尝试备用设备..." << std::endl;
+    hdGetError(); // 清除错误
+
+    // 解析备用设备名称列表（逗号分隔）
+    std::istringstream fallbackStream(fallbacks);
+    std::string deviceName;
+
+    while (std::getline(fallbackStream, deviceName, ',')) {
+        // 移除前后空格
+        deviceName.erase(0, deviceName.find_first_not_of(" \t"));
+        deviceName.erase(deviceName.find_last_not_of(" \t") + 1);
+
+        if (!deviceName.empty()) {
+            std::cout << "   尝试设备名称: " << deviceName << std::endl;
+            if (deviceName == "Default Device") {
+                hHD = hdInitDevice(HD_DEFAULT_DEVICE);
+            } else {
+                hHD = hdInitDevice(deviceName.c_str());
+            }
+            if (!HD_DEVICE_ERROR(error = hdGetError())) {
+                return hHD; // 成功找到设备
+            }
+            hdGetError(); // 清除错误，继续尝试下一个
         }
     }
-    
-    // 更新机械臂1控制
-    g_touchArmController1->update(pos, transformArray);
-    
-    lastButton1Pressed = button1Pressed;
-    lastButton2Pressed = button2Pressed;
 
-    // 应用弹簧力反馈
-    hduVector3Dd force = {0.0, 0.0, 0.0};
-    
-    if (g_touchArmController1->isDragging()) {
-        // 计算指向锚点的弹簧力
-        std::array<double, 3> touchAnchor = g_touchArmController1->getTouchAnchor();
-        double springStiffness = g_touchArmController1->getSpringStiffness();
-        
-        force[0] = springStiffness * (touchAnchor[0] - pos[0]);
-        force[1] = springStiffness * (touchAnchor[1] - pos[1]);
-        force[2] = springStiffness * (touchAnchor[2] - pos[2]);
-        
-        // 力限制
-        HDdouble forceClamp;
-        hdGetDoublev(HD_NOMINAL_MAX_CONTINUOUS_FORCE, &forceClamp);
-        
-        double forceMagnitude = sqrt(force[0]*force[0] + force[1]*force[1] + force[2]*force[2]);
-        
-        if (forceMagnitude > forceClamp) {
-            if (forceMagnitude > 0.0) {
-                double scale = forceClamp / forceMagnitude;
-                force[0] *= scale;
-                force[1] *= scale;
-                force[2] *= scale;
-            }
+    hduPrintError(stderr, &error, ("无法初始化设备 " + primary).c_str());
+    return HD_INVALID_HANDLE;
+}
+
+/*******************************************************************************
+ 初始化所有触觉设备
+*******************************************************************************/
+void initializeDevices()
+{
+    HDErrorInfo error;
+
+    std::cout << "=== 初始化触觉设备 ===" << std::endl;
+
+    // 参考官方HelloSphereDual.cpp示例的标准初始化流程
+    // 重要：所有设备实例需要在启动调度器之前创建
+    for (size_t i = 0; i < g_touchArmControllers.size(); ++i) {
+        int index = static_cast<int>(i + 1);
+        std::string name = "device" + std::to_string(index);
+
+        // 从配置文件读取设备名称
+        std::string defaultFallback = (index == 1) ? "Default Device" :
+                                      (index == 2) ? "Device1,PHANTOM 2,PHANToM Device 2" : "";
+        std::string primary = g_config->getString("device_names." + name + "_primary", "PHANToM " + std::to_string(index));
+        std::string fallbacks = g_config->getString("device_names." + name + "_fallback", defaultFallback);
+        int buttonCount = g_config->getInt(name + ".button_count", 2);
+
+        std::cout << "步骤" << index << ": 初始化设备" << index << " (" << primary << ")..." << std::endl;
+        HHD hHD = initDeviceByName(primary, fallbacks);
+        if (hHD == HD_INVALID_HANDLE) {
+            std::cout << "⚠️  警告: 设备" << index << "不可用" << std::endl;
+            continue;
         }
+
+        hdMakeCurrentDevice(hHD);
+        std::cout << "✅ 发现触觉设备" << index << ": " << hdGetString(HD_DEVICE_MODEL_TYPE)
+                  << " (序列号: " << hdGetString(HD_DEVICE_SERIAL_NUMBER) << ")" << std::endl;
+
+        DeviceChannel* channel = new DeviceChannel(index, name, hHD, g_touchArmControllers[i], buttonCount);
+        channel->queryCapabilities();
+        g_servoTiming->setChannelName(static_cast<int>(g_deviceChannels.size()), name);
+        g_deviceChannels.push_back(channel);
     }
-    
-    hdSetDoublev(HD_CURRENT_FORCE, force);
-    hdEndFrame(g_hHD1);
 
+    if (g_deviceChannels.empty()) {
+        std::cerr << "❌ 没有可用的触觉设备" << std::endl;
+        return;
+    }
+
+    // 为所有设备启用力输出，并调度一个统一的伺服回调
+    std::cout << "配置设备回调函数..." << std::endl;
+    for (size_t i = 0; i < g_deviceChannels.size(); ++i) {
+        hdMakeCurrentDevice(g_deviceChannels[i]->getHandle());
+        hdEnable(HD_FORCE_OUTPUT);
+    }
+    hdScheduleAsynchronous(servoLoopCallback, nullptr, HD_MAX_SCHEDULER_PRIORITY);
+    std::cout << "✅ 统一伺服回调已配置 (" << g_deviceChannels.size() << "个设备通道)" << std::endl;
+
+    // 启动调度器（参考官方示例，在所有设备初始化后统一启动）
+    std::cout << "启动触觉调度器..." << std::endl;
+    hdStartScheduler();
+
+    // 检查错误
     if (HD_DEVICE_ERROR(error = hdGetError()))
     {
-        hduPrintError(stderr, &error, "设备1回调错误");
-        if (hduIsSchedulerError(&error))
-            return HD_CALLBACK_DONE;
+        hduPrintError(stderr, &error, "无法启动调度器");
+        std::cerr << "❌ 启动调度器失败!" << std::endl;
+        std::cerr << "请检查设备连接和权限" << std::endl;
+        return;
     }
 
-    return HD_CALLBACK_CONTINUE;
+    std::cout << "✅ 触觉调度器启动成功" << std::endl;
+
+    // 显示最终状态摘要
+    std::cout << "\n=== 设备初始化完成 ===" << std::endl;
+    std::cout << "活跃设备数量: " << g_deviceChannels.size() << std::endl;
+    for (size_t i = 0; i < g_deviceChannels.size(); ++i) {
+        std::cout << "  设备" << g_deviceChannels[i]->getIndex() << ": 已连接并激活" << std::endl;
+    }
+    std::cout << "============================\n" << std::endl;
 }
 
 /*******************************************************************************
- 设备2回调函数
+ 统一伺服回调：参考CoulombForceDual示例，先开始所有设备的帧并采样，
+ 再逐个设备处理控制、输出力并结束帧
 *******************************************************************************/
-HDCallbackCode HDCALLBACK device2Callback(void *data)
+HDCallbackCode HDCALLBACK servoLoopCallback(void * /*data*/)
 {
-    if (g_hHD2 == HD_INVALID_HANDLE || !g_touchArmController2) {
-        return HD_CALLBACK_CONTINUE;
-    }
+    const size_t count = g_deviceChannels.size();
+    uint64_t channelNs[ServoTimingMonitor::kMaxChannels] = {0};
 
-    HDErrorInfo error;
-    hduVector3Dd position;
-    HDdouble transform[16];
-    int buttons;
-
-    hdBeginFrame(g_hHD2);
-
-    // 获取当前位置和姿态
-    hdGetDoublev(HD_CURRENT_POSITION, position);
-    hdGetDoublev(HD_CURRENT_TRANSFORM, transform);
-    hdGetIntegerv(HD_CURRENT_BUTTONS, &buttons);
-
-    // 转换格式
-    std::array<double, 3> pos = {position[0], position[1], position[2]};
-    std::array<double, 16> transformArray;
-    for (int i = 0; i < 16; i++) {
-        transformArray[i] = transform[i];
-    }
-
-    // 检测按钮状态
-    bool button1Pressed = (buttons & HD_DEVICE_BUTTON_1) != 0;
-    bool button2Pressed = (buttons & HD_DEVICE_BUTTON_2) != 0;
-    static bool lastButton1Pressed = false;
-    static bool lastButton2Pressed = false;
-    
-    // 按钮1控制机械臂2位置姿态
-    if (button1Pressed != lastButton1Pressed) {
-        if (button1Pressed) {
-            g_touchArmController2->onButtonDown(pos, transformArray);
-        } else {
-            g_touchArmController2->onButtonUp();
-        }
-    }
-    
-    // 按钮2控制机械臂2夹抓
-    if (button2Pressed != lastButton2Pressed) {
-        if (button2Pressed) {
-            g_touchArmController2->onGripperButtonPressed();
+    // 首个节拍为伺服线程分配日志缓冲，之后只是线程局部指针检查
+    BinaryLogger::instance().prepareThread();
+
+    g_servoTiming->beginTick();
+
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t start = ServoTimingMonitor::nowNs();
+        g_deviceChannels[i]->beginFrame();
+        if (i < ServoTimingMonitor::kMaxChannels) {
+            channelNs[i] = ServoTimingMonitor::nowNs() - start;
         }
     }
-    
-    // 更新机械臂2控制
-    g_touchArmController2->update(pos, transformArray);
-    
-    lastButton1Pressed = button1Pressed;
-    lastButton2Pressed = button2Pressed;
 
-    // 应用弹簧力反馈
-    hduVector3Dd force = {0.0, 0.0, 0.0};
-    
-    if (g_touchArmController2->isDragging()) {
-        // 计算指向锚点的弹簧力
-        std::array<double, 3> touchAnchor = g_touchArmController2->getTouchAnchor();
-        double springStiffness = g_touchArmController2->getSpringStiffness();
-        
-        force[0] = springStiffness * (touchAnchor[0] - pos[0]);
-        force[1] = springStiffness * (touchAnchor[1] - pos[1]);
-        force[2] = springStiffness * (touchAnchor[2] - pos[2]);
-        
-        // 力限制
-        HDdouble forceClamp;
-        hdGetDoublev(HD_NOMINAL_MAX_CONTINUOUS_FORCE, &forceClamp);
-        
-        double forceMagnitude = sqrt(force[0]*force[0] + force[1]*force[1] + force[2]*force[2]);
-        
-        if (forceMagnitude > forceClamp) {
-            if (forceMagnitude > 0.0) {
-                double scale = forceClamp / forceMagnitude;
-                force[0] *= scale;
-                force[1] *= scale;
-                force[2] *= scale;
-            }
+    HDdouble updateRate = 0.0;
+    hdGetDoublev(HD_INSTANTANEOUS_UPDATE_RATE, &updateRate);
+    g_servoTiming->setUpdateRate(updateRate);
+
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t start = ServoTimingMonitor::nowNs();
+        ok = g_deviceChannels[i]->endFrame() && ok;
+        if (i < ServoTimingMonitor::kMaxChannels) {
+            g_servoTiming->recordChannel(static_cast<int>(i), channelNs[i] + ServoTimingMonitor::nowNs() - start);
         }
     }
-    
-    hdSetDoublev(HD_CURRENT_FORCE, force);
-    hdEndFrame(g_hHD2);
 
-    if (HD_DEVICE_ERROR(error = hdGetError()))
-    {
-        hduPrintError(stderr, &error, "设备2回调错误");
-        if (hduIsSchedulerError(&error))
-            return HD_CALLBACK_DONE;
-    }
+    g_servoTiming->endTick(hdGetSchedulerTimeStamp());
 
-    return HD_CALLBACK_CONTINUE;
+    return ok ? HD_CALLBACK_CONTINUE : HD_CALLBACK_DONE;
 }
 
 /*******************************************************************************
@@ -2097,29 +3073,70 @@ void cleanupDevices()
     hdStopScheduler();
 
     // 禁用设备
-    if (g_hHD1 != HD_INVALID_HANDLE) {
-        hdDisableDevice(g_hHD1);
+    for (size_t i = 0; i < g_deviceChannels.size(); ++i) {
+        hdDisableDevice(g_deviceChannels[i]->getHandle());
+        delete g_deviceChannels[i];
+    }
+    g_deviceChannels.clear();
+
+    // 输出伺服回调时序统计
+    if (g_servoTiming) {
+        g_servoTiming->stopReporter();
+        std::cout << std::endl;
+        g_servoTiming->printReport(std::cout);
+        delete g_servoTiming;
+        g_servoTiming = nullptr;
+    }
+
+    // 输出指令管线统计
+    std::cout << "\n=== 指令管线统计 ===" << std::endl;
+    for (size_t i = 0; i < g_armControllers.size(); ++i) {
+        g_armControllers[i]->printPipelineStats();
+    }
+    if (g_armReactor) {
+        g_armReactor->printStats(std::cout);
     }
-    if (g_hHD2 != HD_INVALID_HANDLE) {
-        hdDisableDevice(g_hHD2);
+    printRealtimePushStats();
+    for (size_t i = 0; i < g_touchArmControllers.size(); ++i) {
+        g_touchArmControllers[i]->printClutchLatencyStats();
+        g_touchArmControllers[i]->printCommandRateStats();
+    }
+    if (g_collisionGuard) {
+        g_collisionGuard->printStats(std::cout);
     }
 
     // 保存配置文件
     std::cout << "\n=== 保存配置文件 ===" << std::endl;
-    if (g_touchArmController1) {
-        g_touchArmController1->saveConfig();
+    if (!g_touchArmControllers.empty()) {
+        g_touchArmControllers[0]->saveConfig();
     }
-    
+
+    // 先停止接收线程，避免发布回调访问已释放的机械臂控制器
+    if (g_armStateReceiver) {
+        delete g_armStateReceiver;
+        g_armStateReceiver = nullptr;
+    }
+
+    // 停止反应器线程，之后不会再回调机械臂控制器（连接由控制器析构时关闭）
+    if (g_armReactor) {
+        g_armReactor->stop();
+    }
+
     // 清理内存
-    delete g_touchArmController1;
-    delete g_touchArmController2;
-    delete g_armController1;
-    delete g_armController2;
-    
-    g_touchArmController1 = nullptr;
-    g_touchArmController2 = nullptr;
-    g_armController1 = nullptr;
-    g_armController2 = nullptr;
+    for (size_t i = 0; i < g_touchArmControllers.size(); ++i) {
+        delete g_touchArmControllers[i];
+    }
+    delete g_collisionGuard;
+    g_collisionGuard = nullptr;
+    for (size_t i = 0; i < g_armControllers.size(); ++i) {
+        delete g_armControllers[i];
+    }
+    g_touchArmControllers.clear();
+    g_armControllers.clear();
+    if (g_armReactor) {
+        delete g_armReactor;
+        g_armReactor = nullptr;
+    }
 
 #ifdef USE_ROS2
     // 清理ROS2
@@ -2130,109 +3147,101 @@ void cleanupDevices()
 #endif
 }
 
+/*******************************************************************************
+ 当前选择设备的控制器
+*******************************************************************************/
+TouchArmController* selectedController()
+{
+    if (g_selectedDevice < 1 || g_selectedDevice > static_cast<int>(g_touchArmControllers.size())) {
+        return nullptr;
+    }
+    return g_touchArmControllers[g_selectedDevice - 1];
+}
+
 /*******************************************************************************
  键盘输入处理
 *******************************************************************************/
 void handleKeyboard()
 {
     int key = getch();
-    
+    TouchArmController* controller = selectedController();
+
+    // 数字键选择设备
+    if (key >= '1' && key <= '9') {
+        int device = key - '0';
+        if (device <= static_cast<int>(g_touchArmControllers.size())) {
+            g_selectedDevice = device;
+            std::cout << "已选择设备" << g_selectedDevice << std::endl;
+        }
+        return;
+    }
+
     switch (key)
     {
         case 'q':
         case 'Q':
             g_applicationRunning = false;
             break;
-            
-        case '1':
-            g_selectedDevice = 1;
-            break;
-            
-        case '2':
-            g_selectedDevice = 2;
-            break;
-            
+
         case '+':
         case '=':
-            if (g_selectedDevice == 1) {
-                g_touchArmController1->setPositionScale(g_touchArmController1->getPositionScale() + 100.0);
-            } else if (g_selectedDevice == 2) {
-                g_touchArmController2->setPositionScale(g_touchArmController2->getPositionScale() + 100.0);
+            if (controller) {
+                controller->setPositionScale(controller->getPositionScale() + 100.0);
             }
             break;
-            
+
         case '-':
         case '_':
-            if (g_selectedDevice == 1) {
-                double newScale = g_touchArmController1->getPositionScale() - 100.0;
-                if (newScale > 0.0) {  // 防止设置为负值
-                    g_touchArmController1->setPositionScale(newScale);
-                }
-            } else if (g_selectedDevice == 2) {
-                double newScale = g_touchArmController2->getPositionScale() - 100.0;
+            if (controller) {
+                double newScale = controller->getPositionScale() - 100.0;
                 if (newScale > 0.0) {  // 防止设置为负值
-                    g_touchArmController2->setPositionScale(newScale);
+                    controller->setPositionScale(newScale);
                 }
             }
             break;
-            
+
         case '[':
-            if (g_selectedDevice == 1) {
-                double newScale = g_touchArmController1->getRotationScale() - 0.1;
-                if (newScale > 0.0) {  // 防止设置为负值
-                    g_touchArmController1->setRotationScale(newScale);
-                }
-            } else if (g_selectedDevice == 2) {
-                double newScale = g_touchArmController2->getRotationScale() - 0.1;
+            if (controller) {
+                double newScale = controller->getRotationScale() - 0.1;
                 if (newScale > 0.0) {  // 防止设置为负值
-                    g_touchArmController2->setRotationScale(newScale);
+                    controller->setRotationScale(newScale);
                 }
             }
             break;
-            
+
         case ']':
-            if (g_selectedDevice == 1) {
-                g_touchArmController1->setRotationScale(g_touchArmController1->getRotationScale() + 0.1);
-            } else if (g_selectedDevice == 2) {
-                g_touchArmController2->setRotationScale(g_touchArmController2->getRotationScale() + 0.1);
+            if (controller) {
+                controller->setRotationScale(controller->getRotationScale() + 0.1);
             }
             break;
-            
+
         case '{':
-            if (g_selectedDevice == 1) {
-                g_touchArmController1->setSpringStiffness(g_touchArmController1->getSpringStiffness() * 0.9);
-            } else if (g_selectedDevice == 2) {
-                g_touchArmController2->setSpringStiffness(g_touchArmController2->getSpringStiffness() * 0.9);
+            if (controller) {
+                controller->setSpringStiffness(controller->getSpringStiffness() * 0.9);
             }
             break;
-            
+
         case '}':
-            if (g_selectedDevice == 1) {
-                g_touchArmController1->setSpringStiffness(g_touchArmController1->getSpringStiffness() * 1.1);
-            } else if (g_selectedDevice == 2) {
-                g_touchArmController2->setSpringStiffness(g_touchArmController2->getSpringStiffness() * 1.1);
+            if (controller) {
+                controller->setSpringStiffness(controller->getSpringStiffness() * 1.1);
             }
             break;
-            
+
         case 's':
         case 'S':
-            if (g_selectedDevice == 1) {
-                g_touchArmController1->queryCurrentArmState();
-            } else if (g_selectedDevice == 2) {
-                g_touchArmController2->queryCurrentArmState();
+            if (controller) {
+                controller->queryCurrentArmState();
             }
             break;
-            
+
         case 'c':
         case 'C':
             std::cout << "\n=== 保存配置到文件 ===" << std::endl;
-            if (g_selectedDevice == 1) {
-                g_touchArmController1->saveConfig();
-            } else if (g_selectedDevice == 2) {
-                g_touchArmController2->saveConfig();
+            if (controller) {
+                controller->saveConfig();
             }
             break;
-            
+
         case 'f':
         case 'F':
             {
@@ -2240,56 +3249,71 @@ void handleKeyboard()
                 int currentFrameType = g_config->getInt("system.teach_frame_type", 1);
                 int newFrameType = (currentFrameType == 0) ? 1 : 0;
                 g_config->setInt("system.teach_frame_type", newFrameType);
-                
+
                 std::cout << "\n=== 切换坐标系类型 ===" << std::endl;
-                std::cout << "从 " << (currentFrameType == 0 ? "基坐标系" : "工具坐标系") 
+                std::cout << "从 " << (currentFrameType == 0 ? "基坐标系" : "工具坐标系")
                           << " 切换为 " << (newFrameType == 0 ? "基坐标系" : "工具坐标系") << std::endl;
                 std::cout << "注意: 需要重启程序才能生效，影响所有设备" << std::endl;
                 std::cout << "========================\n" << std::endl;
             }
             break;
-            
+
+        case 'p':
+        case 'P':
+            std::cout << "\n=== 指令管线统计 ===" << std::endl;
+            for (size_t i = 0; i < g_armControllers.size(); ++i) {
+                g_armControllers[i]->printPipelineStats();
+            }
+            if (g_armReactor) {
+                g_armReactor->printStats(std::cout);
+            }
+            printRealtimePushStats();
+            for (size_t i = 0; i < g_touchArmControllers.size(); ++i) {
+                g_touchArmControllers[i]->printClutchLatencyStats();
+                g_touchArmControllers[i]->printCommandRateStats();
+            }
+            if (g_collisionGuard) {
+                g_collisionGuard->printStats(std::cout);
+            }
+            std::cout << "日志丢弃记录数: " << BinaryLogger::instance().getDropCount() << std::endl;
+            std::cout << "====================\n" << std::endl;
+            break;
+
+        case 't':
+        case 'T':
+            if (g_servoTiming) {
+                std::cout << std::endl;
+                g_servoTiming->printReport(std::cout);
+                std::cout << std::endl;
+            }
+            break;
+
         case 'm':
         case 'M':
             {
                 // 显示当前坐标映射配置
                 std::cout << "\n=== 当前坐标映射配置 ===" << std::endl;
-                
-                // 显示设备1配置
-                std::cout << "设备1 (device1_mapping):" << std::endl;
-                std::cout << "  位置映射: [" 
-                          << g_config->getInt("device1_mapping.touch_pos_to_arm_x", 2) << "→X, "
-                          << g_config->getInt("device1_mapping.touch_pos_to_arm_y", 0) << "→Y, "
-                          << g_config->getInt("device1_mapping.touch_pos_to_arm_z", 1) << "→Z]" << std::endl;
-                std::cout << "  姿态映射: [" 
-                          << g_config->getInt("device1_mapping.touch_rot_to_arm_rx", 2) << "→RX, "
-                          << g_config->getInt("device1_mapping.touch_rot_to_arm_ry", 0) << "→RY, "
-                          << g_config->getInt("device1_mapping.touch_rot_to_arm_rz", 1) << "→RZ]" << std::endl;
-                std::cout << "  符号调整: [" 
-                          << g_config->getInt("device1_mapping.arm_x_sign", -1) << ", "
-                          << g_config->getInt("device1_mapping.arm_y_sign", -1) << ", "
-                          << g_config->getInt("device1_mapping.arm_z_sign", 1) << ", "
-                          << g_config->getInt("device1_mapping.arm_rx_sign", -1) << ", "
-                          << g_config->getInt("device1_mapping.arm_ry_sign", -1) << ", "
-                          << g_config->getInt("device1_mapping.arm_rz_sign", 1) << "]" << std::endl;
-                
-                std::cout << "\n设备2 (device2_mapping):" << std::endl;
-                std::cout << "  位置映射: [" 
-                          << g_config->getInt("device2_mapping.touch_pos_to_arm_x", 0) << "→X, "
-                          << g_config->getInt("device2_mapping.touch_pos_to_arm_y", 1) << "→Y, "
-                          << g_config->getInt("device2_mapping.touch_pos_to_arm_z", 2) << "→Z]" << std::endl;
-                std::cout << "  姿态映射: [" 
-                          << g_config->getInt("device2_mapping.touch_rot_to_arm_rx", 0) << "→RX, "
-                          << g_config->getInt("device2_mapping.touch_rot_to_arm_ry", 1) << "→RY, "
-                          << g_config->getInt("device2_mapping.touch_rot_to_arm_rz", 2) << "→RZ]" << std::endl;
-                std::cout << "  符号调整: [" 
-                          << g_config->getInt("device2_mapping.arm_x_sign", 1) << ", "
-                          << g_config->getInt("device2_mapping.arm_y_sign", 1) << ", "
-                          << g_config->getInt("device2_mapping.arm_z_sign", -1) << ", "
-                          << g_config->getInt("device2_mapping.arm_rx_sign", 1) << ", "
-                          << g_config->getInt("device2_mapping.arm_ry_sign", 1) << ", "
-                          << g_config->getInt("device2_mapping.arm_rz_sign", -1) << "]" << std::endl;
-                          
+
+                for (size_t i = 0; i < g_touchArmControllers.size(); ++i) {
+                    std::string prefix = "device" + std::to_string(i + 1) + "_mapping";
+                    std::cout << "设备" << (i + 1) << " (" << prefix << "):" << std::endl;
+                    std::cout << "  位置映射: ["
+                              << g_config->getInt(prefix + ".touch_pos_to_arm_x", 2) << "→X, "
+                              << g_config->getInt(prefix + ".touch_pos_to_arm_y", 0) << "→Y, "
+                              << g_config->getInt(prefix + ".touch_pos_to_arm_z", 1) << "→Z]" << std::endl;
+                    std::cout << "  姿态映射: ["
+                              << g_config->getInt(prefix + ".touch_rot_to_arm_rx", 2) << "→RX, "
+                              << g_config->getInt(prefix + ".touch_rot_to_arm_ry", 0) << "→RY, "
+                              << g_config->getInt(prefix + ".touch_rot_to_arm_rz", 1) << "→RZ]" << std::endl;
+                    std::cout << "  符号调整: ["
+                              << g_config->getInt(prefix + ".arm_x_sign", 1) << ", "
+                              << g_config->getInt(prefix + ".arm_y_sign", 1) << ", "
+                              << g_config->getInt(prefix + ".arm_z_sign", 1) << ", "
+                              << g_config->getInt(prefix + ".arm_rx_sign", -1) << ", "
+                              << g_config->getInt(prefix + ".arm_ry_sign", -1) << ", "
+                              << g_config->getInt(prefix + ".arm_rz_sign", 1) << "]" << std::endl;
+                }
+
                 std::cout << "\n说明:" << std::endl;
                 std::cout << "  位置映射: 触觉设备轴索引(0=X,1=Y,2=Z) → 机械臂轴" << std::endl;
                 std::cout << "  姿态映射: 触觉设备旋转轴索引(0=RX,1=RY,2=RZ) → 机械臂旋转轴" << std::endl;
@@ -2297,7 +3321,7 @@ void handleKeyboard()
                 std::cout << "==========================\n" << std::endl;
             }
             break;
-            
+
         default:
             break;
     }
@@ -2308,16 +3332,17 @@ void handleKeyboard()
 *******************************************************************************/
 void printInstructions()
 {
-    printf("=== 双设备操作说明 ===\n");
-    printf("设备1 (触觉设备1): 控制机械臂1\n");
-    printf("  按钮1: 控制机械臂1位置和姿态\n");
-    printf("  按钮2: 控制机械臂1夹抓 (切换开/关)\n");
-    printf("设备2 (触觉设备2): 控制机械臂2\n");
-    printf("  按钮1: 控制机械臂2位置和姿态\n");
-    printf("  按钮2: 控制机械臂2夹抓 (切换开/关)\n");
+    const int deviceCount = static_cast<int>(g_touchArmControllers.size());
+
+    printf("=== 多设备操作说明 ===\n");
+    for (int i = 1; i <= deviceCount; ++i) {
+        printf("设备%d (触觉设备%d): 控制机械臂%d\n", i, i, i);
+        printf("  按钮1: 控制机械臂%d位置和姿态\n", i);
+        printf("  按钮2: 控制机械臂%d夹抓 (切换开/关)\n", i);
+    }
     printf("\n");
     printf("键盘控制 (实时调整):\n");
-    printf("  '1'/'2': 选择调整设备1或设备2的参数 (当前: 设备%d)\n", g_selectedDevice);
+    printf("  '1'~'%d': 选择要调整参数的设备 (当前: 设备%d)\n", deviceCount, g_selectedDevice);
     printf("  '+'/'-': 调整当前选择设备的位置映射系数\n");
     printf("  '['/']': 调整当前选择设备的姿态映射系数\n");
     printf("  '{'/'}': 调整当前选择设备的弹簧刚度\n");
@@ -2325,25 +3350,20 @@ void printInstructions()
     printf("  'c': 保存当前选择设备的配置到文件\n");
     printf("  'f': 切换坐标系类型 (基坐标系/工具坐标系)\n");
     printf("  'm': 显示当前坐标映射配置\n");
+    printf("  'p': 显示机械臂指令管线统计 (深度/丢弃/延迟)、离合延迟和指令发送频率\n");
+    printf("  't': 显示伺服回调时序统计 (周期/占空 p50/p99/p99.9/max 和超限次数)\n");
     printf("  'q': 退出程序 (自动保存所有配置)\n");
     printf("\n");
     printf("当前参数设置:\n");
-    if (g_touchArmController1) {
-        printf("  设备1 - 位置映射: %.2f, 姿态映射: %.3f, 弹簧刚度: %.3f\n", 
-               g_touchArmController1->getPositionScale(), 
-               g_touchArmController1->getRotationScale(),
-               g_touchArmController1->getSpringStiffness());
-    }
-    if (g_touchArmController2) {
-        printf("  设备2 - 位置映射: %.2f, 姿态映射: %.3f, 弹簧刚度: %.3f\n", 
-               g_touchArmController2->getPositionScale(), 
-               g_touchArmController2->getRotationScale(),
-               g_touchArmController2->getSpringStiffness());
+    for (int i = 0; i < deviceCount; ++i) {
+        printf("  设备%d - 位置映射: %.2f, 姿态映射: %.3f, 弹簧刚度: %.3f\n", i + 1,
+               g_touchArmControllers[i]->getPositionScale(),
+               g_touchArmControllers[i]->getRotationScale(),
+               g_touchArmControllers[i]->getSpringStiffness());
     }
     printf("\n");
-    printf("坐标轴映射 (支持两设备独立配置):\n");
-    printf("  设备1: 使用device1_mapping节配置\n");
-    printf("  设备2: 使用device2_mapping节配置\n");  
+    printf("坐标轴映射 (支持各设备独立配置):\n");
+    printf("  设备N: 使用deviceN_mapping节配置\n");
     printf("  默认位置: 触觉设备[Z,X,Y] → 机械臂[X,Y,Z]\n");
     printf("  默认姿态: 触觉设备[RZ,RX,RY] → 机械臂[-RX,-RY,RZ]\n");
     printf("  修改config.ini的device*_mapping节可自定义映射\n");
@@ -2351,11 +3371,1526 @@ void printInstructions()
     // 从配置文件读取坐标系信息进行显示
     int frameType = g_config->getInt("system.teach_frame_type", 1);
     std::string toolName = g_config->getString("system.tool_coordinate_name", "Arm_Tip");
-    
-    printf("控制模式: %s控制 (%s)\n", 
+
+    printf("控制模式: %s控制 (%s)\n",
            frameType == 0 ? "基坐标系" : "工具坐标系", toolName.c_str());
-    printf("设备状态: %s, %s\n",
-           g_hHD1 != HD_INVALID_HANDLE ? "设备1已连接" : "设备1未连接",
-           g_hHD2 != HD_INVALID_HANDLE ? "设备2已连接" : "设备2未连接");
+    printf("设备状态: %d/%d个触觉设备已连接\n",
+           static_cast<int>(g_deviceChannels.size()), deviceCount);
     printf("=======================================\n\n");
 }
+
+/*******************************************************************************
+ 打印UDP主动上报接收统计
+*******************************************************************************/
+void printRealtimePushStats()
+{
+    if (!g_armStateReceiver) {
+        return;
+    }
+    ArmStateReceiver::Stats stats = g_armStateReceiver->getStats();
+    std::cout << "[主动上报] 端口=" << g_armStateReceiver->getPort()
+              << ", 收到=" << stats.received
+              << ", 解析失败=" << stats.parseErrors
+              << ", 未知来源=" << stats.unknownSource;
+    for (size_t i = 0; i < g_armControllers.size(); ++i) {
+        std::cout << ", " << g_armControllers[i]->getRobotIP() << "="
+                  << g_armStateReceiver->getArmPacketCount(g_armControllers[i]->getRobotIP());
+    }
+    std::cout << std::endl;
+}
+
+/*******************************************************************************
+ 预测器离线回放：用录制的会话评估预测前后的跟踪误差
+*******************************************************************************/
+int runPredictorReplay(int argc, char* argv[])
+{
+    if (argc < 3) {
+        std::cerr << "用法: " << argv[0] << " --replay-predictor <会话CSV> [deviceN] [端到端延迟ms]" << std::endl;
+        return 1;
+    }
+    std::string sessionFile = argv[2];
+    std::string section = argc > 3 ? argv[3] : "device1";
+    double latencyMs = argc > 4 ? atof(argv[4]) : 50.0;
+
+    std::vector<MotionSample> samples;
+    if (!MotionPredictor::loadSession(sessionFile, samples)) {
+        std::cerr << "❌ 无法读取会话文件: " << sessionFile << std::endl;
+        return 1;
+    }
+
+    MotionPredictor::Params params;
+    TouchArmController::loadPredictorParams(g_config, section, params);
+
+    std::cout << "=== 预测器离线回放 ===" << std::endl;
+    std::cout << "会话: " << sessionFile << " (" << samples.size() << " 帧), 参数: [" << section
+              << "], 假设端到端延迟: " << latencyMs << "ms" << std::endl;
+
+    MotionPredictor::Report report;
+    std::cout << "当前配置 (" << MotionPredictor::modeName(params.mode)
+              << (params.adaptive ? ", 自适应" : "") << "):" << std::endl;
+    MotionPredictor::evaluate(samples, params, latencyMs, report);
+    MotionPredictor::printReport(std::cout, report);
+
+    // 扫描预测时长，便于选择 predictor_horizon_ms
+    const MotionPredictor::Mode modes[] = {MotionPredictor::Velocity, MotionPredictor::ConstantAcceleration};
+    for (int m = 0; m < 2; ++m) {
+        std::cout << MotionPredictor::modeName(modes[m]) << ":" << std::endl;
+        for (int step = 1; step <= 6; ++step) {
+            MotionPredictor::Params sweep = params;
+            sweep.mode = modes[m];
+            sweep.adaptive = false;
+            sweep.horizonMs = latencyMs * step / 4.0;
+            sweep.maxHorizonMs = sweep.horizonMs;
+            MotionPredictor::evaluate(samples, sweep, latencyMs, report);
+            MotionPredictor::printReport(std::cout, report);
+        }
+    }
+    return 0;
+}
+
+/*******************************************************************************
+ 坐标映射微基准：通用矩阵内核与轴置换专用内核
+*******************************************************************************/
+int runMappingBenchmark(int argc, char* argv[])
+{
+    uint64_t iterations = argc > 2 ? strtoull(argv[2], nullptr, 10) : 20000000ULL;
+    if (iterations == 0) {
+        std::cerr << "用法: " << argv[0] << " --bench-mapping [每种变换的调用次数]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "=== 坐标映射微基准 (" << iterations << " 次/变换) ===" << std::endl;
+    std::cout << "  左列为通用3x3矩阵内核，右列为按配置选择的内核" << std::endl;
+    bool consistent = true;
+
+    // 配置文件中各设备的实际映射
+    int deviceCount = g_config->getInt("system.device_count", 2);
+    for (int i = 1; i <= deviceCount; ++i) {
+        std::string device = "device" + std::to_string(i);
+        int positionSource[3], positionSign[3], rotationSource[3], rotationSign[3];
+        TouchArmController::loadAxisMappingConfig(g_config, device + "_mapping", positionSource, positionSign,
+                                                  rotationSource, rotationSign);
+        double positionScale = g_config->getDouble(device + ".position_scale", 1000.0);
+        std::string label = device + "位置";
+        AxisMapping::Vec3 noOffset = {{0.0, 0.0, 0.0}};
+        consistent &= AxisMapping::benchmark(std::cout, label.c_str(), positionSource, positionSign,
+                                             positionScale, noOffset, iterations);
+    }
+
+    // 全部6种轴置换（带符号翻转）以及轴索引重复时的通用内核
+    static const int kSources[7][3] = {
+        {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}, {0, 0, 1}
+    };
+    static const char* kLabels[7] = {"xyz", "xzy", "yxz", "yzx", "zxy", "zyx", "xxy(重复)"};
+    const int sign[3] = {-1, 1, -1};
+    AxisMapping::Vec3 offset = {{1500.0, -2500.0, 800.0}};
+    for (int i = 0; i < 7; ++i) {
+        consistent &= AxisMapping::benchmark(std::cout, kLabels[i], kSources[i], sign, 1000.0, offset, iterations);
+    }
+    return consistent ? 0 : 1;
+}
+
+// 旧版姿态映射的欧拉角提取（XYZ顺序，度），只用于 --bench-orientation 对比
+static OrientationMath::Vec3 legacyEulerDegrees(const std::array<double, 16>& transform)
+{
+    double pitch = std::asin(-transform[2]);
+    double roll, yaw;
+    if (std::cos(pitch) > 0.0001) {
+        roll = std::atan2(transform[6], transform[10]);
+        yaw = std::atan2(transform[1], transform[0]);
+    } else {
+        roll = std::atan2(-transform[9], transform[5]);
+        yaw = 0.0;
+    }
+    OrientationMath::Vec3 euler = {{roll * 180.0 / M_PI, pitch * 180.0 / M_PI, yaw * 180.0 / M_PI}};
+    return euler;
+}
+
+/*******************************************************************************
+ 姿态映射基准：旧版（逐帧欧拉角相减，差值逐分量加到机械臂锚点欧拉角上）与当前路径
+ （离合时转置锚点，每帧 R_cur * R_anchor^T 取旋转向量，发送节拍上左乘机械臂锚点姿态
+ 再转换回欧拉角）的单帧耗时，以及最终指令姿态与真实姿态 R(相对旋转) * R(机械臂锚点) 的夹角。
+ 触觉设备锚点为各轴±34°内的随机欧拉角，机械臂锚点 RX/RZ ±170°、RY ±60°，
+ 相对锚点的旋转为基坐标系中各分量±3°内的随机旋转向量；比较在双精度下进行（不含毫弧度取整）
+*******************************************************************************/
+int runOrientationBenchmark(int argc, char* argv[])
+{
+    int poses = argc > 2 ? atoi(argv[2]) : 200000;
+    if (poses < 1) {
+        std::cerr << "用法: " << argv[0] << " --bench-orientation [随机位姿数]" << std::endl;
+        return 1;
+    }
+    const double kDegToRad = M_PI / 180.0;
+    const int kTimedPoses = 4096;     // 计时时循环使用的位姿数（常驻缓存，只测计算）
+    const int kRepeats = 50;
+
+    struct Sample {
+        std::array<double, 16> anchor;
+        std::array<double, 16> current;
+        OrientationMath::Mat3 anchorInv;
+        OrientationMath::Vec3 armEuler;        // 机械臂锚点欧拉角（弧度）
+        OrientationMath::Mat3 armRotation;
+        OrientationMath::Mat3 truth;           // 真实的最终姿态 R(相对旋转) * R(机械臂锚点)
+    };
+    std::vector<Sample> samples(poses);
+    uint32_t seed = 12345;
+    auto uniform = [&seed](double range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (static_cast<double>(seed >> 8) / 16777216.0 * 2.0 - 1.0) * range;
+    };
+    for (int i = 0; i < poses; ++i) {
+        Sample& sample = samples[i];
+        OrientationMath::Vec3 euler = {{uniform(34.0) * kDegToRad, uniform(34.0) * kDegToRad, uniform(34.0) * kDegToRad}};
+        OrientationMath::Mat3 anchor = OrientationMath::fromEuler(euler);
+        OrientationMath::Vec3 relative = {{uniform(3.0) * kDegToRad, uniform(3.0) * kDegToRad, uniform(3.0) * kDegToRad}};
+        OrientationMath::Mat3 relativeMatrix = OrientationMath::fromRotationVector(relative);
+        OrientationMath::Mat3 current = OrientationMath::multiply(relativeMatrix, anchor);
+        // 写成OpenHaptics的列优先4x4变换
+        sample.anchor.fill(0.0);
+        sample.current.fill(0.0);
+        for (int row = 0; row < 3; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                sample.anchor[col * 4 + row] = anchor[row * 3 + col];
+                sample.current[col * 4 + row] = current[row * 3 + col];
+            }
+        }
+        sample.anchor[15] = sample.current[15] = 1.0;
+        sample.anchorInv = OrientationMath::transpose(OrientationMath::rotationFromTransform(sample.anchor));
+        sample.armEuler = {{uniform(170.0) * kDegToRad, uniform(60.0) * kDegToRad, uniform(170.0) * kDegToRad}};
+        sample.armRotation = OrientationMath::fromEuler(sample.armEuler);
+        sample.truth = OrientationMath::multiply(relativeMatrix, sample.armRotation);
+    }
+
+    // 两条路径各自得到的最终指令欧拉角（弧度）
+    auto legacyPath = [](const Sample& sample) {
+        OrientationMath::Vec3 currentEuler = legacyEulerDegrees(sample.current);
+        OrientationMath::Vec3 anchorEuler = legacyEulerDegrees(sample.anchor);
+        OrientationMath::Vec3 result;
+        for (int axis = 0; axis < 3; ++axis) {
+            result[axis] = sample.armEuler[axis] + (currentEuler[axis] - anchorEuler[axis]) * M_PI / 180.0;
+        }
+        return result;
+    };
+    auto matrixPath = [](const Sample& sample) {
+        OrientationMath::Vec3 offset = OrientationMath::rotationVector(OrientationMath::multiply(
+            OrientationMath::rotationFromTransform(sample.current), sample.anchorInv));
+        return OrientationMath::eulerAngles(OrientationMath::multiply(
+            OrientationMath::fromRotationVector(offset), sample.armRotation), sample.armEuler);
+    };
+
+    // 误差：最终指令欧拉角对应的姿态与真实姿态的夹角（度）
+    double errorSum[2] = {0.0, 0.0};
+    double errorMax[2] = {0.0, 0.0};
+    for (int i = 0; i < poses; ++i) {
+        const Sample& sample = samples[i];
+        OrientationMath::Vec3 results[2] = {legacyPath(sample), matrixPath(sample)};
+        for (int path = 0; path < 2; ++path) {
+            double error = OrientationMath::angleBetween(OrientationMath::fromEuler(results[path]), sample.truth) /
+                           kDegToRad;
+            errorSum[path] += error;
+            errorMax[path] = std::max(errorMax[path], error);
+        }
+    }
+
+    // 单帧耗时：旧版每帧提取当前和锚点两组欧拉角；当前路径每帧一次相对旋转、旋转向量、组合和欧拉角转换
+    int timed = std::min(poses, kTimedPoses);
+    const Sample* volatile samplesPtr = samples.data();
+    double nsPerTick[2];
+    double checksum = 0.0;
+    for (int path = 0; path < 2; ++path) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int repeat = 0; repeat < kRepeats; ++repeat) {
+            const Sample* base = samplesPtr;
+            for (int i = 0; i < timed; ++i) {
+                OrientationMath::Vec3 result = path == 0 ? legacyPath(base[i]) : matrixPath(base[i]);
+                checksum += result[0] + result[1] + result[2];
+            }
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        nsPerTick[path] = std::chrono::duration<double, std::nano>(end - start).count() / (kRepeats * timed);
+    }
+    volatile double sink = checksum;
+    (void)sink;
+
+    const char* labels[2] = {"欧拉角相减(旧)", "旋转矩阵"};
+    std::cout << "=== 姿态映射基准 (" << poses << " 个随机位姿，锚点±34°，机械臂锚点±170°/±60°，相对旋转±3°) ==="
+              << std::endl;
+    for (int path = 0; path < 2; ++path) {
+        std::cout << "  " << std::left << std::setw(16) << labels[path] << std::right << std::fixed
+                  << std::setprecision(1) << " 单帧 " << std::setw(6) << nsPerTick[path] << "ns  最终姿态误差 平均 "
+                  << std::scientific << std::setprecision(2) << errorSum[path] / poses << "° 最大 "
+                  << errorMax[path] << "°" << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+    bool ok = errorMax[1] < 1e-9;
+    std::cout << (ok ? "  ✅ 旋转矩阵路径误差在舍入误差量级" : "  ❌ 旋转矩阵路径误差超过1e-9°") << std::endl;
+    return ok ? 0 : 1;
+}
+
+/*******************************************************************************
+ 轨迹生成基准：按 [deviceN] 的轨迹上限（不要求 trajectory = jerk_limited）在各指令频率下
+ 测量单次 step() 耗时、阶跃响应和正弦跟踪延迟，并逐拍核对速度/加速度/加加速度上限
+*******************************************************************************/
+int runTrajectoryBenchmark(int argc, char* argv[])
+{
+    std::string device = argc > 2 ? argv[2] : "device1";
+    std::vector<double> rates;
+    for (int i = 3; i < argc; ++i) {
+        rates.push_back(atof(argv[i]));
+    }
+    if (rates.empty()) {
+        rates = {100.0, 250.0, 500.0, 1000.0};
+    }
+    for (size_t i = 0; i < rates.size(); ++i) {
+        if (rates[i] <= 0.0) {
+            std::cerr << "用法: " << argv[0] << " --bench-trajectory [deviceN] [指令频率Hz...]" << std::endl;
+            return 1;
+        }
+    }
+
+    TrajectoryGenerator::Params params;
+    TouchArmController::loadTrajectoryParams(g_config, device, params);
+    std::cout << "=== 轨迹生成基准 (" << device << ") ===" << std::endl;
+    std::cout << "  上限: 位置 " << params.maxVelocity[0] / 1000.0 << "mm/s, " << params.maxAcceleration[0] / 1000.0
+              << "mm/s², " << params.maxJerk[0] / 1000.0 << "mm/s³; 姿态 " << params.maxVelocity[3] / 1000.0
+              << "rad/s, " << params.maxAcceleration[3] / 1000.0 << "rad/s², " << params.maxJerk[3] / 1000.0
+              << "rad/s³" << std::endl;
+    bool ok = true;
+    for (size_t i = 0; i < rates.size(); ++i) {
+        ok &= TrajectoryGenerator::benchmark(std::cout, params, rates[i]);
+    }
+    return ok ? 0 : 1;
+}
+
+/*******************************************************************************
+ 指令滤波基准：按 [deviceN] 的滤波参数比较四种滤波类型的单帧耗时、相位滞后和震颤抑制
+ （1kHz输入，默认按 [deviceN] control_rate_hz 发送）
+*******************************************************************************/
+int runFilterBenchmark(int argc, char* argv[])
+{
+    std::string device = argc > 2 ? argv[2] : "device1";
+    int controlPeriodMs = g_config->getInt("system.control_frequency", 10);
+    double defaultRateHz = controlPeriodMs > 0 ? 1000.0 / controlPeriodMs : 100.0;
+    double sendRateHz = argc > 3 ? atof(argv[3]) : g_config->getDouble(device + ".control_rate_hz", defaultRateHz);
+    if (sendRateHz <= 0.0 || sendRateHz > 1000.0) {
+        std::cerr << "用法: " << argv[0] << " --bench-filter [deviceN] [发送频率Hz(≤1000)]" << std::endl;
+        return 1;
+    }
+
+    MotionFilter::Params params;
+    TouchArmController::loadFilterParams(g_config, device, params);
+    std::cout << "=== 指令滤波基准 (" << device << ", 1kHz输入, " << sendRateHz << "Hz发送) ===" << std::endl;
+    std::cout << "  输入: X 20mm@0.5Hz 正弦 + 0.5mm@10Hz 震颤；one_euro 最小截止 " << params.minCutoffHz
+              << "Hz, beta " << params.betaPosition << "/um；critically_damped 截止 " << params.cutoffHz << "Hz"
+              << std::endl;
+    return MotionFilter::benchmark(std::cout, params, sendRateHz) ? 0 : 1;
+}
+
+/*******************************************************************************
+ 虚拟夹具基准：测量 [deviceN_fixtures] 中配置的夹具组以及若干组合成夹具
+ （6个限位平面围成工作空间，其余为引导平面/直线/点）的单次 evaluate() 耗时，
+ 与1kHz伺服周期比较，并核对约束结果
+*******************************************************************************/
+int runFixtureBenchmark(int argc, char* argv[])
+{
+    std::string device = argc > 2 ? argv[2] : "device1";
+    std::vector<int> counts;
+    for (int i = 3; i < argc; ++i) {
+        counts.push_back(atoi(argv[i]));
+    }
+    if (counts.empty()) {
+        counts = {12, 24, 48, 64};
+    }
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] < 1 || counts[i] > VirtualFixtures::kMaxFixtures) {
+            std::cerr << "用法: " << argv[0] << " --bench-fixtures [deviceN] [合成夹具数(1~"
+                      << VirtualFixtures::kMaxFixtures << ")...]" << std::endl;
+            return 1;
+        }
+    }
+
+    const uint64_t kServoPeriodNs = 1000000;
+    const int kIterations = 200000;
+    VirtualFixtures::Params params;
+    std::vector<VirtualFixtures::Fixture> configured;
+    std::string section = device + "_fixtures";
+    TouchArmController::loadFixtures(g_config, section, params, configured);
+    std::cout << "=== 虚拟夹具基准 (" << device << ") ===" << std::endl;
+    std::cout << "  伺服周期 1ms，合格线: evaluate() p99 不超过周期的10%；吸附距离 " << params.snapDistance
+              << "mm, 刚度 " << params.stiffness << "N/mm" << std::endl;
+    bool ok = true;
+    if (!configured.empty()) {
+        ok &= VirtualFixtures::benchmark(std::cout, section.c_str(), params, configured, kIterations, kServoPeriodNs);
+    }
+    for (size_t i = 0; i < counts.size(); ++i) {
+        ok &= VirtualFixtures::benchmark(std::cout, "合成", params, VirtualFixtures::syntheticFixtures(counts[i]),
+                                         kIterations, kServoPeriodNs);
+    }
+    return ok ? 0 : 1;
+}
+
+/*******************************************************************************
+ 运动模式基准：对同一台（模拟）机械臂用合成的触觉轨迹依次运行笛卡尔跟随和关节空间两种模式，
+ 比较指令发送频率、本机逆解耗时和拒绝次数。轨迹的姿态摆动会经过腕部奇异位形附近
+ （配合 mock_arm_server --kinematics rm65 --joints 0,20,70,0,4,0），
+ 控制器侧（模拟器）的拒绝次数见 mock_arm_server 的输出。
+*******************************************************************************/
+int runIkBenchmark(int argc, char* argv[])
+{
+    double seconds = argc > 2 ? atof(argv[2]) : 12.0;
+    std::string device = argc > 3 ? argv[3] : "device1";
+    if (seconds <= 0.0 || device.compare(0, 6, "device") != 0 || device.size() == 6) {
+        std::cerr << "用法: " << argv[0] << " --bench-ik [每种模式的秒数] [deviceN]" << std::endl;
+        return 1;
+    }
+    std::string robotSection = "robot" + device.substr(6);
+    std::string robotIP = g_config->getString(robotSection + ".ip", "192.168.10.18");
+    int robotPort = g_config->getInt(robotSection + ".port", 8080);
+
+    // 关节空间模式的初值取自主动上报（未启用时取自锚点查询响应中的关节角度）
+    bool pushEnabled = g_config->getBool("realtime_push.enabled", true);
+    if (pushEnabled) {
+        g_armStateReceiver = new ArmStateReceiver(g_config->getInt("realtime_push.port", 8089));
+        if (!g_armStateReceiver->start()) {
+            delete g_armStateReceiver;
+            g_armStateReceiver = nullptr;
+        }
+    }
+    int connectTimeoutMs = g_config->getInt("system.arm_connect_timeout_ms", 3000);
+    g_armReactor = new ArmReactor();
+    g_armReactor->setReconnectPolicy(g_config->getInt("system.arm_reconnect_initial_ms", 500),
+                                     g_config->getInt("system.arm_reconnect_max_ms", 30000),
+                                     connectTimeoutMs);
+    ArmController* arm = new ArmController(createArmTransport(robotSection, robotIP, robotPort), robotIP, robotPort);
+    arm->setRealtimePushConfig(g_config->getString("realtime_push.host_ip", "192.168.10.100"),
+                               g_config->getInt("realtime_push.port", 8089),
+                               g_config->getInt("realtime_push.cycle", 5),
+                               g_config->getInt("realtime_push.max_age_ms", 50),
+                               g_armStateReceiver != nullptr);
+    if (g_armStateReceiver) {
+        g_armStateReceiver->registerArm(robotIP, [arm](const ArmRealtimeState& state) {
+            arm->publishRealtimeState(state);
+        });
+    }
+    g_armReactor->start();
+    arm->connect();
+    auto connectDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(connectTimeoutMs);
+    while (!arm->isReady() && std::chrono::steady_clock::now() < connectDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // 等待第一帧主动上报
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    int result = 0;
+    if (!arm->isReady()) {
+        std::cerr << "❌ 机械臂 " << robotIP << ":" << robotPort << " 未就绪，基准取消" << std::endl;
+        result = 1;
+    }
+
+    static const char* kModes[2] = {"pose", "joint"};
+    for (int mode = 0; mode < 2 && result == 0; ++mode) {
+        // 只修改内存中的配置，不写回文件
+        g_config->setString(device + ".motion_mode", kModes[mode]);
+        TouchArmController* controller = new TouchArmController(*arm, g_config, device);
+        bool jointMode = controller->getMotionMode() == TouchArmController::MotionMode::Joint;
+        std::cout << "\n=== " << (jointMode ? "关节空间 (set_joint_angle_transmission)" : "笛卡尔跟随 (movep_follow)")
+                  << ", " << seconds << "s ===" << std::endl;
+        ArmCommandPipeline::Stats pipelineBefore = arm->getPipelineStats();
+
+        // 1kHz合成轨迹：设备坐标下的位置正弦（毫米）叠加绕设备X、Z轴的姿态摆动
+        std::array<double, 3> position = {{0.0, 0.0, 0.0}};
+        std::array<double, 3> velocity = {{0.0, 0.0, 0.0}};
+        std::array<double, 16> transform = {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+        const double kTwoPi = 2.0 * M_PI;
+        auto startTime = std::chrono::steady_clock::now();
+        auto nextTick = startTime;
+        bool pressed = false;
+        while (true) {
+            double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            if (t >= seconds) {
+                break;
+            }
+            position[0] = 40.0 * std::sin(kTwoPi * t / 4.0);
+            position[1] = 30.0 * std::sin(kTwoPi * t / 2.0);
+            position[2] = 30.0 * std::sin(kTwoPi * t / 6.0);
+            velocity[0] = 40.0 * kTwoPi / 4.0 * std::cos(kTwoPi * t / 4.0);
+            velocity[1] = 30.0 * kTwoPi / 2.0 * std::cos(kTwoPi * t / 2.0);
+            velocity[2] = 30.0 * kTwoPi / 6.0 * std::cos(kTwoPi * t / 6.0);
+            double a = 0.35 * std::sin(kTwoPi * t / 3.0);
+            double b = 0.25 * std::sin(kTwoPi * t / 5.0);
+            // R = Rz(b)·Rx(a)，OpenHaptics变换为列优先
+            double ca = std::cos(a), sa = std::sin(a), cb = std::cos(b), sb = std::sin(b);
+            double r[9] = {cb, -sb * ca, sb * sa, sb, cb * ca, -cb * sa, 0.0, sa, ca};
+            for (int row = 0; row < 3; ++row) {
+                for (int col = 0; col < 3; ++col) {
+                    transform[col * 4 + row] = r[row * 3 + col];
+                }
+                transform[12 + row] = position[row];
+            }
+            if (!pressed) {
+                controller->onButtonDown(position, transform);
+                pressed = true;
+            }
+            controller->update(position, transform, velocity);
+            nextTick += std::chrono::milliseconds(1);
+            std::this_thread::sleep_until(nextTick);
+        }
+        controller->onButtonUp();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        uint64_t sent = arm->getPipelineStats().sent - pipelineBefore.sent;
+        if (jointMode && controller->getIkWorker()) {
+            IkWorker::Stats stats;
+            controller->getIkWorker()->getStats(stats);
+            sent = stats.sent;
+        }
+        std::cout << "[" << device << "] 已发送运动指令: " << sent << " (" << std::fixed << std::setprecision(1)
+                  << sent / elapsed << " Hz)" << std::defaultfloat << std::setprecision(6) << std::endl;
+        controller->printClutchLatencyStats();
+        controller->printCommandRateStats();
+        arm->printPipelineStats();
+        delete controller;
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+
+    if (g_armStateReceiver) {
+        delete g_armStateReceiver;
+        g_armStateReceiver = nullptr;
+    }
+    g_armReactor->stop();
+    delete arm;
+    delete g_armReactor;
+    g_armReactor = nullptr;
+    return result;
+}
+
+/*******************************************************************************
+ 双臂防碰撞基准：两台对置的机械臂在随机关节角度和指令目标下的 check() 耗时，
+ 并与逐对分支实现的参考距离核对（不连接设备和机械臂）
+*******************************************************************************/
+int runCollisionBenchmark(int argc, char* argv[])
+{
+    int iterations = argc > 2 ? atoi(argv[2]) : 200000;
+    if (iterations < 1) {
+        std::cerr << "用法: " << argv[0] << " --bench-collision [随机配置数]" << std::endl;
+        return 1;
+    }
+    const uint64_t kCheckBudgetNs = 20000;
+    ArmCollisionGuard::Params params;
+    ArmKinematics::Model model;
+    if (!loadCollisionParams(params, model)) {
+        return 1;
+    }
+    std::cout << "=== 双臂防碰撞基准 ===" << std::endl;
+    std::cout << "  合格线: check() p99 不超过 " << kCheckBudgetNs / 1000 << "us；安全距离 " << params.marginMm
+              << "mm, 连杆/末端半径 " << params.linkRadiusMm << "/" << params.toolRadiusMm << "mm" << std::endl;
+    return ArmCollisionGuard::benchmark(std::cout, params, model, iterations, kCheckBudgetNs) ? 0 : 1;
+}
+
+/*******************************************************************************
+ 伺服通道基准：N 个模拟 DeviceChannel 按1kHz依次 beginFrame()/endFrame()，
+ 与伺服回调相同的顺序，测量每个节拍和每个通道的耗时。
+ 每个通道以合成轨迹拖动（按钮1按下），机械臂不连接（仅触觉反馈的拖动），
+ 映射、预测、滤波、轨迹、夹具和反馈力照常计算；日志线程不启动，调试记录写入后被丢弃
+*******************************************************************************/
+int runChannelBenchmark(int argc, char* argv[])
+{
+    std::vector<int> counts;
+    for (int i = 2; i < argc; ++i) {
+        counts.push_back(atoi(argv[i]));
+    }
+    if (counts.empty()) {
+        counts = {1, 2, 4, 8};
+    }
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] < 1 || counts[i] > ServoTimingMonitor::kMaxChannels) {
+            std::cerr << "用法: " << argv[0] << " --bench-channels [模拟通道数(1~"
+                      << ServoTimingMonitor::kMaxChannels << ")...]" << std::endl;
+            return 1;
+        }
+    }
+
+    const int kTicks = 3000;
+    const double kTwoPi = 2.0 * M_PI;
+    DeviceCapabilities caps;
+    memset(&caps, 0, sizeof(caps));
+    caps.maxContinuousForce = 0.88;   // Touch 标称持续力
+    caps.maxForce = 3.3;
+    caps.buttonCount = 2;
+
+    g_armReactor = new ArmReactor();
+    BinaryLogger::instance().prepareThread();
+    std::cout << "=== 伺服通道基准 (1kHz, 每组 " << kTicks << " 个节拍) ===" << std::endl;
+    double baselineMeanNs = 0.0;
+    for (size_t c = 0; c < counts.size(); ++c) {
+        int count = counts[c];
+        std::vector<ArmController*> arms;
+        std::vector<TouchArmController*> controllers;
+        std::vector<DeviceChannel*> channels;
+        std::cout.setstate(std::ios::failbit);   // 控制器构造时的配置输出
+        for (int i = 1; i <= count; ++i) {
+            std::string robotSection = "robot" + std::to_string(i);
+            std::string robotIP = "127.0.0." + std::to_string(i);
+            ArmController* arm = new ArmController(createArmTransport(robotSection, robotIP, 8080), robotIP, 8080);
+            TouchArmController* controller = new TouchArmController(*arm, g_config, "device" + std::to_string(i));
+            DeviceChannel* channel = new DeviceChannel(i, "device" + std::to_string(i), HD_INVALID_HANDLE, controller, 2);
+            channel->enableSimulation(caps);
+            arms.push_back(arm);
+            controllers.push_back(controller);
+            channels.push_back(channel);
+        }
+        std::cout.clear();
+
+        LatencyHistogram tickTime(1000000);
+        std::vector<LatencyHistogram*> channelTime;
+        for (int i = 0; i < count; ++i) {
+            channelTime.push_back(new LatencyHistogram(1000000));
+        }
+        std::array<double, 3> position, velocity;
+        std::array<double, 16> transform = {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+        auto nextTick = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < kTicks; ++tick) {
+            // 每个通道相位不同的位置正弦和绕Z轴的摆动
+            double t = tick / 1000.0;
+            for (int i = 0; i < count; ++i) {
+                double phase = t + 0.37 * i;
+                for (int axis = 0; axis < 3; ++axis) {
+                    position[axis] = 30.0 * std::sin(kTwoPi * phase / (2.0 + axis));
+                    velocity[axis] = 30.0 * kTwoPi / (2.0 + axis) * std::cos(kTwoPi * phase / (2.0 + axis));
+                    transform[12 + axis] = position[axis];
+                }
+                double angle = 0.3 * std::sin(kTwoPi * phase / 3.0);
+                transform[0] = std::cos(angle);
+                transform[1] = std::sin(angle);
+                transform[4] = -std::sin(angle);
+                transform[5] = std::cos(angle);
+                channels[i]->setSimulatedSample(position, transform, velocity, HD_DEVICE_BUTTON_1);
+            }
+
+            uint64_t channelNs[ServoTimingMonitor::kMaxChannels] = {0};
+            uint64_t tickStart = ServoTimingMonitor::nowNs();
+            for (int i = 0; i < count; ++i) {
+                uint64_t start = ServoTimingMonitor::nowNs();
+                channels[i]->beginFrame();
+                channelNs[i] = ServoTimingMonitor::nowNs() - start;
+            }
+            for (int i = 0; i < count; ++i) {
+                uint64_t start = ServoTimingMonitor::nowNs();
+                channels[i]->endFrame();
+                channelTime[i]->record(channelNs[i] + ServoTimingMonitor::nowNs() - start);
+            }
+            tickTime.record(ServoTimingMonitor::nowNs() - tickStart);
+
+            nextTick += std::chrono::milliseconds(1);
+            std::this_thread::sleep_until(nextTick);
+        }
+
+        LatencyHistogram::Snapshot tick;
+        LatencyHistogram::Snapshot channel;
+        tickTime.snapshot(tick);
+        double channelMeanNs = 0.0;
+        uint64_t channelMaxNs = 0;
+        for (int i = 0; i < count; ++i) {
+            channelTime[i]->snapshot(channel);
+            channelMeanNs += channel.meanNs() / count;
+            channelMaxNs = std::max(channelMaxNs, channel.maxNs);
+        }
+        if (c == 0) {
+            baselineMeanNs = tick.meanNs() / count;
+        }
+        std::cout << std::fixed << std::setprecision(2) << "  " << count << " 个通道: 节拍 p50="
+                  << tick.percentile(0.50) / 1000.0 << "us p99=" << tick.percentile(0.99) / 1000.0
+                  << "us max=" << tick.maxNs / 1000.0 << "us 平均=" << tick.meanNs() / 1000.0
+                  << "us; 单通道平均=" << channelMeanNs / 1000.0 << "us 最大=" << channelMaxNs / 1000.0
+                  << "us; 平均节拍/通道数 相对第一组=" << std::setprecision(2)
+                  << (baselineMeanNs > 0.0 ? tick.meanNs() / count / baselineMeanNs : 0.0)
+                  << std::defaultfloat << std::setprecision(6) << std::endl;
+
+        for (int i = 0; i < count; ++i) {
+            controllers[i]->onButtonUp();
+            delete channelTime[i];
+            delete channels[i];
+            delete controllers[i];
+            delete arms[i];
+        }
+    }
+    delete g_armReactor;
+    g_armReactor = nullptr;
+    return 0;
+}
+
+// 旧版 ostringstream 编码（只用于 --bench-encoder 对比），与原发送路径一样追加\r\n
+static std::string legacyEncodeMovePFollow(const std::array<int, 6>& pose)
+{
+    std::ostringstream oss;
+    oss << "{ \"command\": \"movep_follow\", \"pose\": [";
+    for (int i = 0; i < 6; ++i) {
+        if (i > 0) oss << ", ";
+        oss << pose[i];
+    }
+    oss << "] }";
+    return oss.str() + "\r\n";
+}
+
+static std::string legacyEncodeJointAngles(const std::array<double, 6>& jointAngles)
+{
+    std::ostringstream oss;
+    oss << "{ \"command\": \"set_joint_angle_transmission\", \"joint\": [";
+    for (int i = 0; i < 6; ++i) {
+        if (i > 0) oss << ", ";
+        oss << std::fixed << std::setprecision(6) << jointAngles[i];
+    }
+    oss << "] }";
+    return oss.str() + "\r\n";
+}
+
+// 两帧关节角度的数值是否一致（定点小数在舍入边界上允许相差最后一位）
+static bool jointFramesMatch(const char* a, const char* b)
+{
+    a = strchr(a, '[');
+    b = strchr(b, '[');
+    for (int i = 0; i < 6; ++i) {
+        if (!a || !b) {
+            return false;
+        }
+        char* endA;
+        char* endB;
+        double valueA = strtod(a + 1, &endA);
+        double valueB = strtod(b + 1, &endB);
+        if (std::fabs(valueA - valueB) > 1.000001e-6) {
+            return false;
+        }
+        a = strchr(endA, i < 5 ? ',' : ']');
+        b = strchr(endB, i < 5 ? ',' : ']');
+    }
+    return a && b && strcmp(a, b) == 0;
+}
+
+/*******************************************************************************
+ 指令编码基准：CommandEncoder 与旧版 ostringstream 编码的单次耗时和分配次数，
+ 并逐帧核对输出（movep_follow 逐字节一致，关节角度数值一致）。
+ 编码器发生任何分配或输出不一致时返回失败
+*******************************************************************************/
+int runEncoderBenchmark(int argc, char* argv[])
+{
+    int count = argc > 2 ? atoi(argv[2]) : 200000;
+    if (count < 1) {
+        std::cerr << "用法: " << argv[0] << " --bench-encoder [随机指令数]" << std::endl;
+        return 1;
+    }
+
+    // 随机位姿（±800mm、±π）和关节角度（±180°）
+    std::vector<std::array<int, 6> > poses(count);
+    std::vector<std::array<double, 6> > joints(count);
+    uint32_t seed = 12345;
+    for (int n = 0; n < count; ++n) {
+        for (int i = 0; i < 6; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            double unit = static_cast<double>(seed >> 8) / 16777216.0 * 2.0 - 1.0;
+            poses[n][i] = static_cast<int>(unit * (i < 3 ? 800000.0 : 3141.0));
+            joints[n][i] = unit * 180.0;
+        }
+    }
+
+    CommandEncoder* encoder = new CommandEncoder();
+    int poseMismatches = 0, jointMismatches = 0, jointLastDigit = 0;
+    for (int n = 0; n < count; ++n) {
+        size_t length = encoder->encodeMovePFollow(poses[n]);
+        std::string expected = legacyEncodeMovePFollow(poses[n]);
+        if (length != expected.size() || memcmp(encoder->data(), expected.data(), length) != 0) {
+            ++poseMismatches;
+        }
+        length = encoder->encodeJointAngles(joints[n]);
+        expected = legacyEncodeJointAngles(joints[n]);
+        std::string actual(encoder->data(), length);
+        if (actual != expected) {
+            if (jointFramesMatch(actual.c_str(), expected.c_str())) {
+                ++jointLastDigit;
+            } else {
+                ++jointMismatches;
+            }
+        }
+    }
+
+    // 计时与分配计数：四种编码依次对全部指令各编码一遍
+    const char* labels[4] = {"movep_follow 编码器", "movep_follow ostringstream", "关节角度 编码器",
+                             "关节角度 ostringstream"};
+    double nsPerCall[4];
+    double allocationsPerCall[4];
+    size_t checksum = 0;
+    for (int kind = 0; kind < 4; ++kind) {
+        uint64_t allocationsBefore = AllocationCounter::count();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int n = 0; n < count; ++n) {
+            switch (kind) {
+                case 0: checksum += encoder->encodeMovePFollow(poses[n]); break;
+                case 1: checksum += legacyEncodeMovePFollow(poses[n]).size(); break;
+                case 2: checksum += encoder->encodeJointAngles(joints[n]); break;
+                default: checksum += legacyEncodeJointAngles(joints[n]).size(); break;
+            }
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        nsPerCall[kind] = std::chrono::duration<double, std::nano>(end - start).count() / count;
+        allocationsPerCall[kind] = static_cast<double>(AllocationCounter::count() - allocationsBefore) / count;
+    }
+    volatile size_t sink = checksum;
+    (void)sink;
+    delete encoder;
+
+    std::cout << "=== 指令编码基准 (" << count << " 条随机指令) ===" << std::endl;
+    for (int kind = 0; kind < 4; ++kind) {
+        std::cout << "  " << std::left << std::setw(28) << labels[kind] << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(8) << nsPerCall[kind] << "ns  分配 "
+                  << std::setprecision(2) << allocationsPerCall[kind] << " 次/条" << std::endl;
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "  输出核对: movep_follow 不一致 " << poseMismatches << " 条；关节角度 末位舍入差异 "
+              << jointLastDigit << " 条，数值不一致 " << jointMismatches << " 条" << std::endl;
+
+    bool ok = allocationsPerCall[0] == 0.0 && allocationsPerCall[2] == 0.0 && poseMismatches == 0 &&
+              jointMismatches == 0;
+    std::cout << (ok ? "  ✅ 编码零分配，输出与旧版一致" : "  ❌ 编码发生分配或输出与旧版不一致") << std::endl;
+    return ok ? 0 : 1;
+}
+
+/*******************************************************************************
+ 传输后端基准：对配置中的（模拟）机械臂依次运行各传输后端（json；以 USE_RM_API2 编译时
+ 再运行 rm_api2），在服务线程中测量流式位姿的单帧发送耗时与线程CPU时间，
+ 以及逐条发出的状态查询的往返时间（发出 → 完成回调）。流式期间每约200ms插入一次查询，
+ 后端统计中可见查询对流式发送的影响（如 rm_api2 的句柄忙推迟）
+*******************************************************************************/
+// 服务线程中按节拍发送 frames 帧流式位姿（期间按探测周期插入查询），再逐条发完其余的 queries 次状态查询
+class TransportBenchClient : public ArmTransport::Listener {
+public:
+    TransportBenchClient(int frames, int queries)
+        : m_frames(frames), m_queries(queries), m_connected(false), m_framesSent(0), m_queriesSent(0),
+          m_queryInFlight(false), m_querySentNs(0), m_sendTime(), m_queryTime(), m_cpuNs(0), m_replies(0),
+          m_failures(0), m_finished(false) {}
+
+    bool finished() const { return m_finished.load(std::memory_order_acquire); }
+    uint64_t cpuNs() const { return m_cpuNs.load(std::memory_order_relaxed); }
+    uint64_t replies() const { return m_replies.load(std::memory_order_relaxed); }
+    uint64_t failures() const { return m_failures.load(std::memory_order_relaxed); }
+    const LatencyHistogram& sendTime() const { return m_sendTime; }
+    const LatencyHistogram& queryTime() const { return m_queryTime; }
+
+    void onTransportConnected(ArmTransport& transport) override {
+        (void)transport;
+        m_connected = true;
+    }
+    void onTransportDisconnected(ArmTransport& transport) override {
+        (void)transport;
+        m_connected = false;
+    }
+
+    void onTransportTick(ArmTransport& transport, uint64_t nowNs) override {
+        (void)nowNs;
+        if (!m_connected || finished()) {
+            return;
+        }
+        if (m_framesSent < m_frames) {
+            // 位置在 ±10mm 内缓慢变化，每帧的编码长度与实际拖动相近
+            int offset = static_cast<int>(10000.0 * std::sin(m_framesSent * 0.001));
+            std::array<int, 6> pose = {{200000 + offset, offset, 300000, 3141, 0, 0}};
+            timespec cpuStart, cpuEnd;
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuStart);
+            uint64_t start = ArmCommandPipeline::nowNs();
+            transport.streamPose(pose);
+            m_sendTime.record(ArmCommandPipeline::nowNs() - start);
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuEnd);
+            m_cpuNs.fetch_add(static_cast<uint64_t>((cpuEnd.tv_sec - cpuStart.tv_sec) * 1000000000LL +
+                                                    (cpuEnd.tv_nsec - cpuStart.tv_nsec)),
+                              std::memory_order_relaxed);
+            ++m_framesSent;
+            // 流式期间按探测周期插入查询，与运行时的往返探测一样和流式帧争用连接/句柄
+            if (m_framesSent % kProbeFrames == 0) {
+                sendQuery(transport);
+            }
+            return;
+        }
+        if (m_queryInFlight) {
+            return;
+        }
+        if (m_queriesSent == m_queries) {
+            m_finished.store(true, std::memory_order_release);
+            return;
+        }
+        sendQuery(transport);
+    }
+
+    void onArmState(ArmTransport& transport, const ArmResponse& response) override {
+        (void)transport;
+        (void)response;
+    }
+
+private:
+    static const int kProbeFrames = 1000;   // 200us节拍下约200ms
+
+    void sendQuery(ArmTransport& transport) {
+        if (m_queryInFlight || m_queriesSent == m_queries) {
+            return;
+        }
+        m_queryInFlight = true;
+        ++m_queriesSent;
+        m_querySentNs = ArmCommandPipeline::nowNs();
+        if (!transport.send(ArmCommand::make(ArmCommand::GetArmState), 500000000ULL, 0,
+                            [this](const ArmResponse* response) {
+                                if (response) {
+                                    m_queryTime.record(ArmCommandPipeline::nowNs() - m_querySentNs);
+                                    m_replies.fetch_add(1, std::memory_order_relaxed);
+                                } else {
+                                    m_failures.fetch_add(1, std::memory_order_relaxed);
+                                }
+                                m_queryInFlight = false;
+                            })) {
+            m_failures.fetch_add(1, std::memory_order_relaxed);
+            m_queryInFlight = false;
+        }
+    }
+
+    int m_frames;
+    int m_queries;
+    bool m_connected;               // 以下五项服务线程独占
+    int m_framesSent;
+    int m_queriesSent;
+    bool m_queryInFlight;
+    uint64_t m_querySentNs;
+    LatencyHistogram m_sendTime;    // 单写者：服务线程
+    LatencyHistogram m_queryTime;
+    std::atomic<uint64_t> m_cpuNs;
+    std::atomic<uint64_t> m_replies;
+    std::atomic<uint64_t> m_failures;
+    std::atomic<bool> m_finished;
+};
+
+int runTransportBenchmark(int argc, char* argv[])
+{
+    std::string device = argc > 2 ? argv[2] : "device1";
+    int frames = argc > 3 ? atoi(argv[3]) : 20000;
+    int queries = argc > 4 ? atoi(argv[4]) : 2000;
+    if (device.compare(0, 6, "device") != 0 || device.size() == 6 || frames < 1 || queries < 1) {
+        std::cerr << "用法: " << argv[0] << " --bench-transport [deviceN] [流式帧数] [查询次数]" << std::endl;
+        return 1;
+    }
+    std::string robotSection = "robot" + device.substr(6);
+    std::string robotIP = g_config->getString(robotSection + ".ip", "192.168.10.18");
+    int robotPort = g_config->getInt(robotSection + ".port", 8080);
+
+    std::vector<std::string> backends;
+    backends.push_back("json");
+#ifdef USE_RM_API2
+    backends.push_back("rm_api2");
+#endif
+
+    std::string failed;
+    for (size_t b = 0; b < backends.size(); ++b) {
+        // 只修改内存中的配置，不写回文件
+        g_config->setString(robotSection + ".transport", backends[b]);
+        g_armReactor = new ArmReactor();
+        ArmTransport* transport = createArmTransport(robotSection, robotIP, robotPort);
+        TransportBenchClient* client = new TransportBenchClient(frames, queries);
+        transport->attach(client, BinaryLogger::instance().registerSource("传输基准"));
+        g_armReactor->start();
+        transport->connect();
+
+        std::cout << "\n=== 传输后端 " << transport->name() << " (" << robotIP << ":" << robotPort << ", "
+                  << frames << " 帧流式位姿, " << queries << " 次状态查询) ===" << std::endl;
+        bool connected = false;
+        for (int waited = 0; waited < 3000 && !connected; ++waited) {
+            connected = transport->isConnected();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!connected) {
+            // 连接失败按基准失败处理，不跳过：两种后端必须对同一模拟器测得结果
+            std::cout << "  ❌ " << transport->name() << " 后端3秒内未连接到 " << robotIP << ":" << robotPort
+                      << "（握手失败时查看模拟器输出中收到的指令）" << std::endl;
+            failed += std::string(" ") + transport->name();
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+        while (connected && !client->finished() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        if (connected) {
+            LatencyHistogram::Snapshot send;
+            LatencyHistogram::Snapshot query;
+            client->sendTime().snapshot(send);
+            client->queryTime().snapshot(query);
+            std::cout << std::fixed << std::setprecision(2)
+                      << "  流式发送: 单帧 p50=" << send.percentile(0.50) / 1000.0 << "us p99="
+                      << send.percentile(0.99) / 1000.0 << "us 平均=" << send.meanNs() / 1000.0
+                      << "us; 线程CPU 平均=" << (send.count ? client->cpuNs() / 1000.0 / send.count : 0.0)
+                      << "us/帧 (" << send.count << " 帧)" << std::endl;
+            std::cout << "  状态查询往返: p50=" << query.percentile(0.50) / 1000.0 << "us p99="
+                      << query.percentile(0.99) / 1000.0 << "us max=" << query.maxNs / 1000.0
+                      << "us (成功 " << client->replies() << ", 失败 " << client->failures() << ")"
+                      << std::defaultfloat << std::setprecision(6) << std::endl;
+            if (!client->finished() || send.count != static_cast<uint64_t>(frames) ||
+                client->replies() != static_cast<uint64_t>(queries)) {
+                std::cout << "  ❌ 未完成全部发送或查询" << std::endl;
+                failed += std::string(" ") + transport->name();
+            }
+            transport->printStats(std::cout, " ");
+        }
+
+        transport->disconnect();
+        g_armReactor->stop();
+        delete transport;
+        delete client;
+        delete g_armReactor;
+        g_armReactor = nullptr;
+    }
+    std::cout << std::endl;
+    if (!failed.empty()) {
+        std::cout << "❌ 未完成基准的后端:" << failed << std::endl;
+        return 1;
+    }
+    std::cout << "✅ 全部后端（" << backends.size() << " 个）完成基准" << std::endl;
+    return 0;
+}
+
+/*******************************************************************************
+ 机械臂通信回环自测：对本机 mock_arm_server 运行一个场景，逐项打印检查结果，
+ 全部通过时返回0。模拟器按场景所需的选项由 test/test_arm_loopback.sh 启动：
+ - framing: 模拟器把响应拆成小段分别发送，1000条位姿查询的响应逐条分帧、核对；
+   模拟器随后主动断开，连接按退避自动重连后查询照常完成
+ - backpressure: 模拟器接收缓冲区4KB并周期性停止读取，流式帧经最新帧槽位发送；
+   模拟器指令日志中的每一帧都应完整、序号递增，且最后一帧为最新帧（由脚本核对）
+ - connect: 同时连接三个端口：端口 P 已有模拟器、P+1 拒绝连接、P+2 的模拟器在自测开始约1.5s后
+   才启动。P 不受其他端口影响立即连上，P+1 的退避间隔逐次翻倍到上限，P+2 在模拟器启动后
+   一个退避上限内连上
+ - correlation: 模拟器响应延迟20ms、每5ms插入一条未请求的轨迹到位事件、不应答寄存器写入。
+   流式位姿之间依次发出位姿查询、夹爪、寄存器写入、位姿查询：两条查询按FIFO各得到
+   发出时的位姿，夹爪得到确认，事件不占用任何请求，写入单独超时而不阻塞后发出的查询
+*******************************************************************************/
+// 单项检查：打印结果并返回是否通过
+static bool loopbackCheck(bool ok, const std::string& description)
+{
+    std::cout << (ok ? "  ✅ " : "  ❌ ") << description << std::endl;
+    return ok;
+}
+
+// 每1ms检查一次条件，直到成立或超时
+static bool loopbackWait(const std::function<bool()>& condition, int timeoutMs)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// 在服务线程中保持最多 kWindow 条位姿查询在途，核对每条响应的位姿
+class LoopbackQueryClient : public ArmTransport::Listener {
+public:
+    static const int kWindow = 8;
+
+    LoopbackQueryClient()
+        : m_target(0), m_sent(0), m_inFlight(0), m_replies(0), m_failures(0), m_mismatches(0),
+          m_connects(0), m_disconnects(0), m_connectNs(0), m_disconnectNs(0), m_poseValid(false) {
+        m_pose.fill(0);
+    }
+
+    // 任意线程：再发出 count 条查询
+    void request(int count) { m_target.fetch_add(count, std::memory_order_relaxed); }
+
+    uint64_t replies() const { return m_replies.load(std::memory_order_relaxed); }
+    uint64_t failures() const { return m_failures.load(std::memory_order_relaxed); }
+    uint64_t mismatches() const { return m_mismatches.load(std::memory_order_relaxed); }
+    int connects() const { return m_connects.load(std::memory_order_acquire); }
+    int disconnects() const { return m_disconnects.load(std::memory_order_acquire); }
+    uint64_t connectNs() const { return m_connectNs.load(std::memory_order_relaxed); }
+    uint64_t disconnectNs() const { return m_disconnectNs.load(std::memory_order_relaxed); }
+
+    void onTransportConnected(ArmTransport& transport) override {
+        (void)transport;
+        m_connectNs.store(ArmCommandPipeline::nowNs(), std::memory_order_relaxed);
+        m_connects.fetch_add(1, std::memory_order_release);
+    }
+
+    void onTransportDisconnected(ArmTransport& transport) override {
+        (void)transport;
+        m_disconnectNs.store(ArmCommandPipeline::nowNs(), std::memory_order_relaxed);
+        m_disconnects.fetch_add(1, std::memory_order_release);
+    }
+
+    void onTransportTick(ArmTransport& transport, uint64_t nowNs) override {
+        (void)nowNs;
+        while (transport.isConnected() && m_inFlight < kWindow &&
+               m_sent < m_target.load(std::memory_order_relaxed)) {
+            if (!transport.send(ArmCommand::make(ArmCommand::GetArmState), 500000000ULL, 0,
+                                [this](const ArmResponse* response) { complete(response); })) {
+                break;
+            }
+            ++m_sent;
+            ++m_inFlight;
+        }
+    }
+
+    void onArmState(ArmTransport& transport, const ArmResponse& response) override {
+        (void)transport;
+        (void)response;
+    }
+
+private:
+    // 服务线程：所有响应应带与第一条相同的位姿（模拟器没有运动指令时位姿不变）
+    void complete(const ArmResponse* response) {
+        --m_inFlight;
+        if (!response || !(response->fields & ArmResponse::FieldPose)) {
+            m_failures.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (!m_poseValid) {
+            m_pose = response->pose;
+            m_poseValid = true;
+        }
+        if (response->pose != m_pose) {
+            m_mismatches.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_replies.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::atomic<int> m_target;
+    int m_sent;                     // 以下两项服务线程独占
+    int m_inFlight;
+    std::atomic<uint64_t> m_replies;
+    std::atomic<uint64_t> m_failures;
+    std::atomic<uint64_t> m_mismatches;
+    std::atomic<int> m_connects;
+    std::atomic<int> m_disconnects;
+    std::atomic<uint64_t> m_connectNs;
+    std::atomic<uint64_t> m_disconnectNs;
+    bool m_poseValid;
+    std::array<int, 6> m_pose;
+};
+
+// 每个节拍用 writeLatest() 连续写出 kFramesPerTick 帧 movep_follow，位姿带序号：
+// pose[0] = 序号、pose[5] = -序号（半条帧无法同时满足），最后一帧 pose[1] = 1
+class LoopbackStreamClient : public ArmReactor::Handler {
+public:
+    static const int kFramesPerTick = 4;
+
+    explicit LoopbackStreamClient(int frames) : m_frames(frames), m_sent(0), m_done(false) {}
+
+    bool done() const { return m_done.load(std::memory_order_acquire); }
+
+    void onConnected(ArmReactor::Connection& connection) override { (void)connection; }
+    void onDisconnected(ArmReactor::Connection& connection) override { (void)connection; }
+
+    void onMessage(ArmReactor::Connection& connection, const char* data, size_t length) override {
+        (void)connection;
+        (void)data;
+        (void)length;
+    }
+
+    void onTick(ArmReactor::Connection& connection, uint64_t nowNs) override {
+        (void)nowNs;
+        for (int i = 0; i < kFramesPerTick && connection.isOpen() && m_sent < m_frames; ++i) {
+            int seq = m_sent + 1;
+            std::array<int, 6> pose = {{seq, seq == m_frames ? 1 : 0, 300000, 3141, 0, -seq}};
+            size_t length = m_encoder.encodeMovePFollow(pose);
+            if (!connection.writeLatest(m_encoder.data(), length)) {
+                break;
+            }
+            m_sent = seq;
+        }
+        if (m_sent == m_frames) {
+            m_done.store(true, std::memory_order_release);
+        }
+    }
+
+private:
+    int m_frames;
+    int m_sent;                     // 反应器线程独占
+    CommandEncoder m_encoder;
+    std::atomic<bool> m_done;
+};
+
+// backpressure：mock_arm_server --rcvbuf 4096 --stall-ms 200 --stall-every-ms 300 --log FILE
+static bool loopbackBackpressure(const std::string& ip, int port)
+{
+    const int kFrames = 40000;
+
+    ArmReactor* reactor = new ArmReactor();
+    reactor->setSendBufferSize(4096);
+    LoopbackStreamClient* client = new LoopbackStreamClient(kFrames);
+    ArmReactor::Connection* connection = reactor->addConnection("回环自测", ip, port, client);
+    reactor->start();
+    reactor->connect(connection);
+
+    bool passed = true;
+    passed &= loopbackCheck(loopbackWait([connection]() { return connection->isConnected(); }, 2000),
+                            "连接 " + ip + ":" + std::to_string(port));
+    passed &= loopbackCheck(loopbackWait([client]() { return client->done(); }, 30000),
+                            "写出 " + std::to_string(kFrames) + " 帧流式指令");
+    // 模拟器恢复读取后积压和最新帧槽位都应写空
+    bool drained = loopbackWait([connection]() { return connection->getStats().pendingBytes == 0; }, 5000);
+    ArmReactor::ConnectionStats stats = connection->getStats();
+    passed &= loopbackCheck(drained, "积压写空（待写 " + std::to_string(stats.pendingBytes) + " 字节）");
+    passed &= loopbackCheck(stats.wouldBlock > 0 && stats.superseded > 0,
+                            "发生反压（EAGAIN " + std::to_string(stats.wouldBlock) + " 次，部分写 " +
+                            std::to_string(stats.shortWrites) + " 次，覆盖 " + std::to_string(stats.superseded) +
+                            " 帧）");
+    passed &= loopbackCheck(stats.disconnects == 0 && stats.writeDrops == 0,
+                            "无断开、无写丢弃（断开 " + std::to_string(stats.disconnects) + "，写丢弃 " +
+                            std::to_string(stats.writeDrops) + "）");
+
+    reactor->close(connection);
+    reactor->stop();
+    delete reactor;
+    delete client;
+    return passed;
+}
+
+// 只记录连接建立时间
+class LoopbackConnectProbe : public ArmReactor::Handler {
+public:
+    LoopbackConnectProbe() : m_connectedNs(0) {}
+
+    uint64_t connectedNs() const { return m_connectedNs.load(std::memory_order_acquire); }
+
+    void onConnected(ArmReactor::Connection& connection) override {
+        (void)connection;
+        if (connectedNs() == 0) {
+            m_connectedNs.store(ArmCommandPipeline::nowNs(), std::memory_order_release);
+        }
+    }
+    void onDisconnected(ArmReactor::Connection& connection) override { (void)connection; }
+    void onMessage(ArmReactor::Connection& connection, const char* data, size_t length) override {
+        (void)connection;
+        (void)data;
+        (void)length;
+    }
+    void onTick(ArmReactor::Connection& connection, uint64_t nowNs) override {
+        (void)connection;
+        (void)nowNs;
+    }
+
+private:
+    std::atomic<uint64_t> m_connectedNs;
+};
+
+// connect：mock_arm_server 监听 P；脚本在自测开始 kServerUpMs 后再启动监听 P+2 的模拟器
+static bool loopbackConnect(const std::string& ip, int port)
+{
+    const int kInitialBackoffMs = 50;
+    const int kMaxBackoffMs = 400;
+    const int kServerUpMs = 1500;
+    const int kObserveMs = 3000;
+    const double kSampleSlackMs = 20.0;   // 采样线程每1ms一次，被调度延后时失败时间会晚记
+    const char* kLabels[3] = {"在线端口", "拒绝端口", "延迟启动端口"};
+
+    ArmReactor* reactor = new ArmReactor();
+    reactor->setReconnectPolicy(kInitialBackoffMs, kMaxBackoffMs, 1000);
+    LoopbackConnectProbe probes[3];
+    ArmReactor::Connection* connections[3];
+    for (int i = 0; i < 3; ++i) {
+        connections[i] = reactor->addConnection(kLabels[i], ip, port + i, &probes[i]);
+    }
+    reactor->start();
+    uint64_t startNs = ArmCommandPipeline::nowNs();
+    for (int i = 0; i < 3; ++i) {
+        reactor->connect(connections[i]);
+    }
+
+    // 每1ms采样一次连接失败计数，记下每次失败的时间和选用的退避
+    std::vector<uint64_t> failureNs[3];
+    std::vector<uint64_t> backoffNs[3];
+    uint64_t failures[3] = {0, 0, 0};
+    while (ArmCommandPipeline::nowNs() - startNs < kObserveMs * 1000000ULL) {
+        uint64_t nowNs = ArmCommandPipeline::nowNs();
+        for (int i = 0; i < 3; ++i) {
+            ArmReactor::ConnectionStats stats = connections[i]->getStats();
+            if (stats.connectFailures != failures[i]) {
+                failures[i] = stats.connectFailures;
+                failureNs[i].push_back(nowNs);
+                backoffNs[i].push_back(stats.lastBackoffNs);
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    bool passed = true;
+    std::ostringstream text;
+    double onlineMs = probes[0].connectedNs() ? (probes[0].connectedNs() - startNs) / 1e6 : 0.0;
+    text << std::fixed << std::setprecision(1) << kLabels[0] << " " << port << " 在 " << onlineMs
+         << "ms 内连上（不等待其他端口）";
+    passed &= loopbackCheck(probes[0].connectedNs() != 0 && onlineMs < 50.0, text.str());
+
+    // 拒绝端口：第 n 次失败后的等待在 min(初始值·2^n, 上限) 的 ±20% 内，相邻失败的间隔与之相符
+    bool backoffOk = failureNs[1].size() >= 5 && probes[1].connectedNs() == 0;
+    bool reachedCap = false;
+    text.str("");
+    text << kLabels[1] << " " << port + 1 << " 退避(ms):";
+    for (size_t n = 0; n < backoffNs[1].size(); ++n) {
+        double expectedMs = std::min<double>(kInitialBackoffMs * static_cast<double>(1ULL << std::min<size_t>(n, 20)),
+                                             kMaxBackoffMs);
+        double delayMs = backoffNs[1][n] / 1e6;
+        text << " " << std::setprecision(0) << delayMs;
+        backoffOk &= delayMs >= expectedMs * 0.8 - 1.0 && delayMs <= expectedMs * 1.2 + 1.0;
+        reachedCap |= expectedMs == kMaxBackoffMs;
+        if (n + 1 < failureNs[1].size()) {
+            double gapMs = (failureNs[1][n + 1] - failureNs[1][n]) / 1e6;
+            backoffOk &= std::fabs(gapMs - delayMs) < kSampleSlackMs;
+        }
+    }
+    text << "（上限 " << kMaxBackoffMs << "）";
+    passed &= loopbackCheck(backoffOk && reachedCap, text.str());
+
+    // 延迟启动端口：首次尝试与其他端口同时发起，模拟器启动后不超过一个退避上限（含抖动）连上
+    double firstAttemptMs = failureNs[2].empty() ? -1.0 : (failureNs[2][0] - startNs) / 1e6;
+    double lateMs = probes[2].connectedNs() ? (probes[2].connectedNs() - startNs) / 1e6 : 0.0;
+    text.str("");
+    text << std::setprecision(1) << kLabels[2] << " " << port + 2 << " 首次尝试 " << firstAttemptMs
+         << "ms，失败 " << failureNs[2].size() << " 次后于 " << lateMs << "ms 连上（模拟器约 " << kServerUpMs
+         << "ms 启动）";
+    passed &= loopbackCheck(firstAttemptMs >= 0.0 && firstAttemptMs < 50.0 && probes[2].connectedNs() != 0 &&
+                            lateMs <= kServerUpMs + kMaxBackoffMs * 1.2 + 100.0, text.str());
+
+    for (int i = 0; i < 3; ++i) {
+        reactor->close(connections[i]);
+    }
+    reactor->stop();
+    delete reactor;
+    return passed;
+}
+
+// 连接后在服务线程中一次发出全部请求，记录每个请求的结果、完成顺序和耗时
+class LoopbackCorrelationClient : public ArmTransport::Listener {
+public:
+    enum Request { FirstQuery, Gripper, RegisterWrite, SecondQuery, RequestCount };
+    static const uint64_t kWriteTimeoutNs = 300000000ULL;
+
+    LoopbackCorrelationClient() : m_connected(false), m_issued(false), m_completions(0) {
+        m_firstPose = {{250000, 10000, 300000, 3141, 0, 0}};
+        m_secondPose = {{260000, -10000, 310000, 3141, 0, 100}};
+        for (int i = 0; i < RequestCount; ++i) {
+            m_done[i].store(false, std::memory_order_relaxed);
+            m_ok[i] = false;
+            m_poseMatches[i] = false;
+            m_order[i] = 0;
+            m_sentNs[i] = 0;
+            m_elapsedNs[i] = 0;
+        }
+    }
+
+    bool done(int request) const { return m_done[request].load(std::memory_order_acquire); }
+    // 以下在 done() 之后读取
+    bool ok(int request) const { return m_ok[request]; }
+    bool poseMatches(int request) const { return m_poseMatches[request]; }
+    int order(int request) const { return m_order[request]; }
+    double elapsedMs(int request) const { return m_elapsedNs[request] / 1e6; }
+
+    void onTransportConnected(ArmTransport& transport) override {
+        (void)transport;
+        m_connected = true;
+    }
+    void onTransportDisconnected(ArmTransport& transport) override {
+        (void)transport;
+        m_connected = false;
+    }
+
+    // 查询响应中的位姿是模拟器收到查询时的位姿：两条查询之间的流式帧改变了它
+    void onTransportTick(ArmTransport& transport, uint64_t nowNs) override {
+        (void)nowNs;
+        if (!m_connected || m_issued) {
+            return;
+        }
+        m_issued = true;
+        transport.streamPose(m_firstPose);
+        issue(transport, FirstQuery, ArmCommand::make(ArmCommand::GetArmState), 500000000ULL);
+        issue(transport, Gripper, ArmCommand::make(ArmCommand::GripperPick, 500, 200, 1), 1000000000ULL);
+        issue(transport, RegisterWrite, ArmCommand::make(ArmCommand::WriteSingleRegister, 1, 0, 1, 1),
+              kWriteTimeoutNs);
+        transport.streamPose(m_secondPose);
+        issue(transport, SecondQuery, ArmCommand::make(ArmCommand::GetArmState), 500000000ULL);
+    }
+
+    void onArmState(ArmTransport& transport, const ArmResponse& response) override {
+        (void)transport;
+        (void)response;
+    }
+
+private:
+    void issue(ArmTransport& transport, Request request, const ArmCommand& command, uint64_t timeoutNs) {
+        m_sentNs[request] = ArmCommandPipeline::nowNs();
+        bool sent = transport.send(command, timeoutNs, 0, [this, request](const ArmResponse* response) {
+            m_ok[request] = response != nullptr;
+            if (response && request == FirstQuery) {
+                m_poseMatches[request] = (response->fields & ArmResponse::FieldPose) && response->pose == m_firstPose;
+            } else if (response && request == SecondQuery) {
+                m_poseMatches[request] = (response->fields & ArmResponse::FieldPose) && response->pose == m_secondPose;
+            }
+            m_order[request] = ++m_completions;
+            m_elapsedNs[request] = ArmCommandPipeline::nowNs() - m_sentNs[request];
+            m_done[request].store(true, std::memory_order_release);
+        });
+        if (!sent) {
+            m_done[request].store(true, std::memory_order_release);
+        }
+    }
+
+    std::array<int, 6> m_firstPose;
+    std::array<int, 6> m_secondPose;
+    bool m_connected;               // 以下服务线程独占，结果由 m_done 的release/acquire发布
+    bool m_issued;
+    int m_completions;
+    std::atomic<bool> m_done[RequestCount];
+    bool m_ok[RequestCount];
+    bool m_poseMatches[RequestCount];
+    int m_order[RequestCount];
+    uint64_t m_sentNs[RequestCount];
+    uint64_t m_elapsedNs[RequestCount];
+};
+
+// correlation：mock_arm_server --latency-ms 20 --event-ms 5 --no-reply write_single_register
+static bool loopbackCorrelation(const std::string& ip, int port)
+{
+    ArmReactor* reactor = new ArmReactor();
+    JsonArmTransport* transport = new JsonArmTransport(*reactor, ip, port);
+    LoopbackCorrelationClient* client = new LoopbackCorrelationClient();
+    transport->attach(client, BinaryLogger::instance().registerSource("回环自测"));
+    reactor->start();
+    transport->connect();
+
+    bool passed = true;
+    passed &= loopbackCheck(loopbackWait([transport]() { return transport->isConnected(); }, 2000),
+                            "连接 " + ip + ":" + std::to_string(port));
+    bool finished = loopbackWait([client]() {
+        for (int i = 0; i < LoopbackCorrelationClient::RequestCount; ++i) {
+            if (!client->done(i)) {
+                return false;
+            }
+        }
+        return true;
+    }, 3000);
+    passed &= loopbackCheck(finished, "四个请求全部完成（响应或超时）");
+
+    if (finished) {
+        typedef LoopbackCorrelationClient Client;
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << "两条位姿查询按FIFO对应（第 " << client->order(Client::FirstQuery)
+             << "/" << client->order(Client::SecondQuery) << " 个完成，" << client->elapsedMs(Client::FirstQuery)
+             << "/" << client->elapsedMs(Client::SecondQuery) << "ms），各得到发出时的位姿";
+        passed &= loopbackCheck(client->ok(Client::FirstQuery) && client->ok(Client::SecondQuery) &&
+                                client->poseMatches(Client::FirstQuery) && client->poseMatches(Client::SecondQuery) &&
+                                client->order(Client::FirstQuery) < client->order(Client::SecondQuery),
+                                text.str());
+        text.str("");
+        text << "夹爪指令得到确认（" << client->elapsedMs(Client::Gripper) << "ms）";
+        passed &= loopbackCheck(client->ok(Client::Gripper), text.str());
+        text.str("");
+        text << "未应答的寄存器写入在 " << client->elapsedMs(Client::RegisterWrite) << "ms 后超时（超时 "
+             << Client::kWriteTimeoutNs / 1000000 << "ms），后发出的查询不受阻塞";
+        passed &= loopbackCheck(!client->ok(Client::RegisterWrite) &&
+                                client->elapsedMs(Client::RegisterWrite) >= Client::kWriteTimeoutNs / 1e6 &&
+                                client->elapsedMs(Client::RegisterWrite) < Client::kWriteTimeoutNs / 1e6 + 50.0 &&
+                                client->order(Client::RegisterWrite) == Client::RequestCount,
+                                text.str());
+    }
+    uint64_t unsolicited = transport->getUnsolicitedCount();
+    passed &= loopbackCheck(unsolicited > 0, "轨迹到位事件计为未请求的响应（" + std::to_string(unsolicited) + " 条）");
+
+    transport->printStats(std::cout, "  ");
+    transport->disconnect();
+    reactor->stop();
+    delete transport;
+    delete client;
+    delete reactor;
+    return passed;
+}
+
+// framing：mock_arm_server --segment 7 --segment-gap-us 50 --close-after 1000
+static bool loopbackFraming(const std::string& ip, int port)
+{
+    const int kFirstSession = 1000;
+    const int kSecondSession = 100;
+    const int kBackoffMs = 50;
+
+    ArmReactor* reactor = new ArmReactor();
+    reactor->setReconnectPolicy(kBackoffMs, 400, 1000);
+    JsonArmTransport* transport = new JsonArmTransport(*reactor, ip, port);
+    LoopbackQueryClient* client = new LoopbackQueryClient();
+    transport->attach(client, BinaryLogger::instance().registerSource("回环自测"));
+    reactor->start();
+    transport->connect();
+
+    bool passed = true;
+    passed &= loopbackCheck(loopbackWait([client]() { return client->connects() == 1; }, 2000),
+                            "连接 " + ip + ":" + std::to_string(port));
+    client->request(kFirstSession);
+    loopbackWait([client]() { return client->replies() + client->failures() >= kFirstSession; }, 20000);
+    passed &= loopbackCheck(client->replies() == kFirstSession && client->failures() == 0,
+                            "分段到达的 " + std::to_string(kFirstSession) + " 条响应全部分帧并对应（成功 " +
+                            std::to_string(client->replies()) + "，失败 " + std::to_string(client->failures()) + "）");
+    passed &= loopbackCheck(client->mismatches() == 0,
+                            "响应位姿逐条一致（不一致 " + std::to_string(client->mismatches()) + "）");
+
+    // 模拟器发完最后一条响应后断开，反应器按初始退避重连
+    bool reconnected = loopbackWait([client]() { return client->connects() == 2; }, 3000);
+    double reconnectMs = reconnected ? (client->connectNs() - client->disconnectNs()) / 1e6 : 0.0;
+    std::ostringstream reconnectText;
+    reconnectText << "对端断开后自动重连（断开 " << client->disconnects() << " 次，" << std::fixed
+                  << std::setprecision(1) << reconnectMs << "ms 后重连）";
+    passed &= loopbackCheck(reconnected && client->disconnects() == 1 && reconnectMs < kBackoffMs * 1.2 + 20.0,
+                            reconnectText.str());
+
+    client->request(kSecondSession);
+    loopbackWait([client]() { return client->replies() + client->failures() >= kFirstSession + kSecondSession; },
+                 10000);
+    passed &= loopbackCheck(client->replies() == kFirstSession + kSecondSession && client->failures() == 0 &&
+                            client->mismatches() == 0,
+                            "重连后 " + std::to_string(kSecondSession) + " 条查询全部完成");
+
+    transport->printStats(std::cout, "  ");
+    transport->disconnect();
+    reactor->stop();
+    delete transport;
+    delete client;
+    delete reactor;
+    return passed;
+}
+
+int runLoopbackSelftest(int argc, char* argv[])
+{
+    static const struct {
+        const char* name;
+        bool (*run)(const std::string& ip, int port);
+    } kScenarios[] = {
+        {"framing", loopbackFraming},
+        {"backpressure", loopbackBackpressure},
+        {"connect", loopbackConnect},
+        {"correlation", loopbackCorrelation},
+    };
+
+    std::string scenario = argc > 2 ? argv[2] : "";
+    std::string address = argc > 3 ? argv[3] : "127.0.0.1:18080";
+    size_t colon = address.rfind(':');
+    std::string ip = colon != std::string::npos ? address.substr(0, colon) : "";
+    int port = colon != std::string::npos ? atoi(address.c_str() + colon + 1) : 0;
+    bool (*run)(const std::string& ip, int port) = nullptr;
+    for (size_t i = 0; i < sizeof(kScenarios) / sizeof(kScenarios[0]); ++i) {
+        if (scenario == kScenarios[i].name) {
+            run = kScenarios[i].run;
+        }
+    }
+    if (!run || ip.empty() || port <= 0 || port >= 65536) {
+        std::cerr << "用法: " << argv[0] << " --selftest-loopback <场景> [IP:端口]" << std::endl;
+        std::cerr << "场景:";
+        for (size_t i = 0; i < sizeof(kScenarios) / sizeof(kScenarios[0]); ++i) {
+            std::cerr << " " << kScenarios[i].name;
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+
+    std::cout << "=== 回环自测 " << scenario << " (" << address << ") ===" << std::endl;
+    bool passed = run(ip, port);
+    std::cout << (passed ? "✅ " : "❌ ") << scenario << (passed ? " 通过" : " 失败") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,482 @@
+#include "TrajectoryGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+#include "ServoTiming.h"
+
+namespace {
+
+// 位置轴偏差以微米、姿态轴以毫弧度计，输出最终取整，偏差在1个单位内视为未限制
+const double kLimitedThreshold = 1.0;
+
+// 前馈的目标加速度不超过加速度上限的该比例，其余留给制动
+const double kFeedforwardAcceleration = 0.8;
+
+// 单个jerk求根的二分次数（区间宽度 2×最大加加速度，2^-24 的分辨率远小于取整误差）
+const int kBisections = 24;
+
+double signOf(double value) {
+    return value < 0.0 ? -1.0 : 1.0;
+}
+
+} // namespace
+
+TrajectoryGenerator::Params::Params() : mode(Off), targetVelocity(true) {
+    // 保守默认值，低于RM65末端的出厂速度能力；实际值可由 rm_get_arm_max_line_speed /
+    // rm_get_arm_max_line_acc / rm_get_arm_max_angular_speed 等读出后写入配置
+    setPositionLimits(250.0, 1600.0, 20000.0);
+    setRotationLimits(1.0, 4.0, 50.0);
+}
+
+void TrajectoryGenerator::Params::setPositionLimits(double velocityMm, double accelerationMm, double jerkMm) {
+    for (int i = 0; i < 3; ++i) {
+        maxVelocity[i] = velocityMm * 1000.0;
+        maxAcceleration[i] = accelerationMm * 1000.0;
+        maxJerk[i] = jerkMm * 1000.0;
+    }
+}
+
+void TrajectoryGenerator::Params::setRotationLimits(double velocityRad, double accelerationRad, double jerkRad) {
+    for (int i = 3; i < kAxes; ++i) {
+        maxVelocity[i] = velocityRad * 1000.0;
+        maxAcceleration[i] = accelerationRad * 1000.0;
+        maxJerk[i] = jerkRad * 1000.0;
+    }
+}
+
+TrajectoryGenerator::TrajectoryGenerator()
+    : m_initialized(false), m_lastNs(0),
+      m_steps(0), m_limitedSteps(0), m_maxLagPositionUm(0), m_maxLagRotationUrad(0) {
+    for (int i = 0; i < kAxes; ++i) {
+        m_axes[i].position = 0.0;
+        m_axes[i].velocity = 0.0;
+        m_axes[i].acceleration = 0.0;
+        m_axes[i].lastTarget = 0.0;
+        m_axes[i].lastTargetVelocity = 0.0;
+    }
+}
+
+void TrajectoryGenerator::configure(const Params& params) {
+    Params defaults;
+    m_params = params;
+    for (int i = 0; i < kAxes; ++i) {
+        if (m_params.maxVelocity[i] <= 0.0) m_params.maxVelocity[i] = defaults.maxVelocity[i];
+        if (m_params.maxAcceleration[i] <= 0.0) m_params.maxAcceleration[i] = defaults.maxAcceleration[i];
+        if (m_params.maxJerk[i] <= 0.0) m_params.maxJerk[i] = defaults.maxJerk[i];
+    }
+    m_initialized = false;
+}
+
+bool TrajectoryGenerator::parseMode(const std::string& name, Mode& mode) {
+    if (name == "off") {
+        mode = Off;
+    } else if (name == "jerk_limited") {
+        mode = JerkLimited;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* TrajectoryGenerator::modeName(Mode mode) {
+    return mode == JerkLimited ? "jerk_limited" : "off";
+}
+
+void TrajectoryGenerator::reset(const double position[kAxes], uint64_t nowNs) {
+    for (int i = 0; i < kAxes; ++i) {
+        m_axes[i].position = position[i];
+        m_axes[i].velocity = 0.0;
+        m_axes[i].acceleration = 0.0;
+        m_axes[i].lastTarget = position[i];
+        m_axes[i].lastTargetVelocity = 0.0;
+    }
+    m_lastNs = nowNs;
+    m_initialized = true;
+}
+
+double TrajectoryGenerator::stoppingDistance(double velocity, double acceleration,
+                                             double maxAcceleration, double maxJerk) {
+    // 先把加速度归零后剩余的速度决定制动方向
+    double residual = velocity + acceleration * std::fabs(acceleration) / (2.0 * maxJerk);
+    if (residual == 0.0) {
+        double t = std::fabs(acceleration) / maxJerk;
+        return velocity * t + acceleration * t * t / 2.0 - signOf(acceleration) * maxJerk * t * t * t / 6.0;
+    }
+
+    // 镜像到正方向：jerk -J 把加速度降到 -peak，保持，再以 +J 回到0，同时速度降到0
+    double s = signOf(residual);
+    double v = s * velocity;
+    double a = s * acceleration;
+    double peak = std::sqrt(maxJerk * v + a * a / 2.0);
+    double hold = 0.0;
+    if (peak > maxAcceleration) {
+        peak = maxAcceleration;
+        hold = (v + a * a / (2.0 * maxJerk) - peak * peak / maxJerk) / peak;
+    }
+    const double durations[3] = {(a + peak) / maxJerk, hold, peak / maxJerk};
+    const double jerks[3] = {-maxJerk, 0.0, maxJerk};
+    double x = 0.0;
+    for (int phase = 0; phase < 3; ++phase) {
+        double t = durations[phase];
+        double j = jerks[phase];
+        x += v * t + a * t * t / 2.0 + j * t * t * t / 6.0;
+        v += a * t + j * t * t / 2.0;
+        a += j * t;
+    }
+    return s * x;
+}
+
+void TrajectoryGenerator::stepAxis(Axis& axis, double target, double targetVelocity, double targetAcceleration,
+                                   double dt, double maxVelocity, double maxAcceleration, double maxJerk) {
+    // 在随目标匀加速运动的坐标系中求解：相对位置、速度、加速度都要归零
+    // （target、targetVelocity 为目标在这一拍起点的位置和速度）
+    double e = axis.position - target;
+    double w = axis.velocity - targetVelocity;
+    double a = axis.acceleration;
+    double alpha = a - targetAcceleration;
+    double dt2 = dt * dt / 2.0;
+    double dt3 = dt * dt * dt / 6.0;
+
+    // 剩余偏差在一拍的加加速度能力之内时直接落到目标轨迹上（避免在制动曲线两侧来回切换）
+    if (std::fabs(e) <= maxJerk * dt3 && std::fabs(w) <= maxJerk * dt2 && std::fabs(alpha) <= maxJerk * dt &&
+        std::fabs(targetVelocity + targetAcceleration * dt) <= maxVelocity) {
+        axis.position = target + targetVelocity * dt + targetAcceleration * dt2;
+        axis.velocity = targetVelocity + targetAcceleration * dt;
+        axis.acceleration = targetAcceleration;
+        return;
+    }
+
+    // 制动时的相对加速度不能让绝对加速度超限
+    double brakeAcceleration = maxAcceleration - std::fabs(targetAcceleration);
+
+    // 加速度上限
+    double low = std::max(-maxJerk, (-maxAcceleration - a) / dt);
+    double high = std::min(maxJerk, (maxAcceleration - a) / dt);
+    if (low > high) {
+        low = high = std::max(-maxJerk, std::min(maxJerk, -a / dt));
+    }
+
+    // 速度上限：这一拍内、拍末以及之后以最大jerk把加速度归零的过程中，速度的极值不超过上限
+    // （最大值和最小值都关于jerk单调递增）
+    struct Velocity {
+        double v, a, dt, dt2, maxJerk;
+        double operator()(double j, bool upper) const {
+            double a1 = a + j * dt;
+            double v1 = v + a * dt + j * dt2;
+            double after = v1 + a1 * std::fabs(a1) / (2.0 * maxJerk);
+            double extreme = upper ? std::max(v1, after) : std::min(v1, after);
+            if (a * a1 < 0.0) {
+                // 加速度在这一拍内过零，速度在过零点取极值
+                double inStep = v - a * a / (2.0 * j);
+                extreme = upper ? std::max(extreme, inStep) : std::min(extreme, inStep);
+            }
+            return extreme;
+        }
+    } reachable = {axis.velocity, a, dt, dt2, maxJerk};
+    if (reachable(high, true) > maxVelocity) {
+        if (reachable(low, true) >= maxVelocity) {
+            high = low;
+        } else {
+            double lo = low, hi = high;
+            for (int i = 0; i < kBisections; ++i) {
+                double mid = (lo + hi) / 2.0;
+                (reachable(mid, true) > maxVelocity ? hi : lo) = mid;
+            }
+            high = lo;
+        }
+    }
+    if (reachable(low, false) < -maxVelocity) {
+        if (reachable(high, false) <= -maxVelocity) {
+            low = high;
+        } else {
+            double lo = low, hi = high;
+            for (int i = 0; i < kBisections; ++i) {
+                double mid = (lo + hi) / 2.0;
+                (reachable(mid, false) < -maxVelocity ? lo : hi) = mid;
+            }
+            low = hi;
+        }
+    }
+
+    // 下一拍立即制动时的停止位置（相对目标），关于jerk单调递增；求使其为0的jerk
+    struct Stop {
+        double e, w, alpha, dt, dt2, dt3, brakeAcceleration, maxJerk;
+        double operator()(double j) const {
+            return e + w * dt + alpha * dt2 + j * dt3 +
+                   stoppingDistance(w + alpha * dt + j * dt2, alpha + j * dt, brakeAcceleration, maxJerk);
+        }
+    } stop = {e, w, alpha, dt, dt2, dt3, brakeAcceleration, maxJerk};
+    double jerk;
+    if (stop(low) >= 0.0) {
+        jerk = low;
+    } else if (stop(high) <= 0.0) {
+        jerk = high;
+    } else {
+        double lo = low, hi = high;
+        for (int i = 0; i < kBisections; ++i) {
+            double mid = (lo + hi) / 2.0;
+            (stop(mid) > 0.0 ? hi : lo) = mid;
+        }
+        jerk = (lo + hi) / 2.0;
+    }
+
+    axis.position += axis.velocity * dt + a * dt2 + jerk * dt3;
+    axis.velocity += a * dt + jerk * dt2;
+    axis.acceleration = a + jerk * dt;
+}
+
+void TrajectoryGenerator::step(const double target[kAxes], uint64_t nowNs, double out[kAxes]) {
+    if (!m_initialized) {
+        reset(target, nowNs);
+    }
+
+    // 两次发送之间的实际间隔；长时间中断时限制步长，避免一次积分跨过整个制动过程
+    double dt = nowNs > m_lastNs ? (nowNs - m_lastNs) * 1e-9 : 0.0;
+    if (dt > 0.05) {
+        dt = 0.05;
+    }
+    m_lastNs = nowNs;
+
+    bool limited = false;
+    double lagPosition = 0.0;
+    double lagRotation = 0.0;
+    for (int i = 0; i < kAxes; ++i) {
+        Axis& axis = m_axes[i];
+        double goal = target[i];
+        if (dt > 0.0) {
+            // 目标在这一拍内从上一个目标匀加速运动到新目标：平均速度为差分，加速度为
+            // 相邻两拍平均速度之差。差分速度超过上限说明是跳变而不是运动，按停在新目标处理
+            double averageVelocity = (goal - axis.lastTarget) / dt;
+            double start = goal;
+            double targetVelocity = 0.0;
+            double targetAcceleration = 0.0;
+            if (m_params.targetVelocity && std::fabs(averageVelocity) <= m_params.maxVelocity[i]) {
+                targetAcceleration = (averageVelocity - axis.lastTargetVelocity) / dt;
+                if (std::fabs(targetAcceleration) > kFeedforwardAcceleration * m_params.maxAcceleration[i]) {
+                    targetAcceleration = 0.0;
+                }
+                start = axis.lastTarget;
+                targetVelocity = averageVelocity - targetAcceleration * dt / 2.0;
+            } else {
+                averageVelocity = 0.0;
+            }
+            stepAxis(axis, start, targetVelocity, targetAcceleration, dt,
+                     m_params.maxVelocity[i], m_params.maxAcceleration[i], m_params.maxJerk[i]);
+            axis.lastTargetVelocity = averageVelocity;
+        }
+        axis.lastTarget = goal;
+
+        double lag = std::fabs(goal - axis.position);
+        if (lag > kLimitedThreshold) {
+            limited = true;
+        }
+        if (i < 3) {
+            lagPosition = std::max(lagPosition, lag);
+        } else {
+            lagRotation = std::max(lagRotation, lag);
+        }
+        out[i] = axis.position;
+    }
+
+    m_steps.store(m_steps.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (limited) {
+        m_limitedSteps.store(m_limitedSteps.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    storeMax(m_maxLagPositionUm, static_cast<uint64_t>(lagPosition));
+    storeMax(m_maxLagRotationUrad, static_cast<uint64_t>(lagRotation * 1000.0));
+}
+
+void TrajectoryGenerator::getState(double velocity[kAxes], double acceleration[kAxes]) const {
+    for (int i = 0; i < kAxes; ++i) {
+        velocity[i] = m_axes[i].velocity;
+        acceleration[i] = m_axes[i].acceleration;
+    }
+}
+
+void TrajectoryGenerator::getStats(Stats& stats) const {
+    stats.steps = m_steps.load(std::memory_order_relaxed);
+    stats.limitedSteps = m_limitedSteps.load(std::memory_order_relaxed);
+    stats.maxLagPosition = static_cast<double>(m_maxLagPositionUm.load(std::memory_order_relaxed));
+    stats.maxLagRotation = m_maxLagRotationUrad.load(std::memory_order_relaxed) / 1000.0;
+}
+
+namespace {
+
+uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief 基准中逐拍核对速度/加速度/加加速度与上限之比（>1即超限）
+ */
+struct LimitMonitor {
+    const TrajectoryGenerator::Params& params;
+    double lastAcceleration[TrajectoryGenerator::kAxes];
+    double ratio[3];   // 速度、加速度、加加速度
+
+    explicit LimitMonitor(const TrajectoryGenerator::Params& p) : params(p) {
+        for (int i = 0; i < TrajectoryGenerator::kAxes; ++i) lastAcceleration[i] = 0.0;
+        ratio[0] = ratio[1] = ratio[2] = 0.0;
+    }
+
+    void update(const TrajectoryGenerator& generator, double dt) {
+        double velocity[TrajectoryGenerator::kAxes];
+        double acceleration[TrajectoryGenerator::kAxes];
+        generator.getState(velocity, acceleration);
+        for (int i = 0; i < TrajectoryGenerator::kAxes; ++i) {
+            ratio[0] = std::max(ratio[0], std::fabs(velocity[i]) / params.maxVelocity[i]);
+            ratio[1] = std::max(ratio[1], std::fabs(acceleration[i]) / params.maxAcceleration[i]);
+            ratio[2] = std::max(ratio[2], std::fabs(acceleration[i] - lastAcceleration[i]) / dt / params.maxJerk[i]);
+            lastAcceleration[i] = acceleration[i];
+        }
+    }
+
+    // 离散积分和二分求根的舍入误差之外不允许超限
+    bool ok() const { return ratio[0] <= 1.0001 && ratio[1] <= 1.0001 && ratio[2] <= 1.0001; }
+};
+
+void printLimits(std::ostream& os, const LimitMonitor& monitor) {
+    os << "    峰值/上限: 速度 " << std::setprecision(4) << monitor.ratio[0]
+       << ", 加速度 " << monitor.ratio[1] << ", 加加速度 " << monitor.ratio[2]
+       << (monitor.ok() ? "" : "  ❌ 超限") << std::endl;
+}
+
+} // namespace
+
+bool TrajectoryGenerator::benchmark(std::ostream& os, const Params& params, double rateHz) {
+    Params benchParams = params;
+    benchParams.mode = JerkLimited;
+    const uint64_t periodNs = static_cast<uint64_t>(1e9 / rateHz);
+    const double dt = periodNs * 1e-9;
+    const double kTwoPi = 2.0 * M_PI;
+    bool ok = true;
+
+    os << std::fixed << "--- 指令频率 " << std::setprecision(0) << rateHz << "Hz（dt="
+       << std::setprecision(2) << dt * 1000.0 << "ms）---" << std::endl;
+
+    // 1. 单次 step() 耗时：6轴随机阶跃叠加正弦，覆盖加速、巡航、制动和到达各分支
+    {
+        TrajectoryGenerator generator;
+        generator.configure(benchParams);
+        double zero[kAxes] = {0, 0, 0, 0, 0, 0};
+        uint64_t nowNs = 1000000000ULL;
+        generator.reset(zero, nowNs);
+        LatencyHistogram histogram(1000000);
+        LimitMonitor monitor(benchParams);
+        double target[kAxes], out[kAxes];
+        double stepTarget[kAxes] = {0, 0, 0, 0, 0, 0};
+        uint32_t random = 12345;
+        const int kSteps = 200000;
+        for (int n = 0; n < kSteps; ++n) {
+            if (n % static_cast<int>(rateHz * 0.7) == 0) {
+                for (int i = 0; i < kAxes; ++i) {
+                    random = random * 1664525u + 1013904223u;
+                    double unit = (random >> 8) / 16777216.0 - 0.5;
+                    stepTarget[i] = unit * (i < 3 ? 80000.0 : 600.0);
+                }
+            }
+            double t = n * dt;
+            for (int i = 0; i < kAxes; ++i) {
+                double amplitude = i < 3 ? 20000.0 : 150.0;
+                target[i] = stepTarget[i] + amplitude * std::sin(kTwoPi * (0.3 + 0.2 * i) * t);
+            }
+            nowNs += periodNs;
+            uint64_t startNs = steadyNowNs();
+            generator.step(target, nowNs, out);
+            histogram.record(steadyNowNs() - startNs);
+            monitor.update(generator, dt);
+        }
+        LatencyHistogram::Snapshot snapshot;
+        histogram.snapshot(snapshot);
+        os << "  step() 耗时（6轴，" << kSteps << " 次）: p50=" << std::setprecision(2)
+           << snapshot.percentile(0.50) / 1000.0 << "us p99=" << snapshot.percentile(0.99) / 1000.0
+           << "us max=" << snapshot.maxNs / 1000.0 << "us 平均=" << snapshot.meanNs() / 1000.0 << "us" << std::endl;
+        printLimits(os, monitor);
+        ok &= monitor.ok();
+    }
+
+    // 2. 阶跃：X 50mm、RZ 0.5rad（快速甩动触觉笔的极限情况）
+    {
+        TrajectoryGenerator generator;
+        generator.configure(benchParams);
+        double zero[kAxes] = {0, 0, 0, 0, 0, 0};
+        uint64_t nowNs = 1000000000ULL;
+        generator.reset(zero, nowNs);
+        LimitMonitor monitor(benchParams);
+        const double target[kAxes] = {50000.0, 0, 0, 0, 0, 500.0};
+        double out[kAxes];
+        double reachX = -1.0, settle = -1.0, overshoot = 0.0;
+        for (int n = 1; n <= static_cast<int>(5.0 * rateHz); ++n) {
+            nowNs += periodNs;
+            generator.step(target, nowNs, out);
+            monitor.update(generator, dt);
+            overshoot = std::max(overshoot, out[0] - target[0]);
+            if (reachX < 0.0 && std::fabs(out[0] - target[0]) <= 500.0) {
+                reachX = n * dt;
+            }
+            if (settle < 0.0 && out[0] == target[0] && out[5] == target[5]) {
+                settle = n * dt;
+            }
+        }
+        os << "  阶跃 X 50mm + RZ 0.5rad: 到达1% " << std::setprecision(0) << reachX * 1000.0
+           << "ms, 完全到达 " << settle * 1000.0 << "ms, 超调 " << std::setprecision(1) << overshoot << "um" << std::endl;
+        printLimits(os, monitor);
+        ok &= monitor.ok() && settle > 0.0;
+    }
+
+    // 3. 正弦跟踪：X 30mm@1Hz、RZ 0.2rad@0.5Hz（在限制内的常规拖动），分别在有/无目标速度前馈时
+    //    估计跟踪延迟；前2秒为从静止追上运动目标的过渡过程，不计入
+    for (int feedforward = 1; feedforward >= 0; --feedforward) {
+        TrajectoryGenerator generator;
+        benchParams.targetVelocity = feedforward != 0;
+        generator.configure(benchParams);
+        double zero[kAxes] = {0, 0, 0, 0, 0, 0};
+        uint64_t nowNs = 1000000000ULL;
+        generator.reset(zero, nowNs);
+        LimitMonitor monitor(benchParams);
+        const int kSteps = static_cast<int>(7.0 * rateHz);
+        const int kWarmup = static_cast<int>(2.0 * rateHz);
+        double* outputX = new double[kSteps];
+        double target[kAxes] = {0, 0, 0, 0, 0, 0};
+        double out[kAxes];
+        for (int n = 0; n < kSteps; ++n) {
+            double t = (n + 1) * dt;
+            target[0] = 30000.0 * std::sin(kTwoPi * t);
+            target[5] = 200.0 * std::sin(kTwoPi * 0.5 * t);
+            nowNs += periodNs;
+            generator.step(target, nowNs, out);
+            monitor.update(generator, dt);
+            outputX[n] = out[0];
+        }
+        // 输出与延迟 tau 后的目标之差的RMS最小处即跟踪延迟
+        double bestLag = 0.0, bestRms = 1e300, zeroLagRms = 0.0;
+        for (int lagUs = 0; lagUs <= 200000; lagUs += 100) {
+            double sum = 0.0;
+            for (int n = kWarmup; n < kSteps; ++n) {
+                double t = (n + 1) * dt - lagUs * 1e-6;
+                double diff = outputX[n] - 30000.0 * std::sin(kTwoPi * t);
+                sum += diff * diff;
+            }
+            double rms = std::sqrt(sum / (kSteps - kWarmup));
+            if (lagUs == 0) {
+                zeroLagRms = rms;
+            }
+            if (rms < bestRms) {
+                bestRms = rms;
+                bestLag = lagUs / 1000.0;
+            }
+        }
+        delete[] outputX;
+        os << "  正弦跟踪 X 30mm@1Hz（" << (feedforward ? "目标速度前馈" : "无前馈") << "）: 跟踪延迟 "
+           << std::setprecision(1) << bestLag << "ms"
+           << "（残差RMS " << bestRms << "um），误差RMS " << zeroLagRms << "um" << std::endl;
+        printLimits(os, monitor);
+        ok &= monitor.ok();
+    }
+    os << std::defaultfloat << std::setprecision(6);
+    return ok;
+}
@@ -0,0 +1,137 @@
+#ifndef TRAJECTORYGENERATOR_H
+#define TRAJECTORYGENERATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * @class TrajectoryGenerator
+ * @brief 滤波输出与机械臂之间的在线加加速度（jerk）限制轨迹生成器（每个控制器一个）
+ *
+ * 每个发送节拍以最新目标偏移量（X/Y/Z微米，RX/RY/RZ毫弧度）调用 step()，输出一个
+ * 满足各轴速度、加速度、加加速度上限的位置。按三阶时间最优的思路逐轴计算：
+ * - 以“立即开始制动”时最终停下的位置作为判据，远离目标时以最大加加速度加速，
+ *   制动曲线到达目标时沿曲线减速，每拍求出使停止位置恰好落在目标上的加加速度
+ * - 目标的速度按相邻两拍差分估计（不超过速度上限时），跟随斜坡目标无稳态滞后；
+ *   单拍跳变超过速度上限的目标按阶跃处理
+ * 快速甩动触觉笔产生的阶跃被展开为平滑的S形曲线，机械臂不会因跳变拒绝或剧烈跟随。
+ * 状态为固定大小数组，无分配、无锁；step() 只在伺服线程中调用。
+ */
+class TrajectoryGenerator {
+public:
+    enum Mode { Off, JerkLimited };
+
+    static const int kAxes = 6;
+
+    /**
+     * @brief 轨迹参数（各轴独立；位置轴单位为微米，姿态轴为毫弧度）
+     */
+    struct Params {
+        Mode mode;
+        double maxVelocity[kAxes];        // 每秒
+        double maxAcceleration[kAxes];    // 每秒²
+        double maxJerk[kAxes];            // 每秒³
+        bool targetVelocity;              // 是否按目标差分速度前馈（关闭时每个目标都按静止点处理）
+
+        Params();
+
+        /**
+         * @brief 为位置轴（X/Y/Z，毫米）或姿态轴（RX/RY/RZ，弧度）统一设置上限
+         */
+        void setPositionLimits(double velocityMm, double accelerationMm, double jerkMm);
+        void setRotationLimits(double velocityRad, double accelerationRad, double jerkRad);
+    };
+
+    /**
+     * @brief 运行统计（任意线程读取）
+     */
+    struct Stats {
+        uint64_t steps;            // step() 次数
+        uint64_t limitedSteps;     // 输出与目标不一致（被限制）的次数
+        double maxLagPosition;     // 输出与目标的最大位置偏差（微米）
+        double maxLagRotation;     // 输出与目标的最大姿态偏差（毫弧度）
+    };
+
+    TrajectoryGenerator();
+
+    /**
+     * @brief 设置参数（在伺服线程外、拖动开始前调用）
+     */
+    void configure(const Params& params);
+
+    const Params& getParams() const { return m_params; }
+    bool isEnabled() const { return m_params.mode != Off; }
+
+    /**
+     * @brief 从配置字符串解析模式
+     * @param name off / jerk_limited
+     * @param mode 输出模式
+     * @return 名称有效时返回true
+     */
+    static bool parseMode(const std::string& name, Mode& mode);
+
+    static const char* modeName(Mode mode);
+
+    /**
+     * @brief 以静止状态重置到给定位置（离合开始时调用）
+     */
+    void reset(const double position[kAxes], uint64_t nowNs);
+
+    /**
+     * @brief 推进到 nowNs 并输出位置
+     * @param target 最新目标（可以与 out 为同一数组）
+     * @param nowNs 当前单调时钟时间（纳秒），步长取与上一次调用的实际间隔
+     * @param out 输出位置
+     */
+    void step(const double target[kAxes], uint64_t nowNs, double out[kAxes]);
+
+    /**
+     * @brief 当前速度和加速度（伺服线程或离线调用）
+     */
+    void getState(double velocity[kAxes], double acceleration[kAxes]) const;
+
+    void getStats(Stats& stats) const;
+
+    /**
+     * @brief 离线基准：单次 step() 耗时、阶跃响应、正弦跟踪延迟和限制核对
+     * @param rateHz 模拟的指令频率
+     * @return 所有输出都满足速度/加速度/加加速度上限时返回true
+     */
+    static bool benchmark(std::ostream& os, const Params& params, double rateHz);
+
+private:
+    struct Axis {
+        double position;
+        double velocity;
+        double acceleration;
+        double lastTarget;
+        double lastTargetVelocity;   // 上一拍目标的平均速度
+    };
+
+    // 单轴推进一步：假定目标在这一拍内以 targetVelocity、targetAcceleration 匀加速运动
+    static void stepAxis(Axis& axis, double target, double targetVelocity, double targetAcceleration,
+                         double dt, double maxVelocity, double maxAcceleration, double maxJerk);
+
+    // 从 (velocity, acceleration) 立即制动到相对静止所经过的位移
+    static double stoppingDistance(double velocity, double acceleration, double maxAcceleration, double maxJerk);
+
+    static void storeMax(std::atomic<uint64_t>& value, uint64_t candidate) {
+        if (candidate > value.load(std::memory_order_relaxed)) {
+            value.store(candidate, std::memory_order_relaxed);
+        }
+    }
+
+    Params m_params;
+    Axis m_axes[kAxes];
+    bool m_initialized;
+    uint64_t m_lastNs;
+
+    std::atomic<uint64_t> m_steps;
+    std::atomic<uint64_t> m_limitedSteps;
+    std::atomic<uint64_t> m_maxLagPositionUm;      // 取整到微米
+    std::atomic<uint64_t> m_maxLagRotationUrad;    // 微弧度
+};
+
+#endif // TRAJECTORYGENERATOR_H
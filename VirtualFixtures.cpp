@@ -0,0 +1,446 @@
+#include "VirtualFixtures.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+#include <SnapConstraints/LineConstraint.h>
+#include <SnapConstraints/PlaneConstraint.h>
+#include <SnapConstraints/PointConstraint.h>
+
+namespace {
+
+uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * 单侧平面：法向一侧不约束（返回距离0），另一侧投影回平面
+ */
+class HalfSpaceConstraint : public SnapConstraints::PlaneConstraint {
+public:
+    HalfSpaceConstraint(const hduVector3Dd& point, const hduVector3Dd& normal)
+        : SnapConstraints::PlaneConstraint(point, normal, false) {}
+
+    virtual double testConstraint(const hduVector3Dd& testPt, hduVector3Dd& proxyPt) const {
+        if (dotProduct(testPt - getPoint(), getNormal()) >= 0.0) {
+            proxyPt = testPt;
+            return 0.0;
+        }
+        return SnapConstraints::PlaneConstraint::testConstraint(testPt, proxyPt);
+    }
+};
+
+// 限位投影后浮点残留的容差（毫米）
+const double kLimitEpsilon = 1e-9;
+// 相交限位平面的最大投影轮数
+const int kLimitPasses = 4;
+
+double dot3(const double a[3], const double b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+} // namespace
+
+VirtualFixtures::Fixture::Fixture()
+    : type(Plane), behavior(Guide), snapDistance(0.0), stiffness(0.0) {
+    for (int i = 0; i < 3; ++i) {
+        point[i] = 0.0;
+        normal[i] = 0.0;
+        end[i] = 0.0;
+    }
+}
+
+VirtualFixtures::VirtualFixtures()
+    : m_count(0), m_guideCount(0), m_limitCount(0), m_lastGuide(0),
+      m_evaluations(0), m_guidedTicks(0), m_snapOns(0), m_limitTicks(0), m_finalLimits(0),
+      m_evaluateTime(1000000) {
+}
+
+VirtualFixtures::~VirtualFixtures() {
+    clear();
+}
+
+void VirtualFixtures::clear() {
+    for (int i = 0; i < m_count; ++i) {
+        delete m_entries[i].constraint;
+        m_entries[i].constraint = 0;
+    }
+    m_count = 0;
+    m_guideCount = 0;
+    m_limitCount = 0;
+    m_lastGuide = 0;
+}
+
+bool VirtualFixtures::configure(const Params& params, const std::vector<Fixture>& fixtures, std::ostream& errors) {
+    clear();
+    m_params = params;
+    bool valid = true;
+    for (size_t i = 0; i < fixtures.size(); ++i) {
+        const Fixture& fixture = fixtures[i];
+        if (m_count >= kMaxFixtures) {
+            errors << "警告: 夹具超过 " << kMaxFixtures << " 个，其余 " << fixtures.size() - i << " 个被忽略" << std::endl;
+            return false;
+        }
+        Entry& entry = m_entries[m_count];
+        entry.type = fixture.type;
+        entry.behavior = fixture.behavior;
+        entry.snapDistance = fixture.snapDistance > 0.0 ? fixture.snapDistance : params.snapDistance;
+        entry.stiffness = fixture.stiffness > 0.0 ? fixture.stiffness : params.stiffness;
+        for (int k = 0; k < 3; ++k) {
+            entry.point[k] = fixture.point[k];
+            entry.direction[k] = 0.0;
+        }
+
+        // 平面法向和直线方向必须非零
+        double axis[3] = {0.0, 0.0, 0.0};
+        if (fixture.type == Plane) {
+            for (int k = 0; k < 3; ++k) axis[k] = fixture.normal[k];
+        } else if (fixture.type == Line) {
+            for (int k = 0; k < 3; ++k) axis[k] = fixture.end[k] - fixture.point[k];
+        }
+        double length = std::sqrt(dot3(axis, axis));
+        if (fixture.type != Point && length < 1e-6) {
+            errors << "警告: 夹具" << i + 1 << " (" << typeName(fixture.type) << ") 的"
+                   << (fixture.type == Plane ? "法向" : "端点") << "无效，已跳过" << std::endl;
+            valid = false;
+            continue;
+        }
+        if (fixture.behavior == Limit && fixture.type != Plane) {
+            errors << "警告: 夹具" << i + 1 << " 限位只支持平面，已跳过" << std::endl;
+            valid = false;
+            continue;
+        }
+        if (fixture.type != Point) {
+            for (int k = 0; k < 3; ++k) entry.direction[k] = axis[k] / length;
+        }
+
+        hduVector3Dd point(fixture.point[0], fixture.point[1], fixture.point[2]);
+        if (fixture.behavior == Limit) {
+            entry.constraint = new HalfSpaceConstraint(point, hduVector3Dd(axis[0], axis[1], axis[2]));
+            m_limits[m_limitCount++] = m_count;
+        } else {
+            if (fixture.type == Plane) {
+                entry.constraint = new SnapConstraints::PlaneConstraint(
+                    point, hduVector3Dd(axis[0], axis[1], axis[2]), false);
+            } else if (fixture.type == Line) {
+                entry.constraint = new SnapConstraints::LineConstraint(
+                    point, hduVector3Dd(fixture.end[0], fixture.end[1], fixture.end[2]), false);
+            } else {
+                entry.constraint = new SnapConstraints::PointConstraint(point, false);
+            }
+            entry.constraint->setSnapDistance(entry.snapDistance);
+            m_guides[m_guideCount++] = m_count;
+        }
+        ++m_count;
+    }
+    return valid;
+}
+
+bool VirtualFixtures::parseType(const std::string& name, Type& type) {
+    if (name == "plane") {
+        type = Plane;
+    } else if (name == "line") {
+        type = Line;
+    } else if (name == "point") {
+        type = Point;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool VirtualFixtures::parseBehavior(const std::string& name, Behavior& behavior) {
+    if (name == "guide") {
+        behavior = Guide;
+    } else if (name == "limit") {
+        behavior = Limit;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* VirtualFixtures::typeName(Type type) {
+    switch (type) {
+    case Plane: return "plane";
+    case Line: return "line";
+    case Point: return "point";
+    }
+    return "unknown";
+}
+
+const char* VirtualFixtures::behaviorName(Behavior behavior) {
+    return behavior == Limit ? "limit" : "guide";
+}
+
+bool VirtualFixtures::parseVector(const std::string& text, double value[3]) {
+    std::istringstream stream(text);
+    std::string item;
+    int count = 0;
+    while (std::getline(stream, item, ',')) {
+        if (count >= 3) {
+            return false;
+        }
+        char* end = 0;
+        value[count] = std::strtod(item.c_str(), &end);
+        while (end && (*end == ' ' || *end == '\t')) {
+            ++end;
+        }
+        if (end == item.c_str() || (end && *end != '\0')) {
+            return false;
+        }
+        ++count;
+    }
+    return count == 3;
+}
+
+void VirtualFixtures::reset() {
+    m_lastGuide = 0;
+}
+
+uint64_t VirtualFixtures::applyLimits(double position[3], double pull[3]) const {
+    uint64_t mask = 0;
+    for (int pass = 0; pass < kLimitPasses; ++pass) {
+        bool changed = false;
+        for (int i = 0; i < m_limitCount; ++i) {
+            const Entry& entry = m_entries[m_limits[i]];
+            hduVector3Dd proxy;
+            double distance = entry.constraint->testConstraint(
+                hduVector3Dd(position[0], position[1], position[2]), proxy);
+            if (distance <= kLimitEpsilon) {
+                continue;
+            }
+            for (int k = 0; k < 3; ++k) {
+                pull[k] += entry.stiffness * (proxy[k] - position[k]);
+                position[k] = proxy[k];
+            }
+            mask |= 1ULL << m_limits[i];
+            changed = true;
+        }
+        if (!changed) {
+            break;
+        }
+    }
+    return mask;
+}
+
+void VirtualFixtures::evaluate(const double target[3], Result& result) {
+    uint64_t startNs = steadyNowNs();
+    hduVector3Dd test(target[0], target[1], target[2]);
+    for (int k = 0; k < 3; ++k) {
+        result.position[k] = target[k];
+        result.pull[k] = 0.0;
+    }
+
+    // 引导：吸附距离内最近的一个
+    int best = -1;
+    double bestDistance = 0.0;
+    hduVector3Dd bestProxy;
+    for (int i = 0; i < m_guideCount; ++i) {
+        const Entry& entry = m_entries[m_guides[i]];
+        hduVector3Dd proxy;
+        double distance = entry.constraint->testConstraint(test, proxy);
+        if (distance <= entry.snapDistance && (best < 0 || distance < bestDistance)) {
+            best = m_guides[i];
+            bestDistance = distance;
+            bestProxy = proxy;
+        }
+    }
+    result.guide = best + 1;
+    if (best >= 0) {
+        const Entry& entry = m_entries[best];
+        for (int k = 0; k < 3; ++k) {
+            result.pull[k] = entry.stiffness * (bestProxy[k] - target[k]);
+            result.position[k] = bestProxy[k];
+        }
+        bump(m_guidedTicks);
+        if (result.guide != m_lastGuide) {
+            bump(m_snapOns);
+        }
+    }
+    m_lastGuide = result.guide;
+
+    // 限位在引导之后施加，工作空间边界优先
+    result.limitMask = applyLimits(result.position, result.pull);
+    if (result.limitMask != 0) {
+        bump(m_limitTicks);
+    }
+
+    bump(m_evaluations);
+    m_evaluateTime.record(steadyNowNs() - startNs);
+}
+
+uint64_t VirtualFixtures::enforceLimits(double position[3]) {
+    double pull[3] = {0.0, 0.0, 0.0};
+    uint64_t mask = applyLimits(position, pull);
+    if (mask != 0) {
+        bump(m_finalLimits);
+    }
+    return mask;
+}
+
+void VirtualFixtures::constrainVelocity(const Result& result, double velocity[3]) const {
+    if (result.guide > 0) {
+        const Entry& entry = m_entries[result.guide - 1];
+        double along = dot3(velocity, entry.direction);
+        for (int k = 0; k < 3; ++k) {
+            if (entry.type == Plane) {
+                velocity[k] -= along * entry.direction[k];
+            } else if (entry.type == Line) {
+                velocity[k] = along * entry.direction[k];
+            } else {
+                velocity[k] = 0.0;
+            }
+        }
+    }
+    for (int i = 0; i < m_limitCount && result.limitMask != 0; ++i) {
+        if (!(result.limitMask & (1ULL << m_limits[i]))) {
+            continue;
+        }
+        const Entry& entry = m_entries[m_limits[i]];
+        double inward = dot3(velocity, entry.direction);
+        if (inward < 0.0) {
+            for (int k = 0; k < 3; ++k) {
+                velocity[k] -= inward * entry.direction[k];
+            }
+        }
+    }
+}
+
+void VirtualFixtures::getStats(Stats& stats) const {
+    stats.evaluations = m_evaluations.load(std::memory_order_relaxed);
+    stats.guidedTicks = m_guidedTicks.load(std::memory_order_relaxed);
+    stats.snapOns = m_snapOns.load(std::memory_order_relaxed);
+    stats.limitTicks = m_limitTicks.load(std::memory_order_relaxed);
+    stats.finalLimits = m_finalLimits.load(std::memory_order_relaxed);
+    m_evaluateTime.snapshot(stats.evaluateTime);
+}
+
+std::vector<VirtualFixtures::Fixture> VirtualFixtures::syntheticFixtures(int count) {
+    std::vector<Fixture> fixtures;
+    // 工作空间：X 200~600mm, Y -300~300mm, Z 100~500mm
+    static const double kBox[6][6] = {
+        {200, 0, 0, 1, 0, 0}, {600, 0, 0, -1, 0, 0},
+        {400, -300, 0, 0, 1, 0}, {400, 300, 0, 0, -1, 0},
+        {400, 0, 100, 0, 0, 1}, {400, 0, 500, 0, 0, -1},
+    };
+    for (int i = 0; i < 6 && i < count; ++i) {
+        Fixture fixture;
+        fixture.type = Plane;
+        fixture.behavior = Limit;
+        for (int k = 0; k < 3; ++k) {
+            fixture.point[k] = kBox[i][k];
+            fixture.normal[k] = kBox[i][k + 3];
+        }
+        fixtures.push_back(fixture);
+    }
+    for (int i = 0; i + 6 < count; ++i) {
+        Fixture fixture;
+        fixture.type = static_cast<Type>(i % 3);
+        fixture.behavior = Guide;
+        fixture.point[0] = 230.0 + (i * 37) % 340;
+        fixture.point[1] = -270.0 + (i * 53) % 540;
+        fixture.point[2] = 130.0 + (i * 29) % 340;
+        int axis = (i / 3) % 3;
+        for (int k = 0; k < 3; ++k) {
+            fixture.normal[k] = k == axis ? 1.0 : 0.2;
+            fixture.end[k] = fixture.point[k] + (k == axis ? 50.0 : 10.0);
+        }
+        fixtures.push_back(fixture);
+    }
+    return fixtures;
+}
+
+bool VirtualFixtures::benchmark(std::ostream& os, const char* label, const Params& params,
+                                const std::vector<Fixture>& fixtures, int iterations, uint64_t budgetNs) {
+    VirtualFixtures* instance = new VirtualFixtures();
+    std::ostringstream errors;
+    instance->configure(params, fixtures, errors);
+    os << errors.str();
+    VirtualFixtures& vf = *instance;
+
+    // 目标：工作空间内外的随机点，每隔一个采样取某个引导夹具附近（吸附距离的1.6倍内）的点
+    uint32_t random = 12345;
+    double lower[3] = {1e9, 1e9, 1e9}, upper[3] = {-1e9, -1e9, -1e9};
+    for (int i = 0; i < vf.m_count; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            lower[k] = std::min(lower[k], vf.m_entries[i].point[k]);
+            upper[k] = std::max(upper[k], vf.m_entries[i].point[k]);
+        }
+    }
+    for (int k = 0; k < 3; ++k) {
+        double margin = 0.1 * (upper[k] - lower[k]) + 20.0;
+        lower[k] -= margin;
+        upper[k] += margin;
+    }
+
+    double maxError = 0.0;      // 约束结果与夹具的最大距离（毫米）
+    uint64_t violations = 0;
+    Result result;
+    for (int n = 0; n < iterations; ++n) {
+        double target[3];
+        for (int k = 0; k < 3; ++k) {
+            random = random * 1664525u + 1013904223u;
+            double unit = (random >> 8) / 16777216.0;
+            target[k] = lower[k] + unit * (upper[k] - lower[k]);
+        }
+        if ((n & 1) && vf.m_guideCount > 0) {
+            random = random * 1664525u + 1013904223u;
+            const Entry& entry = vf.m_entries[vf.m_guides[(random >> 8) % vf.m_guideCount]];
+            for (int k = 0; k < 3; ++k) {
+                random = random * 1664525u + 1013904223u;
+                double unit = (random >> 8) / 16777216.0 - 0.5;
+                target[k] = entry.point[k] + unit * 1.6 * entry.snapDistance;
+            }
+        }
+        vf.evaluate(target, result);
+        // 发送节拍上的最终修正：同一目标只施加限位
+        double final[3] = {target[0], target[1], target[2]};
+        vf.enforceLimits(final);
+
+        // 核对：两种结果都满足所有限位平面；只有引导生效时结果落在该夹具上
+        for (int i = 0; i < vf.m_limitCount; ++i) {
+            const Entry& entry = vf.m_entries[vf.m_limits[i]];
+            double offset[3] = {result.position[0] - entry.point[0], result.position[1] - entry.point[1],
+                                result.position[2] - entry.point[2]};
+            double finalOffset[3] = {final[0] - entry.point[0], final[1] - entry.point[1], final[2] - entry.point[2]};
+            double outside = std::max(-dot3(offset, entry.direction), -dot3(finalOffset, entry.direction));
+            if (outside > 1e-6) {
+                ++violations;
+            }
+            maxError = std::max(maxError, outside);
+        }
+        if (result.guide > 0 && result.limitMask == 0) {
+            hduVector3Dd proxy;
+            double distance = vf.m_entries[result.guide - 1].constraint->testConstraint(
+                hduVector3Dd(result.position[0], result.position[1], result.position[2]), proxy);
+            if (distance > 1e-6) {
+                ++violations;
+            }
+            maxError = std::max(maxError, distance);
+        }
+    }
+
+    Stats stats;
+    vf.getStats(stats);
+    uint64_t p99 = stats.evaluateTime.percentile(0.99);
+    bool ok = violations == 0 && p99 * 10 <= budgetNs;
+    os << std::fixed << "  " << label << ": " << vf.m_count << " 个夹具（引导 " << vf.m_guideCount << " / 限位 "
+       << vf.m_limitCount << "）, " << iterations << " 次 evaluate(): p50=" << std::setprecision(2)
+       << stats.evaluateTime.percentile(0.50) / 1000.0 << "us p99=" << p99 / 1000.0
+       << "us max=" << stats.evaluateTime.maxNs / 1000.0 << "us 平均=" << stats.evaluateTime.meanNs() / 1000.0
+       << "us（每个夹具 " << std::setprecision(1) << (vf.m_count ? stats.evaluateTime.meanNs() / vf.m_count : 0.0)
+       << "ns，伺服周期的 " << std::setprecision(3) << 100.0 * p99 / budgetNs << "%）" << std::endl;
+    os << "    吸附=" << std::setprecision(1) << 100.0 * stats.guidedTicks / iterations << "%, 切换=" << stats.snapOns
+       << ", 限位=" << 100.0 * stats.limitTicks / iterations << "%, 最终修正=" << 100.0 * stats.finalLimits / iterations
+       << "%, 最大约束误差=" << std::scientific
+       << std::setprecision(1) << maxError << "mm, 违反=" << violations << " " << (ok ? "✅" : "❌")
+       << std::defaultfloat << std::setprecision(6) << std::endl;
+    delete instance;
+    return ok;
+}
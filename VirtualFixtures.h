@@ -0,0 +1,181 @@
+#ifndef VIRTUALFIXTURES_H
+#define VIRTUALFIXTURES_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ServoTiming.h"
+
+namespace SnapConstraints {
+class SnapConstraint;
+}
+
+/**
+ * @class VirtualFixtures
+ * @brief 机械臂坐标系中的虚拟夹具（每个控制器一个）：引导平面/直线/点与工作空间限位平面
+ *
+ * 几何求解使用 OpenHaptics SnapConstraints 的 PlaneConstraint/LineConstraint/PointConstraint。
+ * 伺服线程每个1kHz采样以指令目标位置（机械臂基坐标系，毫米）调用 evaluate()：
+ * - 引导夹具（guide）：目标到夹具的距离不超过吸附距离时吸附到最近的一个，目标投影到夹具上
+ * - 限位夹具（limit，仅平面）：法向指向允许一侧，目标越过平面时投影回平面上，始终生效且在引导之后施加
+ * 结果给出约束后的目标和按各夹具刚度加权的拉力（机械臂坐标），由控制器经映射的逆变换为触觉设备上的力。
+ * 预测外推、滤波和轨迹生成都可能把目标带出限位，发送节拍上再以 enforceLimits() 约束最终下发的目标。
+ * 夹具在 configure() 时创建，evaluate() 不分配、不加锁，耗时随夹具数线性增长。
+ */
+class VirtualFixtures {
+public:
+    enum Type { Plane, Line, Point };
+    enum Behavior { Guide, Limit };
+
+    static const int kMaxFixtures = 64;
+
+    /**
+     * @brief 单个夹具定义（机械臂基坐标系，毫米）
+     */
+    struct Fixture {
+        Type type;
+        Behavior behavior;
+        double point[3];        // 平面上一点 / 直线起点 / 吸附点
+        double normal[3];       // 平面法向（限位平面指向允许一侧）
+        double end[3];          // 直线上另一点（直线为无限长）
+        double snapDistance;    // 引导夹具的吸附距离（毫米），<=0 时使用 Params::snapDistance
+        double stiffness;       // 触觉设备上的刚度（N/mm），<=0 时使用 Params::stiffness
+
+        Fixture();
+    };
+
+    struct Params {
+        double snapDistance;    // 默认吸附距离（毫米，机械臂坐标）
+        double stiffness;       // 默认刚度（N/mm，触觉设备坐标）
+
+        Params() : snapDistance(5.0), stiffness(0.3) {}
+    };
+
+    /**
+     * @brief 单次求解结果
+     */
+    struct Result {
+        int guide;              // 吸附的引导夹具序号（1起），0为未吸附
+        uint64_t limitMask;     // 本次生效的限位夹具（按序号位）
+        double position[3];     // 约束后的目标（毫米）
+        double pull[3];         // Σ 刚度 × 投影位移（机械臂坐标，N/mm × 毫米），经映射的线性逆变换即为设备上的力
+
+        bool constrained() const { return guide != 0 || limitMask != 0; }
+    };
+
+    struct Stats {
+        uint64_t evaluations;   // evaluate() 次数
+        uint64_t guidedTicks;   // 吸附在引导夹具上的节拍
+        uint64_t snapOns;       // 吸附次数（从未吸附或另一夹具切换过来）
+        uint64_t limitTicks;    // 限位生效的节拍
+        uint64_t finalLimits;   // 发送节拍上最终目标越限被修正的次数
+        LatencyHistogram::Snapshot evaluateTime;
+    };
+
+    VirtualFixtures();
+    ~VirtualFixtures();
+
+    /**
+     * @brief 设置夹具（在伺服线程外、拖动开始前调用）
+     * @return 定义有效时返回true；无效的夹具被跳过，超过 kMaxFixtures 的部分被忽略
+     */
+    bool configure(const Params& params, const std::vector<Fixture>& fixtures, std::ostream& errors);
+
+    bool isEnabled() const { return m_count > 0; }
+    bool hasLimits() const { return m_limitCount > 0; }
+    int getCount() const { return m_count; }
+    const Params& getParams() const { return m_params; }
+
+    static bool parseType(const std::string& name, Type& type);
+    static bool parseBehavior(const std::string& name, Behavior& behavior);
+    static const char* typeName(Type type);
+    static const char* behaviorName(Behavior behavior);
+
+    /**
+     * @brief 解析 "x, y, z" 形式的向量
+     */
+    static bool parseVector(const std::string& text, double value[3]);
+
+    /**
+     * @brief 清除吸附状态（离合开始时调用）
+     */
+    void reset();
+
+    /**
+     * @brief 约束指令目标（伺服线程调用）
+     * @param target 指令目标位置（机械臂基坐标系，毫米）
+     * @param result 约束后的目标和拉力
+     */
+    void evaluate(const double target[3], Result& result);
+
+    /**
+     * @brief 只施加限位夹具（伺服线程在发送节拍上对最终目标调用，不影响吸附状态）
+     * @param position 目标位置（机械臂基坐标系，毫米），越过限位平面时被投影回平面上
+     * @return 生效的限位夹具（按序号位），0为未越限
+     */
+    uint64_t enforceLimits(double position[3]);
+
+    /**
+     * @brief 把速度投影到 result 允许的运动方向上（平面内/沿直线/点处为零，限位平面上去掉向外分量）
+     */
+    void constrainVelocity(const Result& result, double velocity[3]) const;
+
+    void getStats(Stats& stats) const;
+
+    /**
+     * @brief 离线基准：给定夹具组的 evaluate() 耗时和约束结果核对
+     * @param budgetNs 伺服周期预算（纳秒），p99 超过其 1/10 视为不合格
+     * @return 耗时合格且所有结果满足约束时返回true
+     */
+    static bool benchmark(std::ostream& os, const char* label, const Params& params,
+                          const std::vector<Fixture>& fixtures, int iterations, uint64_t budgetNs);
+
+    /**
+     * @brief 生成基准用的夹具组：6个限位平面围成的工作空间，其余为交替的引导平面/直线/点
+     */
+    static std::vector<Fixture> syntheticFixtures(int count);
+
+private:
+    VirtualFixtures(const VirtualFixtures&);
+    VirtualFixtures& operator=(const VirtualFixtures&);
+
+    struct Entry {
+        SnapConstraints::SnapConstraint* constraint;
+        Type type;
+        Behavior behavior;
+        double point[3];
+        double direction[3];    // 平面单位法向 / 直线单位方向
+        double snapDistance;
+        double stiffness;
+    };
+
+    void clear();
+
+    // 所有限位平面依次投影，处理相交平面构成的角（最多若干轮）
+    uint64_t applyLimits(double position[3], double pull[3]) const;
+
+    static void bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Params m_params;
+    Entry m_entries[kMaxFixtures];
+    int m_count;
+    int m_guides[kMaxFixtures];     // 引导夹具在 m_entries 中的下标
+    int m_guideCount;
+    int m_limits[kMaxFixtures];     // 限位夹具在 m_entries 中的下标
+    int m_limitCount;
+    int m_lastGuide;                // 伺服线程独占：上一次吸附的引导夹具（序号，1起）
+
+    std::atomic<uint64_t> m_evaluations;
+    std::atomic<uint64_t> m_guidedTicks;
+    std::atomic<uint64_t> m_snapOns;
+    std::atomic<uint64_t> m_limitTicks;
+    std::atomic<uint64_t> m_finalLimits;
+    LatencyHistogram m_evaluateTime;
+};
+
+#endif // VIRTUALFIXTURES_H
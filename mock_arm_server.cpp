@@ -0,0 +1,1137 @@
+/*****************************************************************************
+ 机械臂控制器模拟程序（本机集成测试 / 性能测试用）
+
+ 功能：
+ - 在本机模拟一台或多台睿尔曼机械臂的TCP JSON接口（ArmController 使用的协议）：
+   movep_follow、set_joint_angle_transmission、get_current_arm_state、
+   set_arm_power、set_realtime_push、夹爪、write_single_register 等
+ - 按 set_realtime_push 设置的周期向上报地址发送UDP主动上报
+ - 可模拟响应延迟/抖动、响应分段发送、接收反压（小接收缓冲区、周期性停止读取）
+ - --kinematics rm65 时按运动学模型维护关节角度与位姿的一致性：movep_follow 目标由
+   模拟器逆解（以当前关节角度为初值），奇异位形附近、不可达、超限位或关节跳变的目标
+   被拒绝；关节角度透传只检查限位和跳变。拒绝次数随统计输出
+ - 记录每条收到指令的时间（单调时钟，与主程序的 steady_clock 相同），周期输出
+   流式指令的频率、到达间隔分布和突发统计，可写出CSV供自动化测试分析
+
+ 编译命令：
+ make mock_arm_server        （或 CMake 目标 mock_arm_server）
+
+ 运行命令：
+ ./mock_arm_server --arm 127.0.0.1:18080 --arm 127.0.0.2:18080 --latency-ms 2 --jitter-ms 1
+
+ 多台机械臂请使用不同的回环地址（127.0.0.x），主动上报从该地址发出，
+ ArmStateReceiver 按来源IP区分机械臂。
+*****************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ArmKinematics.h"
+#include "ArmResponseReader.h"
+
+namespace {
+
+volatile sig_atomic_t g_stop = 0;
+
+void signalHandler(int) {
+    g_stop = 1;
+}
+
+// 与主程序 std::chrono::steady_clock 相同的时钟，日志时间可直接对照
+uint64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// 流式帧到达间隔小于该值视为突发（客户端积压后连续写出）
+const uint64_t kBurstGapNs = 1000000;
+
+// 机械臂上报周期的单位（set_realtime_push 的 cycle 为5ms的倍数）
+const uint64_t kPushCycleUnitNs = 5000000;
+
+/**
+ * @brief 在扁平的JSON指令中查找 "key": 之后的值起点，找不到返回nullptr
+ */
+const char* findValue(const std::string& message, const char* key) {
+    std::string pattern = std::string("\"") + key + "\"";
+    size_t pos = message.find(pattern);
+    while (pos != std::string::npos) {
+        size_t p = pos + pattern.size();
+        while (p < message.size() && isspace(static_cast<unsigned char>(message[p]))) ++p;
+        if (p < message.size() && message[p] == ':') {
+            ++p;
+            while (p < message.size() && isspace(static_cast<unsigned char>(message[p]))) ++p;
+            return message.c_str() + p;
+        }
+        pos = message.find(pattern, pos + 1);
+    }
+    return nullptr;
+}
+
+bool parseString(const std::string& message, const char* key, std::string& value) {
+    const char* p = findValue(message, key);
+    if (!p || *p != '"') {
+        return false;
+    }
+    const char* end = strchr(p + 1, '"');
+    if (!end) {
+        return false;
+    }
+    value.assign(p + 1, end);
+    return true;
+}
+
+bool parseNumber(const std::string& message, const char* key, double& value) {
+    const char* p = findValue(message, key);
+    if (!p) {
+        return false;
+    }
+    char* end = nullptr;
+    value = strtod(p, &end);
+    return end != p;
+}
+
+bool parseBool(const std::string& message, const char* key, bool& value) {
+    const char* p = findValue(message, key);
+    if (!p) {
+        return false;
+    }
+    if (strncmp(p, "true", 4) == 0) {
+        value = true;
+        return true;
+    }
+    if (strncmp(p, "false", 5) == 0) {
+        value = false;
+        return true;
+    }
+    double number = 0.0;
+    if (parseNumber(message, key, number)) {
+        value = number != 0.0;
+        return true;
+    }
+    return false;
+}
+
+int parseArray(const std::string& message, const char* key, double* values, int maxCount) {
+    const char* p = findValue(message, key);
+    if (!p || *p != '[') {
+        return 0;
+    }
+    ++p;
+    int count = 0;
+    while (count < maxCount) {
+        char* end = nullptr;
+        double value = strtod(p, &end);
+        if (end == p) {
+            break;
+        }
+        values[count++] = value;
+        p = end;
+        while (*p == ' ' || *p == ',') ++p;
+    }
+    return count;
+}
+
+/**
+ * @brief 到达间隔统计（毫秒）
+ */
+struct GapSummary {
+    double p50;
+    double p99;
+    double max;
+    double mean;
+};
+
+GapSummary summarizeGaps(std::vector<uint64_t> gaps) {
+    GapSummary summary = {0.0, 0.0, 0.0, 0.0};
+    if (gaps.empty()) {
+        return summary;
+    }
+    std::sort(gaps.begin(), gaps.end());
+    double sum = 0.0;
+    for (size_t i = 0; i < gaps.size(); ++i) sum += static_cast<double>(gaps[i]);
+    summary.p50 = gaps[gaps.size() / 2] / 1e6;
+    summary.p99 = gaps[std::min(gaps.size() - 1, gaps.size() * 99 / 100)] / 1e6;
+    summary.max = gaps.back() / 1e6;
+    summary.mean = sum / gaps.size() / 1e6;
+    return summary;
+}
+
+} // namespace
+
+/**
+ * @struct MockOptions
+ * @brief 命令行参数
+ */
+struct MockOptions {
+    std::vector<std::pair<std::string, int> > arms;   // 监听地址（IP:端口）
+    double latencyMs;          // TCP响应的固定延迟
+    double jitterMs;           // 响应延迟的均匀抖动（±）
+    size_t segmentBytes;       // >0 时把每条响应拆成该大小的分段分别发送
+    int segmentGapUs;          // 分段之间的间隔
+    int receiveBuffer;         // >0 时设置接收缓冲区大小（模拟控制器接收慢）
+    int stallMs;               // 周期性停止读取的时长
+    int stallEveryMs;          // 停止读取的周期（0为不停止）
+    std::string pushIp;        // 覆盖 set_realtime_push 中的上报目标IP
+    std::string logPath;       // 每条收到的指令写一行CSV
+    double statsInterval;      // 周期统计输出间隔（秒，0为不输出）
+    double duration;           // 运行时长（秒，0为直到中断）
+    unsigned seed;
+    std::string kinematics;    // 运动学模型名（空为不模拟运动学）
+    std::array<double, 6> joints;      // 初始关节角度（度）
+    double singularityThreshold;       // 笛卡尔目标逆解的可操作度低于该值时拒绝
+    double maxJointStepDeg;            // 相邻两帧单关节变化超过该值时拒绝
+    int closeAfter;            // 每个连接收到该条数的指令并发完响应后主动断开（0为不断开）
+    std::vector<std::string> noReply;  // 不应答的指令名（模拟丢失的响应）
+    int eventMs;               // >0 时按该周期发送未请求的轨迹到位事件
+
+    MockOptions()
+        : latencyMs(0.0), jitterMs(0.0), segmentBytes(0), segmentGapUs(0), receiveBuffer(0),
+          stallMs(0), stallEveryMs(0), statsInterval(1.0), duration(0.0), seed(1),
+          singularityThreshold(0.004), maxJointStepDeg(10.0), closeAfter(0), eventMs(0) {
+        joints = {{0.0, 0.0, 90.0, 0.0, 90.0, 0.0}};
+    }
+};
+
+/**
+ * @class MockArmServer
+ * @brief 单线程epoll服务器，每台模拟机械臂一个监听socket、一个客户端连接和一个UDP上报socket
+ */
+class MockArmServer {
+public:
+    explicit MockArmServer(const MockOptions& options)
+        : m_options(options), m_epollFd(-1), m_timerFd(-1), m_log(nullptr),
+          m_random(options.seed), m_useKinematics(false), m_startNs(0), m_nextStatsNs(0) {}
+
+    ~MockArmServer() {
+        for (size_t i = 0; i < m_arms.size(); ++i) {
+            Arm& arm = *m_arms[i];
+            if (arm.clientFd >= 0) close(arm.clientFd);
+            if (arm.listenFd >= 0) close(arm.listenFd);
+            if (arm.udpFd >= 0) close(arm.udpFd);
+        }
+        if (m_timerFd >= 0) close(m_timerFd);
+        if (m_epollFd >= 0) close(m_epollFd);
+        if (m_log) fclose(m_log);
+    }
+
+    bool start() {
+        m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+        m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (m_epollFd < 0 || m_timerFd < 0) {
+            std::cerr << "❌ 创建epoll/timerfd失败: " << strerror(errno) << std::endl;
+            return false;
+        }
+        addEvents(m_timerFd, EPOLLIN, kTimerToken);
+
+        if (!m_options.logPath.empty()) {
+            m_log = fopen(m_options.logPath.c_str(), "w");
+            if (!m_log) {
+                std::cerr << "❌ 无法创建指令日志 " << m_options.logPath << ": " << strerror(errno) << std::endl;
+                return false;
+            }
+            fprintf(m_log, "recv_ns,arm,command,bytes,gap_us,v0,v1,v2,v3,v4,v5\n");
+        }
+
+        if (!m_options.kinematics.empty()) {
+            ArmKinematics::Model model;
+            if (!ArmKinematics::findModel(m_options.kinematics, model)) {
+                std::cerr << "❌ 未知的运动学模型: " << m_options.kinematics << std::endl;
+                return false;
+            }
+            ArmKinematics::Params params;
+            params.maxIterations = 50;
+            m_kinematics.configure(model, params);
+            m_useKinematics = true;
+        }
+
+        for (size_t i = 0; i < m_options.arms.size(); ++i) {
+            std::unique_ptr<Arm> arm(new Arm(m_options.arms[i].first, m_options.arms[i].second));
+            if (!openArm(*arm, i)) {
+                return false;
+            }
+            arm->joints = m_options.joints;
+            if (m_useKinematics) {
+                arm->pose = m_kinematics.forward(arm->joints);
+            }
+            m_arms.push_back(std::move(arm));
+        }
+
+        m_startNs = monotonicNs();
+        if (m_options.statsInterval > 0.0) {
+            m_nextStatsNs = m_startNs + static_cast<uint64_t>(m_options.statsInterval * 1e9);
+        }
+        return true;
+    }
+
+    void run() {
+        uint64_t endNs = m_options.duration > 0.0
+            ? m_startNs + static_cast<uint64_t>(m_options.duration * 1e9) : 0;
+        epoll_event events[32];
+
+        while (!g_stop) {
+            uint64_t nowNs = monotonicNs();
+            if (endNs && nowNs >= endNs) {
+                break;
+            }
+            serviceTimers(nowNs);
+            armTimer(endNs);
+
+            int count = epoll_wait(m_epollFd, events, 32, -1);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "❌ epoll_wait失败: " << strerror(errno) << std::endl;
+                break;
+            }
+            for (int i = 0; i < count; ++i) {
+                uint64_t token = events[i].data.u64;
+                if (token == kTimerToken) {
+                    uint64_t expirations;
+                    while (read(m_timerFd, &expirations, sizeof(expirations)) > 0) {}
+                    continue;
+                }
+                Arm& arm = *m_arms[token / 2];
+                if (token % 2 == 0) {
+                    acceptClient(arm);
+                } else {
+                    if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                        readClient(arm);
+                    }
+                    if (arm.clientFd >= 0 && (events[i].events & EPOLLOUT)) {
+                        flushOutgoing(arm, monotonicNs());
+                    }
+                }
+            }
+        }
+        printSummary();
+    }
+
+private:
+    MockArmServer(const MockArmServer&);
+    MockArmServer& operator=(const MockArmServer&);
+
+    static const uint64_t kTimerToken = ~0ULL;
+
+    // 待发送的响应分段（按到期时间有序）
+    struct Chunk {
+        uint64_t dueNs;
+        std::string data;
+        size_t offset;
+    };
+
+    struct Arm {
+        std::string ip;
+        int port;
+        std::string label;
+        size_t index;
+        int listenFd;
+        int clientFd;
+        int udpFd;
+        ArmResponseReader reader;
+
+        std::deque<Chunk> outgoing;
+        uint64_t lastDueNs;        // 保证响应按发出顺序到达
+        bool wantWrite;
+        bool stalled;
+        uint64_t stallUntilNs;
+        uint64_t nextStallNs;
+        uint64_t sessionMessages;  // 当前连接收到的指令（含流式帧）
+        uint64_t nextEventNs;      // 下一次未请求事件的时间
+
+        // 模拟状态
+        std::array<int, 6> pose;           // 微米/毫弧度
+        std::array<double, 6> joints;      // 度
+        bool power;
+        bool pushEnabled;
+        uint64_t pushPeriodNs;
+        uint64_t nextPushNs;
+        sockaddr_in pushAddress;
+
+        // 统计：interval* 在每次周期输出后清零
+        uint64_t lastStreamNs;
+        std::vector<uint64_t> intervalGaps;
+        std::vector<uint64_t> totalGaps;
+        uint64_t intervalStream, totalStream;
+        uint64_t intervalBursts, totalBursts;
+        uint64_t intervalCommands, totalCommands;
+        uint64_t intervalPushes, totalPushes;
+        uint64_t intervalRejects;
+        uint64_t rejectSingular, rejectUnreachable, rejectLimit, rejectJump;   // 按原因累计
+        uint64_t coalescedReads;           // 一次recv中包含多条流式帧的次数
+        uint64_t bytesIn;
+        uint64_t connections;
+        uint64_t stalls;
+
+        Arm(const std::string& armIp, int armPort)
+            : ip(armIp), port(armPort), index(0), listenFd(-1), clientFd(-1), udpFd(-1),
+              lastDueNs(0), wantWrite(false), stalled(false), stallUntilNs(0), nextStallNs(0),
+              sessionMessages(0), nextEventNs(0), power(false), pushEnabled(false), pushPeriodNs(0), nextPushNs(0),
+              lastStreamNs(0), intervalStream(0), totalStream(0), intervalBursts(0), totalBursts(0),
+              intervalCommands(0), totalCommands(0), intervalPushes(0), totalPushes(0),
+              intervalRejects(0), rejectSingular(0), rejectUnreachable(0), rejectLimit(0), rejectJump(0),
+              coalescedReads(0), bytesIn(0), connections(0), stalls(0) {
+            std::ostringstream oss;
+            oss << ip << ":" << port;
+            label = oss.str();
+            pose = {{200000, 0, 300000, 3141, 0, 0}};
+            joints = {{0.0, 0.0, 90.0, 0.0, 90.0, 0.0}};
+            memset(&pushAddress, 0, sizeof(pushAddress));
+        }
+    };
+
+    bool openArm(Arm& arm, size_t index) {
+        arm.index = index;
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(arm.port));
+        if (inet_pton(AF_INET, arm.ip.c_str(), &address.sin_addr) != 1) {
+            std::cerr << "❌ 无效的机械臂地址: " << arm.ip << std::endl;
+            return false;
+        }
+
+        arm.listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        setsockopt(arm.listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        // 接收缓冲区须在listen之前设置，才能影响窗口大小
+        if (m_options.receiveBuffer > 0) {
+            setsockopt(arm.listenFd, SOL_SOCKET, SO_RCVBUF, &m_options.receiveBuffer, sizeof(m_options.receiveBuffer));
+        }
+        if (bind(arm.listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            listen(arm.listenFd, 4) < 0) {
+            std::cerr << "❌ 监听 " << arm.label << " 失败: " << strerror(errno) << std::endl;
+            return false;
+        }
+        addEvents(arm.listenFd, EPOLLIN, index * 2);
+
+        // 上报从机械臂地址发出，主程序按来源IP区分机械臂
+        arm.udpFd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        address.sin_port = 0;
+        if (bind(arm.udpFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            std::cerr << "警告：上报socket无法绑定到 " << arm.ip << ": " << strerror(errno) << std::endl;
+        }
+
+        std::cout << "✅ 模拟机械臂已监听: " << arm.label << std::endl;
+        return true;
+    }
+
+    void addEvents(int fd, uint32_t events, uint64_t token) {
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = events;
+        event.data.u64 = token;
+        epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    void updateClientEvents(Arm& arm) {
+        if (arm.clientFd < 0) {
+            return;
+        }
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = (arm.stalled ? 0u : static_cast<uint32_t>(EPOLLIN)) | (arm.wantWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+        event.data.u64 = arm.index * 2 + 1;
+        epoll_ctl(m_epollFd, EPOLL_CTL_MOD, arm.clientFd, &event);
+    }
+
+    void acceptClient(Arm& arm) {
+        int fd = accept4(arm.listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        if (arm.clientFd >= 0) {
+            std::cout << "⚠️  " << arm.label << " 新连接替换旧连接" << std::endl;
+            closeClient(arm);
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        uint64_t nowNs = monotonicNs();
+        arm.clientFd = fd;
+        arm.reader.reset();
+        arm.outgoing.clear();
+        arm.lastDueNs = 0;
+        arm.wantWrite = false;
+        arm.stalled = false;
+        arm.nextStallNs = m_options.stallEveryMs > 0 ? nowNs + m_options.stallEveryMs * 1000000ULL : 0;
+        arm.lastStreamNs = 0;
+        arm.sessionMessages = 0;
+        arm.nextEventNs = m_options.eventMs > 0 ? nowNs + m_options.eventMs * 1000000ULL : 0;
+        ++arm.connections;
+        addEvents(fd, EPOLLIN, arm.index * 2 + 1);
+        std::cout << "🔗 " << arm.label << " 客户端已连接（第" << arm.connections << "次）" << std::endl;
+    }
+
+    void closeClient(Arm& arm) {
+        if (arm.clientFd < 0) {
+            return;
+        }
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, arm.clientFd, nullptr);
+        close(arm.clientFd);
+        arm.clientFd = -1;
+        arm.outgoing.clear();
+        // 断开后控制器停止上报，重连后由设置序列重新开启
+        arm.pushEnabled = false;
+    }
+
+    void readClient(Arm& arm) {
+        while (arm.clientFd >= 0 && !arm.stalled) {
+            size_t available = 0;
+            char* buffer = arm.reader.prepareWrite(4096, available);
+            if (available == 0) {
+                arm.reader.reset();
+                continue;
+            }
+            ssize_t received = recv(arm.clientFd, buffer, available, 0);
+            if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                std::cout << "🔌 " << arm.label << " 客户端断开" << std::endl;
+                closeClient(arm);
+                return;
+            }
+            if (received < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            uint64_t nowNs = monotonicNs();
+            arm.reader.commitWrite(static_cast<size_t>(received));
+            arm.bytesIn += static_cast<uint64_t>(received);
+
+            int streamFrames = 0;
+            const char* data = nullptr;
+            size_t length = 0;
+            while (arm.reader.nextMessage(data, length)) {
+                if (handleMessage(arm, std::string(data, length), nowNs)) {
+                    ++streamFrames;
+                }
+            }
+            if (streamFrames > 1) {
+                ++arm.coalescedReads;
+            }
+        }
+    }
+
+    /**
+     * @brief 处理一条指令，返回是否为流式帧
+     */
+    bool handleMessage(Arm& arm, const std::string& message, uint64_t nowNs) {
+        ++arm.sessionMessages;
+        std::string command;
+        if (!parseString(message, "command", command)) {
+            logMessage(arm, nowNs, "unknown", message.size(), 0, nullptr, 0);
+            return false;
+        }
+
+        double values[6] = {0, 0, 0, 0, 0, 0};
+        // RM_API2 后端以 movep_canfd/movej_canfd 透传
+        if (command == "movep_follow" || command == "set_joint_angle_transmission" ||
+            command == "movep_canfd" || command == "movej_canfd") {
+            bool isPose = command == "movep_follow" || command == "movep_canfd";
+            int count = parseArray(message, isPose ? "pose" : "joint", values, 6);
+            if (count == 6 && m_useKinematics) {
+                applyKinematicFrame(arm, isPose, values);
+            } else if (count == 6) {
+                for (int i = 0; i < 6; ++i) {
+                    if (isPose) {
+                        arm.pose[i] = static_cast<int>(values[i]);
+                    } else {
+                        arm.joints[i] = values[i];
+                    }
+                }
+            }
+            uint64_t gapNs = recordStreamFrame(arm, nowNs);
+            logMessage(arm, nowNs, command.c_str(), message.size(), gapNs, values, count);
+            // 透传指令控制器不应答
+            return true;
+        }
+
+        ++arm.intervalCommands;
+        ++arm.totalCommands;
+        logMessage(arm, nowNs, command.c_str(), message.size(), 0, nullptr, 0);
+        if (std::find(m_options.noReply.begin(), m_options.noReply.end(), command) != m_options.noReply.end()) {
+            return false;
+        }
+
+        std::ostringstream reply;
+        if (command == "get_current_arm_state") {
+            reply << "{\"state\":\"current_arm_state\",\"arm_state\":{\"joint\":[";
+            for (int i = 0; i < 6; ++i) {
+                reply << (i ? "," : "") << static_cast<long>(std::lround(arm.joints[i] * 1000.0));
+            }
+            reply << "],\"pose\":[";
+            for (int i = 0; i < 6; ++i) {
+                reply << (i ? "," : "") << arm.pose[i];
+            }
+            reply << "],\"arm_err\":0,\"sys_err\":0,\"err\":[0]}}";
+        } else if (command == "set_arm_power") {
+            bool enable = true;
+            parseBool(message, "enable", enable);
+            arm.power = enable;
+            reply << "{\"command\":\"set_arm_power\",\"set_state\":true}";
+        } else if (command == "set_realtime_push") {
+            configurePush(arm, message, nowNs);
+            reply << "{\"command\":\"set_realtime_push\",\"set_state\":true}";
+        } else if (command == "write_single_register") {
+            reply << "{\"command\":\"write_single_register\",\"write_state\":true}";
+        } else if (command == "get_realtime_push") {
+            // RM_API2 连接时读取当前的主动上报配置
+            char ip[INET_ADDRSTRLEN] = "127.0.0.1";
+            if (arm.pushAddress.sin_family == AF_INET) {
+                inet_ntop(AF_INET, &arm.pushAddress.sin_addr, ip, sizeof(ip));
+            }
+            reply << "{\"command\":\"get_realtime_push\",\"cycle\":"
+                  << (arm.pushPeriodNs ? arm.pushPeriodNs / kPushCycleUnitNs : 1)
+                  << ",\"enable\":" << (arm.pushEnabled ? "true" : "false")
+                  << ",\"port\":" << (arm.pushAddress.sin_family == AF_INET ? ntohs(arm.pushAddress.sin_port) : 8089)
+                  << ",\"force_coordinate\":-1,\"ip\":\"" << ip << "\","
+                  << "\"custom\":{\"joint_speed\":false,\"lift_state\":false,\"expand_state\":false,"
+                  << "\"hand_state\":false,\"arm_current_status\":false,\"aloha_state\":false}}";
+        } else if (command == "get_current_work_frame") {
+            reply << "{\"state\":\"current_work_frame\",\"frame_name\":\"World\",\"pose\":[0,0,0,0,0,0]}";
+        } else if (command == "get_current_tool_frame") {
+            reply << "{\"state\":\"current_tool_frame\",\"tool_name\":\"Arm_Tip\",\"pose\":[0,0,0,0,0,0],"
+                  << "\"payload\":0,\"position\":[0,0,0]}";
+        } else if (command == "get_install_pose") {
+            reply << "{\"state\":\"install_pose\",\"pose\":[0,0,0]}";
+        } else if (command == "get_joint_min_pos" || command == "get_joint_max_pos" ||
+                   command == "get_joint_max_speed" || command == "get_joint_max_acc") {
+            // 关节限位（模型）和速度/加速度上限（RM65 出厂值 180°/s、600°/s²），单位0.001°
+            ArmKinematics::Model model = handshakeModel();
+            std::string limit = command.substr(10);
+            std::string key = limit == "max_speed" ? "joint_speed" : limit == "max_acc" ? "joint_acc" : limit;
+            reply << "{\"state\":\"" << command.substr(4) << "\",\"" << key << "\":[";
+            for (int i = 0; i < ArmKinematics::kJoints; ++i) {
+                double value = limit == "min_pos" ? model.minDeg[i] : limit == "max_pos" ? model.maxDeg[i]
+                             : limit == "max_speed" ? 180.0 : 600.0;
+                reply << (i ? "," : "") << std::lround(value * 1000.0);
+            }
+            reply << "]}";
+        } else if (command == "get_arm_software_info") {
+            // RM_API2 的 rm_create_robot_arm 连接时先读取软件版本
+            reply << "{\"state\":\"arm_software_info\",\"Product_version\":\"RM65-B\","
+                  << "\"robot_controller_version\":\"4.0\",\"algorithm_info\":{\"version\":\"mock\"},"
+                  << "\"ctrl_info\":{\"build_time\":\"mock\",\"version\":\"mock\"},"
+                  << "\"dynamic_info\":{\"model_version\":\"mock\"},"
+                  << "\"plan_info\":{\"build_time\":\"mock\",\"version\":\"mock\"},"
+                  << "\"com_info\":{\"build_time\":\"mock\",\"version\":\"mock\"},"
+                  << "\"program_info\":{\"build_time\":\"mock\",\"version\":\"mock\"}}";
+        } else if (command == "get_DH_data") {
+            // 按 rm_dh_t 的顺序每个关节 [d, a, alpha, offset]，长度0.001mm、角度0.001°
+            ArmKinematics::Model model = handshakeModel();
+            reply << "{\"state\":\"get_DH_data\"";
+            for (int i = 0; i < ArmKinematics::kJoints; ++i) {
+                const ArmKinematics::Link& link = model.links[i];
+                reply << ",\"joint_" << (i + 1) << "\":[" << std::lround(link.dMm * 1000.0) << ","
+                      << std::lround(link.aMm * 1000.0) << "," << std::lround(link.alphaDeg * 1000.0) << ","
+                      << std::lround(link.offsetDeg * 1000.0) << "]";
+            }
+            reply << "}";
+        } else {
+            // 夹爪及其他设置类指令统一确认
+            reply << "{\"command\":\"" << command << "\",\"set_state\":true}";
+        }
+        reply << "\r\n";
+        scheduleReply(arm, reply.str(), nowNs);
+        return false;
+    }
+
+    /**
+     * @brief 握手查询（DH参数、关节限位）使用的型号：--kinematics 指定的模型，未指定时为RM65
+     */
+    ArmKinematics::Model handshakeModel() const {
+        ArmKinematics::Model model;
+        if (m_useKinematics) {
+            model = m_kinematics.getModel();
+        } else {
+            ArmKinematics::findModel("rm65", model);
+        }
+        return model;
+    }
+
+    /**
+     * @brief 按运动学模型执行一帧流式指令，被拒绝的帧不改变状态
+     */
+    void applyKinematicFrame(Arm& arm, bool isPose, const double* values) {
+        ArmKinematics::Joints target;
+        if (isPose) {
+            // 控制器侧逆解：以当前关节角度为初值
+            ArmKinematics::Pose pose;
+            for (int i = 0; i < 6; ++i) {
+                pose[i] = static_cast<int>(values[i]);
+            }
+            ArmKinematics::Result result;
+            m_kinematics.inverse(pose, arm.joints, target, result);
+            if (result.manipulability < m_options.singularityThreshold) {
+                reject(arm, arm.rejectSingular);
+                return;
+            }
+            if (result.positionError > 0.1 || result.rotationError > 0.002) {
+                reject(arm, arm.rejectUnreachable);
+                return;
+            }
+        } else {
+            for (int i = 0; i < 6; ++i) {
+                target[i] = values[i];
+            }
+        }
+        if (m_kinematics.checkLimits(target) != 0) {
+            reject(arm, arm.rejectLimit);
+            return;
+        }
+        if (ArmKinematics::maxJointDelta(target, arm.joints) > m_options.maxJointStepDeg) {
+            reject(arm, arm.rejectJump);
+            return;
+        }
+        arm.joints = target;
+        arm.pose = m_kinematics.forward(target);
+    }
+
+    void reject(Arm& arm, uint64_t& reason) {
+        ++reason;
+        ++arm.intervalRejects;
+    }
+
+    uint64_t recordStreamFrame(Arm& arm, uint64_t nowNs) {
+        uint64_t gapNs = 0;
+        if (arm.lastStreamNs != 0) {
+            gapNs = nowNs - arm.lastStreamNs;
+            arm.intervalGaps.push_back(gapNs);
+            arm.totalGaps.push_back(gapNs);
+            if (gapNs < kBurstGapNs) {
+                ++arm.intervalBursts;
+                ++arm.totalBursts;
+            }
+        }
+        arm.lastStreamNs = nowNs;
+        ++arm.intervalStream;
+        ++arm.totalStream;
+        return gapNs;
+    }
+
+    void configurePush(Arm& arm, const std::string& message, uint64_t nowNs) {
+        double cycle = 1.0;
+        double port = 8089.0;
+        bool enable = true;
+        std::string ip = "127.0.0.1";
+        parseNumber(message, "cycle", cycle);
+        parseNumber(message, "port", port);
+        parseBool(message, "enable", enable);
+        parseString(message, "ip", ip);
+        if (!m_options.pushIp.empty()) {
+            ip = m_options.pushIp;
+        }
+
+        memset(&arm.pushAddress, 0, sizeof(arm.pushAddress));
+        arm.pushAddress.sin_family = AF_INET;
+        arm.pushAddress.sin_port = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, ip.c_str(), &arm.pushAddress.sin_addr) != 1) {
+            std::cerr << "警告：" << arm.label << " 上报目标IP无效: " << ip << std::endl;
+            arm.pushEnabled = false;
+            return;
+        }
+        arm.pushEnabled = enable;
+        arm.pushPeriodNs = static_cast<uint64_t>(std::max(1.0, cycle)) * kPushCycleUnitNs;
+        arm.nextPushNs = nowNs + arm.pushPeriodNs;
+        std::cout << "📡 " << arm.label << " 主动上报" << (enable ? "开启" : "关闭") << ": " << ip << ":"
+                  << static_cast<int>(port) << "，周期 " << arm.pushPeriodNs / 1000000 << " ms" << std::endl;
+    }
+
+    void scheduleReply(Arm& arm, const std::string& reply, uint64_t nowNs) {
+        double delayMs = m_options.latencyMs;
+        if (m_options.jitterMs > 0.0) {
+            std::uniform_real_distribution<double> jitter(-m_options.jitterMs, m_options.jitterMs);
+            delayMs += jitter(m_random);
+        }
+        uint64_t dueNs = nowNs + static_cast<uint64_t>(std::max(0.0, delayMs) * 1e6);
+        dueNs = std::max(dueNs, arm.lastDueNs);
+
+        size_t segment = m_options.segmentBytes > 0 ? m_options.segmentBytes : reply.size();
+        for (size_t offset = 0; offset < reply.size(); offset += segment) {
+            Chunk chunk;
+            chunk.dueNs = dueNs;
+            chunk.data = reply.substr(offset, segment);
+            chunk.offset = 0;
+            arm.outgoing.push_back(chunk);
+            dueNs += static_cast<uint64_t>(m_options.segmentGapUs) * 1000ULL;
+        }
+        arm.lastDueNs = arm.outgoing.back().dueNs;
+        flushOutgoing(arm, nowNs);
+    }
+
+    void flushOutgoing(Arm& arm, uint64_t nowNs) {
+        bool wantWrite = false;
+        while (arm.clientFd >= 0 && !arm.outgoing.empty() && arm.outgoing.front().dueNs <= nowNs) {
+            Chunk& chunk = arm.outgoing.front();
+            ssize_t sent = send(arm.clientFd, chunk.data.data() + chunk.offset,
+                                chunk.data.size() - chunk.offset, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    wantWrite = true;
+                    break;
+                }
+                if (errno == EINTR) continue;
+                std::cout << "🔌 " << arm.label << " 发送失败: " << strerror(errno) << std::endl;
+                closeClient(arm);
+                return;
+            }
+            chunk.offset += static_cast<size_t>(sent);
+            if (chunk.offset < chunk.data.size()) {
+                wantWrite = true;
+                break;
+            }
+            arm.outgoing.pop_front();
+        }
+        if (wantWrite != arm.wantWrite) {
+            arm.wantWrite = wantWrite;
+            updateClientEvents(arm);
+        }
+    }
+
+    void sendPush(Arm& arm) {
+        double rx = arm.pose[3] / 1000.0;
+        double ry = arm.pose[4] / 1000.0;
+        double rz = arm.pose[5] / 1000.0;
+        // 欧拉角（X-Y-Z固定轴）→ 四元数 ×1e6
+        double cx = cos(rx / 2), sx = sin(rx / 2);
+        double cy = cos(ry / 2), sy = sin(ry / 2);
+        double cz = cos(rz / 2), sz = sin(rz / 2);
+        long quat[4] = {
+            std::lround((cz * cy * cx + sz * sy * sx) * 1e6),
+            std::lround((cz * cy * sx - sz * sy * cx) * 1e6),
+            std::lround((cz * sy * cx + sz * cy * sx) * 1e6),
+            std::lround((sz * cy * cx - cz * sy * sx) * 1e6)
+        };
+
+        std::ostringstream oss;
+        oss << "{\"state\":\"realtime_arm_joint_state\",\"arm_current_status\":\"RM_IDLE_E\","
+            << "\"joint_status\":{\"joint_position\":[";
+        for (int i = 0; i < 6; ++i) {
+            oss << (i ? "," : "") << static_cast<long>(std::lround(arm.joints[i] * 1000.0));
+        }
+        oss << "],\"joint_en_flag\":[";
+        for (int i = 0; i < 6; ++i) {
+            oss << (i ? "," : "") << (arm.power ? 1 : 0);
+        }
+        oss << "],\"joint_err_code\":[0,0,0,0,0,0]},\"waypoint\":{\"position\":["
+            << arm.pose[0] << "," << arm.pose[1] << "," << arm.pose[2] << "],\"euler\":["
+            << arm.pose[3] << "," << arm.pose[4] << "," << arm.pose[5] << "],\"quat\":["
+            << quat[0] << "," << quat[1] << "," << quat[2] << "," << quat[3] << "]},"
+            << "\"err\":{\"err_len\":1,\"err\":[0]}}";
+        std::string packet = oss.str();
+        sendto(arm.udpFd, packet.data(), packet.size(), 0,
+               reinterpret_cast<const sockaddr*>(&arm.pushAddress), sizeof(arm.pushAddress));
+        ++arm.intervalPushes;
+        ++arm.totalPushes;
+    }
+
+    void serviceTimers(uint64_t nowNs) {
+        for (size_t i = 0; i < m_arms.size(); ++i) {
+            Arm& arm = *m_arms[i];
+            if (arm.clientFd >= 0) {
+                flushOutgoing(arm, nowNs);
+            }
+            // 模拟控制器主动断开：响应全部发完后再关闭，客户端应自动重连
+            if (arm.clientFd >= 0 && m_options.closeAfter > 0 &&
+                arm.sessionMessages >= static_cast<uint64_t>(m_options.closeAfter) && arm.outgoing.empty()) {
+                std::cout << "🔌 " << arm.label << " 已收到 " << arm.sessionMessages << " 条指令，主动断开" << std::endl;
+                closeClient(arm);
+            }
+            // 轨迹到位事件与响应共用同一条流，按响应的延迟和分段排队，不会插入半条响应中间
+            if (arm.clientFd >= 0 && m_options.eventMs > 0 && nowNs >= arm.nextEventNs) {
+                scheduleReply(arm, "{\"state\":\"current_trajectory_state\",\"trajectory_state\":true,"
+                                   "\"device\":0,\"trajectory_connect\":0}\r\n", nowNs);
+                arm.nextEventNs = nowNs + m_options.eventMs * 1000000ULL;
+            }
+            if (arm.clientFd >= 0 && m_options.stallEveryMs > 0) {
+                if (!arm.stalled && nowNs >= arm.nextStallNs) {
+                    arm.stalled = true;
+                    arm.stallUntilNs = nowNs + m_options.stallMs * 1000000ULL;
+                    ++arm.stalls;
+                    updateClientEvents(arm);
+                } else if (arm.stalled && nowNs >= arm.stallUntilNs) {
+                    arm.stalled = false;
+                    arm.nextStallNs = nowNs + m_options.stallEveryMs * 1000000ULL;
+                    updateClientEvents(arm);
+                }
+            }
+            if (arm.pushEnabled && nowNs >= arm.nextPushNs) {
+                sendPush(arm);
+                arm.nextPushNs += arm.pushPeriodNs;
+                if (arm.nextPushNs <= nowNs) {
+                    arm.nextPushNs = nowNs + arm.pushPeriodNs;
+                }
+            }
+        }
+        if (m_nextStatsNs && nowNs >= m_nextStatsNs) {
+            printInterval(nowNs);
+            m_nextStatsNs += static_cast<uint64_t>(m_options.statsInterval * 1e9);
+        }
+    }
+
+    // 把timerfd设置到最早的下一个到期时间
+    void armTimer(uint64_t endNs) {
+        uint64_t nextNs = endNs ? endNs : ~0ULL;
+        if (m_nextStatsNs) nextNs = std::min(nextNs, m_nextStatsNs);
+        for (size_t i = 0; i < m_arms.size(); ++i) {
+            const Arm& arm = *m_arms[i];
+            if (arm.clientFd >= 0 && !arm.outgoing.empty() && !arm.wantWrite) {
+                nextNs = std::min(nextNs, arm.outgoing.front().dueNs);
+            }
+            if (arm.clientFd >= 0 && m_options.stallEveryMs > 0) {
+                nextNs = std::min(nextNs, arm.stalled ? arm.stallUntilNs : arm.nextStallNs);
+            }
+            if (arm.clientFd >= 0 && m_options.eventMs > 0) {
+                nextNs = std::min(nextNs, arm.nextEventNs);
+            }
+            if (arm.pushEnabled) {
+                nextNs = std::min(nextNs, arm.nextPushNs);
+            }
+        }
+        itimerspec spec;
+        memset(&spec, 0, sizeof(spec));
+        if (nextNs != ~0ULL) {
+            // 绝对时间为0会解除定时器，已到期的时间取1ns
+            nextNs = std::max<uint64_t>(nextNs, 1);
+            spec.it_value.tv_sec = static_cast<time_t>(nextNs / 1000000000ULL);
+            spec.it_value.tv_nsec = static_cast<long>(nextNs % 1000000000ULL);
+        }
+        timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+    }
+
+    void logMessage(const Arm& arm, uint64_t nowNs, const char* command, size_t bytes,
+                    uint64_t gapNs, const double* values, int count) {
+        if (!m_log) {
+            return;
+        }
+        fprintf(m_log, "%llu,%zu,%s,%zu,%.1f", static_cast<unsigned long long>(nowNs), arm.index,
+                command, bytes, gapNs / 1e3);
+        for (int i = 0; i < 6; ++i) {
+            if (values && i < count) {
+                fprintf(m_log, ",%.6g", values[i]);
+            } else {
+                fputs(",", m_log);
+            }
+        }
+        fputc('\n', m_log);
+    }
+
+    void printInterval(uint64_t nowNs) {
+        (void)nowNs;
+        for (size_t i = 0; i < m_arms.size(); ++i) {
+            Arm& arm = *m_arms[i];
+            GapSummary gaps = summarizeGaps(arm.intervalGaps);
+            std::cout << "[mock " << arm.label << "] " << std::fixed << std::setprecision(1)
+                      << "流式 " << arm.intervalStream / m_options.statsInterval << " Hz"
+                      << std::setprecision(2)
+                      << "，间隔 p50 " << gaps.p50 << " / p99 " << gaps.p99 << " / max " << gaps.max << " ms"
+                      << "，突发 " << arm.intervalBursts
+                      << "，指令 " << arm.intervalCommands
+                      << "，上报 " << arm.intervalPushes;
+            if (m_useKinematics) {
+                std::cout << "，拒绝 " << arm.intervalRejects;
+            }
+            std::cout << (arm.clientFd >= 0 ? "" : "（未连接）") << std::endl;
+            arm.intervalGaps.clear();
+            arm.intervalStream = 0;
+            arm.intervalBursts = 0;
+            arm.intervalCommands = 0;
+            arm.intervalPushes = 0;
+            arm.intervalRejects = 0;
+        }
+    }
+
+    void printSummary() {
+        double elapsed = (monotonicNs() - m_startNs) / 1e9;
+        std::cout << "\n=== 模拟机械臂统计（运行 " << std::fixed << std::setprecision(1) << elapsed << " s）===" << std::endl;
+        for (size_t i = 0; i < m_arms.size(); ++i) {
+            const Arm& arm = *m_arms[i];
+            GapSummary gaps = summarizeGaps(arm.totalGaps);
+            std::cout << arm.label << std::setprecision(2)
+                      << ": 流式帧=" << arm.totalStream
+                      << " 平均频率=" << (elapsed > 0 ? arm.totalStream / elapsed : 0.0) << "Hz"
+                      << " 间隔(ms) 平均=" << gaps.mean << " p50=" << gaps.p50
+                      << " p99=" << gaps.p99 << " max=" << gaps.max
+                      << " 突发=" << arm.totalBursts
+                      << " 合并读取=" << arm.coalescedReads
+                      << " 指令=" << arm.totalCommands
+                      << " 上报=" << arm.totalPushes
+                      << " 接收字节=" << arm.bytesIn
+                      << " 连接=" << arm.connections
+                      << " 停读=" << arm.stalls << std::endl;
+            if (m_useKinematics) {
+                std::cout << arm.label << ": 拒绝 奇异=" << arm.rejectSingular << " 不可达=" << arm.rejectUnreachable
+                          << " 限位=" << arm.rejectLimit << " 跳变=" << arm.rejectJump << std::endl;
+            }
+        }
+    }
+
+    MockOptions m_options;
+    int m_epollFd;
+    int m_timerFd;
+    FILE* m_log;
+    std::mt19937 m_random;
+    ArmKinematics m_kinematics;
+    bool m_useKinematics;
+    std::vector<std::unique_ptr<Arm> > m_arms;
+    uint64_t m_startNs;
+    uint64_t m_nextStatsNs;
+};
+
+const uint64_t MockArmServer::kTimerToken;
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cout << "用法: " << program << " [选项]" << std::endl;
+    std::cout << "选项:" << std::endl;
+    std::cout << "  --arm IP:PORT           模拟机械臂监听地址，可重复（默认 127.0.0.1:8080）" << std::endl;
+    std::cout << "  --latency-ms MS         TCP响应延迟" << std::endl;
+    std::cout << "  --jitter-ms MS          响应延迟的均匀抖动（±）" << std::endl;
+    std::cout << "  --segment BYTES         把每条响应拆成该大小的分段分别发送" << std::endl;
+    std::cout << "  --segment-gap-us US     分段之间的间隔" << std::endl;
+    std::cout << "  --rcvbuf BYTES          接收缓冲区大小（模拟反压）" << std::endl;
+    std::cout << "  --stall-ms MS           每次停止读取的时长（模拟控制器卡顿）" << std::endl;
+    std::cout << "  --stall-every-ms MS     停止读取的周期" << std::endl;
+    std::cout << "  --push-ip IP            覆盖 set_realtime_push 中的上报目标IP" << std::endl;
+    std::cout << "  --log FILE              每条收到的指令写一行CSV（recv_ns为单调时钟）" << std::endl;
+    std::cout << "  --stats-interval S      周期统计输出间隔（秒，0为不输出，默认1）" << std::endl;
+    std::cout << "  --duration S            运行时长后退出并输出汇总（默认直到Ctrl+C）" << std::endl;
+    std::cout << "  --seed N                抖动随机数种子" << std::endl;
+    std::cout << "  --kinematics MODEL      按运动学模型模拟逆解和拒绝（rm65）" << std::endl;
+    std::cout << "  --joints J1,...,J6      初始关节角度（度，默认 0,0,90,0,90,0）" << std::endl;
+    std::cout << "  --singularity W         笛卡尔目标的可操作度低于该值时拒绝（默认0.004）" << std::endl;
+    std::cout << "  --max-joint-step DEG    相邻两帧单关节变化超过该值时拒绝（默认10）" << std::endl;
+    std::cout << "  --close-after N         每个连接收到N条指令并发完响应后主动断开（模拟掉线）" << std::endl;
+    std::cout << "  --no-reply COMMAND      不应答该指令（模拟丢失的响应），可重复" << std::endl;
+    std::cout << "  --event-ms MS           按周期发送未请求的轨迹到位事件 current_trajectory_state" << std::endl;
+    std::cout << "  --help                  显示此帮助信息" << std::endl;
+    std::cout << std::endl;
+    std::cout << "示例:" << std::endl;
+    std::cout << "  " << program << " --arm 127.0.0.1:18080 --arm 127.0.0.2:18080 --latency-ms 2 --jitter-ms 1" << std::endl;
+}
+
+bool parseArm(const std::string& text, std::pair<std::string, int>& arm) {
+    size_t colon = text.rfind(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+    arm.first = text.substr(0, colon);
+    arm.second = atoi(text.c_str() + colon + 1);
+    return !arm.first.empty() && arm.second > 0 && arm.second < 65536;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    MockOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "❌ 参数缺少取值: " << arg << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--arm") {
+            std::pair<std::string, int> arm;
+            if (!parseArm(value, arm)) {
+                std::cerr << "❌ 无效的机械臂地址: " << value << std::endl;
+                return 1;
+            }
+            options.arms.push_back(arm);
+        } else if (arg == "--latency-ms") {
+            options.latencyMs = atof(value.c_str());
+        } else if (arg == "--jitter-ms") {
+            options.jitterMs = atof(value.c_str());
+        } else if (arg == "--segment") {
+            options.segmentBytes = static_cast<size_t>(atoi(value.c_str()));
+        } else if (arg == "--segment-gap-us") {
+            options.segmentGapUs = atoi(value.c_str());
+        } else if (arg == "--rcvbuf") {
+            options.receiveBuffer = atoi(value.c_str());
+        } else if (arg == "--stall-ms") {
+            options.stallMs = atoi(value.c_str());
+        } else if (arg == "--stall-every-ms") {
+            options.stallEveryMs = atoi(value.c_str());
+        } else if (arg == "--push-ip") {
+            options.pushIp = value;
+        } else if (arg == "--log") {
+            options.logPath = value;
+        } else if (arg == "--stats-interval") {
+            options.statsInterval = atof(value.c_str());
+        } else if (arg == "--duration") {
+            options.duration = atof(value.c_str());
+        } else if (arg == "--seed") {
+            options.seed = static_cast<unsigned>(strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--kinematics") {
+            options.kinematics = value;
+        } else if (arg == "--joints") {
+            const char* p = value.c_str();
+            for (int j = 0; j < 6; ++j) {
+                char* end = nullptr;
+                options.joints[j] = strtod(p, &end);
+                if (end == p) {
+                    std::cerr << "❌ 无效的关节角度: " << value << std::endl;
+                    return 1;
+                }
+                p = *end == ',' ? end + 1 : end;
+            }
+        } else if (arg == "--singularity") {
+            options.singularityThreshold = atof(value.c_str());
+        } else if (arg == "--max-joint-step") {
+            options.maxJointStepDeg = atof(value.c_str());
+        } else if (arg == "--close-after") {
+            options.closeAfter = atoi(value.c_str());
+        } else if (arg == "--no-reply") {
+            options.noReply.push_back(value);
+        } else if (arg == "--event-ms") {
+            options.eventMs = atoi(value.c_str());
+        } else {
+            std::cerr << "❌ 未知参数: " << arg << "（--help 查看用法）" << std::endl;
+            return 1;
+        }
+    }
+    if (options.arms.empty()) {
+        options.arms.push_back(std::make_pair(std::string("127.0.0.1"), 8080));
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = signalHandler;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    MockArmServer server(options);
+    if (!server.start()) {
+        return 1;
+    }
+    server.run();
+    return 0;
+}
@@ -77,12 +77,14 @@ install_libraries() {
     
     # 复制库文件
     sudo cp ./OpenHaptics/openhaptics_3.4-0-developer-edition-amd64/usr/lib/libH*.* /usr/lib/
+    sudo cp ./OpenHaptics/openhaptics_3.4-0-developer-edition-amd64/usr/lib/libSnapConstraints.a /usr/lib/
     
     # 设置权限
     sudo chmod 755 /usr/lib/libHL.so.3.4.0
     sudo chmod 755 /usr/lib/libHD.so.3.4.0
     sudo chmod 644 /usr/lib/libHLU.a
     sudo chmod 644 /usr/lib/libHDU.a
+    sudo chmod 644 /usr/lib/libSnapConstraints.a
     
     # 创建符号链接
     sudo ln -sf /usr/lib/libHL.so.3.4.0 /usr/lib/libHL.so.3.4
@@ -98,16 +100,17 @@ install_headers() {
     log_info "开始安装OpenHaptics头文件到 /usr/include..."
     
     # 创建目录并复制头文件
-    sudo mkdir -p /usr/include/HD /usr/include/HDU /usr/include/HL /usr/include/HLU
+    sudo mkdir -p /usr/include/HD /usr/include/HDU /usr/include/HL /usr/include/HLU /usr/include/SnapConstraints
     
     sudo cp ./OpenHaptics/openhaptics_3.4-0-developer-edition-amd64/usr/include/HD/* /usr/include/HD/
     sudo cp ./OpenHaptics/openhaptics_3.4-0-developer-edition-amd64/usr/include/HDU/* /usr/include/HDU/
     sudo cp ./OpenHaptics/openhaptics_3.4-0-developer-edition-amd64/usr/include/HL/* /usr/include/HL/
     sudo cp ./OpenHaptics/openhaptics_3.4-0-developer-edition-amd64/usr/include/HLU/* /usr/include/HLU/
+    sudo cp ./OpenHaptics/openhaptics_3.4-0-developer-edition-amd64/usr/include/SnapConstraints/* /usr/include/SnapConstraints/
     
     # 设置权限
-    sudo chmod -R 644 /usr/include/H*/
-    sudo chmod 755 /usr/include/HD /usr/include/HDU /usr/include/HL /usr/include/HLU
+    sudo chmod -R 644 /usr/include/H*/ /usr/include/SnapConstraints/
+    sudo chmod 755 /usr/include/HD /usr/include/HDU /usr/include/HL /usr/include/HLU /usr/include/SnapConstraints
     
     log_success "OpenHaptics头文件安装完成"
 }
@@ -135,7 +138,7 @@ verify_installation() {
     log_info "验证安装结果..."
     
     # 检查库文件
-    local lib_files=("libHL.so.3.4.0" "libHD.so.3.4.0" "libHLU.a" "libHDU.a")
+    local lib_files=("libHL.so.3.4.0" "libHD.so.3.4.0" "libHLU.a" "libHDU.a" "libSnapConstraints.a")
     for lib in "${lib_files[@]}"; do
         if [[ -f "/usr/lib/$lib" ]]; then
             log_success "库文件存在: /usr/lib/$lib"
@@ -0,0 +1,126 @@
+#!/bin/bash
+
+# 机械臂通信回环测试：每个场景按所需选项启动 mock_arm_server，
+# 再运行 Touch_Controller_Arm2 --selftest-loopback <场景>，全部通过时返回0
+#
+# 用法: test/test_arm_loopback.sh [场景...]（默认运行全部场景）
+# 环境变量:
+#   TOUCH_CONTROLLER_BIN  主程序路径（默认 ./Touch_Controller_Arm2）
+#   MOCK_ARM_SERVER_BIN   模拟器路径（默认 ./mock_arm_server，make mock_arm_server 生成）
+#   LOOPBACK_PORT         模拟器监听端口（默认 18080）
+
+cd "$(dirname "$0")/.."
+
+CONTROLLER=${TOUCH_CONTROLLER_BIN:-./Touch_Controller_Arm2}
+MOCK=${MOCK_ARM_SERVER_BIN:-./mock_arm_server}
+PORT=${LOOPBACK_PORT:-18080}
+ADDRESS=127.0.0.1:$PORT
+ALL_SCENARIOS="framing backpressure connect correlation"
+
+for BINARY in "$CONTROLLER" "$MOCK"; do
+    if [ ! -x "$BINARY" ]; then
+        echo "❌ 找不到可执行文件: $BINARY"
+        exit 1
+    fi
+done
+
+LOG_DIR=$(mktemp -d /tmp/arm_loopback.XXXXXX)
+MOCK_PID=""
+
+# 后台启动模拟器（附加参数为场景选项），等待其开始监听
+start_mock() {
+    "$MOCK" --arm "$ADDRESS" --stats-interval 0 "$@" > "$LOG_DIR/mock_$SCENARIO.log" 2>&1 &
+    MOCK_PID=$!
+    sleep 0.3
+}
+
+# SIGINT 让模拟器输出汇总并写完指令日志后退出
+stop_mock() {
+    if [ -n "$MOCK_PID" ]; then
+        kill -INT "$MOCK_PID" 2>/dev/null
+        wait "$MOCK_PID" 2>/dev/null
+        MOCK_PID=""
+    fi
+}
+trap stop_mock EXIT
+
+# 响应拆成7字节的小段分别发送；每个连接收到1000条指令后模拟器主动断开
+run_framing() {
+    start_mock --segment 7 --segment-gap-us 50 --close-after 1000
+    "$CONTROLLER" --selftest-loopback framing "$ADDRESS"
+    local result=$?
+    stop_mock
+    return $result
+}
+
+# 接收缓冲区4KB、每300ms停止读取200ms；主程序发送缓冲区同为4KB。
+# 模拟器退出后核对指令日志：每帧完整（pose[0] = -pose[5]）、序号递增，最后一帧带结束标记（pose[1] = 1）
+run_backpressure() {
+    local csv="$LOG_DIR/backpressure.csv"
+    start_mock --rcvbuf 4096 --stall-ms 200 --stall-every-ms 300 --log "$csv"
+    "$CONTROLLER" --selftest-loopback backpressure "$ADDRESS"
+    local result=$?
+    stop_mock
+    awk -F, '
+        NR == 1 { next }
+        { ++lines }
+        $3 != "movep_follow" || $6 == "" || $11 == "" || $6 + $11 != 0 { ++broken; next }
+        $6 + 0 <= last { ++reordered }
+        { last = $6 + 0; final = $7 + 0; if ($7 + 0 == 1) ++marks }
+        END {
+            ok = lines > 0 && broken == 0 && reordered == 0 && marks == 1 && final == 1
+            printf "  %s 指令日志 %d 帧：不完整 %d，乱序 %d，最后一帧%s最新帧\n",
+                   ok ? "✅" : "❌", lines, broken, reordered, final == 1 ? "为" : "不是"
+            exit ok ? 0 : 1
+        }' "$csv" || result=1
+    return $result
+}
+
+# 端口 PORT 立即启动模拟器，PORT+1 无人监听（拒绝连接），PORT+2 的模拟器在自测开始1.5s后启动
+run_connect() {
+    start_mock
+    "$CONTROLLER" --selftest-loopback connect "$ADDRESS" &
+    local selftest=$!
+    sleep 1.5
+    "$MOCK" --arm "127.0.0.1:$((PORT + 2))" --stats-interval 0 > "$LOG_DIR/mock_connect_late.log" 2>&1 &
+    local late=$!
+    wait "$selftest"
+    local result=$?
+    kill -INT "$late" 2>/dev/null
+    wait "$late" 2>/dev/null
+    stop_mock
+    return $result
+}
+
+# 响应延迟20ms，每5ms插入一条轨迹到位事件，寄存器写入不应答
+run_correlation() {
+    start_mock --latency-ms 20 --event-ms 5 --no-reply write_single_register
+    "$CONTROLLER" --selftest-loopback correlation "$ADDRESS"
+    local result=$?
+    stop_mock
+    return $result
+}
+
+echo "=== 机械臂通信回环测试 ==="
+echo "日志目录: $LOG_DIR"
+FAILED=""
+for SCENARIO in ${@:-$ALL_SCENARIOS}; do
+    echo ""
+    echo "🧪 场景: $SCENARIO"
+    if ! declare -F "run_$SCENARIO" > /dev/null; then
+        echo "❌ 未知场景: $SCENARIO（可选: $ALL_SCENARIOS）"
+        FAILED="$FAILED $SCENARIO"
+        continue
+    fi
+    if ! "run_$SCENARIO"; then
+        echo "   模拟器输出: $LOG_DIR/mock_$SCENARIO.log"
+        FAILED="$FAILED $SCENARIO"
+    fi
+done
+
+echo ""
+if [ -n "$FAILED" ]; then
+    echo "❌ 失败的场景:$FAILED"
+    exit 1
+fi
+echo "✅ 全部场景通过"